@@ -0,0 +1,526 @@
+/**
+ * @file ComStudioBench.cpp
+ * @brief Microbenchmarks for the parser, frame decoder, checksum, buffer, downsampling and writer hot paths
+ *
+ * Built as comstudio_bench (Qt Test QBENCHMARK). For machine-readable
+ * results run e.g. `comstudio_bench -o results.xml,xml` or
+ * `comstudio_bench -o results.csv,csv`.
+ */
+
+#include <QtTest>
+#include <QBuffer>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QtEndian>
+#include <QtMath>
+#include <cstring>
+
+#include "core/LineParser.h"
+#include "core/ParserConfig.h"
+#include "core/BinaryFrameProtocol.h"
+#include "core/FrameSchema.h"
+#include "core/Checksum.h"
+#include "core/NmeaProtocol.h"
+#include "core/Downsampler.h"
+#include "core/CsvRecordWriter.h"
+#include "core/PacketBatch.h"
+#include "models/DataBuffer.h"
+#include "ui/TerminalWidget.h"
+
+namespace {
+
+constexpr int LinesPerBlock = 1000;
+constexpr int PacketsPerRun = 10000;
+constexpr int DisplayPoints = 2000;   ///< PlotterWidget::MAX_DISPLAY_POINTS
+
+/**
+ * @brief Build a block of lines with the given field count
+ */
+QByteArray makeBlock(int fields, const QString &delimiter, bool labeled, bool withId)
+{
+    QByteArray block;
+    for (int line = 0; line < LinesPerBlock; ++line) {
+        QStringList tokens;
+        if (withId) {
+            tokens.append(QString::number(line % 2 + 1));
+        }
+        for (int f = 0; f < fields; ++f) {
+            const QString value = QString::number(qSin(line * 0.01 + f) * 100.0, 'f', 3);
+            tokens.append(labeled ? QString("ch%1:%2").arg(f).arg(value) : value);
+        }
+        block.append(tokens.join(delimiter).toUtf8());
+        block.append('\n');
+    }
+    return block;
+}
+
+/**
+ * @brief Append an NMEA-style "*XX" checksum to every line of a block
+ */
+QByteArray withLineChecksums(const QByteArray &block)
+{
+    QByteArray result;
+    for (const QByteArray &line : block.split('\n')) {
+        if (!line.isEmpty()) {
+            result.append(line);
+            result.append('*');
+            result.append(QByteArray::number(Checksum::xor8(line), 16).rightJustified(2, '0').toUpper());
+            result.append('\n');
+        }
+    }
+    return result;
+}
+
+GenericDataPacket makePacket(quint64 index, int channels)
+{
+    GenericDataPacket packet;
+    packet.timestamp = 1700000000000 + static_cast<qint64>(index);
+    packet.packetIndex = index;
+    packet.sensorId = QStringLiteral("1");
+    for (int c = 0; c < channels; ++c) {
+        const double value = qSin(index * 0.01 + c) * 100.0;
+        packet.addChannel(QString("Ch%1").arg(c), value);
+    }
+    packet.isValid = true;
+    return packet;
+}
+
+/**
+ * @brief Frame schemas: a plain float array and a mixed big-endian layout
+ */
+QJsonObject frameSchema(const QString &name)
+{
+    if (name == "f32x8_sum8") {
+        return QJsonDocument::fromJson(R"({
+            "sync": "AA 55",
+            "fields": [ { "name": "a", "type": "f32" }, { "name": "b", "type": "f32" },
+                        { "name": "c", "type": "f32" }, { "name": "d", "type": "f32" },
+                        { "name": "e", "type": "f32" }, { "name": "f", "type": "f32" },
+                        { "name": "g", "type": "f32" }, { "name": "h", "type": "f32" } ],
+            "checksum": { "type": "sum8" } })").object();
+    }
+    return QJsonDocument::fromJson(R"({
+        "endian": "big", "sync": "AA 55",
+        "length": { "at": 2, "type": "u8" },
+        "fields": [ { "name": "seq", "type": "u32" },
+                    { "name": "ax", "type": "i16", "scale": 0.001 },
+                    { "name": "ay", "type": "i16", "scale": 0.001 },
+                    { "name": "az", "type": "i16", "scale": 0.001 },
+                    { "name": "gx", "type": "i16", "scale": 0.01 },
+                    { "name": "gy", "type": "i16", "scale": 0.01 },
+                    { "name": "gz", "type": "i16", "scale": 0.01 },
+                    { "name": "ok", "type": "u8", "bits": [0, 1] },
+                    { "name": "mode", "type": "u8", "bits": [1, 3] },
+                    { "name": "temp", "type": "u16", "endian": "little", "scale": 0.01, "offset": -40 } ],
+        "checksum": { "type": "crc16", "endian": "little" } })").object();
+}
+
+/**
+ * @brief Encode LinesPerBlock frames of one of the schemas above
+ */
+QByteArray makeFrameBlock(const FrameDecoder &decoder)
+{
+    const FrameSchema &schema = decoder.schema();
+    const int size = decoder.minFrameSize();
+    QByteArray block;
+    block.reserve(size * LinesPerBlock);
+    for (int n = 0; n < LinesPerBlock; ++n) {
+        QByteArray frame(size, '\0');
+        char *p = frame.data();
+        std::memcpy(p, schema.sync.constData(), static_cast<size_t>(schema.sync.size()));
+        if (schema.lengthAt >= 0) {
+            p[schema.lengthAt] = static_cast<char>(size);
+        }
+        for (int f = 0; f < schema.fields.size(); ++f) {
+            const FrameField &field = schema.fields[f];
+            const double value = qSin(n * 0.01 + f);
+            char *at = p + field.at;
+            if (field.bitWidth > 0) {
+                at[0] = static_cast<char>(at[0] | ((n & ((1 << field.bitWidth) - 1)) << field.bitShift));
+            } else if (field.type == FrameFieldType::F32) {
+                const float v = static_cast<float>(value * 100.0);
+                field.bigEndian ? qToBigEndian(v, at) : qToLittleEndian(v, at);
+            } else if (field.type == FrameFieldType::U32) {
+                const quint32 v = static_cast<quint32>(n);
+                field.bigEndian ? qToBigEndian(v, at) : qToLittleEndian(v, at);
+            } else {
+                const quint16 v = static_cast<quint16>(static_cast<qint16>(value * 10000.0));
+                field.bigEndian ? qToBigEndian(v, at) : qToLittleEndian(v, at);
+            }
+        }
+        const quint32 checksum = decoder.computeChecksum(frame);
+        if (schema.checksum == FrameChecksum::Sum8) {
+            p[size - 1] = static_cast<char>(checksum);
+        } else {
+            qToLittleEndian(static_cast<quint16>(checksum), p + size - 2);
+        }
+        block.append(frame);
+    }
+    return block;
+}
+
+void makeSeries(int size, QVector<double> &x, QVector<double> &y)
+{
+    x.resize(size);
+    y.resize(size);
+    QRandomGenerator rng(42);
+    for (int i = 0; i < size; ++i) {
+        x[i] = i * 0.001;
+        y[i] = qSin(i * 0.001) + rng.generateDouble() * 0.1;
+    }
+}
+
+} // namespace
+
+/**
+ * @class ComStudioBench
+ * @brief QBENCHMARK suite (friend of LineParser and TerminalWidget)
+ */
+class ComStudioBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void lineParserParse_data();
+    void lineParserParse();
+    void binaryFrameParse_data();
+    void binaryFrameParse();
+    void frameDecode_data();
+    void frameDecode();
+    void checksum_data();
+    void checksum();
+    void nmeaParse();
+    void splitLine_data();
+    void splitLine();
+    void extractNumber_data();
+    void extractNumber();
+    void dataBufferAddPacket();
+    void dataBufferAddBatch();
+    void dataBufferChannelData();
+    void downsample_data();
+    void downsample();
+    void formatPacket();
+    void csvRecordWriter();
+};
+
+void ComStudioBench::lineParserParse_data()
+{
+    QTest::addColumn<QByteArray>("block");
+    QTest::addColumn<QString>("delimiter");
+    QTest::addColumn<bool>("stripLabels");
+    QTest::addColumn<int>("idFieldIndex");
+    QTest::addColumn<bool>("verifyChecksum");
+
+    QTest::newRow("csv_3")       << makeBlock(3, ",", false, false)  << "," << false << -1 << false;
+    QTest::newRow("csv_16")      << makeBlock(16, ",", false, false) << "," << false << -1 << false;
+    QTest::newRow("tab_8")       << makeBlock(8, "\t", false, false) << "\t" << false << -1 << false;
+    QTest::newRow("space_8")     << makeBlock(8, " ", false, false)  << " " << false << -1 << false;
+    QTest::newRow("labeled_8")   << makeBlock(8, ",", true, false)   << "," << true << -1 << false;
+    QTest::newRow("id_filter_8") << makeBlock(8, ",", false, true)   << "," << false << 0 << false;
+    QTest::newRow("checksum_8")  << withLineChecksums(makeBlock(8, ",", false, false)) << "," << false << -1 << true;
+}
+
+void ComStudioBench::lineParserParse()
+{
+    QFETCH(QByteArray, block);
+    QFETCH(QString, delimiter);
+    QFETCH(bool, stripLabels);
+    QFETCH(int, idFieldIndex);
+    QFETCH(bool, verifyChecksum);
+
+    ParserConfig config = ParserConfig::csvDefault();
+    config.delimiter = delimiter;
+    config.stripLabels = stripLabels;
+    config.idFieldIndex = idFieldIndex;
+    config.verifyChecksum = verifyChecksum;
+    if (idFieldIndex >= 0) {
+        config.acceptSensorId = QStringLiteral("1");
+    }
+
+    LineParser parser(config);
+    parser.setRateLimitEnabled(false);
+
+    QBENCHMARK {
+        parser.parse(block);
+    }
+}
+
+void ComStudioBench::binaryFrameParse_data()
+{
+    QTest::addColumn<QString>("schema");
+
+    QTest::newRow("f32x8_sum8")  << "f32x8_sum8";
+    QTest::newRow("mixed_crc16") << "mixed_crc16";
+}
+
+void ComStudioBench::binaryFrameParse()
+{
+    QFETCH(QString, schema);
+
+    FrameDecoder decoder;
+    QVERIFY2(decoder.load(frameSchema(schema)), qPrintable(decoder.errorString()));
+    const QByteArray block = makeFrameBlock(decoder);
+
+    BinaryFrameProtocol protocol;
+    protocol.setTargetDisplayRate(0);
+    QVERIFY(protocol.setSchema(decoder.schema()));
+    int frames = 0;
+    connect(&protocol, &BaseProtocol::batchForLogging, this, [&frames](const PacketBatch &batch) {
+        frames += static_cast<int>(batch.size());
+    });
+
+    QBENCHMARK {
+        protocol.parse(block);
+    }
+    QVERIFY(frames > 0 && frames % LinesPerBlock == 0);
+}
+
+void ComStudioBench::frameDecode_data()
+{
+    binaryFrameParse_data();
+}
+
+void ComStudioBench::frameDecode()
+{
+    QFETCH(QString, schema);
+
+    // Field extraction only: the compiled program without framing
+    FrameDecoder decoder;
+    QVERIFY2(decoder.load(frameSchema(schema)), qPrintable(decoder.errorString()));
+    const QByteArray block = makeFrameBlock(decoder);
+    const int size = decoder.minFrameSize();
+    QVector<double> values(decoder.channelNames().size());
+
+    QBENCHMARK {
+        for (int offset = 0; offset < block.size(); offset += size) {
+            decoder.decode(block.constData() + offset, values.data());
+        }
+    }
+}
+
+void ComStudioBench::checksum_data()
+{
+    QTest::addColumn<QString>("algorithm");
+    QTest::addColumn<int>("size");
+
+    // 64 bytes: a typical frame; 4 KiB: throughput per byte
+    for (const char *algorithm : {"xor8", "crc16-ccitt", "crc16-modbus", "crc32", "crc32c"}) {
+        for (int size : {64, 4096}) {
+            QTest::addRow("%s_%d", algorithm, size) << QString(algorithm) << size;
+        }
+    }
+}
+
+void ComStudioBench::checksum()
+{
+    QFETCH(QString, algorithm);
+    QFETCH(int, size);
+
+    QByteArray data(size, Qt::Uninitialized);
+    for (char &byte : data) {
+        byte = static_cast<char>(QRandomGenerator::global()->bounded(256));
+    }
+    quint32 (*function)(QByteArrayView) = nullptr;
+    if (algorithm == "xor8") {
+        function = [](QByteArrayView d) -> quint32 { return Checksum::xor8(d); };
+    } else if (algorithm == "crc16-ccitt") {
+        function = [](QByteArrayView d) -> quint32 { return Checksum::crc16Ccitt(d); };
+    } else if (algorithm == "crc16-modbus") {
+        function = [](QByteArrayView d) -> quint32 { return Checksum::crc16Modbus(d); };
+    } else if (algorithm == "crc32") {
+        function = [](QByteArrayView d) -> quint32 { return Checksum::crc32(d); };
+    } else {
+        function = [](QByteArrayView d) -> quint32 { return Checksum::crc32c(d); };
+    }
+    if (algorithm == "crc32c") {
+        qInfo("crc32c: %s", Checksum::hasHardwareCrc32c() ? "hardware" : "slice-by-8");
+    }
+
+    quint32 result = 0;
+    QBENCHMARK {
+        result ^= function(data);
+    }
+    Q_UNUSED(result);
+}
+
+void ComStudioBench::nmeaParse()
+{
+    // A 10 Hz receiver's mix: GGA, RMC, VTG and GSA every epoch
+    const QByteArray epoch =
+        "$GPGGA,123519.00,4807.0381,N,01131.0002,E,1,08,0.9,545.4,M,46.9,M,,*6A\r\n"
+        "$GPRMC,123519.00,A,4807.0381,N,01131.0002,E,022.4,084.4,230394,003.1,W*47\r\n"
+        "$GPVTG,084.4,T,087.5,M,022.4,N,041.5,K*48\r\n"
+        "$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39\r\n";
+    QByteArray block;
+    for (int i = 0; i < LinesPerBlock / 4; ++i) {
+        block.append(epoch);
+    }
+
+    NmeaProtocol protocol;
+    protocol.setTargetDisplayRate(0);
+    int errors = 0;
+    connect(&protocol, &BaseProtocol::parseError, this, [&errors]() { errors++; });
+
+    QBENCHMARK {
+        protocol.parse(block);
+    }
+    QCOMPARE(errors, 0);
+}
+
+void ComStudioBench::splitLine_data()
+{
+    QTest::addColumn<QString>("line");
+    QTest::addColumn<QString>("delimiter");
+
+    QTest::newRow("comma_4")   << QString("1.0,2.0,3.0,4.0") << ",";
+    QTest::newRow("comma_16")  << QString::fromUtf8(makeBlock(16, ",", false, false).split('\n').first()) << ",";
+    QTest::newRow("tab_16")    << QString::fromUtf8(makeBlock(16, "\t", false, false).split('\n').first()) << "\t";
+    QTest::newRow("multi_16")  << QString::fromUtf8(makeBlock(16, "; ", false, false).split('\n').first()) << "; ";
+}
+
+void ComStudioBench::splitLine()
+{
+    QFETCH(QString, line);
+    QFETCH(QString, delimiter);
+
+    QBENCHMARK {
+        auto tokens = LineParser::splitLine(line, delimiter);
+        Q_UNUSED(tokens);
+    }
+}
+
+void ComStudioBench::extractNumber_data()
+{
+    QTest::addColumn<QString>("token");
+    QTest::addColumn<bool>("stripLabels");
+
+    QTest::newRow("plain")      << QString("123.456") << false;
+    QTest::newRow("padded")     << QString("  -1.5e3 ") << false;
+    QTest::newRow("labeled")    << QString("X:123.456") << true;
+    QTest::newRow("invalid")    << QString("abc") << false;
+}
+
+void ComStudioBench::extractNumber()
+{
+    QFETCH(QString, token);
+    QFETCH(bool, stripLabels);
+
+    ParserConfig config = ParserConfig::csvDefault();
+    config.stripLabels = stripLabels;
+
+    QBENCHMARK {
+        auto value = LineParser::extractNumber(token, config);
+        Q_UNUSED(value);
+    }
+}
+
+void ComStudioBench::dataBufferAddPacket()
+{
+    QVector<GenericDataPacket> packets;
+    packets.reserve(PacketsPerRun);
+    for (int i = 0; i < PacketsPerRun; ++i) {
+        packets.append(makePacket(i, 4));
+    }
+
+    DataBuffer buffer(PacketsPerRun);
+    QBENCHMARK {
+        for (const auto &packet : std::as_const(packets)) {
+            buffer.addPacket(packet);
+        }
+    }
+}
+
+void ComStudioBench::dataBufferAddBatch()
+{
+    // Parser-sized batches, as published by LineParser::parse()
+    QVector<PacketBatch> batches;
+    for (int start = 0; start < PacketsPerRun; start += LinesPerBlock) {
+        QVector<GenericDataPacket> packets;
+        packets.reserve(LinesPerBlock);
+        for (int i = start; i < start + LinesPerBlock; ++i) {
+            packets.append(makePacket(i, 4));
+        }
+        batches.append(PacketBatch(std::move(packets)));
+    }
+
+    DataBuffer buffer(PacketsPerRun);
+    QBENCHMARK {
+        for (const auto &batch : std::as_const(batches)) {
+            buffer.addBatch(batch);
+        }
+    }
+    QCOMPARE(buffer.size(), PacketsPerRun);
+}
+
+void ComStudioBench::dataBufferChannelData()
+{
+    DataBuffer buffer(PacketsPerRun);
+    for (int i = 0; i < PacketsPerRun; ++i) {
+        buffer.addPacket(makePacket(i, 4));
+    }
+
+    QVector<double> timestamps, values;
+    QBENCHMARK {
+        buffer.channelData(QStringLiteral("Ch0"), timestamps, values);
+    }
+    QCOMPARE(timestamps.size(), PacketsPerRun);
+}
+
+void ComStudioBench::downsample_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<int>("size");
+
+    for (int size : {10000, 100000, 1000000}) {
+        QTest::addRow("lttb_%d", size) << static_cast<int>(DownsampleMode::LTTB) << size;
+        QTest::addRow("minmax_%d", size) << static_cast<int>(DownsampleMode::MinMax) << size;
+    }
+}
+
+void ComStudioBench::downsample()
+{
+    QFETCH(int, mode);
+    QFETCH(int, size);
+
+    QVector<double> x, y, outX, outY;
+    makeSeries(size, x, y);
+
+    QBENCHMARK {
+        Downsampler::downsample(static_cast<DownsampleMode>(mode), x, y, DisplayPoints, outX, outY);
+    }
+    QVERIFY(outX.size() <= DisplayPoints + 2);
+}
+
+void ComStudioBench::formatPacket()
+{
+    const GenericDataPacket packet = makePacket(12345, 8);
+
+    QBENCHMARK {
+        QString text = TerminalWidget::formatPacket(packet);
+        Q_UNUSED(text);
+    }
+}
+
+void ComStudioBench::csvRecordWriter()
+{
+    QVector<GenericDataPacket> packets;
+    packets.reserve(LinesPerBlock);
+    for (int i = 0; i < LinesPerBlock; ++i) {
+        packets.append(makePacket(i, 8));
+    }
+
+    QBENCHMARK {
+        QBuffer device;
+        device.open(QIODevice::WriteOnly);
+        CsvRecordWriter writer(true);
+        writer.setDevice(&device);
+        for (const auto &packet : std::as_const(packets)) {
+            writer.append(packet);
+        }
+        writer.close();
+    }
+}
+
+QTEST_GUILESS_MAIN(ComStudioBench)
+
+#include "ComStudioBench.moc"
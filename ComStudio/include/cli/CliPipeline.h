@@ -0,0 +1,134 @@
+/**
+ * @file CliPipeline.h
+ * @brief Headless capture -> parse -> record pipeline for comstudio-cli
+ */
+
+#ifndef CLIPIPELINE_H
+#define CLIPIPELINE_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <memory>
+
+#include "core/SerialManager.h"
+#include "core/ParserConfig.h"
+#include "core/RawCapture.h"
+#include "core/PipelineMetrics.h"
+#include "core/PacketBatch.h"
+
+class QTimer;
+class LineParser;
+class PipelineGraph;
+class CsvRecordWriter;
+class RecordingWriter;
+
+/**
+ * @struct CliOptions
+ * @brief Everything comstudio-cli was asked to do
+ */
+struct CliOptions
+{
+    SerialSettings serial;              ///< Source (serial port, replay or generator)
+    ParserConfig parser;                ///< Line parser configuration
+    QString pipelinePath;               ///< Stage graph config (empty = parser only)
+    QString outputPath;                 ///< Parsed packets (empty = parse only)
+    bool nativeFormat = false;          ///< .csrec instead of CSV
+    bool includeTimestamp = true;       ///< CSV Timestamp column
+    RawCaptureSettings rawCapture;      ///< Raw bytes (empty path = off)
+    qint64 durationMs = 0;              ///< Stop after this time (0 = no limit)
+    quint64 maxPackets = 0;             ///< Stop after this many packets (0 = no limit)
+    int statsIntervalMs = 0;            ///< Periodic stats on stderr (0 = off)
+};
+
+/**
+ * @class CliPipeline
+ * @brief Wires SerialManager, LineParser and a recording writer without any GUI
+ *
+ * Every parsed packet is recorded (batchForLogging, no display rate limit).
+ * With a pipeline config, bytes go to its "serial" source stage instead
+ * and its "record" sink feeds the output.
+ * The pipeline finishes on a stop condition, on disconnect, at the end
+ * of a replay or when stop() is called, and reports a summary on stderr.
+ */
+class CliPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor
+     * @param options What to capture and where to write it
+     * @param parent Parent object
+     */
+    explicit CliPipeline(const CliOptions &options, QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor - closes the outputs
+     */
+    ~CliPipeline() override;
+
+    /**
+     * @brief Open the outputs and connect the source
+     * @return False if an output could not be opened (see errorString())
+     */
+    bool start();
+
+    /**
+     * @brief Get the last error
+     * @return Error text
+     */
+    QString errorString() const { return m_errorString; }
+
+public slots:
+    /**
+     * @brief Stop capturing and finish (e.g. on Ctrl+C)
+     */
+    void stop();
+
+signals:
+    /**
+     * @brief Emitted once when the pipeline is done
+     * @param exitCode Process exit code (0 = success)
+     */
+    void finished(int exitCode);
+
+private slots:
+    void onRawBytes(const QByteArray &data);
+    void onBatch(const PacketBatch &batch);
+    void onConnectionStateChanged(bool connected, const QString &message);
+    void onError(const QString &error);
+    void onReplayFinished(const ReplayStats &stats);
+    void onStatsTimer();
+
+private:
+    /**
+     * @brief Stop the timers and disconnect; complete() follows once closed
+     * @param exitCode Exit code
+     * @param reason Why the pipeline stopped
+     */
+    void finish(int exitCode, const QString &reason);
+
+    /**
+     * @brief Close the outputs, print the summary and emit finished()
+     */
+    void complete();
+
+    CliOptions m_options;
+    std::unique_ptr<LineParser> m_parser;
+    std::unique_ptr<PipelineGraph> m_pipeline;  ///< Replaces m_parser if a config is given
+    std::unique_ptr<CsvRecordWriter> m_csvWriter;
+    std::unique_ptr<RecordingWriter> m_nativeWriter;
+    QTimer *m_statsTimer = nullptr;
+    QTimer *m_durationTimer = nullptr;
+    QElapsedTimer m_clock;
+    MetricsSnapshot m_lastStats;
+    quint64 m_packets = 0;
+    QString m_errorString;
+    QString m_writeError;               ///< First write error (reported in the summary)
+    QString m_stopReason;
+    int m_exitCode = 0;
+    bool m_connected = false;
+    bool m_finished = false;
+};
+
+#endif // CLIPIPELINE_H
@@ -12,10 +12,35 @@
 
 #include <QObject>
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QString>
 #include <memory>
 
 #include "GenericDataPacket.h"
+#include "PacketBatch.h"
+
+/**
+ * @struct FrameClaim
+ * @brief A protocol's answer to "does this data start with one of your frames?"
+ *
+ * Used by ProtocolHandler to split one byte stream between several
+ * protocols (see BaseProtocol::claimFrame()).
+ */
+struct FrameClaim
+{
+    enum Result {
+        NoMatch,    ///< Not this protocol's frame
+        NeedMore,   ///< Could be a frame; wait for more bytes
+        Match       ///< A frame of length bytes
+    };
+
+    Result result = NoMatch;
+    qsizetype length = 0;   ///< Frame length in bytes (Match)
+
+    static FrameClaim noMatch() { return {}; }
+    static FrameClaim needMore() { return {NeedMore, 0}; }
+    static FrameClaim match(qsizetype length) { return {Match, length}; }
+};
 
 /**
  * @class BaseProtocol
@@ -39,8 +64,8 @@ public:
     /**
      * @brief Parse incoming raw bytes
      *
-     * Process raw data from the serial port and emit dataParsed()
-     * for each complete packet/frame that is decoded.
+     * Process raw data from the serial port and emit batchForLogging()
+     * and batchParsed() with the complete packets/frames that were decoded.
      *
      * @param data Raw bytes received from serial port
      */
@@ -71,13 +96,45 @@ public:
      * @return True if protocol has configurable options
      */
     virtual bool isConfigurable() const { return false; }
+    
+    /**
+     * @brief Check whether data starts with a frame of this protocol
+     *
+     * Used when several protocols share one stream: the claimed bytes
+     * are passed to parse() of this protocol only. Must be cheap (sync
+     * bytes, length field, line ending) and must not change state. The
+     * default claims nothing, so the protocol can only run alone.
+     *
+     * @param data Unassigned bytes, starting at a possible frame boundary
+     * @return Claim; a match must cover at least one byte
+     */
+    virtual FrameClaim claimFrame(QByteArrayView data) const
+    {
+        Q_UNUSED(data);
+        return FrameClaim::noMatch();
+    }
 
 signals:
     /**
-     * @brief Emitted when a complete data packet is parsed
-     * @param packet The parsed data in standardized format
+     * @brief Emitted when complete data packets are parsed
+     *
+     * Protocols publish the packets of one parse() call together;
+     * receivers hold the batch instead of copying packets.
+     *
+     * @param batch The parsed data in standardized format
+     */
+    void batchParsed(const PacketBatch &batch);
+    
+    /**
+     * @brief Emitted with every valid packet of a parse() call (no rate limiting)
+     * 
+     * Use this for data logging where all samples must be recorded.
+     * Emitted before batchParsed(); protocols without a display rate
+     * limit emit the same batch on both.
+     * 
+     * @param batch The parsed packets in arrival order
      */
-    void dataParsed(const GenericDataPacket &packet);
+    void batchForLogging(const PacketBatch &batch);
     
     /**
      * @brief Emitted when a parsing error occurs
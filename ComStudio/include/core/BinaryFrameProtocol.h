@@ -0,0 +1,99 @@
+/**
+ * @file BinaryFrameProtocol.h
+ * @brief Protocol for custom binary telemetry described by a FrameSchema
+ */
+
+#ifndef BINARYFRAMEPROTOCOL_H
+#define BINARYFRAMEPROTOCOL_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "FramedProtocol.h"
+#include "FrameSchema.h"
+
+/**
+ * @class BinaryFrameProtocol
+ * @brief Finds, checks and decodes frames with a compiled FrameDecoder
+ *
+ * Frames start at the schema's sync bytes; a frame with a bad length
+ * or checksum is skipped by one byte and the search continues. If the
+ * schema has a "framing" entry, its Framer delimits the frames instead
+ * and each frame is checked against the layout. Without a schema
+ * loaded, parse() discards its input.
+ */
+class BinaryFrameProtocol : public FramedProtocol
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor
+     * @param parent Parent QObject
+     */
+    explicit BinaryFrameProtocol(QObject *parent = nullptr);
+
+    // BaseProtocol interface
+    void parse(const QByteArray &data) override;
+    QString name() const override { return QStringLiteral("Binary Frame"); }
+    QString description() const override;
+    void reset() override;
+    bool isConfigurable() const override { return true; }
+
+    /**
+     * @brief Claim a complete frame with a valid checksum
+     *
+     * Schemas without sync bytes or framing claim nothing, so they
+     * only run alone.
+     */
+    FrameClaim claimFrame(QByteArrayView data) const override;
+
+    /**
+     * @brief Compile and use a schema
+     * @param schema Frame layout
+     * @return False if the layout or framing is invalid (the previous schema stays)
+     */
+    bool setSchema(const FrameSchema &schema);
+
+    /**
+     * @brief Load, compile and use a JSON schema file
+     * @param path File path
+     * @return False on error (the previous schema stays)
+     */
+    bool loadSchema(const QString &path);
+
+    /**
+     * @brief Get the last setSchema()/loadSchema() error
+     * @return Error description
+     */
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * @brief Get the active decoder
+     * @return Decoder (invalid until a schema is loaded)
+     */
+    const FrameDecoder &decoder() const { return m_decoder; }
+
+protected:
+    void processFrame(QByteArrayView frame) override;
+
+private:
+    /**
+     * @brief Take a compiled decoder and its framer into use and reset
+     * @param decoder Valid decoder
+     * @return False if the schema's framing is invalid
+     */
+    bool useDecoder(const FrameDecoder &decoder);
+
+    /**
+     * @brief Decode one checked frame into a packet
+     * @param frame Frame bytes
+     */
+    void decodeFrame(const char *frame);
+
+    FrameDecoder m_decoder;
+    QByteArray m_buffer;                ///< Bytes not yet part of a complete frame
+    QString m_errorString;
+};
+
+#endif // BINARYFRAMEPROTOCOL_H
@@ -0,0 +1,199 @@
+/**
+ * @file BulkImporter.h
+ * @brief Offline import of large CSV/log files with parallel parsing
+ *
+ * Memory-maps the file, splits it into line-aligned chunks and parses
+ * them on a thread pool with LineParser::parseLine(). Results are
+ * delivered to the GUI thread strictly in file order.
+ */
+
+#ifndef BULKIMPORTER_H
+#define BULKIMPORTER_H
+
+#include <QObject>
+#include <QFile>
+#include <QMutex>
+#include <QPair>
+#include <QThreadPool>
+#include <QVector>
+#include <QElapsedTimer>
+#include <atomic>
+#include <optional>
+
+#include "GenericDataPacket.h"
+#include "PacketBatch.h"
+#include "ParserConfig.h"
+#include "DeviceClock.h"
+
+/**
+ * @struct ImportOptions
+ * @brief Tuning options for a bulk import
+ */
+struct ImportOptions
+{
+    qint64 chunkSize = 1024 * 1024;         ///< Target bytes per parse task
+    int threads = 0;                        ///< Worker threads (0 = ideal thread count)
+    qint64 sampleIntervalUs = 1000;         ///< Synthesized time step between lines
+    qint64 baseTimestamp = 0;               ///< Timestamp of the first line (0 = now)
+};
+
+/**
+ * @struct ImportChunkResult
+ * @brief Packets and counters produced from one chunk
+ */
+struct ImportChunkResult
+{
+    QVector<GenericDataPacket> packets;     ///< Packets with data, in line order
+    quint64 lines = 0;                      ///< Non-empty lines seen
+    quint64 errors = 0;                     ///< Lines that produced no valid packet
+};
+
+/**
+ * @struct ImportStats
+ * @brief Summary of a finished import
+ */
+struct ImportStats
+{
+    qint64 bytes = 0;                       ///< Bytes parsed
+    quint64 lines = 0;                      ///< Lines parsed
+    quint64 packets = 0;                    ///< Packets delivered
+    quint64 errors = 0;                     ///< Lines with parse errors
+    qint64 elapsedMs = 0;                   ///< Wall time
+    bool cancelled = false;
+};
+
+/**
+ * @class BulkImporter
+ * @brief Parallel, cancellable file importer
+ *
+ * At most a few chunks per thread are in flight, so memory use is
+ * bounded regardless of file size. Packet indices and timestamps are
+ * assigned during the in-order merge.
+ */
+class BulkImporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor
+     * @param parent Parent QObject
+     */
+    explicit BulkImporter(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor - cancels and waits for running tasks
+     */
+    ~BulkImporter() override;
+
+    /**
+     * @brief Start importing a file
+     * @param path File to import
+     * @param config Parser configuration (delimiter, fields, labels, ID filter)
+     * @param options Import tuning
+     * @return False if the file cannot be opened or mapped
+     */
+    bool start(const QString &path, const ParserConfig &config,
+               const ImportOptions &options = ImportOptions());
+
+    /**
+     * @brief Request cancellation (finished() follows once tasks drain)
+     */
+    void cancel();
+
+    /**
+     * @brief Check if an import is in progress
+     * @return True if running
+     */
+    bool isRunning() const { return m_running; }
+
+    /**
+     * @brief Get last error description
+     * @return Error string
+     */
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * @brief Split a buffer into line-aligned chunks
+     * @param data Buffer start
+     * @param size Buffer size
+     * @param chunkSize Target chunk size (chunks end after a '\n')
+     * @return Chunk boundaries as (offset, length) pairs
+     */
+    static QVector<QPair<qint64, qint64>> splitLineAligned(const char *data, qint64 size,
+                                                            qint64 chunkSize);
+
+    /**
+     * @brief Parse a chunk of complete lines
+     * @param data Chunk start
+     * @param size Chunk size
+     * @param config Parser configuration
+     * @param cancelled Optional flag polled to abort early
+     * @return Parsed packets (packetIndex relative to the chunk) and counters
+     */
+    static ImportChunkResult parseChunk(const char *data, qint64 size,
+                                        const ParserConfig &config,
+                                        const std::atomic<bool> *cancelled = nullptr);
+
+signals:
+    /**
+     * @brief Emitted as chunks are merged
+     * @param bytesDone Bytes merged so far
+     * @param bytesTotal File size
+     */
+    void progress(qint64 bytesDone, qint64 bytesTotal);
+
+    /**
+     * @brief Emitted for each chunk in file order
+     * @param batch Packets with global packetIndex and timestamps
+     */
+    void packetsReady(const PacketBatch &batch);
+
+    /**
+     * @brief Emitted when the import completes or is cancelled
+     * @param stats Import summary
+     */
+    void finished(const ImportStats &stats);
+
+private:
+    /**
+     * @brief Queue parse tasks up to the in-flight limit
+     */
+    void scheduleTasks();
+
+    /**
+     * @brief Merge finished chunks in order (GUI thread)
+     */
+    void mergeReadyChunks();
+
+    /**
+     * @brief Release the mapping and report the result
+     */
+    void finish();
+
+    QThreadPool m_pool;
+    QFile m_file;
+    const char *m_data = nullptr;               ///< Mapped file contents
+    qint64 m_size = 0;
+    ParserConfig m_config;
+    DeviceClock m_deviceClock;                  ///< Timebase, applied in merge order
+    ImportOptions m_options;
+    QString m_errorString;
+
+    QVector<QPair<qint64, qint64>> m_chunks;    ///< (offset, length) per chunk
+    QVector<std::optional<ImportChunkResult>> m_results;  ///< Guarded by m_resultMutex
+    QMutex m_resultMutex;
+    int m_nextToSchedule = 0;
+    int m_nextToMerge = 0;
+    int m_inFlight = 0;
+    int m_maxInFlight = 0;
+
+    std::atomic<bool> m_cancelled{false};
+    bool m_running = false;
+    quint64 m_nextPacketIndex = 0;
+    qint64 m_bytesMerged = 0;
+    ImportStats m_stats;
+    QElapsedTimer m_clock;
+};
+
+#endif // BULKIMPORTER_H
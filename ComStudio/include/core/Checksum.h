@@ -0,0 +1,94 @@
+/**
+ * @file Checksum.h
+ * @brief Frame and line checksums (sums, CRC-16, CRC-32, CRC-32C, NMEA)
+ *
+ * The CRCs use slice-by-8 tables: eight bytes per step with eight
+ * independent table lookups instead of one dependent lookup per byte.
+ * CRC-32C uses the SSE4.2 / ARMv8 CRC instructions when the CPU has
+ * them. At 12 Mbaud (about 1.2 MB/s) either costs well under 1% of a
+ * core.
+ */
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <QByteArrayView>
+#include <QtGlobal>
+
+/**
+ * @enum NmeaChecksum
+ * @brief Result of checking an NMEA-style "*XX" line checksum
+ */
+enum class NmeaChecksum {
+    Missing,    ///< No "*XX" at the end of the line
+    Valid,      ///< XX matches the XOR of the sentence bytes
+    Mismatch    ///< XX does not match
+};
+
+/**
+ * @namespace Checksum
+ * @brief Checksum functions over byte ranges
+ */
+namespace Checksum {
+
+    /**
+     * @brief 8-bit sum of the bytes
+     */
+    quint8 sum8(QByteArrayView data);
+
+    /**
+     * @brief 8-bit XOR of the bytes
+     */
+    quint8 xor8(QByteArrayView data);
+
+    /**
+     * @brief CRC-16/MODBUS (reflected 0x8005, init 0xFFFF)
+     */
+    quint16 crc16Modbus(QByteArrayView data);
+
+    /**
+     * @brief CRC-16/CCITT-FALSE (0x1021, init 0xFFFF, not reflected)
+     */
+    quint16 crc16Ccitt(QByteArrayView data);
+
+    /**
+     * @brief CRC-32 as used by Ethernet and zlib (reflected 0x04C11DB7)
+     */
+    quint32 crc32(QByteArrayView data);
+
+    /**
+     * @brief CRC-32C (Castagnoli, reflected 0x1EDC6F41)
+     *
+     * Uses the CPU's CRC32 instruction when available, slice-by-8 otherwise.
+     */
+    quint32 crc32c(QByteArrayView data);
+
+    /**
+     * @brief CRC-32C with the slice-by-8 tables only
+     *
+     * Reference for the hardware path of crc32c().
+     */
+    quint32 crc32cSoftware(QByteArrayView data);
+
+    /**
+     * @brief Check whether crc32c() runs on the CPU's CRC instruction
+     * @return True for SSE4.2 (x86) or the ARMv8 CRC extension
+     */
+    bool hasHardwareCrc32c();
+
+    /**
+     * @brief Check the "*XX" checksum of an NMEA-style line
+     *
+     * XX is the XOR of the bytes between a leading '$' or '!' (or the
+     * line start) and the '*', as two hex digits. Trailing whitespace
+     * after XX is allowed.
+     *
+     * @param line Line without the line ending
+     * @param bodySize Set to the offset of the '*' (if not Missing)
+     * @return Check result
+     */
+    NmeaChecksum checkNmea(QByteArrayView line, qsizetype *bodySize = nullptr);
+
+}
+
+#endif // CHECKSUM_H
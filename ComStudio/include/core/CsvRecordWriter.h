@@ -0,0 +1,87 @@
+/**
+ * @file CsvRecordWriter.h
+ * @brief Streaming CSV writer for recorded packets
+ */
+
+#ifndef CSVRECORDWRITER_H
+#define CSVRECORDWRITER_H
+
+#include <QFile>
+#include <QString>
+#include <QTextStream>
+
+#include "GenericDataPacket.h"
+
+class QIODevice;
+
+/**
+ * @class CsvRecordWriter
+ * @brief Writes one CSV row per packet
+ *
+ * Columns: [Timestamp,] PacketIndex, SensorID, Ch0..ChN. The header is
+ * written with the first packet, so it has that packet's channel count;
+ * rows of later packets with more channels get extra unnamed columns
+ * (streaming trade-off, the header is never rewritten).
+ */
+class CsvRecordWriter
+{
+public:
+    /**
+     * @brief Constructor
+     * @param includeTimestamp Write the Timestamp column
+     */
+    explicit CsvRecordWriter(bool includeTimestamp = true);
+
+    /**
+     * @brief Open (truncate) a file for writing
+     * @param path Output path
+     * @return True on success (see errorString())
+     */
+    bool open(const QString &path);
+
+    /**
+     * @brief Write to an already open device instead of a file
+     * @param device Device (not owned)
+     */
+    void setDevice(QIODevice *device);
+
+    /**
+     * @brief Append one packet (writes the header first if needed)
+     * @param packet Packet to write
+     */
+    void append(const GenericDataPacket &packet);
+
+    /**
+     * @brief Flush and close the file
+     * @return False if a write failed
+     */
+    bool close();
+
+    /**
+     * @brief Get the last error
+     * @return Error text
+     */
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * @brief Get the number of rows written
+     * @return Row count (excluding the header)
+     */
+    int recordCount() const { return m_recordCount; }
+
+private:
+    /**
+     * @brief Write the header row
+     */
+    void writeHeader();
+
+    QFile m_file;
+    QTextStream m_stream;
+    QString m_errorString;
+    bool m_includeTimestamp = true;
+    bool m_headerWritten = false;
+    int m_columns = 0;          ///< Channel columns per row (max seen)
+    int m_recordCount = 0;
+};
+
+#endif // CSVRECORDWRITER_H
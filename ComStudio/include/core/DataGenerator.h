@@ -0,0 +1,137 @@
+/**
+ * @file DataGenerator.h
+ * @brief Synthetic device traffic for load testing
+ *
+ * Produces line-oriented or binary frames with configurable channel
+ * count, rate, noise, spikes and malformed lines. Used by SerialWorker
+ * to implement the Generator port kind.
+ */
+
+#ifndef DATAGENERATOR_H
+#define DATAGENERATOR_H
+
+#include <QByteArray>
+#include <QVector>
+#include <random>
+
+/**
+ * @enum GeneratorFormat
+ * @brief Wire format of generated traffic
+ */
+enum class GeneratorFormat {
+    Csv,            ///< "1.23,4.56,..."
+    Labeled,        ///< "X:1.23,Y:4.56,..."
+    IdPrefixed,     ///< "<id>,1.23,4.56,..." (ID in field 0)
+    JustFloat       ///< Binary: N little-endian floats + 00 00 80 7F tail
+};
+
+/**
+ * @struct GeneratorSettings
+ * @brief Configuration of the synthetic data generator
+ */
+struct GeneratorSettings
+{
+    GeneratorFormat format = GeneratorFormat::Csv;
+    int channels = 4;                   ///< Values per line/frame
+    double linesPerSecond = 1000.0;     ///< Line rate (0 = as fast as the pipeline accepts)
+    qint32 baudLimit = 0;               ///< Byte budget as baud / 10 (0 = no limit)
+    double noise = 0.05;                ///< Gaussian noise standard deviation (amplitude 1.0 signal)
+    double spikeProbability = 0.0;      ///< Chance per value of a spike (0..1)
+    double malformedProbability = 0.0;  ///< Chance per line of a corrupted line (0..1)
+    int sensorCount = 3;                ///< Distinct IDs for IdPrefixed format
+};
+
+/**
+ * @class DataGenerator
+ * @brief Deterministic (seeded) traffic generator
+ *
+ * Each channel is a sine of a different frequency plus noise. The
+ * generator tracks how many lines and bytes it has produced so the
+ * caller only has to pass the elapsed time.
+ */
+class DataGenerator
+{
+public:
+    /**
+     * @brief Constructor
+     * @param settings Generator configuration
+     * @param seed Random seed (same seed gives the same stream)
+     */
+    explicit DataGenerator(const GeneratorSettings &settings = GeneratorSettings(),
+                           quint32 seed = 1);
+
+    /**
+     * @brief Append everything that is due at the given time
+     *
+     * Applies the line rate and the baud limit. With an unlimited rate
+     * a fixed-size batch is produced per call.
+     *
+     * @param elapsedNs Time since the generator started
+     * @param out Buffer to append to
+     * @param maxBytes Upper bound for this call
+     * @return Number of lines appended
+     */
+    int produce(qint64 elapsedNs, QByteArray &out, qsizetype maxBytes = 64 * 1024);
+
+    /**
+     * @brief Append a fixed number of lines/frames
+     * @param count Number of lines
+     * @param out Buffer to append to
+     */
+    void generate(int count, QByteArray &out);
+
+    /**
+     * @brief Get number of lines/frames generated
+     * @return Line count
+     */
+    quint64 linesGenerated() const { return m_lineIndex; }
+
+    /**
+     * @brief Get number of bytes generated
+     * @return Byte count
+     */
+    quint64 bytesGenerated() const { return m_bytes; }
+
+    /**
+     * @brief Get the configuration
+     * @return Settings
+     */
+    const GeneratorSettings& settings() const { return m_settings; }
+
+private:
+    /**
+     * @brief Compute the next value of a channel
+     * @param channel Channel index
+     * @return Sample value (with noise and occasional spikes)
+     */
+    double sample(int channel);
+
+    /**
+     * @brief Append one text line
+     * @param out Buffer to append to
+     */
+    void appendTextLine(QByteArray &out);
+
+    /**
+     * @brief Append one binary frame
+     * @param out Buffer to append to
+     */
+    void appendBinaryFrame(QByteArray &out);
+
+    /**
+     * @brief Damage a freshly appended line
+     * @param out Buffer containing the line
+     * @param lineStart Offset of the line in the buffer
+     */
+    void corruptLine(QByteArray &out, qsizetype lineStart);
+
+    GeneratorSettings m_settings;
+    std::mt19937 m_rng;
+    std::normal_distribution<double> m_noise{0.0, 1.0};  ///< Scaled by settings.noise
+    std::uniform_real_distribution<double> m_uniform{0.0, 1.0};
+    QVector<double> m_frequencies;      ///< Per-channel sine frequency (Hz)
+    quint64 m_lineIndex = 0;
+    quint64 m_bytes = 0;
+};
+
+#endif // DATAGENERATOR_H
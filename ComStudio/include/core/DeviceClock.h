@@ -0,0 +1,107 @@
+/**
+ * @file DeviceClock.h
+ * @brief X-axis timebase of parsed packets (host time, counter or device clock)
+ *
+ * Host arrival time includes USB and OS batching jitter: samples taken
+ * 1 ms apart on the device arrive in bursts. Devices that send their
+ * own tick counter give jitter-free spacing once the counter is
+ * unwrapped; an optional linear fit maps the device clock onto host
+ * time so it stays comparable with other sources despite drift.
+ */
+
+#ifndef DEVICECLOCK_H
+#define DEVICECLOCK_H
+
+#include <QtGlobal>
+
+#include "ParserConfig.h"
+#include "GenericDataPacket.h"
+
+/**
+ * @class DeviceClock
+ * @brief Sets GenericDataPacket::sampleTime according to ParserConfig::xAxisSource
+ *
+ * Stateful (counter unwrapping, drift fit): use one instance per
+ * stream and stamp packets in arrival order.
+ */
+class DeviceClock
+{
+public:
+    /**
+     * @brief Constructor
+     * @param config Parser configuration (xAxisSource and device tick settings)
+     */
+    explicit DeviceClock(const ParserConfig &config = ParserConfig());
+
+    /**
+     * @brief Apply a new configuration and reset
+     * @param config Parser configuration
+     */
+    void configure(const ParserConfig &config);
+
+    /**
+     * @brief Forget the counter history and the drift fit
+     */
+    void reset();
+
+    /**
+     * @brief Set the packet's sample time
+     *
+     * Timestamp: leaves sampleTime unset (host time is used). Counter:
+     * the packet index. FieldIndex: converts the raw tick value that
+     * LineParser::parseLine() stored in sampleTime to seconds.
+     *
+     * @param packet Packet with timestamp and packetIndex set
+     */
+    void stamp(GenericDataPacket &packet);
+
+    /**
+     * @brief Convert one device counter reading to seconds
+     * @param ticks Raw counter value
+     * @param hostSeconds Host arrival time in seconds
+     * @return Unwrapped device time, or host-clock time when fitting drift
+     */
+    double toSeconds(double ticks, double hostSeconds);
+
+    /**
+     * @brief Get the fitted drift of the device clock against host time
+     * @return Parts per million (0 while not fitting)
+     */
+    double driftPpm() const { return (m_rate - 1.0) * 1e6; }
+
+private:
+    /**
+     * @brief Add a (device, host) pair to the fit and update rate and offset
+     * @param x Device seconds since the fit origin
+     * @param y Host seconds since the fit origin
+     */
+    void addFitPoint(double x, double y);
+
+    static constexpr double FitWindow = 2000.0;     ///< Samples of exponential memory
+    static constexpr double MinFitWeight = 16.0;    ///< Samples before the slope is trusted
+    static constexpr double MaxDrift = 0.01;        ///< Slopes further from 1 are rejected
+
+    XAxisSource m_source = XAxisSource::Timestamp;
+    int m_tickBits = 0;
+    double m_tickSeconds = 0.001;
+    bool m_fitDrift = false;
+
+    // Counter unwrapping
+    bool m_started = false;
+    quint64 m_lastRaw = 0;
+    double m_ticks = 0.0;           ///< Unwrapped counter
+
+    // Drift fit: host = origin + offset + rate * (device - origin)
+    bool m_fitStarted = false;
+    double m_deviceOrigin = 0.0;
+    double m_hostOrigin = 0.0;
+    double m_sumW = 0.0;
+    double m_sumX = 0.0;
+    double m_sumY = 0.0;
+    double m_sumXX = 0.0;
+    double m_sumXY = 0.0;
+    double m_rate = 1.0;
+    double m_offset = 0.0;
+};
+
+#endif // DEVICECLOCK_H
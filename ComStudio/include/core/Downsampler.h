@@ -0,0 +1,61 @@
+/**
+ * @file Downsampler.h
+ * @brief Time-series downsampling for display (LTTB and Min-Max)
+ */
+
+#ifndef DOWNSAMPLER_H
+#define DOWNSAMPLER_H
+
+#include <QVector>
+
+/**
+ * @enum DownsampleMode
+ * @brief Downsampling algorithm selection
+ */
+enum class DownsampleMode {
+    LTTB,       ///< Largest Triangle Three Buckets - best for smooth trends
+    MinMax      ///< Min-Max bucketing - best for catching spikes/glitches
+};
+
+/**
+ * @namespace Downsampler
+ * @brief Reduce a series to at most maxPoints points
+ *
+ * Both algorithms always keep the first and last point. Inputs with
+ * maxPoints or fewer points are copied unchanged.
+ */
+namespace Downsampler {
+
+    /**
+     * @brief Downsample with the given algorithm
+     * @param mode Algorithm
+     * @param x Input timestamps (ascending)
+     * @param y Input values (same size as x)
+     * @param maxPoints Output size limit (>= 4)
+     * @param outX Output timestamps (replaced)
+     * @param outY Output values (replaced)
+     */
+    void downsample(DownsampleMode mode, const QVector<double> &x, const QVector<double> &y,
+                    int maxPoints, QVector<double> &outX, QVector<double> &outY);
+
+    /**
+     * @brief Largest Triangle Three Buckets
+     *
+     * Picks the point of each bucket that forms the largest triangle with
+     * the previous pick and the average of the next bucket.
+     */
+    void lttb(const QVector<double> &x, const QVector<double> &y,
+              int maxPoints, QVector<double> &outX, QVector<double> &outY);
+
+    /**
+     * @brief Min-Max bucketing
+     *
+     * Keeps the minimum and maximum of each bucket in time order, so
+     * single-sample spikes survive.
+     */
+    void minMax(const QVector<double> &x, const QVector<double> &y,
+                int maxPoints, QVector<double> &outX, QVector<double> &outY);
+
+}
+
+#endif // DOWNSAMPLER_H
@@ -0,0 +1,247 @@
+/**
+ * @file FrameSchema.h
+ * @brief Declarative binary frame layout and its compiled decoder
+ *
+ * A schema describes a telemetry frame: sync bytes, an optional length
+ * field, typed fields (integers and floats in either byte order,
+ * bitfields, scale and offset) and a trailing checksum. FrameDecoder
+ * compiles it once into a flat program: runs of same-typed adjacent
+ * fields become one op that a type-specialised loop reads, so the
+ * per-frame work has no name lookups or per-field format decisions.
+ *
+ * JSON form (see README):
+ * @code
+ * { "name": "imu", "endian": "little", "sync": "AA 55",
+ *   "length": { "at": 2, "type": "u8", "adjust": 5 },
+ *   "fields": [ { "name": "ax", "type": "i16", "scale": 0.001 }, ... ],
+ *   "checksum": { "type": "crc16" } }
+ * @endcode
+ *
+ * An optional "framing" object (e.g. { "type": "cobs" }) delimits
+ * frames with a Framer; the layout then describes the decoded frame.
+ */
+
+#ifndef FRAMESCHEMA_H
+#define FRAMESCHEMA_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @enum FrameFieldType
+ * @brief Wire type of a field
+ */
+enum class FrameFieldType {
+    U8, I8, U16, I16, U32, I32, F32, F64
+};
+
+/**
+ * @enum FrameChecksum
+ * @brief Checksum stored in the last bytes of a frame
+ */
+enum class FrameChecksum {
+    None,
+    Sum8,           ///< Byte sum modulo 256
+    Xor8,           ///< XOR of all bytes
+    Crc16Modbus,    ///< CRC-16/MODBUS (reflected 0x8005, init 0xFFFF)
+    Crc16Ccitt,     ///< CRC-16/CCITT-FALSE (0x1021, init 0xFFFF)
+    Crc32,          ///< CRC-32 (IEEE 802.3, as zlib)
+    Crc32c          ///< CRC-32C (Castagnoli; hardware accelerated where available)
+};
+
+/**
+ * @struct FrameField
+ * @brief One decoded channel of a frame
+ */
+struct FrameField
+{
+    QString name;                           ///< Channel name
+    FrameFieldType type = FrameFieldType::U8;
+    bool bigEndian = false;
+    int at = -1;                            ///< Byte offset in the frame (-1 = after the previous field)
+    int bitShift = 0;                       ///< Bitfield: lowest bit (integer types only)
+    int bitWidth = 0;                       ///< Bitfield: width in bits (0 = whole value)
+    double scale = 1.0;                     ///< value = raw * scale + offset
+    double offset = 0.0;
+};
+
+/**
+ * @struct FrameSchema
+ * @brief Frame layout as written in the schema file
+ */
+struct FrameSchema
+{
+    QString name;
+    QByteArray sync;                        ///< Bytes every frame starts with (may be empty)
+
+    int lengthAt = -1;                      ///< Offset of the length field (-1 = fixed size)
+    FrameFieldType lengthType = FrameFieldType::U8;
+    bool lengthBigEndian = false;
+    int lengthAdjust = 0;                   ///< Frame bytes = length value + lengthAdjust
+
+    int size = 0;                           ///< Fixed frame size (0 = end of the last field + checksum)
+    int maxSize = 1024;                     ///< Longer length values are treated as corruption
+
+    QVector<FrameField> fields;
+
+    FrameChecksum checksum = FrameChecksum::None;
+    int checksumFrom = -1;                  ///< First covered byte (-1 = after the sync bytes)
+    bool checksumBigEndian = false;
+
+    QJsonObject framing;                    ///< Framer config (see Framer::create()), empty = frames found by sync bytes
+
+    /**
+     * @brief Read a schema from its JSON form
+     * @param json Schema object
+     * @param schema Output schema
+     * @param error Set to a description if the JSON is invalid
+     * @return False on error
+     */
+    static bool fromJson(const QJsonObject &json, FrameSchema &schema, QString &error);
+};
+
+/**
+ * @class FrameDecoder
+ * @brief Compiled form of a FrameSchema
+ *
+ * Read-only after compile(), so it can be shared between threads.
+ */
+class FrameDecoder
+{
+public:
+    /**
+     * @brief Resolve field offsets, check the layout and build the decode program
+     * @param schema Schema
+     * @return False if the layout is invalid (see errorString())
+     */
+    bool compile(const FrameSchema &schema);
+
+    /**
+     * @brief Parse and compile a JSON schema
+     * @param json Schema object
+     * @return False on error (see errorString())
+     */
+    bool load(const QJsonObject &json);
+
+    /**
+     * @brief Parse and compile a JSON schema file
+     * @param path File path
+     * @return False on error (see errorString())
+     */
+    bool loadFile(const QString &path);
+
+    /**
+     * @brief Get the last load or compile error
+     * @return Error description
+     */
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * @brief Check whether a schema is compiled
+     * @return True after a successful compile()
+     */
+    bool isValid() const { return m_valid; }
+
+    /**
+     * @brief Get the compiled schema
+     * @return Schema with resolved field offsets
+     */
+    const FrameSchema &schema() const { return m_schema; }
+
+    /**
+     * @brief Get the channel names in value order
+     * @return Field names
+     */
+    const QStringList &channelNames() const { return m_channelNames; }
+
+    /**
+     * @brief Get the smallest valid frame
+     * @return Bytes
+     */
+    int minFrameSize() const { return m_minSize; }
+
+    /**
+     * @brief Get the length of the frame at the start of data
+     *
+     * data must start with the sync bytes.
+     *
+     * @param data Bytes from the frame start
+     * @return Frame length, 0 if the length field is not complete yet,
+     *         -1 if the length is out of range
+     */
+    qsizetype frameLength(QByteArrayView data) const;
+
+    /**
+     * @brief Compute the checksum over the covered bytes of a frame
+     * @param frame Complete frame
+     * @return Checksum value (0 without a checksum)
+     */
+    quint32 computeChecksum(QByteArrayView frame) const;
+
+    /**
+     * @brief Compare the stored checksum with the computed one
+     * @param frame Complete frame
+     * @return True if they match or the schema has no checksum
+     */
+    bool checksumOk(QByteArrayView frame) const;
+
+    /**
+     * @brief Decode all fields of a frame
+     * @param frame Complete frame (at least minFrameSize() bytes)
+     * @param values Output, channelNames().size() values
+     */
+    void decode(const char *frame, double *values) const;
+
+    /**
+     * @brief Get the number of ops in the decode program
+     * @return Op count (fewer than fields when runs were merged)
+     */
+    int programSize() const { return static_cast<int>(m_program.size()); }
+
+private:
+    /**
+     * @enum OpKind
+     * @brief Wire type and byte order of an op, fixed at compile time
+     */
+    enum class OpKind : quint8 {
+        U8, I8,
+        U16Le, U16Be, I16Le, I16Be,
+        U32Le, U32Be, I32Le, I32Be,
+        F32Le, F32Be, F64Le, F64Be,
+        Bits                    ///< Single bitfield of an unsigned container
+    };
+
+    /**
+     * @struct Op
+     * @brief Decode count adjacent values of one kind
+     */
+    struct Op
+    {
+        OpKind kind = OpKind::U8;
+        bool bigEndian = false; ///< Bits: byte order of the container
+        quint8 size = 1;        ///< Bytes per value
+        quint8 bitShift = 0;
+        quint8 bitWidth = 0;
+        bool scaled = false;    ///< scale != 1 or offset != 0
+        int at = 0;             ///< Byte offset in the frame
+        int count = 1;          ///< Adjacent values
+        int channel = 0;        ///< First output value
+        double scale = 1.0;
+        double offset = 0.0;
+    };
+
+    FrameSchema m_schema;
+    QStringList m_channelNames;
+    QVector<Op> m_program;
+    int m_minSize = 0;          ///< Sync, length field and all fields plus checksum
+    int m_checksumSize = 0;
+    int m_lengthSize = 0;
+    bool m_valid = false;
+    QString m_errorString;
+};
+
+#endif // FRAMESCHEMA_H
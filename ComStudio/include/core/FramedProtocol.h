@@ -0,0 +1,126 @@
+/**
+ * @file FramedProtocol.h
+ * @brief Common base of the binary frame protocols
+ *
+ * Collects the packets decoded by one parse() call and publishes them
+ * like LineParser does: every packet for logging, a rate-limited and
+ * (under overload) decimated subset for display.
+ */
+
+#ifndef FRAMEDPROTOCOL_H
+#define FRAMEDPROTOCOL_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+#include "BaseProtocol.h"
+#include "Framer.h"
+
+/**
+ * @class FramedProtocol
+ * @brief BaseProtocol with display rate limiting and batch publishing
+ *
+ * Subclasses decode frames in parse(), hand each packet to addPacket()
+ * and call publishBatches() at the end of parse(). With a Framer set,
+ * the default parse(), reset() and claimFrame() use it to cut the
+ * stream and the subclass only decodes frames in processFrame().
+ */
+class FramedProtocol : public BaseProtocol
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Set target display rate for rate-limited output
+     * @param hz Target rate in Hz (0 = no limit, emit all packets)
+     */
+    void setTargetDisplayRate(int hz);
+
+    /**
+     * @brief Thin out the display batch on top of the rate limit (overload)
+     *
+     * batchForLogging is not affected.
+     *
+     * @param factor Keep 1 of factor packets (1 = off)
+     */
+    void setDisplayDecimation(int factor) { m_displayDecimation = qMax(1, factor); }
+
+    /**
+     * @brief Cut the input with a framer instead of the protocol's own framing
+     * @param framer Framer, or nullptr for the protocol's own framing
+     */
+    void setFramer(std::unique_ptr<Framer> framer);
+
+    /**
+     * @brief Get the framer
+     * @return Framer, nullptr if none is set
+     */
+    Framer *framer() const { return m_framer.get(); }
+
+    // BaseProtocol interface (framer path)
+    void parse(const QByteArray &data) override;
+    void reset() override;
+    FrameClaim claimFrame(QByteArrayView data) const override;
+
+protected:
+    /**
+     * @brief Protected constructor (abstract class)
+     * @param parent Parent QObject
+     */
+    explicit FramedProtocol(QObject *parent = nullptr);
+
+    /**
+     * @brief Assign the next packet index
+     * @return Index (0, 1, 2, ... since the last resetBatches())
+     */
+    quint64 nextPacketIndex() { return m_packetCounter++; }
+
+    /**
+     * @brief Get the default name of a channel
+     * @param index Channel index
+     * @return "Ch<index>", shared between packets
+     */
+    const QString &channelName(int index);
+
+    /**
+     * @brief Collect a decoded packet and apply the display rate limit
+     * @param packet Valid packet with data
+     */
+    void addPacket(GenericDataPacket &&packet);
+
+    /**
+     * @brief Emit the packets collected by the current parse() call
+     */
+    void publishBatches();
+
+    /**
+     * @brief Drop collected packets and restart packet indices and rate limit
+     */
+    void resetBatches();
+
+    /**
+     * @brief Decode one frame cut by the framer
+     * @param frame Frame payload without framing bytes; valid during the call
+     */
+    virtual void processFrame(QByteArrayView frame) = 0;
+
+private:
+    std::unique_ptr<Framer> m_framer;
+    quint64 m_reportedResyncs = 0;      ///< Framer resyncs already counted as parse errors
+
+    QStringList m_channelNames;         ///< "Ch0", "Ch1", ... built on demand
+    quint64 m_packetCounter = 0;
+    QVector<GenericDataPacket> m_batchPackets;  ///< Packets of the current parse() call
+    QVector<qsizetype> m_displayIndices;        ///< Packets in m_batchPackets that pass the rate limit
+
+    QElapsedTimer m_elapsedTimer;
+    qint64 m_lastEmit = -1;             ///< Last display time (ms), -1 = none yet
+    double m_targetIntervalMs = 1000.0 / 60;
+    int m_displayDecimation = 1;
+    quint64 m_decimationCounter = 0;
+};
+
+#endif // FRAMEDPROTOCOL_H
@@ -0,0 +1,273 @@
+/**
+ * @file Framer.h
+ * @brief Reusable byte-stream framing (COBS, SLIP, length-prefixed, fixed-size)
+ *
+ * A framer owns the receive buffer of a protocol and cuts it into
+ * frames; the protocol only decodes complete frames. Frames are
+ * returned as views into the buffer (escaped encodings are decoded in
+ * place, since decoding never makes a frame longer), and corrupt input
+ * is skipped up to the next point where a frame can start.
+ */
+
+#ifndef FRAMER_H
+#define FRAMER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QJsonObject>
+#include <QString>
+#include <memory>
+
+#include "BaseProtocol.h"
+
+/**
+ * @class Framer
+ * @brief Base class of the framers
+ *
+ * The input buffer is used like a ring: frames are consumed from the
+ * front and the unread tail is moved back to the start only when new
+ * data would not fit, so a frame is always contiguous and never copied.
+ */
+class Framer
+{
+public:
+    virtual ~Framer() = default;
+
+    /**
+     * @brief Create a framer from its JSON description
+     *
+     * { "type": "cobs" | "slip" | "length" | "fixed", "maxSize": 4096,
+     *   "sync": "AA 55", "bytes": 2, "endian": "little", "adjust": 0, "size": 16 }
+     * (sync and the length options apply to "length", sync and size to "fixed").
+     *
+     * @param config Framer object
+     * @param error Set to a description if the config is invalid
+     * @return Framer, or nullptr on error
+     */
+    static std::unique_ptr<Framer> create(const QJsonObject &config, QString &error);
+
+    /**
+     * @brief Parse hex text such as "AA 55" or "aa55"
+     * @param text Hex digits, spaces allowed
+     * @param bytes Output bytes
+     * @return False if text is not an even number of hex digits
+     */
+    static bool bytesFromHex(const QString &text, QByteArray &bytes);
+
+    /**
+     * @brief Check whether bytes look like text (printable ASCII and line whitespace)
+     *
+     * Used by claimFrame() of formats without a start marker, to leave
+     * text to the other protocols of a shared stream.
+     *
+     * @param data Bytes
+     * @return True if every byte is text
+     */
+    static bool isText(QByteArrayView data);
+
+    /**
+     * @brief Get the length of a text line at the start of data
+     * @param data Bytes
+     * @return Bytes up to and including the first '\n', 0 if data does not start with a text line
+     */
+    static qsizetype textLineLength(QByteArrayView data);
+
+    /**
+     * @brief Get the framing name
+     * @return Name, e.g. "COBS"
+     */
+    virtual QString name() const = 0;
+
+    /**
+     * @brief Check whether data starts with one complete frame (see BaseProtocol::claimFrame())
+     * @param data Unassigned bytes
+     * @return Claim covering the frame including its framing bytes
+     */
+    virtual FrameClaim claimFrame(QByteArrayView data) const = 0;
+
+    /**
+     * @brief Append received bytes
+     *
+     * Invalidates frame views returned before.
+     *
+     * @param data Bytes
+     */
+    void push(QByteArrayView data);
+
+    /**
+     * @brief Take the next complete frame
+     * @param frame Set to the frame payload; valid until the next push() or reset()
+     * @return False if no complete frame is buffered
+     */
+    bool nextFrame(QByteArrayView &frame);
+
+    /**
+     * @brief Drop buffered bytes and counters
+     */
+    void reset();
+
+    /**
+     * @brief Get the number of unread bytes
+     * @return Bytes
+     */
+    qsizetype buffered() const { return m_end - m_begin; }
+
+    /**
+     * @brief Get the number of corrupt frames skipped since reset()
+     * @return Count
+     */
+    quint64 resyncs() const { return m_resyncs; }
+
+    /**
+     * @brief Get the largest frame accepted
+     * @return Payload bytes
+     */
+    qsizetype maxFrameSize() const { return m_maxFrameSize; }
+
+protected:
+    /**
+     * @enum Scan
+     * @brief Result of scanning the unread bytes
+     */
+    enum class Scan {
+        Frame,      ///< frame is set
+        NeedMore,   ///< No complete frame yet
+        Skip,       ///< Consumed bytes hold no frame (idle delimiters), not an error
+        Corrupt     ///< Invalid frame or noise; consumed bytes are skipped
+    };
+
+    /**
+     * @brief Constructor
+     * @param maxFrameSize Largest payload; longer input counts as corrupt
+     */
+    explicit Framer(qsizetype maxFrameSize);
+
+    /**
+     * @brief Find the next frame in the unread bytes
+     * @param data Unread bytes (may be modified up to consumed, for in-place decoding)
+     * @param size Number of unread bytes
+     * @param consumed Set to the bytes to remove from the input (at least 1 for Corrupt)
+     * @param frame Set to the payload (Frame)
+     * @return Scan result
+     */
+    virtual Scan scan(char *data, qsizetype size, qsizetype &consumed, QByteArrayView &frame) = 0;
+
+    qsizetype m_maxFrameSize;
+
+private:
+    QByteArray m_buffer;
+    qsizetype m_begin = 0;      ///< First unread byte
+    qsizetype m_end = 0;        ///< End of the received bytes
+    quint64 m_resyncs = 0;
+};
+
+/**
+ * @class CobsFramer
+ * @brief Consistent Overhead Byte Stuffing, frames terminated by 0x00
+ */
+class CobsFramer : public Framer
+{
+public:
+    /**
+     * @brief Constructor
+     * @param maxFrameSize Largest decoded frame
+     */
+    explicit CobsFramer(qsizetype maxFrameSize = 4096) : Framer(maxFrameSize) {}
+
+    QString name() const override { return QStringLiteral("COBS"); }
+    FrameClaim claimFrame(QByteArrayView data) const override;
+
+protected:
+    Scan scan(char *data, qsizetype size, qsizetype &consumed, QByteArrayView &frame) override;
+};
+
+/**
+ * @class SlipFramer
+ * @brief SLIP (RFC 1055): frames end with 0xC0, 0xDB escapes
+ *
+ * To share a stream in demultiplex mode the sender must also start
+ * each frame with 0xC0, as most SLIP implementations do.
+ */
+class SlipFramer : public Framer
+{
+public:
+    /**
+     * @brief Constructor
+     * @param maxFrameSize Largest decoded frame
+     */
+    explicit SlipFramer(qsizetype maxFrameSize = 4096) : Framer(maxFrameSize) {}
+
+    QString name() const override { return QStringLiteral("SLIP"); }
+    FrameClaim claimFrame(QByteArrayView data) const override;
+
+protected:
+    Scan scan(char *data, qsizetype size, qsizetype &consumed, QByteArrayView &frame) override;
+};
+
+/**
+ * @class LengthPrefixFramer
+ * @brief Optional sync bytes, a length field, then the payload
+ *
+ * The payload is length + adjust bytes. Without sync bytes a corrupt
+ * length is skipped one byte at a time, and the framer cannot share a
+ * stream.
+ */
+class LengthPrefixFramer : public Framer
+{
+public:
+    /**
+     * @brief Constructor
+     * @param lengthBytes Size of the length field (1, 2 or 4)
+     * @param bigEndian Byte order of the length field
+     * @param adjust Added to the length value to get the payload size
+     * @param sync Bytes before the length field (may be empty)
+     * @param maxFrameSize Largest payload
+     */
+    LengthPrefixFramer(int lengthBytes, bool bigEndian, int adjust = 0,
+                       const QByteArray &sync = QByteArray(), qsizetype maxFrameSize = 4096);
+
+    QString name() const override { return QStringLiteral("Length prefix"); }
+    FrameClaim claimFrame(QByteArrayView data) const override;
+
+protected:
+    Scan scan(char *data, qsizetype size, qsizetype &consumed, QByteArrayView &frame) override;
+
+private:
+    /**
+     * @brief Read the payload size of the record at data (sync already matched)
+     * @return Payload size, -1 if out of range
+     */
+    qsizetype payloadSize(const char *data) const;
+
+    int m_lengthBytes;
+    bool m_bigEndian;
+    int m_adjust;
+    QByteArray m_sync;
+};
+
+/**
+ * @class FixedSizeFramer
+ * @brief Records of a fixed size, optionally preceded by sync bytes
+ */
+class FixedSizeFramer : public Framer
+{
+public:
+    /**
+     * @brief Constructor
+     * @param size Payload size
+     * @param sync Bytes before each record (may be empty)
+     */
+    explicit FixedSizeFramer(qsizetype size, const QByteArray &sync = QByteArray());
+
+    QString name() const override { return QStringLiteral("Fixed size"); }
+    FrameClaim claimFrame(QByteArrayView data) const override;
+
+protected:
+    Scan scan(char *data, qsizetype size, qsizetype &consumed, QByteArrayView &frame) override;
+
+private:
+    qsizetype m_size;
+    QByteArray m_sync;
+};
+
+#endif // FRAMER_H
@@ -13,6 +13,7 @@
 
 #include <QMap>
 #include <QString>
+#include <QStringList>
 #include <QVector>
 #include <QDateTime>
 #include <QByteArray>
@@ -44,6 +45,13 @@ struct GenericDataPacket
      */
     QString sensorId;
     
+    /**
+     * @brief sensorId interned by SensorRegistry (-1 if none)
+     *
+     * Compare and group by this instead of the string.
+     */
+    int sensorKey = -1;
+    
     /**
      * @brief Channel name to value mapping
      *
@@ -60,6 +68,14 @@ struct GenericDataPacket
      */
     QVector<double> values;
     
+    /**
+     * @brief Channel names in parse order, parallel to values
+     *
+     * channels is sorted by name; this keeps the order the values were
+     * parsed in, e.g. for the recording schema.
+     */
+    QStringList channelNames;
+    
     /**
      * @brief Original raw data that produced this packet
      *
@@ -84,6 +100,26 @@ struct GenericDataPacket
      */
     QString errorMessage;
     
+    /**
+     * @brief Latency trace ID of the read chunk that completed this packet
+     *
+     * 0 if untraced (bulk import, tests). See LatencyTracer.
+     */
+    quint64 traceId = 0;
+    
+    /**
+     * @brief X-axis time in seconds when not host time (see DeviceClock)
+     *
+     * The packet counter or the device clock, depending on
+     * ParserConfig::xAxisSource. Only meaningful if hasSampleTime.
+     */
+    double sampleTime = 0.0;
+    
+    /**
+     * @brief True if sampleTime is set
+     */
+    bool hasSampleTime = false;
+    
     /**
      * @brief Default constructor
      */
@@ -107,6 +143,7 @@ struct GenericDataPacket
     {
         channels[name] = value;
         values.append(value);
+        channelNames.append(name);
     }
     
     /**
@@ -151,6 +188,15 @@ struct GenericDataPacket
     {
         return !values.isEmpty();
     }
+    
+    /**
+     * @brief Get the x-axis time used for plotting
+     * @return sampleTime if set, else the host timestamp in seconds
+     */
+    double xTime() const
+    {
+        return hasSampleTime ? sampleTime : timestamp / 1000.0;
+    }
 };
 
 /**
@@ -0,0 +1,166 @@
+/**
+ * @file IngestQueue.h
+ * @brief Bounded queue of read chunks between the serial worker and the GUI thread
+ *
+ * The worker used to emit one queued signal per read chunk, so a GUI
+ * thread that fell behind accumulated events without limit. Chunks now
+ * go through a bounded queue with an overload policy; the consumer is
+ * woken once per batch of chunks and drains them in time slices.
+ */
+
+#ifndef INGESTQUEUE_H
+#define INGESTQUEUE_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <deque>
+
+/**
+ * @enum OverloadPolicy
+ * @brief What happens when the ingest queue is full
+ */
+enum class OverloadPolicy {
+    Block,              ///< Stop reading; the OS buffer and flow control hold the data
+    DropOldest,         ///< Discard queued chunks to make room for new ones
+    DropNewest,         ///< Discard new chunks until the queue has room
+    DecimateDisplay     ///< Thin out the display while overloaded, block when full
+};
+
+/**
+ * @struct IngestQueueSettings
+ * @brief Bounds and overload policy of the ingest queue
+ */
+struct IngestQueueSettings {
+    OverloadPolicy policy = OverloadPolicy::DecimateDisplay;
+    int maxChunks = 256;                    ///< Queued chunks before the policy applies
+    qsizetype maxBytes = 4 * 1024 * 1024;   ///< Queued bytes before the policy applies
+
+    /**
+     * @brief Check if the reader waits for room instead of dropping
+     * @return True for Block and DecimateDisplay
+     */
+    bool blocks() const
+    {
+        return policy == OverloadPolicy::Block || policy == OverloadPolicy::DecimateDisplay;
+    }
+
+    /**
+     * @brief Get the stable name of a policy (CLI, logs)
+     * @param policy Policy
+     * @return Name such as "drop-oldest"
+     */
+    static QString policyName(OverloadPolicy policy);
+
+    /**
+     * @brief Look up a policy by name
+     * @param name Name as returned by policyName()
+     * @param ok Set to false if the name is unknown (optional)
+     * @return Policy (DecimateDisplay if unknown)
+     */
+    static OverloadPolicy policyFromName(const QString &name, bool *ok = nullptr);
+};
+
+/**
+ * @struct IngestChunk
+ * @brief One read chunk with its latency trace
+ */
+struct IngestChunk {
+    QByteArray data;
+    quint64 traceId = 0;                ///< Latency trace ID of this chunk
+    qint64 readNs = 0;                  ///< LatencyTracer::nowNs() when the chunk was read
+};
+
+/**
+ * @class IngestQueue
+ * @brief Thread-safe bounded FIFO of read chunks (one producer, one consumer)
+ *
+ * The producer asks tryAdmit() before reading when the policy blocks,
+ * and push() applies the drop policies. push() returns true when the
+ * consumer has to be woken; the consumer pops until empty and then
+ * calls finishDrain(), so a burst of chunks costs one wake-up.
+ * Dropped chunks are counted in PipelineMetrics.
+ */
+class IngestQueue
+{
+public:
+    /**
+     * @brief Replace bounds and policy (queued chunks are kept)
+     * @param settings New settings
+     */
+    void setSettings(const IngestQueueSettings &settings);
+
+    /**
+     * @brief Get current bounds and policy
+     * @return Settings
+     */
+    IngestQueueSettings settings() const;
+
+    /**
+     * @brief Check for room, remembering that the reader waits if there is none
+     *
+     * When this returns false, the pop() that makes room again reports
+     * that the reader must be resumed.
+     *
+     * @return True if a chunk may be read now
+     */
+    bool tryAdmit();
+
+    /**
+     * @brief Append a chunk, applying the drop policy if the queue is full
+     *
+     * Blocking policies always accept the chunk: it was already read and
+     * callers check tryAdmit() first, so the bound is exceeded by at most
+     * one chunk.
+     *
+     * @param chunk Chunk to append
+     * @return True if the consumer must be woken
+     */
+    bool push(IngestChunk chunk);
+
+    /**
+     * @brief Remove the oldest chunk
+     * @param chunk Receives the chunk
+     * @param wakeReader Set to true if a waiting reader must be resumed
+     * @return False if the queue is empty
+     */
+    bool pop(IngestChunk &chunk, bool &wakeReader);
+
+    /**
+     * @brief End a drain pass of the consumer
+     * @return True if chunks are left; the consumer must schedule another pass
+     */
+    bool finishDrain();
+
+    /**
+     * @brief Get queued chunk count
+     * @return Chunks
+     */
+    int size() const;
+
+    /**
+     * @brief Get queued byte count
+     * @return Bytes
+     */
+    qsizetype bytes() const;
+
+    /**
+     * @brief Get how full the queue is
+     * @return Larger of chunks/maxChunks and bytes/maxBytes (may exceed 1)
+     */
+    double fillRatio() const;
+
+private:
+    bool hasRoomLocked() const;
+    void dropFrontLocked();
+
+    mutable QMutex m_mutex;
+    std::deque<IngestChunk> m_chunks;
+    qsizetype m_bytes = 0;                  ///< Sum of queued chunk sizes
+    IngestQueueSettings m_settings;
+    bool m_readerWaiting = false;           ///< tryAdmit() failed since the last pop()
+    std::atomic<bool> m_wakePending{false}; ///< Consumer already woken or draining
+};
+
+#endif // INGESTQUEUE_H
@@ -0,0 +1,135 @@
+/**
+ * @file LatencyTracer.h
+ * @brief Byte-to-pixel latency tracing of serial read chunks
+ *
+ * Every chunk read by SerialWorker gets a trace ID and a monotonic read
+ * timestamp. Downstream stages stamp the trace as the chunk's bytes pass
+ * through them (parse, buffer insert, plot commit, replot done), and the
+ * time since the read is added to one histogram per stage.
+ */
+
+#ifndef LATENCYTRACER_H
+#define LATENCYTRACER_H
+
+#include <QString>
+#include <QVector>
+#include <array>
+
+#include "PipelineMetrics.h"
+
+/**
+ * @enum LatencyStage
+ * @brief Points at which a traced chunk is stamped
+ */
+enum class LatencyStage {
+    Parse,          ///< Chunk framed and parsed
+    BufferInsert,   ///< First packet of the chunk inserted into DataBuffer
+    PlotCommit,     ///< Chunk's points moved into the plot's channel data
+    Screen,         ///< Replot containing the chunk's points finished
+    Count
+};
+
+constexpr int LatencyStageCount = static_cast<int>(LatencyStage::Count);
+
+/**
+ * @struct LatencySnapshot
+ * @brief Read-to-stage latency distributions
+ */
+struct LatencySnapshot
+{
+    quint64 chunksTraced = 0;                               ///< Chunks that started a trace
+    quint64 tracesLost = 0;                                 ///< Stamps for traces already evicted
+    std::array<StageHistogram, LatencyStageCount> stages{}; ///< ns from read to stage
+    std::array<quint64, LatencyStageCount> maxNs{};         ///< Exact maximum per stage
+
+    const StageHistogram& stage(LatencyStage s) const { return stages[static_cast<int>(s)]; }
+};
+
+/**
+ * @class LatencyTracer
+ * @brief Per-chunk latency tracer (singleton)
+ *
+ * nowNs() and nextTraceId() may be called from any thread; all other
+ * methods run on the GUI thread, where every stamped stage lives.
+ * Open traces are kept in a fixed ring, so a chunk whose points never
+ * reach the screen (rate limited, paused plot) is simply overwritten.
+ */
+class LatencyTracer
+{
+public:
+    /**
+     * @brief Get singleton instance
+     * @return Reference to the tracer
+     */
+    static LatencyTracer& instance();
+
+    /**
+     * @brief Monotonic clock shared by all threads
+     * @return Nanoseconds since process start
+     */
+    static qint64 nowNs();
+
+    /**
+     * @brief Register a chunk read and make it the current trace
+     * @param traceId ID assigned by the reader (0 = untraced)
+     * @param readNs nowNs() when the chunk was read
+     */
+    void beginChunk(quint64 traceId, qint64 readNs);
+
+    /**
+     * @brief Get the trace of the chunk being processed
+     * @return Trace ID (0 if none)
+     */
+    quint64 currentTrace() const { return m_currentTrace; }
+
+    /**
+     * @brief Stamp a stage for a trace (first stamp per stage wins)
+     * @param traceId Trace ID (0 is ignored)
+     * @param stage Stage reached
+     */
+    void mark(quint64 traceId, LatencyStage stage);
+
+    /**
+     * @brief Get a copy of the histograms
+     * @return Snapshot
+     */
+    LatencySnapshot snapshot() const { return m_stats; }
+
+    /**
+     * @brief Clear histograms and open traces
+     */
+    void reset();
+
+    /**
+     * @brief Get display name of a stage
+     * @param stage Stage
+     * @return Name
+     */
+    static QString stageName(LatencyStage stage);
+
+    /**
+     * @brief Format a snapshot as a multi-line text report
+     * @param snapshot Snapshot to format
+     * @return Report with p50/p99/max per stage
+     */
+    static QString report(const LatencySnapshot &snapshot);
+
+private:
+    LatencyTracer();
+    LatencyTracer(const LatencyTracer&) = delete;
+    LatencyTracer& operator=(const LatencyTracer&) = delete;
+
+    struct OpenTrace {
+        quint64 id = 0;
+        qint64 readNs = 0;
+        quint32 stampedMask = 0;    ///< Bit per LatencyStage already stamped
+    };
+
+    static constexpr int RingSize = 1024;   ///< Power of two
+
+    std::array<OpenTrace, RingSize> m_ring{};
+    quint64 m_currentTrace = 0;
+    LatencySnapshot m_stats;
+};
+
+#endif // LATENCYTRACER_H
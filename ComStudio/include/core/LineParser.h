@@ -21,6 +21,7 @@
 #include "BaseProtocol.h"
 #include "ParserConfig.h"
 #include "GenericDataPacket.h"
+#include "DeviceClock.h"
 
 /**
  * @struct ParseResult
@@ -74,6 +75,14 @@ public:
     void reset() override;
     bool isConfigurable() const override { return true; }
     
+    /**
+     * @brief Claim text up to and including the next line ending
+     *
+     * Lines longer than maxLineLength are claimed as well, so parse()
+     * reports and discards them.
+     */
+    FrameClaim claimFrame(QByteArrayView data) const override;
+    
     /**
      * @brief Get current configuration
      * @return Current parser configuration
@@ -88,6 +97,10 @@ public:
     
     /**
      * @brief Set target display rate for rate-limited output
+     *
+     * The rate applies per sensor, so every sensor of a shared bus
+     * stays visible.
+     *
      * @param hz Target rate in Hz (0 = no limit, emit all packets)
      */
     void setTargetDisplayRate(int hz);
@@ -110,11 +123,29 @@ public:
      */
     bool isRateLimitEnabled() const { return m_rateLimitEnabled; }
     
+    /**
+     * @brief Thin out the display batch on top of the rate limit
+     *
+     * Used while the ingest queue is overloaded: only every factor-th
+     * packet that passes the rate limit is displayed. batchForLogging
+     * is not affected.
+     *
+     * @param factor Keep 1 of factor packets (1 = off)
+     */
+    void setDisplayDecimation(int factor) { m_displayDecimation = qMax(1, factor); }
+    
+    /**
+     * @brief Get the display decimation factor
+     * @return Factor (1 = off)
+     */
+    int displayDecimation() const { return m_displayDecimation; }
+    
     /**
      * @brief Test parse a sample line
      *
      * Static method for testing configuration against sample data
-     * without affecting parser state.
+     * without affecting parser state. Runs the same checksum, trim and
+     * parseLine() steps as the streaming parser.
      *
      * @param sampleLine Line to test parse
      * @param config Configuration to use
@@ -128,6 +159,24 @@ public:
      * @return Detailed parse result
      */
     ParseResult testParse(const QString &sampleLine) const;
+    
+    /**
+     * @brief Parse one line into a packet
+     *
+     * Stateless and thread-safe: splits the line, applies the sensor ID
+     * filter and extracts the configured fields. Shared by the streaming
+     * parser and the offline bulk importer. Does not touch timestamp,
+     * packetIndex, rawData or displayText. With XAxisSource::FieldIndex
+     * the raw x field is stored in sampleTime for DeviceClock::stamp().
+     *
+     * @param line Line without line ending (already trimmed if configured)
+     * @param config Configuration to use
+     * @param packet Output packet (values, channels, sensorId, isValid, errorMessage)
+     * @param failedField Optional output: index of the last field that failed, -1 if none
+     * @return False if the line has no tokens or is rejected by the ID filter
+     */
+    static bool parseLine(QStringView line, const ParserConfig &config, GenericDataPacket &packet,
+                          int *failedField = nullptr);
 
 signals:
     /**
@@ -139,24 +188,21 @@ signals:
      * @param line The raw line as received
      */
     void rawLineReady(const QString &line);
-    
-    /**
-     * @brief Emitted for every valid packet (no rate limiting)
-     * 
-     * Use this for data logging where all samples must be recorded.
-     * Bypasses display rate limiting.
-     * 
-     * @param packet The parsed packet
-     */
-    void dataForLogging(const GenericDataPacket &packet);
 
 private:
+    friend class ComStudioBench;    ///< Benchmarks splitLine() and extractNumber()
+    
     /**
      * @brief Process a complete line
      * @param line The line to process (without line ending)
      */
     void processLine(QStringView line);
     
+    /**
+     * @brief Emit the packets collected by the current parse() call
+     */
+    void publishBatches();
+    
     /**
      * @brief Extract numeric value from a token
      *
@@ -177,16 +223,22 @@ private:
     static QVector<QStringView> splitLine(QStringView line, QStringView delimiter);
 
     ParserConfig m_config;
+    DeviceClock m_clock;           ///< X-axis timebase (counter, unwrapped device ticks)
     QByteArray m_buffer;           ///< Accumulation buffer for incomplete lines
     quint64 m_packetCounter = 0;   ///< Auto-incrementing packet counter
+    QVector<GenericDataPacket> m_batchPackets;  ///< Valid packets of the current parse() call
+    QVector<qsizetype> m_displayIndices;        ///< Packets in m_batchPackets that pass the rate limit
     
     // Rate limiting for display performance
     QElapsedTimer m_elapsedTimer;  ///< High-resolution timer for rate limiting
-    qint64 m_lastEmitTimestamp = 0; ///< Last time dataParsed was emitted
+    QVector<qint64> m_lastEmitBySensor; ///< Last display time per sensor key + 1 (0 = no ID)
     double m_targetIntervalMs = 16.67; ///< Target interval between emissions (ms)
     int m_targetDisplayRate = 60;  ///< Target display rate in Hz
     bool m_rateLimitEnabled = true; ///< Whether rate limiting is active
+    int m_displayDecimation = 1;   ///< Keep 1 of this many display packets (overload)
+    quint64 m_decimationCounter = 0; ///< Display packets seen while decimating
     bool m_timerStarted = false;   ///< Whether elapsed timer has been started
+    bool m_traced = false;         ///< Current parse() runs on the GUI thread (LatencyTracer)
 };
 
 #endif // LINEPARSER_H
@@ -0,0 +1,129 @@
+/**
+ * @file NmeaProtocol.h
+ * @brief NMEA 0183 sentence decoder (GPS and marine instruments)
+ *
+ * Each supported sentence type has a fixed channel map, e.g. GGA ->
+ * time, lat, lon, fix, sats, hdop, alt. Coordinates are converted from
+ * ddmm.mmmm to signed decimal degrees and times from hhmmss.ss to
+ * seconds of the day. Packets carry the sentence type as their sensor
+ * ID, so each sentence forms its own channel group.
+ */
+
+#ifndef NMEAPROTOCOL_H
+#define NMEAPROTOCOL_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "FramedProtocol.h"
+
+/**
+ * @class NmeaProtocol
+ * @brief Decoder for "$TTSSS,f1,f2,...*XX" sentences
+ *
+ * A sentence is handled in one pass over its bytes: the field
+ * boundaries (as views into the receive buffer) and the XOR checksum
+ * are collected together, the type is dispatched through a perfect
+ * hash of its three letters, and the mapped fields are converted with
+ * std::from_chars without copying the fields. The talker ID
+ * (GP, GN, GL, ...) is ignored; unsupported types are skipped.
+ * A sentence with a malformed mapped field is dropped as a whole;
+ * empty fields (not reported) are only left out of the packet.
+ */
+class NmeaProtocol : public FramedProtocol
+{
+    Q_OBJECT
+
+public:
+    static constexpr qsizetype MaxSentenceLength = 128;     ///< Spec: 82; longer lines are errors
+    static constexpr int MaxFields = 32;                    ///< Fields after this are ignored
+
+    /**
+     * @enum FieldKind
+     * @brief How a mapped field is converted
+     */
+    enum class FieldKind : quint8 {
+        Number,     ///< Plain decimal
+        Latitude,   ///< ddmm.mmmm, N/S in the next field
+        Longitude,  ///< dddmm.mmmm, E/W in the next field
+        Time,       ///< hhmmss.sss -> seconds of the day
+        Status      ///< A (valid) -> 1, V (void) -> 0
+    };
+
+    /**
+     * @brief Constructor
+     * @param parent Parent QObject
+     */
+    explicit NmeaProtocol(QObject *parent = nullptr);
+
+    // BaseProtocol interface
+    void parse(const QByteArray &data) override;
+    QString name() const override { return QStringLiteral("NMEA 0183"); }
+    QString description() const override;
+    void reset() override;
+
+    /**
+     * @brief Claim one complete line that starts like a sentence ("$" or "!" and an address)
+     */
+    FrameClaim claimFrame(QByteArrayView data) const override;
+
+    /**
+     * @brief Reject sentences without a "*XX" checksum
+     *
+     * Present checksums are always verified. Follows
+     * ParserConfig::verifyChecksum in the application.
+     *
+     * @param require True to reject sentences without one (default false)
+     */
+    void setRequireChecksum(bool require) { m_requireChecksum = require; }
+
+    /**
+     * @brief Get the supported sentence types
+     * @return Types such as "GGA", "RMC"
+     */
+    static QStringList sentenceTypes();
+
+    /**
+     * @brief Convert an NMEA coordinate to decimal degrees
+     * @param value Field in ddmm.mmmm (latitude) or dddmm.mmmm (longitude)
+     * @param hemisphere 'N' or 'S' for a latitude, 'E' or 'W' for a longitude
+     * @param kind FieldKind::Latitude (up to 90 degrees) or FieldKind::Longitude (up to 180)
+     * @param degrees Set to the signed degrees (negative for S and W)
+     * @return False if the field is empty, out of range or has the wrong hemisphere
+     */
+    static bool toDegrees(QByteArrayView value, char hemisphere, FieldKind kind, double &degrees);
+
+    /**
+     * @brief Convert an NMEA time to seconds of the day
+     * @param value Field in hhmmss or hhmmss.sss
+     * @param seconds Set to the seconds since midnight (UTC)
+     * @return False if the field is empty or malformed
+     */
+    static bool toSecondsOfDay(QByteArrayView value, double &seconds);
+
+signals:
+    /**
+     * @brief Emitted for every sentence, for the terminal
+     * @param line Sentence without the line ending
+     */
+    void rawLineReady(const QString &line);
+
+protected:
+    /**
+     * @brief Decode one sentence
+     * @param sentence Line without the line ending
+     */
+    void processFrame(QByteArrayView sentence) override;
+
+private:
+    QByteArray m_buffer;                        ///< Bytes after the last complete line
+    QVector<QStringList> m_sentenceChannels;    ///< Channel names per sentence type, shared by packets
+    QStringList m_sentenceIds;                  ///< Sensor ID per sentence type ("GGA", ...)
+    QVector<int> m_sentenceKeys;                ///< m_sentenceIds interned by SensorRegistry
+    bool m_requireChecksum = false;
+};
+
+#endif // NMEAPROTOCOL_H
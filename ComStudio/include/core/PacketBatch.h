@@ -0,0 +1,128 @@
+/**
+ * @file PacketBatch.h
+ * @brief Shared, immutable batch of parsed packets
+ *
+ * The parser publishes everything it produced from one chunk of bytes
+ * as a single PacketBatch. Consumers (data buffer, plotter, terminal,
+ * recorder, statistics) keep the batch itself instead of copying its
+ * packets, so a packet costs one allocation no matter how many
+ * consumers see it.
+ */
+
+#ifndef PACKETBATCH_H
+#define PACKETBATCH_H
+
+#include <QVector>
+#include <memory>
+
+#include "GenericDataPacket.h"
+
+/**
+ * @class PacketBatch
+ * @brief Reference-counted, read-only vector of packets
+ *
+ * Copying a PacketBatch copies one pointer. The packets can no longer
+ * be modified once the batch is constructed, so any thread may read a
+ * batch it holds without locking. mid() returns a slice that shares
+ * the same packets.
+ */
+class PacketBatch
+{
+public:
+    using const_iterator = QVector<GenericDataPacket>::const_iterator;
+
+    /**
+     * @brief Construct an empty batch
+     */
+    PacketBatch() = default;
+
+    /**
+     * @brief Take ownership of packets
+     * @param packets Packets in arrival order
+     */
+    explicit PacketBatch(QVector<GenericDataPacket> packets)
+        : m_packets(packets.isEmpty()
+                        ? nullptr
+                        : std::make_shared<const QVector<GenericDataPacket>>(std::move(packets)))
+        , m_size(m_packets ? m_packets->size() : 0)
+    {
+    }
+
+    /**
+     * @brief Get number of packets
+     * @return Packet count
+     */
+    qsizetype size() const { return m_size; }
+
+    /**
+     * @brief Check if the batch holds no packets
+     * @return True if empty
+     */
+    bool isEmpty() const { return size() == 0; }
+
+    /**
+     * @brief Get packet at index (must be valid)
+     * @param index 0 = oldest
+     * @return Packet reference, valid while the batch is held
+     */
+    const GenericDataPacket &at(qsizetype index) const { return m_packets->at(m_offset + index); }
+
+    /**
+     * @brief Get the oldest packet (batch must not be empty)
+     * @return Packet reference
+     */
+    const GenericDataPacket &first() const { return at(0); }
+
+    /**
+     * @brief Get the newest packet (batch must not be empty)
+     * @return Packet reference
+     */
+    const GenericDataPacket &last() const { return at(m_size - 1); }
+
+    const_iterator begin() const { return m_packets ? m_packets->cbegin() + m_offset : const_iterator(); }
+    const_iterator end() const { return m_packets ? m_packets->cbegin() + m_offset + m_size : const_iterator(); }
+
+    /**
+     * @brief Get a slice sharing this batch's packets
+     * @param pos Index of the first packet of the slice
+     * @param length Packets in the slice (-1 = to the end)
+     * @return Slice (empty if pos is out of range)
+     */
+    PacketBatch mid(qsizetype pos, qsizetype length = -1) const
+    {
+        PacketBatch slice;
+        if (pos < 0 || pos >= m_size) {
+            return slice;
+        }
+        slice.m_packets = m_packets;
+        slice.m_offset = m_offset + pos;
+        slice.m_size = (length < 0 || pos + length > m_size) ? m_size - pos : length;
+        return slice;
+    }
+
+    /**
+     * @brief Get the packets as a vector
+     *
+     * Shares data (no deep copy) for a whole batch; a slice copies its
+     * packets, which only bumps their reference counts.
+     *
+     * @return Packet vector
+     */
+    QVector<GenericDataPacket> packets() const
+    {
+        if (!m_packets) {
+            return QVector<GenericDataPacket>();
+        }
+        if (m_offset == 0 && m_size == m_packets->size()) {
+            return *m_packets;
+        }
+        return m_packets->mid(m_offset, m_size);
+    }
+
+private:
+    std::shared_ptr<const QVector<GenericDataPacket>> m_packets;
+    qsizetype m_offset = 0;             ///< First packet of this slice
+    qsizetype m_size = 0;               ///< Packets in this slice
+};
+
+#endif // PACKETBATCH_H
@@ -19,9 +19,9 @@
  * @brief Defines what to use for X-axis values in plotting
  */
 enum class XAxisSource {
-    Timestamp,      ///< Use system timestamp (milliseconds)
+    Timestamp,      ///< Use host arrival time
     Counter,        ///< Use auto-incrementing counter
-    FieldIndex      ///< Use a specific field from the data
+    FieldIndex      ///< Use a device timestamp/tick field from the data (see DeviceClock)
 };
 
 /**
@@ -54,7 +54,8 @@ struct ParserConfig
      *
      * If idFieldIndex is set and this is not empty, only lines with
      * matching sensor ID will be processed. Supports alphanumeric IDs
-     * like "d1", "sensor2", "#5", etc.
+     * like "d1", "sensor2", "#5", etc. When empty every sensor is kept
+     * and grouped by its interned ID (see SensorRegistry).
      */
     QString acceptSensorId;
     
@@ -84,6 +85,27 @@ struct ParserConfig
      */
     int xAxisFieldIndex = 0;
     
+    /**
+     * @brief Width of the device tick counter in bits (FieldIndex)
+     *
+     * 16 or 32 for counters that wrap around; 0 if the field does not
+     * wrap (seconds, 64-bit counters).
+     */
+    int deviceTickBits = 32;
+    
+    /**
+     * @brief Seconds per device tick (FieldIndex), e.g. 0.001 for a ms counter
+     */
+    double deviceTickSeconds = 0.001;
+    
+    /**
+     * @brief Fit the device clock to host time (FieldIndex)
+     *
+     * Removes drift between the device oscillator and the host clock
+     * while keeping the device's sample spacing.
+     */
+    bool fitClockDrift = false;
+    
     /**
      * @brief Strip non-numeric prefixes from values
      *
@@ -104,6 +126,15 @@ struct ParserConfig
      */
     bool trimWhitespace = true;
     
+    /**
+     * @brief Require an NMEA-style "*XX" checksum at the end of each line
+     *
+     * XX is the hex XOR of the bytes between a leading '$' (or the line
+     * start) and the '*'. Lines with a missing or wrong checksum are
+     * rejected; the "*XX" suffix is removed before splitting.
+     */
+    bool verifyChecksum = false;
+    
     /**
      * @brief Skip empty lines
      */
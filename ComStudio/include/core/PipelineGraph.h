@@ -0,0 +1,208 @@
+/**
+ * @file PipelineGraph.h
+ * @brief Dataflow graph of pipeline stages assembled from a JSON configuration
+ *
+ * The application binds its endpoints by name (protocol handlers,
+ * packet sinks) and feeds raw bytes into source stages; everything in
+ * between - framers, decoders, filters, derived channels, exporters -
+ * comes from the configuration:
+ *
+ * @code
+ * {
+ *   "poolThreads": 2,
+ *   "stages": [
+ *     { "id": "serial",  "type": "source" },
+ *     { "id": "decoder", "type": "protocol", "target": "protocol" },
+ *     { "id": "power",   "type": "derive", "thread": "pool",
+ *       "name": "P", "product": ["U", "I"] },
+ *     { "id": "csv",     "type": "csv_export", "thread": "pinned", "path": "all.csv" },
+ *     { "id": "display", "type": "sink", "target": "display" }
+ *   ],
+ *   "links": [
+ *     { "from": "serial.out",      "to": "decoder.in" },
+ *     { "from": "decoder.display", "to": "power.in" },
+ *     { "from": "power.out",       "to": "display.in" },
+ *     { "from": "decoder.packets", "to": "csv.in" }
+ *   ]
+ * }
+ * @endcode
+ */
+
+#ifndef PIPELINEGRAPH_H
+#define PIPELINEGRAPH_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QThreadPool>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "PipelineStage.h"
+
+class QThread;
+class ProtocolHandler;
+
+/**
+ * @class PipelineGraph
+ * @brief Owns the stages, routes batches along links and runs each stage on its thread
+ *
+ * Links connect an output port to an input port of the same type;
+ * cycles are rejected. Each stage has a mailbox so batches reach it
+ * in order and it never runs concurrently with itself, whichever
+ * thread it uses. The graph is rebuilt as a whole by load(); batches
+ * in flight are processed before the old stages are destroyed.
+ */
+class PipelineGraph : public QObject
+{
+    Q_OBJECT
+
+public:
+    using StageFactory = std::function<std::unique_ptr<PipelineStage>()>;
+    using PacketSink = std::function<void(const PacketBatch &)>;
+
+    /**
+     * @brief Constructor
+     * @param parent Parent object (the graph's thread is the GUI thread)
+     */
+    explicit PipelineGraph(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor - processes queued batches and stops stage threads
+     */
+    ~PipelineGraph() override;
+
+    /**
+     * @brief Register a stage type for configurations
+     *
+     * The built-in stages (see PipelineStages.h) are registered on first
+     * use; applications may add their own.
+     *
+     * @param type Type name used in "type"
+     * @param factory Creates an unconfigured stage
+     */
+    static void registerStageType(const QString &type, StageFactory factory);
+
+    /**
+     * @brief Get the registered stage types
+     * @return Sorted type names
+     */
+    static QStringList stageTypes();
+
+    /**
+     * @brief Make a protocol handler available to "protocol" stages
+     * @param name Name used in the stage's "target"
+     * @param handler Handler living in the graph's thread (not owned)
+     */
+    void bindProtocol(const QString &name, ProtocolHandler *handler);
+
+    /**
+     * @brief Make an application function available to "sink" stages
+     * @param name Name used in the stage's "target"
+     * @param sink Called on the graph's thread with every batch
+     */
+    void bindSink(const QString &name, PacketSink sink);
+
+    /**
+     * @brief Get a bound protocol handler
+     * @param name Binding name
+     * @return Handler or nullptr
+     */
+    ProtocolHandler *protocol(const QString &name) const { return m_protocols.value(name); }
+
+    /**
+     * @brief Get a bound sink
+     * @param name Binding name
+     * @return Sink (empty if unbound)
+     */
+    PacketSink sink(const QString &name) const { return m_sinks.value(name); }
+
+    /**
+     * @brief Replace the graph with one built from a configuration
+     *
+     * On error the graph is left empty.
+     *
+     * @param config Configuration object (see file documentation)
+     * @return False if invalid (see errorString())
+     */
+    bool load(const QJsonObject &config);
+
+    /**
+     * @brief Load a configuration file
+     * @param path JSON file
+     * @return False if unreadable or invalid (see errorString())
+     */
+    bool loadFile(const QString &path);
+
+    /**
+     * @brief Process queued batches, finish and destroy all stages
+     */
+    void clear();
+
+    /**
+     * @brief Push raw bytes into a source stage (graph's thread)
+     * @param sourceId ID of a "source" stage
+     * @param data Bytes
+     */
+    void feed(const QString &sourceId, const QByteArray &data);
+
+    /**
+     * @brief Get the IDs of the current stages
+     * @return IDs in configuration order
+     */
+    QStringList stageIds() const;
+
+    /**
+     * @brief Get the last error
+     * @return Error text
+     */
+    QString errorString() const { return m_errorString; }
+
+private:
+    friend class PipelineStage;
+
+    /**
+     * @struct Route
+     * @brief Destination of one link
+     */
+    struct Route {
+        int slot = -1;
+        int input = 0;
+    };
+
+    /**
+     * @struct StageSlot
+     * @brief A stage with its links, mailbox and thread
+     */
+    struct StageSlot {
+        std::unique_ptr<PipelineStage> stage;
+        StageThread thread = StageThread::Gui;
+        QVector<QVector<Route>> routes;             ///< Per output port
+        QMutex mutex;                               ///< Guards mailbox and scheduled
+        std::deque<std::pair<int, StageData>> mailbox;
+        bool scheduled = false;                     ///< Running or a drain is posted
+        std::unique_ptr<QThread> pinnedThread;
+    };
+
+    bool build(const QJsonObject &config);
+    bool addLink(const QString &from, const QString &to);
+    bool hasCycle() const;
+    void route(int slot, int output, const StageData &data);
+    void deliver(int slot, int input, const StageData &data);
+    void schedule(int slot);
+    void drainSlot(int slot, quint64 generation);
+    void drainAll();
+
+    std::vector<std::unique_ptr<StageSlot>> m_slots;
+    QHash<QString, int> m_slotById;
+    QHash<QString, ProtocolHandler *> m_protocols;
+    QHash<QString, PacketSink> m_sinks;
+    QThreadPool m_pool;                 ///< Shared by all "pool" stages
+    quint64 m_generation = 0;           ///< Bumped by clear(); stale posted drains are ignored
+    QString m_errorString;
+};
+
+#endif // PIPELINEGRAPH_H
@@ -0,0 +1,299 @@
+/**
+ * @file PipelineMetrics.h
+ * @brief Lock-free counters, gauges and latency histograms for the data pipeline
+ *
+ * Every stage (serial read, line framing, parsing, buffer insert,
+ * terminal, plotter) reports into one process-wide instance. Updates are
+ * relaxed atomics so they can be called from any thread on the hot path;
+ * readers take a snapshot and derive rates from two snapshots.
+ */
+
+#ifndef PIPELINEMETRICS_H
+#define PIPELINEMETRICS_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <array>
+#include <atomic>
+
+/**
+ * @enum MetricCounter
+ * @brief Monotonic event counters
+ */
+enum class MetricCounter {
+    BytesRead,          ///< Bytes delivered by the serial worker
+    ChunksRead,         ///< Read chunks delivered by the serial worker
+    LinesFramed,        ///< Complete lines extracted by the parser
+    PacketsParsed,      ///< Packets with data (all, before rate limiting)
+    PacketsRateLimited, ///< Packets not shown because of the display rate limit
+    ParseErrors,        ///< Lines rejected by the parser
+    TerminalLines,      ///< Lines appended to the terminal
+    PlotFrames,         ///< Plot replots
+    GuiStalls,          ///< GUI event-loop stalls reported by the watchdog
+    CursorPacketsLost,  ///< Packets trimmed from a DataBuffer before a cursor read them
+    ChunksDropped,      ///< Read chunks discarded by the ingest overload policy
+    BytesDropped,       ///< Bytes of the discarded chunks
+    ReaderStalls,       ///< Times the reader waited for room in the ingest queue
+    PacketsDecimated,   ///< Packets not shown because the display was decimated under overload
+    BytesUnclaimed,     ///< Bytes no protocol claimed while demultiplexing
+    ChecksumRejects,    ///< Frames and lines with a wrong or missing checksum (also parse errors)
+    Count
+};
+
+/**
+ * @enum MetricGauge
+ * @brief Instantaneous queue depths
+ */
+enum class MetricGauge {
+    SerialPendingChunks,    ///< Chunks emitted by the worker, not yet parsed
+    SerialPendingBytes,     ///< Bytes of those chunks
+    ParserBufferBytes,      ///< Bytes of an incomplete line held by the parser
+    DataBufferPackets,      ///< Packets held by DataBuffer
+    TerminalPendingLines,   ///< Lines batched into the last terminal flush
+    PlotterPendingPoints,   ///< Packets batched into the last plot frame
+    Count
+};
+
+/**
+ * @enum MetricStage
+ * @brief Stages with a time-per-item histogram
+ */
+enum class MetricStage {
+    Read,           ///< Serial read per chunk
+    Parse,          ///< Field extraction per line
+    BufferInsert,   ///< DataBuffer insert per packet
+    TerminalAppend, ///< Terminal flush per line
+    PlotRender,     ///< Plot update per frame
+    Count
+};
+
+constexpr int MetricCounterCount = static_cast<int>(MetricCounter::Count);
+constexpr int MetricGaugeCount = static_cast<int>(MetricGauge::Count);
+constexpr int MetricStageCount = static_cast<int>(MetricStage::Count);
+
+/**
+ * @struct StageHistogram
+ * @brief Log2-bucketed ns/item distribution of one stage
+ *
+ * Bucket 0 holds 0 ns, bucket b (b >= 1) holds [2^(b-1), 2^b) ns.
+ */
+struct StageHistogram
+{
+    static constexpr int Buckets = 40;      ///< Up to ~9 minutes per item
+
+    quint64 items = 0;                      ///< Items recorded
+    quint64 totalNs = 0;                    ///< Sum of recorded time
+    std::array<quint64, Buckets> buckets{};
+
+    /**
+     * @brief Get mean time per item
+     * @return Mean in ns (0 if empty)
+     */
+    double meanNs() const { return items ? static_cast<double>(totalNs) / items : 0.0; }
+
+    /**
+     * @brief Add a sample (single-threaded use; PipelineMetrics uses atomics)
+     * @param ns Duration in ns
+     */
+    void add(quint64 ns)
+    {
+        items++;
+        totalNs += ns;
+        buckets[bucketFor(ns)]++;
+    }
+
+    /**
+     * @brief Estimate a percentile
+     * @param fraction Percentile as 0..1 (0.5 = median)
+     * @return Upper bound of the bucket containing the percentile (ns)
+     */
+    quint64 percentileNs(double fraction) const;
+
+    /**
+     * @brief Get upper bound of the highest non-empty bucket
+     * @return Max in ns (bucket resolution)
+     */
+    quint64 maxNs() const { return percentileNs(1.0); }
+
+    /**
+     * @brief Get the bucket index of a duration
+     * @param ns Duration in ns
+     * @return Bucket index
+     */
+    static int bucketFor(quint64 ns);
+
+    /**
+     * @brief Get the exclusive upper bound of a bucket
+     * @param bucket Bucket index
+     * @return Upper bound in ns
+     */
+    static quint64 bucketUpperNs(int bucket);
+};
+
+/**
+ * @struct MetricsSnapshot
+ * @brief Point-in-time copy of all metrics
+ */
+struct MetricsSnapshot
+{
+    qint64 timestampMs = 0;                 ///< Wall clock (ms since epoch)
+    qint64 uptimeNs = 0;                    ///< Time since the last reset
+    std::array<quint64, MetricCounterCount> counters{};
+    std::array<qint64, MetricGaugeCount> gauges{};
+    std::array<StageHistogram, MetricStageCount> stages{};
+
+    quint64 counter(MetricCounter c) const { return counters[static_cast<int>(c)]; }
+    qint64 gauge(MetricGauge g) const { return gauges[static_cast<int>(g)]; }
+    const StageHistogram& stage(MetricStage s) const { return stages[static_cast<int>(s)]; }
+
+    /**
+     * @brief Per-second rate of a counter between two snapshots
+     * @param c Counter
+     * @param previous Earlier snapshot (default snapshot = since reset)
+     * @return Events per second
+     */
+    double rate(MetricCounter c, const MetricsSnapshot &previous) const;
+};
+
+/**
+ * @class PipelineMetrics
+ * @brief Process-wide metrics registry (singleton)
+ */
+class PipelineMetrics
+{
+public:
+    /**
+     * @brief Get singleton instance
+     * @return Reference to the metrics registry
+     */
+    static PipelineMetrics& instance();
+
+    /**
+     * @brief Increment a counter
+     * @param c Counter
+     * @param n Increment
+     */
+    void add(MetricCounter c, quint64 n = 1)
+    {
+        m_counters[static_cast<int>(c)].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Set a gauge
+     * @param g Gauge
+     * @param value Current value
+     */
+    void setGauge(MetricGauge g, qint64 value)
+    {
+        m_gauges[static_cast<int>(g)].store(value, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Record time spent in a stage
+     * @param s Stage
+     * @param ns Elapsed time for all items
+     * @param items Items processed in that time (averaged into one bucket)
+     */
+    void record(MetricStage s, qint64 ns, quint64 items = 1);
+
+    /**
+     * @brief Take a snapshot of all metrics
+     * @return Snapshot
+     */
+    MetricsSnapshot snapshot() const;
+
+    /**
+     * @brief Zero all counters and histograms (gauges are kept)
+     */
+    void reset();
+
+    /**
+     * @brief Get display name of a counter
+     * @param c Counter
+     * @return Name (snake_case, also used in exports)
+     */
+    static QString counterName(MetricCounter c);
+
+    /**
+     * @brief Get display name of a gauge
+     * @param g Gauge
+     * @return Name
+     */
+    static QString gaugeName(MetricGauge g);
+
+    /**
+     * @brief Get display name of a stage
+     * @param s Stage
+     * @return Name
+     */
+    static QString stageName(MetricStage s);
+
+    /**
+     * @brief Format a snapshot as CSV (one row per metric)
+     * @param current Snapshot to export
+     * @param previous Earlier snapshot for rates
+     * @return CSV text
+     */
+    static QByteArray toCsv(const MetricsSnapshot &current, const MetricsSnapshot &previous);
+
+    /**
+     * @brief Format a snapshot as JSON
+     * @param current Snapshot to export
+     * @param previous Earlier snapshot for rates
+     * @return Indented JSON document
+     */
+    static QByteArray toJson(const MetricsSnapshot &current, const MetricsSnapshot &previous);
+
+private:
+    PipelineMetrics();
+    PipelineMetrics(const PipelineMetrics&) = delete;
+    PipelineMetrics& operator=(const PipelineMetrics&) = delete;
+
+    struct AtomicHistogram {
+        std::atomic<quint64> items{0};
+        std::atomic<quint64> totalNs{0};
+        std::array<std::atomic<quint64>, StageHistogram::Buckets> buckets{};
+    };
+
+    std::array<std::atomic<quint64>, MetricCounterCount> m_counters{};
+    std::array<std::atomic<qint64>, MetricGaugeCount> m_gauges{};
+    std::array<AtomicHistogram, MetricStageCount> m_stages;
+    QElapsedTimer m_clock;                  ///< Restarted by reset()
+};
+
+/**
+ * @class StageTimer
+ * @brief Scoped timer that records into a stage histogram
+ *
+ * @code
+ * StageTimer timer(MetricStage::Parse);
+ * ... work ...
+ * timer.setItems(lines);   // optional, defaults to 1
+ * @endcode
+ */
+class StageTimer
+{
+public:
+    explicit StageTimer(MetricStage stage, quint64 items = 1)
+        : m_stage(stage), m_items(items) { m_timer.start(); }
+    ~StageTimer()
+    {
+        if (m_items > 0) {
+            PipelineMetrics::instance().record(m_stage, m_timer.nsecsElapsed(), m_items);
+        }
+    }
+
+    /**
+     * @brief Set the number of items covered by this scope (0 = discard)
+     * @param items Item count
+     */
+    void setItems(quint64 items) { m_items = items; }
+
+private:
+    QElapsedTimer m_timer;
+    MetricStage m_stage;
+    quint64 m_items;
+};
+
+#endif // PIPELINEMETRICS_H
@@ -0,0 +1,189 @@
+/**
+ * @file PipelineStage.h
+ * @brief Base class for stages of a PipelineGraph
+ *
+ * A stage declares typed input and output ports, receives batches on
+ * its inputs through process() and publishes batches with emitOutput().
+ * The graph decides which thread process() runs on; a stage only sees
+ * one batch at a time.
+ */
+
+#ifndef PIPELINESTAGE_H
+#define PIPELINESTAGE_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+#include "PacketBatch.h"
+
+class PipelineGraph;
+
+/**
+ * @enum StageDataType
+ * @brief What travels over a port
+ */
+enum class StageDataType {
+    Bytes,      ///< Raw bytes (source -> framer/decoder)
+    Packets     ///< PacketBatch (decoder -> transforms -> sinks)
+};
+
+/**
+ * @enum StageThread
+ * @brief Where a stage's process() runs
+ */
+enum class StageThread {
+    Gui,        ///< The graph's (GUI) thread; inline when the input arrives there
+    Pool,       ///< The graph's shared thread pool, one batch at a time per stage
+    Pinned      ///< A dedicated thread owned by the stage
+};
+
+/**
+ * @struct StagePort
+ * @brief Named, typed input or output of a stage
+ */
+struct StagePort {
+    QString name;
+    StageDataType type = StageDataType::Packets;
+};
+
+/**
+ * @struct StageData
+ * @brief One batch travelling between stages
+ *
+ * Only the member matching the port type is set. Both are implicitly
+ * shared, so fanning out to several stages copies nothing.
+ */
+struct StageData {
+    QByteArray bytes;       ///< StageDataType::Bytes
+    PacketBatch packets;    ///< StageDataType::Packets
+
+    static StageData fromBytes(const QByteArray &bytes)
+    {
+        StageData data;
+        data.bytes = bytes;
+        return data;
+    }
+
+    static StageData fromPackets(const PacketBatch &packets)
+    {
+        StageData data;
+        data.packets = packets;
+        return data;
+    }
+};
+
+/**
+ * @class PipelineStage
+ * @brief Abstract stage: typed ports, configuration and batch processing
+ *
+ * Stages are created by type name from the graph configuration (see
+ * PipelineGraph::registerStageType()). Pinned stages are moved to their
+ * thread, so they may use timers there.
+ */
+class PipelineStage : public QObject
+{
+    Q_OBJECT
+
+public:
+    ~PipelineStage() override = default;
+
+    /**
+     * @brief Get the stage ID from the graph configuration
+     * @return Unique ID
+     */
+    QString id() const { return m_id; }
+
+    /**
+     * @brief Get the input ports
+     * @return Ports, index = input number passed to process()
+     */
+    virtual QVector<StagePort> inputs() const = 0;
+
+    /**
+     * @brief Get the output ports
+     * @return Ports, index = output number passed to emitOutput()
+     */
+    virtual QVector<StagePort> outputs() const = 0;
+
+    /**
+     * @brief Apply the stage's configuration object
+     * @param config The stage entry of the graph configuration
+     * @param graph Graph with the application's bindings
+     * @return False if the configuration is invalid (see errorString())
+     */
+    virtual bool configure(const QJsonObject &config, const PipelineGraph &graph)
+    {
+        Q_UNUSED(config);
+        Q_UNUSED(graph);
+        return true;
+    }
+
+    /**
+     * @brief Get the thread used when the configuration names none
+     * @return Default thread
+     */
+    virtual StageThread defaultThread() const { return StageThread::Pool; }
+
+    /**
+     * @brief Check if the stage must run on the GUI thread
+     *
+     * True for stages that call into GUI-thread objects (bound protocol
+     * handlers, application sinks).
+     *
+     * @return True to reject "pool" and "pinned"
+     */
+    virtual bool requiresGuiThread() const { return false; }
+
+    /**
+     * @brief Process one batch
+     * @param input Input port index
+     * @param data Batch of the port's type
+     */
+    virtual void process(int input, const StageData &data) = 0;
+
+    /**
+     * @brief Release resources after the last batch (files, devices)
+     *
+     * Called once when the graph is cleared, after all queued batches
+     * were processed.
+     */
+    virtual void finish() {}
+
+    /**
+     * @brief Get the last configuration error
+     * @return Error text
+     */
+    QString errorString() const { return m_errorString; }
+
+protected:
+    /**
+     * @brief Constructor
+     * @param parent Parent object
+     */
+    explicit PipelineStage(QObject *parent = nullptr) : QObject(parent) {}
+
+    /**
+     * @brief Publish a batch on an output port
+     *
+     * Delivered to every linked input, possibly on other threads; an
+     * unconnected output drops the batch.
+     *
+     * @param output Output port index
+     * @param data Batch of the port's type
+     */
+    void emitOutput(int output, const StageData &data);
+
+    QString m_errorString;
+
+private:
+    friend class PipelineGraph;
+
+    PipelineGraph *m_graph = nullptr;   ///< Set when added to a graph
+    int m_slot = -1;                    ///< Index of the stage in its graph
+    QString m_id;
+};
+
+#endif // PIPELINESTAGE_H
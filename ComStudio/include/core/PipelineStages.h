@@ -0,0 +1,229 @@
+/**
+ * @file PipelineStages.h
+ * @brief Built-in PipelineGraph stages
+ *
+ * | type         | inputs      | outputs                    | default thread |
+ * |--------------|-------------|----------------------------|----------------|
+ * | source       | -           | out (bytes)                | caller         |
+ * | protocol     | in (bytes)  | packets, display (packets) | gui (fixed)    |
+ * | line_parser  | in (bytes)  | packets, display (packets) | pool           |
+ * | filter       | in (packets)| out (packets)              | pool           |
+ * | derive       | in (packets)| out (packets)              | pool           |
+ * | decimate     | in (packets)| out (packets)              | pool           |
+ * | sink         | in (packets)| -                          | gui (fixed)    |
+ * | csv_export   | in (packets)| -                          | pinned         |
+ *
+ * "packets" outputs carry every packet, "display" the rate-limited subset.
+ */
+
+#ifndef PIPELINESTAGES_H
+#define PIPELINESTAGES_H
+
+#include <QPointer>
+#include <QStringList>
+#include <memory>
+
+#include "PipelineStage.h"
+#include "PipelineGraph.h"
+#include "ProtocolHandler.h"
+
+class LineParser;
+class CsvRecordWriter;
+
+/**
+ * @brief Register the built-in stage types with PipelineGraph
+ *
+ * Called by PipelineGraph on first use.
+ */
+void registerBuiltinStages();
+
+/**
+ * @class SourceStage
+ * @brief Entry point for bytes fed by the application (PipelineGraph::feed())
+ */
+class SourceStage : public PipelineStage
+{
+    Q_OBJECT
+
+public:
+    QVector<StagePort> inputs() const override { return {}; }
+    QVector<StagePort> outputs() const override { return {{"out", StageDataType::Bytes}}; }
+    StageThread defaultThread() const override { return StageThread::Gui; }
+    void process(int, const StageData &) override {}
+
+    /**
+     * @brief Publish bytes on "out" (on the caller's thread)
+     * @param data Bytes
+     */
+    void push(const QByteArray &data) { emitOutput(0, StageData::fromBytes(data)); }
+};
+
+/**
+ * @class ProtocolStage
+ * @brief Decode with a bound ProtocolHandler (the protocol selected in the UI)
+ *
+ * Config: "target" (binding name, default "protocol").
+ */
+class ProtocolStage : public PipelineStage
+{
+    Q_OBJECT
+
+public:
+    QVector<StagePort> inputs() const override { return {{"in", StageDataType::Bytes}}; }
+    QVector<StagePort> outputs() const override;
+    bool configure(const QJsonObject &config, const PipelineGraph &graph) override;
+    StageThread defaultThread() const override { return StageThread::Gui; }
+    bool requiresGuiThread() const override { return true; }
+    void process(int input, const StageData &data) override;
+
+private:
+    QPointer<ProtocolHandler> m_handler;
+};
+
+/**
+ * @class LineParserStage
+ * @brief Frame and decode text lines with a private LineParser
+ *
+ * Config: "delimiter", "fields" (array of indices), "names" (array),
+ * "idField", "acceptId", "stripLabels", "checksum" (require "*XX"),
+ * "displayRate" (Hz, 0 = no limit);
+ * device timestamps: "xField", "tickBits" (16, 32, 0), "tickRate"
+ * (ticks/s), "fitDrift".
+ *
+ * Off the GUI thread (the default pool) its packets are not latency
+ * traced, since LatencyTracer is GUI-thread only.
+ */
+class LineParserStage : public PipelineStage
+{
+    Q_OBJECT
+
+public:
+    LineParserStage();
+    ~LineParserStage() override;
+
+    QVector<StagePort> inputs() const override { return {{"in", StageDataType::Bytes}}; }
+    QVector<StagePort> outputs() const override;
+    bool configure(const QJsonObject &config, const PipelineGraph &graph) override;
+    void process(int input, const StageData &data) override;
+
+private:
+    std::unique_ptr<LineParser> m_parser;
+};
+
+/**
+ * @class FilterStage
+ * @brief Keep packets of one sensor and/or a subset of channels
+ *
+ * Config: "sensor" (ID, empty = all), "channels" (names, empty = all).
+ */
+class FilterStage : public PipelineStage
+{
+    Q_OBJECT
+
+public:
+    QVector<StagePort> inputs() const override { return {{"in", StageDataType::Packets}}; }
+    QVector<StagePort> outputs() const override { return {{"out", StageDataType::Packets}}; }
+    bool configure(const QJsonObject &config, const PipelineGraph &graph) override;
+    void process(int input, const StageData &data) override;
+
+private:
+    int m_sensorKey = -1;           ///< Interned "sensor" (-1 = all)
+    QStringList m_channels;
+};
+
+/**
+ * @class DeriveStage
+ * @brief Append a channel computed from other channels
+ *
+ * Config: "name"; either "terms" ({channel: coefficient}) and "offset"
+ * for offset + sum(coefficient * channel), or "product" (array of
+ * channels) and "scale" for scale * product(channels). Packets missing
+ * an input channel pass unchanged.
+ */
+class DeriveStage : public PipelineStage
+{
+    Q_OBJECT
+
+public:
+    QVector<StagePort> inputs() const override { return {{"in", StageDataType::Packets}}; }
+    QVector<StagePort> outputs() const override { return {{"out", StageDataType::Packets}}; }
+    bool configure(const QJsonObject &config, const PipelineGraph &graph) override;
+    void process(int input, const StageData &data) override;
+
+private:
+    QString m_name;
+    QVector<QPair<QString, double>> m_terms;
+    QStringList m_product;
+    double m_offset = 0.0;
+    double m_scale = 1.0;
+};
+
+/**
+ * @class DecimateStage
+ * @brief Keep one of every N packets
+ *
+ * Config: "factor" (>= 1).
+ */
+class DecimateStage : public PipelineStage
+{
+    Q_OBJECT
+
+public:
+    QVector<StagePort> inputs() const override { return {{"in", StageDataType::Packets}}; }
+    QVector<StagePort> outputs() const override { return {{"out", StageDataType::Packets}}; }
+    bool configure(const QJsonObject &config, const PipelineGraph &graph) override;
+    void process(int input, const StageData &data) override;
+
+private:
+    int m_factor = 1;
+    quint64 m_seen = 0;
+};
+
+/**
+ * @class SinkStage
+ * @brief Hand batches to a function bound by the application
+ *
+ * Config: "target" (binding name).
+ */
+class SinkStage : public PipelineStage
+{
+    Q_OBJECT
+
+public:
+    QVector<StagePort> inputs() const override { return {{"in", StageDataType::Packets}}; }
+    QVector<StagePort> outputs() const override { return {}; }
+    bool configure(const QJsonObject &config, const PipelineGraph &graph) override;
+    StageThread defaultThread() const override { return StageThread::Gui; }
+    bool requiresGuiThread() const override { return true; }
+    void process(int input, const StageData &data) override;
+
+private:
+    PipelineGraph::PacketSink m_sink;
+};
+
+/**
+ * @class CsvExportStage
+ * @brief Write every packet to a CSV file
+ *
+ * Config: "path", "timestamp" (bool, default true).
+ */
+class CsvExportStage : public PipelineStage
+{
+    Q_OBJECT
+
+public:
+    CsvExportStage();
+    ~CsvExportStage() override;
+
+    QVector<StagePort> inputs() const override { return {{"in", StageDataType::Packets}}; }
+    QVector<StagePort> outputs() const override { return {}; }
+    bool configure(const QJsonObject &config, const PipelineGraph &graph) override;
+    StageThread defaultThread() const override { return StageThread::Pinned; }
+    void process(int input, const StageData &data) override;
+    void finish() override;
+
+private:
+    std::unique_ptr<CsvRecordWriter> m_writer;
+};
+
+#endif // PIPELINESTAGES_H
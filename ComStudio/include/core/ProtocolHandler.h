@@ -4,7 +4,9 @@
  *
  * Acts as the central coordinator between SerialManager and
  * the active protocol parser. Implements strategy pattern to
- * allow runtime protocol switching.
+ * allow runtime protocol switching, or demultiplexes one stream
+ * between several protocols (e.g. log lines interleaved with
+ * binary telemetry frames).
  */
 
 #ifndef PROTOCOLHANDLER_H
@@ -14,10 +16,13 @@
 #include <QByteArray>
 #include <QMap>
 #include <QString>
+#include <QStringList>
+#include <QVector>
 #include <memory>
 
 #include "BaseProtocol.h"
 #include "GenericDataPacket.h"
+#include "PacketBatch.h"
 
 /**
  * @class ProtocolHandler
@@ -26,6 +31,11 @@
  * Manages protocol registration and switching. Receives raw bytes
  * from SerialManager and forwards them to the currently active
  * protocol parser.
+ *
+ * In demux mode each byte range goes to the first protocol (in
+ * priority order) that claims it through BaseProtocol::claimFrame(),
+ * so every protocol only parses its own frames. The packets of all
+ * demultiplexed protocols are relayed through the same signals.
  */
 class ProtocolHandler : public QObject
 {
@@ -89,7 +99,30 @@ public:
     BaseProtocol* protocol(const QString &id) const;
     
     /**
-     * @brief Reset the active protocol's state
+     * @brief Split the stream between several protocols
+     *
+     * Frame-based protocols with sync bytes should come before text
+     * protocols, which claim any line.
+     *
+     * @param ids Protocols in claim priority order; empty = only the active protocol
+     * @return False if an ID is not registered (nothing changes)
+     */
+    bool setDemuxProtocols(const QStringList &ids);
+    
+    /**
+     * @brief Get the demultiplexed protocols
+     * @return IDs in priority order (empty when not demultiplexing)
+     */
+    QStringList demuxProtocols() const { return m_demuxIds; }
+    
+    /**
+     * @brief Check if the stream is split between several protocols
+     * @return True in demux mode
+     */
+    bool isDemultiplexing() const { return !m_demuxIds.isEmpty(); }
+    
+    /**
+     * @brief Reset the state of the protocols in use
      */
     void resetParser();
 
@@ -97,7 +130,8 @@ public slots:
     /**
      * @brief Process raw bytes from serial port
      *
-     * Forwards data to the active protocol parser.
+     * Forwards data to the active protocol parser, or splits it
+     * between the demultiplexed protocols.
      * Should be connected to SerialManager::rawBytesReady.
      *
      * @param data Raw bytes to process
@@ -108,12 +142,21 @@ signals:
     /**
      * @brief Emitted when parsed data is ready
      *
-     * Re-emits the active protocol's dataParsed signal.
+     * Re-emits the active protocol's batchParsed signal.
      * UI components should connect to this signal.
      *
-     * @param packet Parsed data packet
+     * @param batch Parsed data packets (shared, read-only)
      */
-    void dataParsed(const GenericDataPacket &packet);
+    void batchParsed(const PacketBatch &batch);
+    
+    /**
+     * @brief Emitted with every packet, not rate limited (for logging)
+     *
+     * Re-emits the active protocol's batchForLogging signal.
+     *
+     * @param batch Parsed data packets (shared, read-only)
+     */
+    void batchForLogging(const PacketBatch &batch);
     
     /**
      * @brief Emitted when a parsing error occurs
@@ -140,9 +183,23 @@ private:
      * @param protocol Protocol to disconnect
      */
     void disconnectProtocolSignals(BaseProtocol *protocol);
+    
+    /**
+     * @brief Relay the signals of exactly the protocols in use
+     */
+    void updateConnections();
+    
+    /**
+     * @brief Assign buffered bytes to the demultiplexed protocols
+     * @param data Newly received bytes
+     */
+    void demultiplex(const QByteArray &data);
 
     QMap<QString, ProtocolPtr> m_protocols;
     QString m_activeProtocolId;
+    QStringList m_demuxIds;                 ///< Demultiplexed protocols, priority order
+    QVector<BaseProtocol *> m_demuxOrder;   ///< Same, resolved
+    QByteArray m_demuxBuffer;               ///< Bytes no protocol could decide on yet
 };
 
 #endif // PROTOCOLHANDLER_H
@@ -0,0 +1,273 @@
+/**
+ * @file RawCapture.h
+ * @brief Timestamped raw byte capture files (.csraw)
+ *
+ * Stores every chunk read from the serial port exactly as received,
+ * before any parsing, so parser problems can be reproduced later.
+ *
+ * Layout (all integers little-endian):
+ * @code
+ * FileHeader : u32 magic 'CSRW' | u16 version | u16 flags | i64 startEpochMs
+ *              u32 partNumber | u32 reserved
+ * Record     : u64 monotonicNs | u32 length | bytes
+ * @endcode
+ *
+ * If the Compressed flag is set, records are grouped into blocks:
+ * @code
+ * Block      : u32 storedSize | u32 rawSize | qCompress(records)
+ * @endcode
+ *
+ * monotonicNs counts from the start of the capture (the wall clock
+ * time of that instant is startEpochMs) and keeps counting across
+ * rotated parts.
+ */
+
+#ifndef RAWCAPTURE_H
+#define RAWCAPTURE_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+
+/**
+ * @namespace RawCaptureFormat
+ * @brief Constants shared by the capture writer and reader
+ */
+namespace RawCaptureFormat {
+    constexpr quint32 FileMagic = 0x57525343;   ///< 'CSRW'
+    constexpr quint16 Version = 1;
+    constexpr quint16 FlagCompressed = 0x0001;
+    constexpr int FileHeaderSize = 24;
+    constexpr int RecordHeaderSize = 12;
+    constexpr int BlockHeaderSize = 8;
+    constexpr const char *FileSuffix = "csraw";
+}
+
+/**
+ * @struct RawCaptureSettings
+ * @brief Configuration for a raw capture session
+ */
+struct RawCaptureSettings
+{
+    QString path;                       ///< Output file (part number is appended when rotating)
+    bool compress = false;              ///< qCompress each block
+    int compressionLevel = 1;           ///< zlib level (1 = fastest)
+    int blockSize = 64 * 1024;          ///< Bytes buffered before a write
+    qint64 rotateBytes = 0;             ///< Start a new part after this size (0 = never)
+    qint64 rotateSeconds = 0;           ///< Start a new part after this time (0 = never)
+};
+
+/**
+ * @class RawCaptureWriter
+ * @brief Buffered, sequential writer for raw capture files
+ *
+ * append() only copies into a preallocated block buffer; the file is
+ * written once per block, so the cost on the read path is a memcpy
+ * and a clock read.
+ */
+class RawCaptureWriter
+{
+public:
+    RawCaptureWriter() = default;
+
+    /**
+     * @brief Destructor - flushes and closes the file
+     */
+    ~RawCaptureWriter();
+
+    RawCaptureWriter(const RawCaptureWriter&) = delete;
+    RawCaptureWriter& operator=(const RawCaptureWriter&) = delete;
+
+    /**
+     * @brief Start a capture session
+     * @param settings Capture configuration
+     * @return True if the first part was created
+     */
+    bool open(const RawCaptureSettings &settings);
+
+    /**
+     * @brief Append one read chunk
+     * @param data Bytes as received from the device
+     * @return False if a block write failed
+     */
+    bool append(const QByteArray &data);
+
+    /**
+     * @brief Write buffered records to disk
+     * @return True on success
+     */
+    bool flush();
+
+    /**
+     * @brief Flush buffered records and rotate if a limit is reached
+     *
+     * Call periodically so slow streams still reach the disk and
+     * time-based rotation happens without waiting for a full block.
+     *
+     * @return False if a write or rotation failed
+     */
+    bool periodicFlush();
+
+    /**
+     * @brief Flush and close the current part
+     */
+    void close();
+
+    /**
+     * @brief Check if a capture is active
+     * @return True if open
+     */
+    bool isOpen() const { return m_file.isOpen(); }
+
+    /**
+     * @brief Get last error description
+     * @return Error string
+     */
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * @brief Get path of the part currently being written
+     * @return File path
+     */
+    QString currentPath() const { return m_file.fileName(); }
+
+    /**
+     * @brief Get number of payload bytes captured in this session
+     * @return Byte count
+     */
+    quint64 bytesCaptured() const { return m_bytesCaptured; }
+
+    /**
+     * @brief Get number of parts created in this session
+     * @return Part count
+     */
+    int partCount() const { return m_partNumber; }
+
+    /**
+     * @brief Build the file name of a rotated part
+     * @param path Base path from the settings
+     * @param partNumber Part number (starting at 1)
+     * @return Path with the part number before the suffix
+     */
+    static QString partPath(const QString &path, int partNumber);
+
+private:
+    /**
+     * @brief Close the current part and create the next one
+     * @return True on success
+     */
+    bool openNextPart();
+
+    /**
+     * @brief Check whether the current part reached a rotation limit
+     * @return True if a new part should be started
+     */
+    bool shouldRotate() const;
+
+    QFile m_file;
+    QString m_errorString;
+    RawCaptureSettings m_settings;
+    QElapsedTimer m_clock;              ///< Monotonic time base for the session
+    qint64 m_startEpochMs = 0;
+    qint64 m_partStartNs = 0;
+    int m_partNumber = 0;
+    quint64 m_bytesCaptured = 0;
+    QByteArray m_block;                 ///< Pending records (capacity reserved once)
+};
+
+/**
+ * @class RawCaptureReader
+ * @brief Sequential reader for one raw capture file
+ */
+class RawCaptureReader
+{
+public:
+    RawCaptureReader() = default;
+
+    RawCaptureReader(const RawCaptureReader&) = delete;
+    RawCaptureReader& operator=(const RawCaptureReader&) = delete;
+
+    /**
+     * @brief Open a capture file and read its header
+     * @param path Capture file path
+     * @return True on success
+     */
+    bool open(const QString &path);
+
+    /**
+     * @brief Close the file
+     */
+    void close();
+
+    /**
+     * @brief Read the next recorded chunk
+     *
+     * A truncated record at the end of the file (e.g. after a crash)
+     * is treated as end of file.
+     *
+     * @param timestampNs Output: monotonic time of the read
+     * @param data Output: bytes as received
+     * @return False at end of file or on error (see errorString())
+     */
+    bool readNext(qint64 &timestampNs, QByteArray &data);
+
+    /**
+     * @brief Rewind to the first record
+     * @return True on success
+     */
+    bool rewind();
+
+    /**
+     * @brief Get last error description (empty at clean end of file)
+     * @return Error string
+     */
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * @brief Get wall clock time of monotonic time zero
+     * @return Milliseconds since epoch
+     */
+    qint64 startEpochMs() const { return m_startEpochMs; }
+
+    /**
+     * @brief Get the part number stored in the header
+     * @return Part number
+     */
+    int partNumber() const { return m_partNumber; }
+
+    /**
+     * @brief Check if the file uses compressed blocks
+     * @return True if compressed
+     */
+    bool isCompressed() const { return m_compressed; }
+
+    /**
+     * @brief Get file size
+     * @return Size in bytes
+     */
+    qint64 fileSize() const { return m_file.size(); }
+
+    /**
+     * @brief Get current read position
+     * @return Offset in bytes
+     */
+    qint64 position() const { return m_file.pos(); }
+
+private:
+    /**
+     * @brief Load and decompress the next block
+     * @return False at end of file or on error
+     */
+    bool loadBlock();
+
+    QFile m_file;
+    QString m_errorString;
+    qint64 m_startEpochMs = 0;
+    int m_partNumber = 0;
+    bool m_compressed = false;
+    QByteArray m_block;                 ///< Decompressed block (compressed files)
+    qsizetype m_blockPos = 0;
+};
+
+#endif // RAWCAPTURE_H
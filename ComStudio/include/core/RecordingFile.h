@@ -0,0 +1,388 @@
+/**
+ * @file RecordingFile.h
+ * @brief Native chunked columnar recording format (.csrec)
+ *
+ * Compact binary alternative to CSV recordings. Packets are grouped
+ * into chunks, each chunk stores its own channel schema followed by
+ * one column per field. Timestamps are delta-of-delta encoded,
+ * channel values are XOR encoded against the previous sample, and a
+ * footer index allows seeking by time in O(log n).
+ *
+ * Layout (all integers little-endian):
+ * @code
+ * FileHeader  : u32 magic 'CSRC' | u16 version | u16 flags | i64 createdMs
+ * Chunk       : u32 magic 'CHNK' | u32 payloadSize | payload
+ *   payload   : u32 rows | i64 firstTs | i64 lastTs | u64 firstIndex
+ *               u16 channels { u16 len | utf8 name }
+ *               u16 sensors  { u16 len | utf8 id }
+ *               timestamp column   (zigzag varint delta-of-delta)
+ *               packetIndex column (zigzag varint delta)
+ *               sensor column      (varint dictionary ref, only if sensors > 1)
+ *               value columns      (XOR encoded doubles, one per channel)
+ * Index       : u32 magic 'INDX' | u16 schemaCount { u16 channels { u16 len | utf8 } }
+ *               u32 entryCount { i64 firstTs | i64 lastTs | u64 offset | u32 rows | u16 schemaId }
+ * Trailer     : u64 indexOffset | u32 magic 'CEND'
+ * @endcode
+ *
+ * A file without a valid trailer (e.g. after a crash) is still
+ * readable: the reader rebuilds the index by scanning the chunks.
+ */
+
+#ifndef RECORDINGFILE_H
+#define RECORDINGFILE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "GenericDataPacket.h"
+
+/**
+ * @namespace RecordingFormat
+ * @brief Constants shared by the recording writer and reader
+ */
+namespace RecordingFormat {
+    constexpr quint32 FileMagic = 0x43525343;    ///< 'CSRC'
+    constexpr quint32 ChunkMagic = 0x4B4E4843;   ///< 'CHNK'
+    constexpr quint32 IndexMagic = 0x58444E49;   ///< 'INDX'
+    constexpr quint32 TrailerMagic = 0x444E4543; ///< 'CEND'
+    constexpr quint16 Version = 1;
+    constexpr int FileHeaderSize = 16;
+    constexpr int ChunkHeaderSize = 8;
+    constexpr int TrailerSize = 12;
+    constexpr const char *FileSuffix = "csrec";
+}
+
+/**
+ * @struct RecordingIndexEntry
+ * @brief Footer index entry describing one chunk
+ */
+struct RecordingIndexEntry
+{
+    qint64 firstTimestamp = 0;  ///< Timestamp of the first row
+    qint64 lastTimestamp = 0;   ///< Timestamp of the last row
+    quint64 offset = 0;         ///< File offset of the chunk header
+    quint32 rowCount = 0;       ///< Number of rows in the chunk
+    quint16 schemaId = 0;       ///< Index into RecordingReader::schemas()
+};
+
+/**
+ * @struct RecordingChunk
+ * @brief Decoded contents of one chunk
+ *
+ * Column-oriented: columns[c][row] is the value of channelNames[c]
+ * for the given row. Every row in a chunk shares the same schema.
+ */
+struct RecordingChunk
+{
+    QStringList channelNames;           ///< Chunk schema (channel names)
+    QVector<qint64> timestamps;         ///< Per-row timestamps (ms)
+    QVector<quint64> packetIndices;     ///< Per-row packet counters
+    QStringList sensorIds;              ///< Sensor ID dictionary for this chunk
+    QVector<int> sensorRefs;            ///< Per-row dictionary refs (empty if <= 1 sensor)
+    QVector<QVector<double>> columns;   ///< One value column per channel
+
+    /**
+     * @brief Get number of rows in the chunk
+     * @return Row count
+     */
+    int rowCount() const { return timestamps.size(); }
+
+    /**
+     * @brief Get sensor ID of a row
+     * @param row Row index
+     * @return Sensor ID (empty if not used)
+     */
+    QString sensorIdAt(int row) const;
+
+    /**
+     * @brief Rebuild a packet from one row
+     * @param row Row index
+     * @return Reconstructed packet (raw data and display text are not stored)
+     */
+    GenericDataPacket packetAt(int row) const;
+
+    /**
+     * @brief Find the first row with timestamp >= the given time
+     * @param timestamp Time to search for (ms)
+     * @return Row index, or rowCount() if all rows are earlier
+     */
+    int lowerBound(qint64 timestamp) const;
+};
+
+/**
+ * @class RecordingWriter
+ * @brief Streaming writer for the native recording format
+ *
+ * Buffers rows column-wise and writes a chunk when the row limit is
+ * reached, the chunk spans too much time, or the channel set changes.
+ * close() appends the footer index.
+ */
+class RecordingWriter
+{
+public:
+    /**
+     * @brief Constructor
+     * @param rowsPerChunk Maximum rows buffered before a chunk is written
+     */
+    explicit RecordingWriter(int rowsPerChunk = 4096);
+
+    /**
+     * @brief Destructor - closes the file if still open
+     */
+    ~RecordingWriter();
+
+    RecordingWriter(const RecordingWriter&) = delete;
+    RecordingWriter& operator=(const RecordingWriter&) = delete;
+
+    /**
+     * @brief Create the file and write the file header
+     * @param path Output file path
+     * @return True on success
+     */
+    bool open(const QString &path);
+
+    /**
+     * @brief Append a packet as one row
+     *
+     * Starts a new chunk if the packet's channel set differs from
+     * the current chunk schema.
+     *
+     * @param packet Packet to record
+     * @return False if a chunk write failed
+     */
+    bool append(const GenericDataPacket &packet);
+
+    /**
+     * @brief Write the pending chunk (if any) to disk
+     * @return True on success
+     */
+    bool flush();
+
+    /**
+     * @brief Flush, write the footer index and close the file
+     * @return True on success
+     */
+    bool close();
+
+    /**
+     * @brief Check if a file is open
+     * @return True if open
+     */
+    bool isOpen() const { return m_file.isOpen(); }
+
+    /**
+     * @brief Get last error description
+     * @return Error string
+     */
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * @brief Get number of rows written (including pending rows)
+     * @return Row count
+     */
+    quint64 rowCount() const { return m_rowCount; }
+
+    /**
+     * @brief Get number of chunks written so far
+     * @return Chunk count
+     */
+    int chunkCount() const { return m_index.size(); }
+
+    /**
+     * @brief Set maximum time span of a chunk
+     *
+     * Bounds how much data is lost if the application dies
+     * before the chunk is written.
+     *
+     * @param ms Maximum span in milliseconds
+     */
+    void setMaxChunkSpanMs(qint64 ms) { m_maxChunkSpanMs = ms; }
+
+private:
+    /**
+     * @brief Check whether a packet matches the current chunk schema
+     * @param packet Packet to compare
+     * @return True if packet.channelNames equals the schema (same names, same order)
+     */
+    bool matchesSchema(const GenericDataPacket &packet) const;
+
+    /**
+     * @brief Start a new chunk with the packet's channel set
+     * @param packet Packet defining the schema
+     */
+    void beginChunk(const GenericDataPacket &packet);
+
+    /**
+     * @brief Encode and write the pending chunk
+     * @return True on success
+     */
+    bool writeChunk();
+
+    /**
+     * @brief Write the footer index and trailer
+     * @return True on success
+     */
+    bool writeIndex();
+
+    QFile m_file;
+    QString m_errorString;
+    int m_rowsPerChunk;
+    qint64 m_maxChunkSpanMs = 5000;
+    quint64 m_rowCount = 0;
+
+    // Pending chunk (column buffers)
+    QStringList m_schema;
+    QVector<qint64> m_timestamps;
+    QVector<quint64> m_packetIndices;
+    QStringList m_sensorDict;
+    QVector<int> m_sensorRefs;
+    QVector<QVector<double>> m_columns;
+    QByteArray m_encodeBuffer;          ///< Reused chunk encode buffer
+
+    // Footer data
+    QVector<QStringList> m_schemas;
+    QVector<RecordingIndexEntry> m_index;
+};
+
+/**
+ * @class RecordingReader
+ * @brief Random-access reader for the native recording format
+ */
+class RecordingReader
+{
+public:
+    RecordingReader() = default;
+    ~RecordingReader() = default;
+
+    RecordingReader(const RecordingReader&) = delete;
+    RecordingReader& operator=(const RecordingReader&) = delete;
+
+    /**
+     * @brief Open a recording and load its index
+     * @param path Recording file path
+     * @return True on success
+     */
+    bool open(const QString &path);
+
+    /**
+     * @brief Close the file
+     */
+    void close();
+
+    /**
+     * @brief Get last error description
+     * @return Error string
+     */
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * @brief Check if the index was rebuilt by scanning (no valid footer)
+     * @return True if the file was recovered
+     */
+    bool isRecovered() const { return m_recovered; }
+
+    /**
+     * @brief Get number of chunks
+     * @return Chunk count
+     */
+    int chunkCount() const { return m_index.size(); }
+
+    /**
+     * @brief Get total number of rows
+     * @return Row count
+     */
+    quint64 rowCount() const;
+
+    /**
+     * @brief Get timestamp of the first row
+     * @return Timestamp in ms (0 if empty)
+     */
+    qint64 firstTimestamp() const;
+
+    /**
+     * @brief Get timestamp of the last row
+     * @return Timestamp in ms (0 if empty)
+     */
+    qint64 lastTimestamp() const;
+
+    /**
+     * @brief Get the chunk index
+     * @return Index entries in file order
+     */
+    const QVector<RecordingIndexEntry>& index() const { return m_index; }
+
+    /**
+     * @brief Get all distinct chunk schemas
+     * @return Schemas referenced by RecordingIndexEntry::schemaId
+     */
+    const QVector<QStringList>& schemas() const { return m_schemas; }
+
+    /**
+     * @brief Union of all channel names in first-seen order
+     * @return Channel names across every chunk
+     */
+    QStringList allChannelNames() const;
+
+    /**
+     * @brief Find the chunk containing a point in time (binary search)
+     * @param timestamp Time in ms
+     * @return First chunk whose last timestamp is >= timestamp, or -1 if none
+     */
+    int findChunk(qint64 timestamp) const;
+
+    /**
+     * @brief Read and decode one chunk
+     * @param chunkIndex Chunk index
+     * @param chunk Output chunk
+     * @return True on success
+     */
+    bool readChunk(int chunkIndex, RecordingChunk &chunk);
+
+    /**
+     * @brief Seek to the first row at or after a point in time
+     * @param timestamp Time in ms
+     * @param chunk Output: decoded chunk containing the row
+     * @param row Output: row index within the chunk
+     * @return True if such a row exists
+     */
+    bool seek(qint64 timestamp, RecordingChunk &chunk, int &row);
+
+    /**
+     * @brief Convert a recording into a CSV file
+     *
+     * The header lists every channel that appears anywhere in the
+     * recording, so late channels get a proper column name.
+     *
+     * @param recordingPath Input .csrec file
+     * @param csvPath Output CSV file
+     * @param errorMessage Optional output for error description
+     * @return True on success
+     */
+    static bool convertToCsv(const QString &recordingPath, const QString &csvPath,
+                             QString *errorMessage = nullptr);
+
+private:
+    /**
+     * @brief Load index from the footer
+     * @return True if a valid footer was found
+     */
+    bool loadIndex();
+
+    /**
+     * @brief Rebuild the index by scanning all chunks
+     * @return True if at least the file header was valid
+     */
+    bool rebuildIndex();
+
+    QFile m_file;
+    QString m_errorString;
+    bool m_recovered = false;
+    QVector<QStringList> m_schemas;
+    QVector<RecordingIndexEntry> m_index;
+    QByteArray m_payload;               ///< Reused chunk read buffer
+};
+
+#endif // RECORDINGFILE_H
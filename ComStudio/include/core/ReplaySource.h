@@ -0,0 +1,104 @@
+/**
+ * @file ReplaySource.h
+ * @brief Reads recorded traffic back as timed chunks
+ *
+ * Supports raw capture files (.csraw, original read timing) and plain
+ * text logs (paced at a nominal byte rate). Used by SerialWorker to
+ * implement the Replay port kind.
+ */
+
+#ifndef REPLAYSOURCE_H
+#define REPLAYSOURCE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include "RawCapture.h"
+
+/**
+ * @class ReplaySource
+ * @brief Sequential chunk source for replay
+ *
+ * Each chunk carries its offset from the first chunk in original
+ * time; the caller applies the speed multiplier. A capture split by
+ * RawCaptureWriter rotation is replayed across its parts
+ * (name_0001.csraw, name_0002.csraw, ...) as one stream.
+ */
+class ReplaySource
+{
+public:
+    ReplaySource() = default;
+
+    ReplaySource(const ReplaySource&) = delete;
+    ReplaySource& operator=(const ReplaySource&) = delete;
+
+    /**
+     * @brief Open a capture or log file
+     *
+     * Files starting with the raw capture magic are replayed with
+     * their recorded timing; anything else is treated as a text log
+     * split into line-aligned chunks. A rotated part continues with
+     * the parts numbered after it; the base path of a rotated capture
+     * (without part number) opens its first part.
+     *
+     * @param path File path
+     * @param logBytesPerSecond Nominal rate used to time text logs
+     * @return True on success
+     */
+    bool open(const QString &path, qint64 logBytesPerSecond);
+
+    /**
+     * @brief Close the file
+     */
+    void close();
+
+    /**
+     * @brief Get the next chunk
+     * @param data Output: chunk bytes
+     * @param offsetNs Output: time since the first chunk (original timing)
+     * @return False at end of file or on error
+     */
+    bool next(QByteArray &data, qint64 &offsetNs);
+
+    /**
+     * @brief Check if the source is a raw capture file
+     * @return True for .csraw input
+     */
+    bool isCapture() const { return m_isCapture; }
+
+    /**
+     * @brief Get last error description
+     * @return Error string (empty at clean end of file)
+     */
+    QString errorString() const;
+
+    /**
+     * @brief Get replay progress
+     * @return Fraction of the file (or of the rotated parts) consumed (0..1)
+     */
+    double progress() const;
+
+private:
+    /**
+     * @brief Continue a rotated capture with its next part
+     * @return False after the last part or on error (see errorString())
+     */
+    bool openNextPart();
+
+    RawCaptureReader m_capture;
+    QString m_partBase;                 ///< Base path of a rotated capture (empty if not rotated)
+    qint64 m_startEpochMs = 0;          ///< Session of the first part; later parts must match
+    qint64 m_doneBytes = 0;             ///< Size of the parts already replayed
+    qint64 m_totalBytes = 0;            ///< Size of all parts found at open()
+    QFile m_log;
+    QByteArray m_logCarry;              ///< Partial line carried to the next chunk
+    QString m_errorString;
+    bool m_isCapture = false;
+    bool m_hasFirst = false;
+    qint64 m_firstNs = 0;
+    qint64 m_logBytesPerSecond = 11520;
+    quint64 m_logBytes = 0;             ///< Log bytes returned so far (for timing)
+};
+
+#endif // REPLAYSOURCE_H
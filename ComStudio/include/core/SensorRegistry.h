@@ -0,0 +1,96 @@
+/**
+ * @file SensorRegistry.h
+ * @brief Process-wide interning of sensor IDs
+ *
+ * Buses with tens of sensors repeat the same few ID strings on every
+ * line. The parser interns each ID once and stores the small integer
+ * key in the packet, so grouping and filtering compare integers and
+ * the packet's sensorId shares the registry's string.
+ */
+
+#ifndef SENSORREGISTRY_H
+#define SENSORREGISTRY_H
+
+#include <QReadWriteLock>
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+/**
+ * @class SensorRegistry
+ * @brief Thread-safe ID string <-> key table
+ *
+ * Keys are dense (0, 1, 2, ... in order of first appearance) and stay
+ * valid for the lifetime of the process. Lookups of known IDs do not
+ * allocate. The table is bounded so noise in the ID column cannot grow
+ * it without limit; IDs beyond the bound are not interned.
+ */
+class SensorRegistry
+{
+public:
+    static constexpr int MaxSensors = 4096;
+
+    /**
+     * @brief Get the process-wide registry
+     * @return Registry
+     */
+    static SensorRegistry &instance();
+
+    /**
+     * @brief Get the key of an ID, adding it if new
+     * @param id Sensor ID as received
+     * @return Key, or -1 if id is empty or the table is full
+     */
+    int intern(QStringView id);
+
+    /**
+     * @brief Get the key of a known ID
+     * @param id Sensor ID
+     * @return Key, or -1 if never interned
+     */
+    int find(QStringView id) const;
+
+    /**
+     * @brief Get the ID string of a key
+     * @param key Key from intern()
+     * @return ID (shared, no copy), empty for an invalid key
+     */
+    QString name(int key) const;
+
+    /**
+     * @brief Get the number of interned IDs
+     * @return Count
+     */
+    int count() const;
+
+    /**
+     * @brief Check an ID against a sensor filter
+     *
+     * Matches case-insensitively, or by the numeric part so "#12820"
+     * matches "12820" and "d1" matches "1". Does not allocate.
+     *
+     * @param id Sensor ID as received
+     * @param filter Filter text (ParserConfig::acceptSensorId)
+     * @return True if the ID passes
+     */
+    static bool idMatches(QStringView id, QStringView filter);
+
+private:
+    SensorRegistry();
+
+    /**
+     * @brief Find the bucket holding id, or the empty bucket where it belongs (lock held)
+     * @param id Sensor ID
+     * @param hash qHash(id)
+     * @return Bucket index
+     */
+    qsizetype probe(QStringView id, size_t hash) const;
+
+    static constexpr qsizetype BucketCount = 2 * MaxSensors;  ///< Power of two, load <= 0.5
+
+    mutable QReadWriteLock m_lock;
+    QVector<QString> m_names;       ///< Indexed by key
+    QVector<int> m_buckets;         ///< Open addressing: key + 1, 0 = empty
+};
+
+#endif // SENSORREGISTRY_H
@@ -16,19 +16,62 @@
 #include <QThread>
 #include <QMutex>
 #include <QByteArray>
+#include <QElapsedTimer>
+#include <atomic>
 #include <memory>
 
+#include "DataGenerator.h"
+#include "IngestQueue.h"
+#include "RawCapture.h"
+#include "ReplaySource.h"
+
+class QTimer;
+
+/**
+ * @enum PortKind
+ * @brief Kind of data source behind a "port"
+ */
+enum class PortKind {
+    Serial,     ///< Real serial port (QSerialPort)
+    Replay,     ///< Raw capture or text log played back from a file
+    Generator   ///< Built-in synthetic traffic (load testing)
+};
+
 /**
  * @struct SerialSettings
  * @brief Configuration structure for serial port settings
  */
 struct SerialSettings {
+    PortKind kind = PortKind::Serial;
     QString portName;
     qint32 baudRate = 115200;
     QSerialPort::DataBits dataBits = QSerialPort::Data8;
     QSerialPort::Parity parity = QSerialPort::NoParity;
     QSerialPort::StopBits stopBits = QSerialPort::OneStop;
     QSerialPort::FlowControl flowControl = QSerialPort::NoFlowControl;
+    
+    // Replay source
+    QString replayPath;                 ///< .csraw capture or text log
+    double replaySpeed = 1.0;           ///< Time multiplier (0.1 - 1000)
+    bool replayMaxSpeed = false;        ///< Ignore timing, feed as fast as the pipeline accepts
+    
+    // Generator source
+    GeneratorSettings generator;        ///< Synthetic traffic configuration
+    
+    // Worker -> GUI thread queue
+    IngestQueueSettings ingest;         ///< Queue bounds and overload policy
+};
+
+/**
+ * @struct ReplayStats
+ * @brief Summary of a finished replay
+ */
+struct ReplayStats {
+    quint64 bytes = 0;                  ///< Bytes emitted
+    quint64 chunks = 0;                 ///< Chunks emitted
+    qint64 elapsedNs = 0;               ///< Wall time from first to last chunk
+    bool maxSpeed = false;              ///< True if timing was ignored
+    bool completed = false;             ///< False if stopped early or on error
 };
 
 /**
@@ -53,6 +96,15 @@ public:
      * @brief Destructor - ensures port is closed
      */
     ~SerialWorker() override;
+    
+    /**
+     * @brief Get the queue of read chunks towards the GUI thread
+     *
+     * Thread-safe. The manager drains it after chunksQueued().
+     *
+     * @return Ingest queue
+     */
+    IngestQueue &queue() { return m_queue; }
 
 public slots:
     /**
@@ -71,13 +123,28 @@ public slots:
      * @param data Data to write
      */
     void writeData(const QByteArray &data);
+    
+    /**
+     * @brief Start capturing every read chunk to a raw capture file
+     * @param settings Capture configuration
+     */
+    void startCapture(const RawCaptureSettings &settings);
+    
+    /**
+     * @brief Stop raw capture and close the file
+     */
+    void stopCapture();
+    
+    /**
+     * @brief Read again after the ingest queue made room for a waiting reader
+     */
+    void resumeReading();
 
 signals:
     /**
-     * @brief Emitted when raw bytes are received
-     * @param data The received data
+     * @brief Emitted when chunks were queued and the consumer is not yet woken
      */
-    void rawBytesReady(const QByteArray &data);
+    void chunksQueued();
     
     /**
      * @brief Emitted when connection state changes
@@ -91,6 +158,19 @@ signals:
      * @param error Error description
      */
     void errorOccurred(const QString &error);
+    
+    /**
+     * @brief Emitted when raw capture starts or stops
+     * @param active True if capturing
+     * @param message Status message (file name, byte count or error)
+     */
+    void captureStateChanged(bool active, const QString &message);
+    
+    /**
+     * @brief Emitted when a replay source reaches its end or is stopped
+     * @param stats Replay summary
+     */
+    void replayFinished(const ReplayStats &stats);
 
 private slots:
     /**
@@ -103,10 +183,87 @@ private slots:
      * @param error The error code
      */
     void handleError(QSerialPort::SerialPortError error);
+    
+    /**
+     * @brief Periodically flush the raw capture and rotate files
+     */
+    void handleCaptureFlush();
+    
+    /**
+     * @brief Emit replay chunks that are due and schedule the next tick
+     */
+    void handleReplayTick();
+    
+    /**
+     * @brief Emit generated traffic that is due
+     */
+    void handleGeneratorTick();
 
 private:
+    /**
+     * @brief Open a replay source instead of a serial port
+     * @param settings Settings with the replay file and speed
+     */
+    void openReplay(const SerialSettings &settings);
+    
+    /**
+     * @brief Stop the replay and report statistics
+     * @param completed True if the source reached its end
+     */
+    void finishReplay(bool completed);
+    
+    /**
+     * @brief Start the synthetic data generator instead of a serial port
+     * @param settings Settings with the generator configuration
+     */
+    void openGenerator(const SerialSettings &settings);
+    
+    /**
+     * @brief Stop the generator
+     * @param message Status message for connectionStateChanged
+     */
+    void stopGenerator(const QString &message);
+    
+    /**
+     * @brief Queue a chunk towards the pipeline
+     * @param data Bytes to emit
+     * @param readNs Read time for latency tracing (-1 = now)
+     */
+    void emitChunk(const QByteArray &data, qint64 readNs = -1);
+    
+    /**
+     * @brief Check if a source-paced emitter may produce another chunk
+     *
+     * Max-speed replay and the generator have nothing to lose by waiting,
+     * so they keep the queue short regardless of the overload policy.
+     *
+     * @return True if few enough chunks are queued
+     */
+    bool sourceMayEmit() const;
+
     std::unique_ptr<QSerialPort> m_serialPort;
     QByteArray m_readBuffer;
+    std::unique_ptr<RawCaptureWriter> m_capture;   ///< Active raw capture (null if off)
+    QTimer *m_captureFlushTimer = nullptr;
+    
+    // Replay state
+    std::unique_ptr<ReplaySource> m_replay;
+    QTimer *m_replayTimer = nullptr;
+    QElapsedTimer m_replayClock;
+    QByteArray m_replayNext;            ///< Lookahead chunk not yet due
+    qint64 m_replayNextNs = 0;          ///< Original-time offset of m_replayNext
+    bool m_replayHasNext = false;
+    double m_replaySpeed = 1.0;
+    bool m_replayMaxSpeed = false;
+    ReplayStats m_replayStats;
+    
+    // Generator state
+    std::unique_ptr<DataGenerator> m_generator;
+    QTimer *m_generatorTimer = nullptr;
+    QElapsedTimer m_generatorClock;
+    
+    IngestQueue m_queue;                ///< Read chunks not yet parsed
+    quint64 m_nextTraceId = 1;          ///< Latency trace ID of the next chunk
 };
 
 /**
@@ -173,6 +330,17 @@ public slots:
      * @param data Data to send
      */
     void sendData(const QByteArray &data);
+    
+    /**
+     * @brief Start raw byte capture in the worker thread
+     * @param settings Capture configuration
+     */
+    void startRawCapture(const RawCaptureSettings &settings);
+    
+    /**
+     * @brief Stop raw byte capture
+     */
+    void stopRawCapture();
 
 signals:
     /**
@@ -193,6 +361,30 @@ signals:
      * @param error Error description
      */
     void errorOccurred(const QString &error);
+    
+    /**
+     * @brief Emitted when raw capture starts or stops
+     * @param active True if capturing
+     * @param message Status message
+     */
+    void rawCaptureStateChanged(bool active, const QString &message);
+    
+    /**
+     * @brief Emitted when a replay source finishes
+     * @param stats Replay summary
+     */
+    void replayFinished(const ReplayStats &stats);
+    
+    /**
+     * @brief Emitted when the ingest queue crosses its overload watermarks
+     *
+     * On at half full, off again at a quarter, for every policy. With
+     * OverloadPolicy::DecimateDisplay the receiver is expected to thin
+     * out its display work while logging continues at full rate.
+     *
+     * @param overloaded True while the GUI thread is behind the reader
+     */
+    void overloadChanged(bool overloaded);
 
 private:
     /**
@@ -204,12 +396,29 @@ private:
      * @brief Initialize worker thread
      */
     void initWorkerThread();
+    
+    /**
+     * @brief Deliver queued chunks as rawBytesReady
+     *
+     * Runs for at most DrainSliceMs and then re-posts itself, so a
+     * backlog never blocks painting and input for long.
+     *
+     * @param all True to drain everything (before a state change is reported)
+     */
+    void drainQueue(bool all = false);
+    
+    /**
+     * @brief Update the overload state from the queue fill level
+     */
+    void updateOverload();
 
     // Internal signals to communicate with worker
 signals:
     void requestOpenPort(const SerialSettings &settings);
     void requestClosePort();
     void requestWriteData(const QByteArray &data);
+    void requestStartCapture(const RawCaptureSettings &settings);
+    void requestStopCapture();
 
 private:
     std::unique_ptr<QThread> m_workerThread;
@@ -217,6 +426,7 @@ private:
     
     mutable QMutex m_mutex;
     bool m_isConnected = false;
+    bool m_overloaded = false;          ///< Last reported overloadChanged() state (GUI thread)
     SerialSettings m_currentSettings;
 };
 
@@ -0,0 +1,114 @@
+/**
+ * @file StallWatchdog.h
+ * @brief Detects GUI event-loop stalls and reports what was running
+ *
+ * A heartbeat timer on the GUI thread stamps the time of every beat. A
+ * separate watchdog thread polls that stamp; when a beat is later than the
+ * threshold it samples the active TRACE_SCOPE stage and the pipeline queue
+ * depths until the GUI recovers, then logs a stall report.
+ */
+
+#ifndef STALLWATCHDOG_H
+#define STALLWATCHDOG_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <array>
+#include <atomic>
+#include <memory>
+
+#include "PipelineMetrics.h"
+
+class QThread;
+class QTimer;
+
+/**
+ * @struct StallReport
+ * @brief What the watchdog saw during one stall
+ */
+struct StallReport
+{
+    qint64 durationNs = 0;                          ///< Expected beat to recovery
+    QString culprit;                                ///< Most sampled stage ("idle" if none)
+    QHash<QString, int> stageSamples;               ///< Samples per active stage
+    std::array<qint64, MetricGaugeCount> peakGauges{};  ///< Max queue depths seen
+
+    /**
+     * @brief Format the report for the log
+     * @return Multi-line text
+     */
+    QString toString() const;
+};
+
+/**
+ * @class StallWatchdog
+ * @brief GUI heartbeat plus a watchdog thread
+ *
+ * Must be created and started on the GUI thread. start() makes the GUI
+ * thread publish its active stage (see TraceRecorder::publishActiveStage()).
+ */
+class StallWatchdog : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_THRESHOLD_MS = 200;
+
+    /**
+     * @brief Constructor
+     * @param parent Parent object
+     */
+    explicit StallWatchdog(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor - stops the watchdog thread
+     */
+    ~StallWatchdog() override;
+
+    /**
+     * @brief Start the heartbeat and the watchdog thread
+     * @param thresholdMs Beat lateness that counts as a stall
+     */
+    void start(int thresholdMs = DEFAULT_THRESHOLD_MS);
+
+    /**
+     * @brief Stop the heartbeat and join the watchdog thread
+     */
+    void stop();
+
+    /**
+     * @brief Check if the watchdog is running
+     * @return True if started
+     */
+    bool isRunning() const { return m_running.load(std::memory_order_relaxed); }
+
+signals:
+    /**
+     * @brief Emitted (queued, on the GUI thread) after a stall ends
+     * @param report Stall details
+     */
+    void stallDetected(const StallReport &report);
+
+private:
+    /**
+     * @brief Heartbeat (GUI thread)
+     */
+    void onHeartbeat();
+
+    /**
+     * @brief Poll loop (watchdog thread)
+     */
+    void watchLoop();
+
+    QTimer *m_heartbeat = nullptr;
+    std::unique_ptr<QThread> m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<qint64> m_lastBeatNs{0};   ///< LatencyTracer::nowNs() of the last beat
+    qint64 m_thresholdNs = 0;
+
+    static constexpr int HEARTBEAT_INTERVAL_MS = 20;
+    static constexpr int POLL_INTERVAL_MS = 10;
+};
+
+#endif // STALLWATCHDOG_H
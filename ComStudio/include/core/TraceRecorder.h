@@ -0,0 +1,196 @@
+/**
+ * @file TraceRecorder.h
+ * @brief Scoped trace events exported as Chrome/Perfetto trace JSON
+ *
+ * TRACE_SCOPE("name") records a complete event (start + duration) into a
+ * ring buffer owned by the calling thread. Recording is off by default;
+ * when off, a scope costs one relaxed atomic load. The JSON can be opened
+ * in chrome://tracing or ui.perfetto.dev.
+ *
+ * Independently of recording, scopes on the thread that called
+ * publishActiveStage() (the GUI thread) publish their name, so the stall
+ * watchdog can tell which stage was running when the event loop froze.
+ */
+
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+/**
+ * @struct TraceEvent
+ * @brief One complete ("X") event
+ */
+struct TraceEvent
+{
+    const char *name = nullptr;     ///< String literal (not copied)
+    qint64 startNs = 0;             ///< LatencyTracer::nowNs() at scope entry
+    qint64 durationNs = 0;
+};
+
+/**
+ * @class TraceRecorder
+ * @brief Process-wide trace event recorder (singleton)
+ *
+ * Each thread writes only to its own ring, so recording takes no lock.
+ * The oldest events of a thread are overwritten once its ring is full.
+ */
+class TraceRecorder
+{
+public:
+    static constexpr int RingCapacity = 1 << 16;   ///< Events kept per thread
+
+    /**
+     * @brief Get singleton instance
+     * @return Reference to the recorder
+     */
+    static TraceRecorder& instance();
+
+    /**
+     * @brief Check if recording is on (cheap, any thread)
+     * @return True if enabled
+     */
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Publish TRACE_SCOPE names of the calling thread as the active stage
+     *
+     * Only one thread may publish (the GUI thread).
+     */
+    static void publishActiveStage() { t_publishStage = true; }
+
+    /**
+     * @brief Check if the calling thread publishes its active stage
+     * @return True for the publishing thread
+     */
+    static bool publishesActiveStage() { return t_publishStage; }
+
+    /**
+     * @brief Get the innermost scope currently running on the publishing thread
+     * @return Stage name, or nullptr when idle (any thread)
+     */
+    static const char* activeStage() { return s_activeStage.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Replace the active stage (publishing thread only)
+     * @param name New stage name (nullptr = idle)
+     * @return Previous stage name
+     */
+    static const char* swapActiveStage(const char *name)
+    {
+        return s_activeStage.exchange(name, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Turn recording on or off
+     * @param enabled True to record
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Record a complete event for the calling thread
+     * @param name Event name (must outlive the recorder, e.g. a literal)
+     * @param startNs Start time (LatencyTracer::nowNs())
+     * @param durationNs Duration
+     */
+    void record(const char *name, qint64 startNs, qint64 durationNs);
+
+    /**
+     * @brief Drop all recorded events
+     */
+    void clear();
+
+    /**
+     * @brief Build Chrome trace JSON from all threads
+     *
+     * Recording is paused while the rings are read.
+     *
+     * @return JSON document ({"traceEvents": [...]})
+     */
+    QByteArray exportChromeJson();
+
+    /**
+     * @brief Write Chrome trace JSON to a file
+     * @param path Output path
+     * @param errorString Set on failure (may be null)
+     * @return True on success
+     */
+    bool writeChromeJson(const QString &path, QString *errorString = nullptr);
+
+private:
+    TraceRecorder() = default;
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    struct ThreadRing {
+        int threadId = 0;
+        QString threadName;
+        std::unique_ptr<TraceEvent[]> events{new TraceEvent[RingCapacity]};
+        std::atomic<quint64> written{0};    ///< Total events written (release)
+    };
+
+    /**
+     * @brief Get (creating on first use) the calling thread's ring
+     * @return Ring
+     */
+    ThreadRing& localRing();
+
+    static std::atomic<bool> s_enabled;
+    static std::atomic<const char*> s_activeStage;
+    static thread_local bool t_publishStage;
+    QMutex m_mutex;                                 ///< Guards m_rings
+    QVector<std::shared_ptr<ThreadRing>> m_rings;   ///< Kept after thread exit
+};
+
+/**
+ * @class TraceScope
+ * @brief RAII helper behind TRACE_SCOPE
+ */
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name)
+    {
+        if (TraceRecorder::publishesActiveStage()) {
+            m_previousStage = TraceRecorder::swapActiveStage(name);
+            m_published = true;
+        }
+        if (TraceRecorder::isEnabled()) {
+            m_name = name;
+            m_startNs = now();
+        }
+    }
+    ~TraceScope()
+    {
+        if (m_name) {
+            TraceRecorder::instance().record(m_name, m_startNs, now() - m_startNs);
+        }
+        if (m_published) {
+            TraceRecorder::swapActiveStage(m_previousStage);
+        }
+    }
+
+private:
+    static qint64 now();
+
+    const char *m_name = nullptr;
+    qint64 m_startNs = 0;
+    const char *m_previousStage = nullptr;
+    bool m_published = false;
+};
+
+#define TRACE_SCOPE_CONCAT_INNER(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT_INNER(a, b)
+
+/**
+ * @brief Record the enclosing scope as a trace event
+ * @param name String literal
+ */
+#define TRACE_SCOPE(name) TraceScope TRACE_SCOPE_CONCAT(traceScope_, __LINE__)(name)
+
+#endif // TRACERECORDER_H
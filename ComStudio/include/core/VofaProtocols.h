@@ -0,0 +1,116 @@
+/**
+ * @file VofaProtocols.h
+ * @brief VOFA+ JustFloat (binary) and FireWater (text) protocols
+ *
+ * JustFloat frames are raw little-endian float32 values followed by the
+ * tail 00 00 80 7F (the bytes of +Inf). No text is parsed, and a
+ * frame of N channels takes 4N + 4 bytes instead of roughly 10N
+ * for ASCII. FireWater is the text variant: "[name:]v0,v1,...\n".
+ */
+
+#ifndef VOFAPROTOCOLS_H
+#define VOFAPROTOCOLS_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+
+#include "FramedProtocol.h"
+#include "LineParser.h"
+
+/**
+ * @class JustFloatProtocol
+ * @brief Decoder for VOFA+ JustFloat frames
+ *
+ * Frame tails are located with memchr() on the 0x7F tail byte; a tail
+ * only counts at a 4-byte multiple from the frame start, so an Inf
+ * pattern straddling two floats is not taken for a tail. Payloads are
+ * read in place from the receive buffer into the packet's values.
+ * Channels are named "Ch0", "Ch1", ... With a framer set (e.g. JustFloat
+ * payloads sent in COBS frames) the framer cuts the stream instead and
+ * the tail is optional.
+ */
+class JustFloatProtocol : public FramedProtocol
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MaxChannels = 64;                      ///< Longer payloads are resync errors
+    static constexpr qsizetype TailSize = 4;
+    static constexpr qsizetype MaxFrameBytes = MaxChannels * 4 + TailSize;
+
+    /**
+     * @brief Constructor
+     * @param parent Parent QObject
+     */
+    explicit JustFloatProtocol(QObject *parent = nullptr);
+
+    // BaseProtocol interface
+    void parse(const QByteArray &data) override;
+    QString name() const override { return QStringLiteral("VOFA+ JustFloat"); }
+    QString description() const override { return QStringLiteral("Little-endian float32 arrays with a 00 00 80 7F tail"); }
+    void reset() override;
+
+    /**
+     * @brief Claim whole floats up to and including the tail
+     *
+     * An incomplete frame is only waited for if it contains non-text
+     * bytes; plain text is left to the other protocols.
+     */
+    FrameClaim claimFrame(QByteArrayView data) const override;
+
+protected:
+    void processFrame(QByteArrayView frame) override;
+
+private:
+    /**
+     * @brief Decode one frame payload into a packet
+     * @param payload Pointer to the first float
+     * @param count Number of floats
+     */
+    void decodeFrame(const char *payload, int count);
+
+    QByteArray m_buffer;                ///< Bytes after the last complete frame
+};
+
+/**
+ * @class FireWaterProtocol
+ * @brief VOFA+ FireWater text frames: "[name:]v0,v1,...\n"
+ *
+ * A LineParser with a fixed configuration: comma delimiter, "\n" line
+ * ending and the optional "name:" prefix stripped as a label.
+ */
+class FireWaterProtocol : public LineParser
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor
+     * @param parent Parent QObject
+     */
+    explicit FireWaterProtocol(QObject *parent = nullptr);
+
+    QString name() const override { return QStringLiteral("VOFA+ FireWater"); }
+    QString description() const override { return QStringLiteral("Comma-separated values with an optional name: prefix"); }
+    bool isConfigurable() const override { return false; }
+
+    /**
+     * @brief Get the FireWater parser configuration
+     * @return Configuration
+     */
+    static ParserConfig fireWaterConfig();
+
+    /**
+     * @brief Get the FireWater configuration with the user's non-framing settings
+     *
+     * Takes the x-axis source, device clock and checksum settings from
+     * settings; delimiter, labels, fields and line ending stay fixed.
+     *
+     * @param settings Configuration applied to the line parser
+     * @return Configuration
+     */
+    static ParserConfig fireWaterConfig(const ParserConfig &settings);
+};
+
+#endif // VOFAPROTOCOLS_H
@@ -2,9 +2,11 @@
  * @file DataBuffer.h
  * @brief Central data storage for parsed serial data
  *
- * Provides a thread-safe ring buffer for storing parsed data packets.
- * Both TerminalWidget and PlotterWidget subscribe to this buffer
- * for updates.
+ * Provides a thread-safe, append-only log of parsed data packets.
+ * Packets are held in the shared batches the parser published, so
+ * storing them does not copy anything. Consumers (plotter, terminal,
+ * recorder) read the log through their own PacketCursor at their own
+ * pace instead of being pushed every packet.
  */
 
 #ifndef DATABUFFER_H
@@ -13,10 +15,16 @@
 #include <QObject>
 #include <QVector>
 #include <QMutex>
+#include <QWaitCondition>
 #include <QReadWriteLock>
+#include <QHash>
+#include <QSet>
 #include <deque>
 
 #include "core/GenericDataPacket.h"
+#include "core/PacketBatch.h"
+
+class PacketCursor;
 
 /**
  * @class DataBuffer
@@ -24,13 +32,26 @@
  *
  * Stores a configurable number of recent packets in a ring buffer.
  * Provides both raw packet access and per-channel time-series data
- * for plotting.
+ * for plotting. The ring holds whole PacketBatch references; trimming
+ * slices the oldest batch until it can be released.
+ *
+ * Channels are also grouped by sensor (GenericDataPacket::sensorKey),
+ * so one stream carrying many sensors of the same format keeps each
+ * sensor's channels apart.
+ *
+ * Every appended packet gets a sequence number. A PacketCursor
+ * remembers the next sequence its consumer wants; a consumer that
+ * falls more than maxSize() packets behind loses the oldest ones and
+ * is told how many (PacketCursor::fellBehind()).
  */
 class DataBuffer : public QObject
 {
     Q_OBJECT
 
 public:
+    /// Sensor key that selects packets of every sensor
+    static constexpr int AnySensor = -2;
+    
     /**
      * @brief Constructor
      * @param maxSize Maximum number of packets to store
@@ -39,9 +60,9 @@ public:
     explicit DataBuffer(int maxSize = 10000, QObject *parent = nullptr);
     
     /**
-     * @brief Destructor
+     * @brief Destructor - detaches open cursors
      */
-    ~DataBuffer() override = default;
+    ~DataBuffer() override;
     
     /**
      * @brief Get maximum buffer size
@@ -98,16 +119,20 @@ public:
      * @brief Get time-series data for a channel
      *
      * Returns parallel vectors of timestamps and values for plotting.
+     * Timestamps are GenericDataPacket::xTime() (seconds on the
+     * configured x-axis timebase).
      *
      * @param channelName Name of the channel
      * @param timestamps Output vector for timestamps
      * @param values Output vector for values
      * @param maxPoints Maximum number of points to return (0 = all)
+     * @param sensorKey Only packets of this sensor (-1 = without ID, AnySensor = all)
      */
     void channelData(const QString &channelName,
                      QVector<double> &timestamps,
                      QVector<double> &values,
-                     int maxPoints = 0) const;
+                     int maxPoints = 0,
+                     int sensorKey = AnySensor) const;
     
     /**
      * @brief Get time-series data by channel index
@@ -115,11 +140,13 @@ public:
      * @param timestamps Output vector for timestamps
      * @param values Output vector for values
      * @param maxPoints Maximum number of points to return
+     * @param sensorKey Only packets of this sensor (-1 = without ID, AnySensor = all)
      */
     void channelDataByIndex(int channelIndex,
                             QVector<double> &timestamps,
                             QVector<double> &values,
-                            int maxPoints = 0) const;
+                            int maxPoints = 0,
+                            int sensorKey = AnySensor) const;
     
     /**
      * @brief Get list of known channel names
@@ -132,10 +159,57 @@ public:
      * @return Maximum channel count
      */
     int maxChannelCount() const;
+    
+    /**
+     * @brief Get the sensors seen in the data
+     * @return Sensor keys in order of first appearance (-1 = packets without ID)
+     */
+    QVector<int> sensors() const;
+    
+    /**
+     * @brief Get the channel group of one sensor
+     * @param sensorKey Sensor key (-1 = packets without ID)
+     * @return Channel names seen for that sensor
+     */
+    QStringList sensorChannelNames(int sensorKey) const;
+    
+    /**
+     * @brief Get sequence number of the oldest stored packet
+     * @return Sequence (equals endSequence() when empty)
+     */
+    quint64 firstSequence() const;
+    
+    /**
+     * @brief Get sequence number the next appended packet will get
+     * @return Sequence
+     */
+    quint64 endSequence() const;
+    
+    /**
+     * @brief Open a read cursor positioned at the end of the log
+     *
+     * The cursor sees packets appended from now on. It may be read
+     * from any thread; readyRead() follows the cursor's thread affinity.
+     *
+     * @param name Consumer name (for diagnostics)
+     * @param parent Owner of the cursor
+     * @return New cursor
+     */
+    PacketCursor *openCursor(const QString &name, QObject *parent = nullptr);
 
 public slots:
     /**
-     * @brief Add a new packet to the buffer
+     * @brief Add a batch of packets under a single lock
+     *
+     * The batch is referenced, not copied. Cursors with no unread
+     * packets so far are notified once (PacketCursor::readyRead()).
+     *
+     * @param batch Packets in arrival order
+     */
+    void addBatch(const PacketBatch &batch);
+    
+    /**
+     * @brief Add a single packet (wrapped in a one-packet batch)
      * @param packet Packet to add
      */
     void addPacket(const GenericDataPacket &packet);
@@ -146,12 +220,6 @@ public slots:
     void clear();
 
 signals:
-    /**
-     * @brief Emitted when new data is added
-     * @param packet The newly added packet
-     */
-    void dataUpdated(const GenericDataPacket &packet);
-    
     /**
      * @brief Emitted when buffer is cleared
      */
@@ -162,13 +230,93 @@ signals:
      * @param channelName Name of the new channel
      */
     void channelAdded(const QString &channelName);
+    
+    /**
+     * @brief Emitted when packets of a new sensor arrive
+     * @param sensorKey Sensor key (see SensorRegistry, -1 = without ID)
+     */
+    void sensorAdded(int sensorKey);
 
 private:
+    friend class PacketCursor;
+    
+    /**
+     * @struct StoredBatch
+     * @brief A batch and the sequence number of its first packet
+     */
+    struct StoredBatch {
+        quint64 firstSequence = 0;
+        PacketBatch batch;
+    };
+    
+    /**
+     * @brief Read from a cursor position (used by PacketCursor)
+     * @param sequence In: next sequence wanted; out: after the last packet read
+     * @param maxPackets Maximum packets to return (0 = all available)
+     * @param lost Output: packets that were trimmed before they were read
+     * @return Slices of the stored batches, oldest first
+     */
+    QVector<PacketBatch> readFrom(quint64 &sequence, qint64 maxPackets, quint64 &lost) const;
+    
+    /**
+     * @brief Get number of packets readable from a position
+     * @param sequence Cursor position
+     * @return Unread packets still stored
+     */
+    qint64 availableFrom(quint64 sequence) const;
+    
+    /**
+     * @brief Forget a cursor that is being destroyed
+     *
+     * From another thread, waits until a running readyRead() pass has
+     * finished so the cursor is not signalled after its destruction.
+     *
+     * @param cursor Cursor to remove
+     */
+    void closeCursor(PacketCursor *cursor);
+    
+    /**
+     * @brief Get number of stored packets (lock must be held)
+     * @return Packet count
+     */
+    int count() const { return static_cast<int>(m_nextSequence - m_firstSequence); }
+    
+    /**
+     * @brief Find the stored batch holding a sequence (lock must be held)
+     * @param sequence Sequence between firstSequence() and endSequence()
+     * @return Batch iterator
+     */
+    std::deque<StoredBatch>::const_iterator batchAt(quint64 sequence) const;
+    
+    /**
+     * @brief Visit stored packets from index onwards (lock must be held)
+     * @param start Index of the first packet to visit
+     * @param visit Callback receiving each packet, oldest first; returns false to stop
+     */
+    template <typename Visitor>
+    void forEachPacket(int start, Visitor &&visit) const;
+    
+    /**
+     * @brief Drop the oldest packets beyond m_maxSize (lock must be held)
+     */
+    void trimToMaxSize();
+
     mutable QReadWriteLock m_lock;
-    std::deque<GenericDataPacket> m_packets;
+    std::deque<StoredBatch> m_batches;  ///< Shared batches, oldest first
+    quint64 m_firstSequence = 0;        ///< Sequence of the oldest stored packet
+    quint64 m_nextSequence = 0;         ///< Sequence of the next appended packet
+    quint64 m_clearedSequence = 0;      ///< Packets before this were cleared, not lost
     int m_maxSize;
     QStringList m_channelNames;
+    QSet<QString> m_knownChannels;      ///< Fast membership test for m_channelNames
     int m_maxChannelCount = 0;
+    QVector<int> m_sensors;             ///< Sensor keys in order of first appearance
+    QHash<int, QStringList> m_sensorChannels;   ///< Channel group per sensor key
+    
+    QMutex m_cursorMutex;               ///< Guards m_cursors and m_wakingThreads
+    QVector<PacketCursor *> m_cursors;  ///< Open cursors (not owned)
+    QVector<QThread *> m_wakingThreads; ///< Threads emitting readyRead() right now
+    QWaitCondition m_wakeDone;          ///< Signalled when a wake pass ends
 };
 
 #endif // DATABUFFER_H
@@ -0,0 +1,129 @@
+/**
+ * @file PacketCursor.h
+ * @brief Independent read position in a DataBuffer packet log
+ */
+
+#ifndef PACKETCURSOR_H
+#define PACKETCURSOR_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <atomic>
+
+#include "core/PacketBatch.h"
+
+class DataBuffer;
+
+/**
+ * @class PacketCursor
+ * @brief One consumer's position in a DataBuffer
+ *
+ * Created with DataBuffer::openCursor(). Each consumer pulls packets
+ * at its own cadence with read(); a slow consumer only delays itself.
+ * If it falls so far behind that the log has trimmed packets it has
+ * not read yet, the next read() skips them and emits fellBehind().
+ *
+ * readyRead() is emitted once when packets arrive for a cursor that
+ * had nothing unread at its last read(), so connecting it (queued or
+ * not) never floods the event queue.
+ */
+class PacketCursor : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Destructor - detaches from the log
+     */
+    ~PacketCursor() override;
+
+    /**
+     * @brief Get consumer name
+     * @return Name given to DataBuffer::openCursor()
+     */
+    QString name() const { return m_name; }
+
+    /**
+     * @brief Get sequence number of the next packet to read
+     * @return Sequence
+     */
+    quint64 position() const { return m_position; }
+
+    /**
+     * @brief Get number of unread packets still in the log
+     * @return Packet count
+     */
+    qint64 available() const;
+
+    /**
+     * @brief Read unread packets and advance
+     *
+     * Re-arms readyRead(). When maxPackets limits the read, call again
+     * until available() is 0.
+     *
+     * @param maxPackets Maximum packets to read (0 = all available)
+     * @return Shared slices of the log's batches, oldest first
+     */
+    QVector<PacketBatch> read(qint64 maxPackets = 0);
+
+    /**
+     * @brief Advance past unread packets without reading them
+     *
+     * Used by consumers that only want the newest data. Not reported
+     * as falling behind.
+     *
+     * @param count Packets to skip
+     * @return Packets skipped
+     */
+    qint64 skip(qint64 count);
+
+    /**
+     * @brief Skip everything unread (e.g. while paused)
+     */
+    void seekToEnd();
+
+    /**
+     * @brief Get packets lost because this consumer fell behind
+     * @return Total since the cursor was opened
+     */
+    quint64 lostTotal() const { return m_lostTotal; }
+
+signals:
+    /**
+     * @brief Packets became available after the cursor was drained
+     */
+    void readyRead();
+
+    /**
+     * @brief The log trimmed packets before this consumer read them
+     * @param skipped Packets lost on this read
+     */
+    void fellBehind(quint64 skipped);
+
+private:
+    friend class DataBuffer;
+
+    /**
+     * @brief Constructor (see DataBuffer::openCursor())
+     * @param log Log to read
+     * @param name Consumer name
+     * @param position First sequence to read
+     * @param parent Owner
+     */
+    PacketCursor(DataBuffer *log, const QString &name, quint64 position, QObject *parent);
+
+    /**
+     * @brief Called by the log after an append (on the appending thread)
+     * @return True if readyRead() is due, false if one is still pending
+     */
+    bool armReadyRead() { return !m_readyPending.exchange(true); }
+
+    DataBuffer *m_log = nullptr;            ///< Null once the log is destroyed
+    QString m_name;
+    quint64 m_position = 0;                 ///< Next sequence to read
+    quint64 m_lostTotal = 0;
+    std::atomic<bool> m_readyPending{false};///< readyRead() emitted, not yet read
+};
+
+#endif // PACKETCURSOR_H
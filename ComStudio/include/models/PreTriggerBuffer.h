@@ -0,0 +1,203 @@
+/**
+ * @file PreTriggerBuffer.h
+ * @brief Bounded pre-trigger history and recording trigger conditions
+ *
+ * Keeps the last N seconds / N megabytes of packets in a fixed ring
+ * of pre-allocated slots so that a recording can include what
+ * happened before the trigger fired.
+ */
+
+#ifndef PRETRIGGERBUFFER_H
+#define PRETRIGGERBUFFER_H
+
+#include <QRegularExpression>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+#include "core/GenericDataPacket.h"
+
+/**
+ * @class PreTriggerBuffer
+ * @brief Fixed-capacity ring of recent packets
+ *
+ * Slots are allocated once (on construction or setCapacity()). Pushing
+ * a packet assigns it into an existing slot; GenericDataPacket members
+ * are implicitly shared, so this only bumps reference counts and never
+ * allocates per packet. Old packets are evicted when the ring is full,
+ * older than the age limit, or when the byte estimate exceeds the limit.
+ */
+class PreTriggerBuffer
+{
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Number of pre-allocated packet slots
+     */
+    explicit PreTriggerBuffer(int capacity = 65536);
+
+    /**
+     * @brief Change number of slots (reallocates, drops history)
+     * @param capacity New slot count
+     */
+    void setCapacity(int capacity);
+
+    /**
+     * @brief Get number of slots
+     * @return Slot count
+     */
+    int capacity() const { return m_slots.size(); }
+
+    /**
+     * @brief Set maximum history age
+     * @param ms Maximum span between oldest and newest packet (0 = unlimited)
+     */
+    void setMaxAgeMs(qint64 ms) { m_maxAgeMs = ms; }
+
+    /**
+     * @brief Set maximum estimated memory held by the history
+     * @param bytes Byte limit (0 = unlimited)
+     */
+    void setMaxBytes(qint64 bytes) { m_maxBytes = bytes; }
+
+    /**
+     * @brief Add a packet, evicting old ones as needed
+     * @param packet Packet to store
+     */
+    void push(const GenericDataPacket &packet);
+
+    /**
+     * @brief Pass all stored packets (oldest first) to a callback and clear
+     * @param sink Callback receiving each packet
+     * @return Number of packets drained
+     */
+    int drain(const std::function<void(const GenericDataPacket &)> &sink);
+
+    /**
+     * @brief Drop all stored packets (keeps slots)
+     */
+    void clear();
+
+    /**
+     * @brief Get number of stored packets
+     * @return Packet count
+     */
+    int size() const { return m_count; }
+
+    /**
+     * @brief Get estimated memory held by stored packets
+     * @return Bytes
+     */
+    qint64 byteEstimate() const { return m_bytes; }
+
+    /**
+     * @brief Get time span covered by stored packets
+     * @return Span in ms
+     */
+    qint64 spanMs() const;
+
+private:
+    /**
+     * @brief Remove the oldest packet
+     */
+    void popOldest();
+
+    /**
+     * @brief Estimate memory used by a packet
+     * @param packet Packet to measure
+     * @return Approximate bytes
+     */
+    static qint64 estimateBytes(const GenericDataPacket &packet);
+
+    QVector<GenericDataPacket> m_slots;
+    QVector<qint64> m_slotBytes;
+    GenericDataPacket m_emptyPacket;    ///< Assigned to evicted slots to release data
+    int m_head = 0;                     ///< Slot of the oldest packet
+    int m_count = 0;
+    qint64 m_bytes = 0;
+    qint64 m_maxAgeMs = 10000;
+    qint64 m_maxBytes = 0;
+};
+
+/**
+ * @enum TriggerType
+ * @brief What starts a triggered recording
+ */
+enum class TriggerType {
+    Manual,             ///< User presses Start
+    ChannelThreshold,   ///< A channel crosses a threshold
+    LinePattern         ///< A raw line matches a regular expression
+};
+
+/**
+ * @enum TriggerEdge
+ * @brief Crossing direction for threshold triggers
+ */
+enum class TriggerEdge {
+    Rising,     ///< Value goes from below to at/above threshold
+    Falling,    ///< Value goes from above to at/below threshold
+    Either      ///< Any crossing
+};
+
+/**
+ * @struct TriggerConfig
+ * @brief Trigger condition settings
+ */
+struct TriggerConfig
+{
+    TriggerType type = TriggerType::Manual;
+    int channelIndex = 0;               ///< Channel (value index) for threshold trigger
+    double threshold = 0.0;             ///< Threshold level
+    TriggerEdge edge = TriggerEdge::Rising;
+    QString pattern;                    ///< Regular expression for line trigger
+};
+
+/**
+ * @class RecordingTrigger
+ * @brief Evaluates a TriggerConfig against incoming data
+ */
+class RecordingTrigger
+{
+public:
+    RecordingTrigger() = default;
+
+    /**
+     * @brief Set trigger condition and reset edge state
+     * @param config Trigger configuration
+     * @return False if the line pattern is not a valid regular expression
+     */
+    bool setConfig(const TriggerConfig &config);
+
+    /**
+     * @brief Get current trigger condition
+     * @return Trigger configuration
+     */
+    const TriggerConfig& config() const { return m_config; }
+
+    /**
+     * @brief Reset edge detection state
+     */
+    void reset() { m_hasPrevious = false; }
+
+    /**
+     * @brief Check a parsed packet (threshold triggers)
+     * @param packet Packet to check
+     * @return True if the trigger fires
+     */
+    bool checkPacket(const GenericDataPacket &packet);
+
+    /**
+     * @brief Check a raw line (pattern triggers)
+     * @param line Raw line
+     * @return True if the trigger fires
+     */
+    bool checkLine(const QString &line) const;
+
+private:
+    TriggerConfig m_config;
+    QRegularExpression m_regex;
+    double m_previousValue = 0.0;
+    bool m_hasPrevious = false;
+};
+
+#endif // PRETRIGGERBUFFER_H
@@ -10,10 +10,13 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QElapsedTimer>
+#include <QVector>
 #include <memory>
 
 #include "core/SerialManager.h"
 #include "core/GenericDataPacket.h"
+#include "core/PacketBatch.h"
 
 // Forward declarations
 class SerialSettingsWidget;
@@ -22,16 +25,28 @@ class PlotterWidget;
 class ParserConfigWidget;
 class AutoSendDialog;
 class RecordingWidget;
+class MetricsWidget;
 class ProtocolHandler;
+class BulkImporter;
+class StallWatchdog;
 class DataBuffer;
+class PipelineGraph;
 class LineParser;
+class FramedProtocol;
+class BinaryFrameProtocol;
+class FireWaterProtocol;
+class NmeaProtocol;
 class QTabWidget;
 class QDockWidget;
 class QLabel;
 class QComboBox;
 class QSplitter;
 class QStackedWidget;
+class QProgressDialog;
 struct ParserConfig;
+struct ImportStats;
+struct StallReport;
+struct MetricsSnapshot;
 struct SendPreset;
 
 /**
@@ -89,6 +104,42 @@ private slots:
      */
     void onSerialError(const QString &error);
     
+    /**
+     * @brief Report end-to-end throughput of a finished replay
+     * @param stats Replay summary from the worker
+     */
+    void onReplayFinished(const ReplayStats &stats);
+    
+    /**
+     * @brief Decimate the display while the ingest queue is overloaded
+     *
+     * Only with OverloadPolicy::DecimateDisplay; recording keeps every packet.
+     *
+     * @param overloaded True while the GUI thread is behind the reader
+     */
+    void onIngestOverloadChanged(bool overloaded);
+    
+    /**
+     * @brief Choose and load a pipeline config file
+     */
+    void onLoadPipeline();
+    
+    /**
+     * @brief Choose and load a binary frame schema
+     */
+    void onLoadFrameSchema();
+    
+    /**
+     * @brief Import a CSV/log file into the data buffer and plotter
+     */
+    void onImportData();
+    
+    /**
+     * @brief Handle end of a bulk import
+     * @param stats Import summary
+     */
+    void onImportFinished(const ImportStats &stats);
+    
     /**
      * @brief Handle raw bytes from serial
      * @param data Raw bytes
@@ -96,10 +147,10 @@ private slots:
     void onRawBytesReceived(const QByteArray &data);
     
     /**
-     * @brief Handle parsed data packet (rate-limited for display)
-     * @param packet Parsed packet
+     * @brief Handle parsed data packets (rate-limited for display)
+     * @param batch Parsed packets (shared with the buffer and terminal)
      */
-    void onDataParsed(const GenericDataPacket &packet);
+    void onDataParsed(const PacketBatch &batch);
     
     /**
      * @brief Handle raw line from parser (for terminal raw mode)
@@ -109,9 +160,9 @@ private slots:
     
     /**
      * @brief Handle all parsed data for logging (not rate-limited)
-     * @param packet Parsed packet
+     * @param batch Parsed packets
      */
-    void onDataForLogging(const GenericDataPacket &packet);
+    void onDataForLogging(const PacketBatch &batch);
     
     /**
      * @brief Handle send data from terminal
@@ -181,6 +232,29 @@ private:
      */
     void initProtocolHandler();
     
+    /**
+     * @brief Bind the pipeline endpoints and load the saved pipeline config
+     */
+    void initPipeline();
+    
+    /**
+     * @brief Replace the stage graph
+     *
+     * Falls back to the default graph (with a warning) if the file is invalid.
+     *
+     * @param path Pipeline config file (empty = default graph)
+     * @return False if the file could not be loaded
+     */
+    bool loadPipeline(const QString &path);
+    
+    /**
+     * @brief Load a binary frame schema into the "Binary Frame" protocol
+     * @param path Schema file
+     * @param quiet Only log errors (restoring settings)
+     * @return False if the file could not be loaded
+     */
+    bool loadFrameSchema(const QString &path, bool quiet = false);
+    
     /**
      * @brief Connect all signals and slots
      */
@@ -204,6 +278,7 @@ private:
     QDockWidget *m_settingsDock = nullptr;
     QDockWidget *m_parserDock = nullptr;
     QDockWidget *m_recordingDock = nullptr;
+    QDockWidget *m_metricsDock = nullptr;
     bool m_isSplitView = false;
     
     SerialSettingsWidget *m_serialSettings = nullptr;
@@ -212,6 +287,7 @@ private:
     ParserConfigWidget *m_parserConfig = nullptr;
     AutoSendDialog *m_autoSendDialog = nullptr;
     RecordingWidget *m_recordingWidget = nullptr;
+    MetricsWidget *m_metricsWidget = nullptr;
     
     // Status bar widgets
     QLabel *m_statusLabel = nullptr;
@@ -220,11 +296,28 @@ private:
     
     // Backend components
     std::unique_ptr<ProtocolHandler> m_protocolHandler;
-    std::unique_ptr<DataBuffer> m_dataBuffer;
+    std::unique_ptr<DataBuffer> m_dataBuffer;   ///< Display log (rate-limited), read by plotter and terminal
+    std::unique_ptr<DataBuffer> m_recordLog;    ///< Log of all packets, read by the recorder
+    std::unique_ptr<PipelineGraph> m_pipeline;  ///< Stage graph from serial bytes to the logs
+    QString m_pipelinePath;                     ///< Loaded pipeline config (empty = default)
+    std::unique_ptr<BulkImporter> m_importer;
+    QProgressDialog *m_importProgress = nullptr;
+    StallWatchdog *m_stallWatchdog = nullptr;
     LineParser *m_lineParser = nullptr;  // Owned by protocol handler
+    FireWaterProtocol *m_fireWater = nullptr;  // Owned by protocol handler
+    BinaryFrameProtocol *m_binaryFrame = nullptr;  // Owned by protocol handler
+    NmeaProtocol *m_nmea = nullptr;                // Owned by protocol handler
+    QVector<FramedProtocol *> m_framedProtocols;   ///< Binary protocols following the display rate
+    QString m_frameSchemaPath;                     ///< Loaded binary frame schema (empty = none)
+    
+    static constexpr int RECORD_LOG_PACKETS = 65536;   ///< Recorder backlog before packets are lost
+    static constexpr int OVERLOAD_DISPLAY_DECIMATION = 10; ///< Keep 1 of N display packets/lines under overload
     
     // State
-    quint64 m_packetCount = 0;
+    quint64 m_sessionLines = 0;      ///< Raw lines since connect (all, not rate-limited)
+    quint64 m_sessionPackets = 0;    ///< Parsed packets since connect (all, not rate-limited)
+    QElapsedTimer m_sessionClock;    ///< Started on connect
+    int m_displayDecimation = 1;     ///< Raw lines per terminal line (1 = all)
     QString m_lastRawLine;  // Last received line for test parse
 };
 
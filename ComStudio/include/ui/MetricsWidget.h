@@ -0,0 +1,132 @@
+/**
+ * @file MetricsWidget.h
+ * @brief Live view of pipeline counters, queue depths, stage latencies
+ *        and byte-to-pixel latency
+ */
+
+#ifndef METRICSWIDGET_H
+#define METRICSWIDGET_H
+
+#include <QWidget>
+
+#include "core/PipelineMetrics.h"
+#include "core/LatencyTracer.h"
+
+class QTableWidget;
+class QPushButton;
+class QTimer;
+
+/**
+ * @class MetricsWidget
+ * @brief Dock contents showing PipelineMetrics snapshots
+ *
+ * Refreshes once per second. Rates are computed between consecutive
+ * snapshots; stage latencies are per item (chunk, line, packet, frame).
+ */
+class MetricsWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor
+     * @param parent Parent widget
+     */
+    explicit MetricsWidget(QWidget *parent = nullptr);
+
+    /**
+     * @brief Get the most recent snapshot
+     * @return Snapshot
+     */
+    const MetricsSnapshot& lastSnapshot() const { return m_current; }
+
+public slots:
+    /**
+     * @brief Take a new snapshot and update the tables
+     */
+    void refresh();
+
+    /**
+     * @brief Zero all counters and histograms (including latency traces)
+     */
+    void resetMetrics();
+
+    /**
+     * @brief Log the byte-to-pixel latency report
+     */
+    void dumpLatency();
+
+signals:
+    /**
+     * @brief Emitted after each refresh
+     * @param current New snapshot
+     * @param previous Snapshot of the previous refresh
+     */
+    void snapshotUpdated(const MetricsSnapshot &current, const MetricsSnapshot &previous);
+
+private slots:
+    /**
+     * @brief Export the current snapshot as CSV
+     */
+    void onExportCsv();
+
+    /**
+     * @brief Export the current snapshot as JSON
+     */
+    void onExportJson();
+
+    /**
+     * @brief Start trace recording, or stop it and save the trace
+     * @param recording True when the button was checked
+     */
+    void onTraceToggled(bool recording);
+
+private:
+    /**
+     * @brief Set up the UI
+     */
+    void setupUi();
+
+    /**
+     * @brief Create a read-only table
+     * @param headers Column headers
+     * @param rows Row count
+     * @return Table widget
+     */
+    QTableWidget* createTable(const QStringList &headers, int rows);
+
+    /**
+     * @brief Write an export to a user-chosen file
+     * @param data File contents
+     * @param title Dialog title
+     * @param filter File dialog filter
+     * @param prefix Suggested file name prefix (timestamp is appended)
+     */
+    void saveExport(const QByteArray &data, const QString &title,
+                    const QString &filter, const QString &prefix);
+
+    /**
+     * @brief Format a duration for display
+     * @param ns Duration in ns
+     * @return Text with unit (ns/us/ms)
+     */
+    static QString formatNs(double ns);
+
+    QTableWidget *m_counterTable = nullptr;
+    QTableWidget *m_gaugeTable = nullptr;
+    QTableWidget *m_stageTable = nullptr;
+    QTableWidget *m_latencyTable = nullptr;
+    QPushButton *m_resetButton = nullptr;
+    QPushButton *m_exportCsvButton = nullptr;
+    QPushButton *m_exportJsonButton = nullptr;
+    QPushButton *m_dumpLatencyButton = nullptr;
+    QPushButton *m_traceButton = nullptr;
+    QTimer *m_refreshTimer = nullptr;
+
+    MetricsSnapshot m_current;      ///< Last snapshot
+    MetricsSnapshot m_previous;     ///< Snapshot before m_current (for rates)
+
+    static constexpr int REFRESH_INTERVAL_MS = 1000;
+};
+
+#endif // METRICSWIDGET_H
@@ -20,6 +20,7 @@
 class QComboBox;
 class QLineEdit;
 class QSpinBox;
+class QDoubleSpinBox;
 class QCheckBox;
 class QLabel;
 class QPushButton;
@@ -192,6 +193,9 @@ private:
     // X-axis controls
     QComboBox *m_xAxisSourceCombo = nullptr;
     QSpinBox *m_xAxisFieldSpin = nullptr;
+    QComboBox *m_tickBitsCombo = nullptr;       ///< Device counter width (0 = no wrap)
+    QDoubleSpinBox *m_tickRateSpin = nullptr;   ///< Device ticks per second
+    QCheckBox *m_fitDriftCheck = nullptr;
     
     // ID filter controls
     QSpinBox *m_idFieldSpin = nullptr;
@@ -202,6 +206,7 @@ private:
     QCheckBox *m_stripLabelsCheck = nullptr;
     QLineEdit *m_labelSeparatorEdit = nullptr;
     QCheckBox *m_trimWhitespaceCheck = nullptr;
+    QCheckBox *m_verifyChecksumCheck = nullptr;
     
     // Performance controls
     QSpinBox *m_displayRateSpin = nullptr;
@@ -13,11 +13,16 @@
 #include <QVector>
 #include <QTimer>
 #include <QMap>
+#include <QHash>
 #include <QSet>
 
 #include "core/GenericDataPacket.h"
+#include "core/PacketBatch.h"
+#include "core/Downsampler.h"
 
 class ChannelPlotWindow;
+class DataBuffer;
+class PacketCursor;
 
 // Forward declarations
 class QCustomPlot;
@@ -29,15 +34,9 @@ class QCheckBox;
 class QPushButton;
 class QComboBox;
 class QLabel;
-
-/**
- * @enum DownsampleMode
- * @brief Downsampling algorithm selection
- */
-enum class DownsampleMode {
-    LTTB,       ///< Largest Triangle Three Buckets - best for smooth trends
-    MinMax      ///< Min-Max bucketing - best for catching spikes/glitches
-};
+class QMenu;
+class QToolButton;
+class QAction;
 
 /**
  * @class PlotterWidget
@@ -46,6 +45,10 @@ enum class DownsampleMode {
  * Uses QCustomPlot to display time-series data with support
  * for multiple channels, auto-scaling, and configurable
  * display window.
+ *
+ * Each (sensor, channel) pair gets its own series, so packets of many
+ * sensors sharing one format do not mix. Every sensor is kept; the
+ * sensor picker only chooses which ones are drawn.
  */
 class PlotterWidget : public QWidget
 {
@@ -93,13 +96,23 @@ public:
      * @return True if OpenGL is active
      */
     bool isOpenGlEnabled() const;
+    
+    /**
+     * @brief Set the x-axis label to match the parser's timebase
+     * @param label Label text, e.g. "Time (s)" or "Sample"
+     */
+    void setXAxisLabel(const QString &label);
 
 public slots:
     /**
-     * @brief Add new data packet to plot
-     * @param packet Parsed data packet
+     * @brief Plot packets from a data log
+     *
+     * The update timer pulls new packets through its own cursor at frame
+     * rate; only the newest points that fit the buffer limit are read.
+     *
+     * @param buffer Log to read (nullptr to detach)
      */
-    void addData(const GenericDataPacket &packet);
+    void setSource(DataBuffer *buffer);
     
     /**
      * @brief Clear all plot data
@@ -202,12 +215,46 @@ private:
      * @return Color for the channel
      */
     QColor channelColor(int index) const;
+    
+    /**
+     * @brief Get the series of a sensor's channel, creating it if new
+     * @param sensorKey Sensor key (-1 = packets without ID)
+     * @param channel Channel index within the packet
+     * @return Series index (graph index)
+     */
+    int seriesFor(int sensorKey, int channel);
+    
+    /**
+     * @brief Add a sensor to the sensor picker
+     * @param sensorKey Sensor key
+     */
+    void addSensor(int sensorKey);
+    
+    /**
+     * @brief Check if a series belongs to a sensor that is picked
+     * @param series Series index
+     * @return True if its sensor is shown
+     */
+    bool isSensorShown(int series) const;
+    
+    /**
+     * @brief Show or hide every sensor
+     * @param shown True to show all
+     */
+    void setAllSensorsShown(bool shown);
+    
+    /**
+     * @brief Apply the sensor picker to graphs, legend and button text
+     */
+    void applySensorVisibility();
 
     QCustomPlot *m_plot = nullptr;
     QSpinBox *m_timeWindowSpin = nullptr;
     QSpinBox *m_bufferLimitSpin = nullptr;
     QCheckBox *m_autoScaleCheck = nullptr;
     QComboBox *m_downsampleModeCombo = nullptr;
+    QToolButton *m_sensorButton = nullptr;
+    QMenu *m_sensorMenu = nullptr;
     QPushButton *m_pauseButton = nullptr;
     QPushButton *m_clearButton = nullptr;
     QLabel *m_bufferStatusLabel = nullptr;
@@ -227,22 +274,28 @@ private:
             values.reserve(10000);
         }
     };
-    QMap<int, ChannelData> m_channelData;
+    QMap<int, ChannelData> m_channelData;   ///< Keyed by series index
     
-    // Batch data buffer (accumulate between replot cycles)
-    struct PendingData {
-        double timestamp;
-        QVector<double> values;
-    };
-    QVector<PendingData> m_pendingData;
-    static constexpr int PENDING_DATA_RESERVE = 500;
+    // Series per (sensor, channel)
+    QHash<quint64, int> m_seriesIndex;      ///< (sensor key << 32 | channel) -> series
+    QVector<int> m_seriesSensor;            ///< Sensor key per series
+    QStringList m_seriesNames;              ///< Legend name per series
+    QHash<int, QAction*> m_sensorActions;   ///< Picker entry per sensor key
+    QSet<int> m_hiddenSensors;              ///< Sensors unticked in the picker
+    
+    PacketCursor *m_cursor = nullptr;    ///< Read position in the data log (pulled per frame)
+    QVector<quint64> m_committedTraces;  ///< Traces in channel data, not yet given to graphs
+    QVector<quint64> m_replotTraces;     ///< Traces waiting for the queued replot
+    qint64 m_replotStartNs = 0;          ///< beforeReplot time while tracing (0 = off)
+    const char *m_replotPreviousStage = nullptr; ///< Active stage restored after replot
     
     double m_timeWindow = 10.0;      ///< Display window in seconds
     int m_maxDataPoints = 2000;      ///< Max points per channel (reduced for performance)
     bool m_autoScale = true;
     bool m_paused = false;
     DownsampleMode m_downsampleMode = DownsampleMode::LTTB;  ///< Current downsampling algorithm
-    qint64 m_startTime = 0;          ///< First data timestamp
+    double m_startTime = 0.0;        ///< xTime() of the first plotted packet (s)
+    bool m_hasStartTime = false;
     bool m_needsReplot = false;
     
     // Performance optimization settings
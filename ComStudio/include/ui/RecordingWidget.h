@@ -1,30 +1,53 @@
 /**
  * @file RecordingWidget.h
- * @brief Widget for CSV recording controls
+ * @brief Widget for recording controls (CSV or native binary format)
  */
 
 #ifndef RECORDINGWIDGET_H
 #define RECORDINGWIDGET_H
 
 #include <QWidget>
-#include <QFile>
-#include <QTextStream>
 #include <QVector>
+#include <memory>
 
 #include "core/GenericDataPacket.h"
+#include "core/PacketBatch.h"
+#include "core/RawCapture.h"
+#include "core/RecordingFile.h"
+#include "models/PreTriggerBuffer.h"
+
+class CsvRecordWriter;
+class DataBuffer;
+class PacketCursor;
 
 class QPushButton;
 class QCheckBox;
 class QLineEdit;
 class QLabel;
 class QSpinBox;
+class QComboBox;
+class QDoubleSpinBox;
+class QGroupBox;
+
+/**
+ * @enum RecordingFileFormat
+ * @brief Output format of a recording
+ */
+enum class RecordingFileFormat {
+    Csv,        ///< Plain CSV text
+    Native      ///< Chunked columnar binary (.csrec)
+};
 
 /**
  * @class RecordingWidget
- * @brief Widget for controlling CSV recording of parsed data
+ * @brief Widget for controlling recording of parsed data
  * 
- * Provides controls to start/stop recording, configure timestamp
- * inclusion, ID filtering, and channel selection.
+ * Provides controls to start/stop recording, choose the output
+ * format, configure timestamp inclusion, ID filtering, and
+ * conversion of native recordings to CSV. An optional pre-trigger
+ * history keeps recent packets so a recording started manually or
+ * by a trigger condition includes what happened just before it.
+ * Raw byte capture settings are forwarded to the serial worker.
  */
 class RecordingWidget : public QWidget
 {
@@ -54,32 +77,115 @@ public slots:
      * @param packet Parsed data packet
      */
     void recordPacket(const GenericDataPacket &packet);
+    
+    /**
+     * @brief Record packets from a data log
+     *
+     * The recorder pulls through its own cursor as soon as the event
+     * loop gets to it, independent of the display consumers. Packets
+     * are written straight from the shared batches; only the
+     * pre-trigger history keeps its own (implicitly shared) copies.
+     *
+     * @param buffer Log of all parsed packets (nullptr to detach)
+     */
+    void setSource(DataBuffer *buffer);
+    
+    /**
+     * @brief Check a raw line against an armed pattern trigger
+     * @param line Raw line as received
+     */
+    void checkRawLine(const QString &line);
+    
+    /**
+     * @brief Update raw capture controls from the serial worker state
+     * @param active True if capturing
+     * @param message Status message
+     */
+    void onRawCaptureStateChanged(bool active, const QString &message);
+
+signals:
+    /**
+     * @brief Emitted when the user starts raw byte capture
+     * @param settings Capture configuration
+     */
+    void rawCaptureStartRequested(const RawCaptureSettings &settings);
+    
+    /**
+     * @brief Emitted when the user stops raw byte capture
+     */
+    void rawCaptureStopRequested();
 
 private slots:
     void onStartStopClicked();
     void onBrowseClicked();
+    void onFormatChanged(int index);
+    void onExportCsvClicked();
+    void onTriggerNowClicked();
+    void onTriggerTypeChanged(int index);
+    void onPreTriggerSettingsChanged();
+    void onRawCaptureClicked();
+    void onRawCaptureBrowseClicked();
+    void drainSource();
+    void onFellBehind(quint64 skipped);
 
 private:
     void setupUi();
+    QGroupBox* createPreTriggerGroup();
+    QGroupBox* createRawCaptureGroup();
     bool startRecording();
     void stopRecording();
-    void writeHeader();
-    void writePacket(const GenericDataPacket &packet);
+    bool armTrigger();
+    void disarmTrigger();
+    void fireTrigger(const QString &reason);
+    int flushPreTrigger();
+    void writeRecord(const GenericDataPacket &packet);
+    bool passesIdFilter(const GenericDataPacket &packet) const;
+    void setSettingsEnabled(bool enabled);
+    void updateStartButtonText();
+    RecordingFileFormat currentFormat() const;
+    TriggerConfig currentTriggerConfig() const;
     
     QPushButton *m_startStopButton = nullptr;
     QPushButton *m_browseButton = nullptr;
     QLineEdit *m_filePathEdit = nullptr;
+    QComboBox *m_formatCombo = nullptr;
+    QPushButton *m_exportCsvButton = nullptr;
     QCheckBox *m_timestampCheck = nullptr;
     QCheckBox *m_idFilterCheck = nullptr;
     QSpinBox *m_idFilterSpin = nullptr;
     QLabel *m_statusLabel = nullptr;
     
-    QFile m_file;
-    QTextStream m_stream;
+    // Pre-trigger controls
+    QGroupBox *m_preTriggerGroup = nullptr;
+    QSpinBox *m_historySecondsSpin = nullptr;
+    QSpinBox *m_historyMegabytesSpin = nullptr;
+    QComboBox *m_triggerTypeCombo = nullptr;
+    QSpinBox *m_triggerChannelSpin = nullptr;
+    QDoubleSpinBox *m_triggerLevelSpin = nullptr;
+    QComboBox *m_triggerEdgeCombo = nullptr;
+    QLineEdit *m_triggerPatternEdit = nullptr;
+    QPushButton *m_triggerNowButton = nullptr;
+    
+    // Raw capture controls
+    QLineEdit *m_rawPathEdit = nullptr;
+    QPushButton *m_rawBrowseButton = nullptr;
+    QCheckBox *m_rawCompressCheck = nullptr;
+    QSpinBox *m_rawRotateMegabytesSpin = nullptr;
+    QSpinBox *m_rawRotateMinutesSpin = nullptr;
+    QPushButton *m_rawCaptureButton = nullptr;
+    QLabel *m_rawStatusLabel = nullptr;
+    bool m_rawCapturing = false;
+    
+    PreTriggerBuffer m_preTrigger{1};   ///< Slots allocated when history is enabled
+    RecordingTrigger m_trigger;
+    bool m_armed = false;
+    
+    std::unique_ptr<RecordingWriter> m_nativeWriter;  ///< Active only for native format
+    std::unique_ptr<CsvRecordWriter> m_csvWriter;     ///< Active only for CSV format
     bool m_isRecording = false;
-    bool m_headerWritten = false;
     int m_recordCount = 0;
-    int m_maxChannelsSeen = 0;
+    quint64 m_lostCount = 0;            ///< Packets the log trimmed before they were recorded
+    PacketCursor *m_cursor = nullptr;   ///< Read position in the packet log
 };
 
 #endif // RECORDINGWIDGET_H
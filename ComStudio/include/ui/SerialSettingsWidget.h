@@ -3,7 +3,8 @@
  * @brief Widget for configuring serial port settings
  *
  * Provides UI controls for selecting port, baud rate, data bits,
- * parity, stop bits, and flow control. Also handles connect/disconnect.
+ * parity, stop bits, and flow control. Also handles connect/disconnect
+ * and selection of virtual sources (file replay, data generator).
  */
 
 #ifndef SERIALSETTINGSWIDGET_H
@@ -18,6 +19,11 @@
 class QComboBox;
 class QPushButton;
 class QLabel;
+class QLineEdit;
+class QCheckBox;
+class QDoubleSpinBox;
+class QSpinBox;
+class QGroupBox;
 
 /**
  * @class SerialSettingsWidget
@@ -88,6 +94,17 @@ private slots:
      * @brief Handle Refresh button click
      */
     void onRefreshClicked();
+    
+    /**
+     * @brief Show the controls for the selected source kind
+     * @param index Source combo index
+     */
+    void onSourceKindChanged(int index);
+    
+    /**
+     * @brief Choose a replay file
+     */
+    void onReplayBrowseClicked();
 
 private:
     /**
@@ -95,6 +112,12 @@ private:
      */
     void setupUi();
     
+    /**
+     * @brief Create the data generator settings group
+     * @return Group box
+     */
+    QGroupBox* createGeneratorGroup();
+    
     /**
      * @brief Populate combo boxes with options
      */
@@ -107,17 +130,37 @@ private:
     void updateConnectionState(bool connected);
 
     // UI Elements
+    QComboBox *m_sourceCombo = nullptr;
     QComboBox *m_portCombo = nullptr;
     QComboBox *m_baudRateCombo = nullptr;
     QComboBox *m_dataBitsCombo = nullptr;
     QComboBox *m_parityCombo = nullptr;
     QComboBox *m_stopBitsCombo = nullptr;
     QComboBox *m_flowControlCombo = nullptr;
+    QComboBox *m_overloadCombo = nullptr;
     
     QPushButton *m_connectButton = nullptr;
     QPushButton *m_disconnectButton = nullptr;
     QPushButton *m_refreshButton = nullptr;
     
+    // Replay source
+    QGroupBox *m_replayGroup = nullptr;
+    QLineEdit *m_replayPathEdit = nullptr;
+    QPushButton *m_replayBrowseButton = nullptr;
+    QDoubleSpinBox *m_replaySpeedSpin = nullptr;
+    QCheckBox *m_replayMaxSpeedCheck = nullptr;
+    
+    // Generator source
+    QGroupBox *m_generatorGroup = nullptr;
+    QComboBox *m_generatorFormatCombo = nullptr;
+    QSpinBox *m_generatorChannelsSpin = nullptr;
+    QSpinBox *m_generatorRateSpin = nullptr;
+    QCheckBox *m_generatorBaudLimitCheck = nullptr;
+    QDoubleSpinBox *m_generatorNoiseSpin = nullptr;
+    QDoubleSpinBox *m_generatorSpikeSpin = nullptr;
+    QDoubleSpinBox *m_generatorMalformedSpin = nullptr;
+    QSpinBox *m_generatorSensorsSpin = nullptr;
+    
     QLabel *m_statusLabel = nullptr;
     
     bool m_isConnected = false;
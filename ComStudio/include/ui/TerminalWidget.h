@@ -20,6 +20,10 @@
 #include <QElapsedTimer>
 
 #include "core/GenericDataPacket.h"
+#include "core/PacketBatch.h"
+
+class DataBuffer;
+class PacketCursor;
 
 /**
  * @enum DisplayMode
@@ -105,10 +109,15 @@ public slots:
     void appendRawLine(const QString &line);
     
     /**
-     * @brief Append parsed data packet (batched for performance)
-     * @param packet Parsed packet
+     * @brief Show parsed packets from a data log (Parsed mode)
+     *
+     * New packets are pulled through the terminal's own cursor on the
+     * flush timer; at most MAX_PENDING_PACKETS of the newest are shown
+     * per flush.
+     *
+     * @param buffer Log to read (nullptr to detach)
      */
-    void appendPacket(const GenericDataPacket &packet);
+    void setSource(DataBuffer *buffer);
     
     /**
      * @brief Clear terminal content
@@ -128,6 +137,11 @@ signals:
     void sendData(const QByteArray &data);
 
 private slots:
+    /**
+     * @brief New packets are in the log; schedule a flush
+     */
+    void onPacketsAvailable();
+    
     /**
      * @brief Handle display mode change
      * @param index Combo box index
@@ -151,6 +165,8 @@ private slots:
     void onFlushTimer();
 
 private:
+    friend class ComStudioBench;    ///< Benchmarks formatPacket()
+    
     /**
      * @brief Set up the UI
      */
@@ -168,7 +184,7 @@ private:
      * @param packet Parsed packet
      * @return Formatted string
      */
-    QString formatPacket(const GenericDataPacket &packet) const;
+    static QString formatPacket(const GenericDataPacket &packet);
     
     /**
      * @brief Trim excess lines from terminal
@@ -196,10 +212,11 @@ private:
     // Batched update optimization
     QTimer *m_flushTimer = nullptr;
     QString m_pendingRawText;          ///< Buffered raw text
-    QVector<GenericDataPacket> m_pendingPackets;  ///< Buffered packets for parsed mode
+    int m_pendingRawLines = 0;         ///< Lines in m_pendingRawText (metrics)
+    PacketCursor *m_cursor = nullptr;  ///< Read position in the data log (parsed mode)
     static constexpr int FLUSH_INTERVAL_MS = 50;  ///< Batch flush interval (~20 FPS)
     static constexpr int MAX_PENDING_CHARS = 8192; ///< Max chars before forced flush
-    static constexpr int MAX_PENDING_PACKETS = 100; ///< Max packets before forced flush
+    static constexpr int MAX_PENDING_PACKETS = 100; ///< Max packets shown per flush (newest)
 };
 
 #endif // TERMINALWIDGET_H
@@ -0,0 +1,253 @@
+/**
+ * @file CliPipeline.cpp
+ * @brief Implementation of CliPipeline
+ */
+
+#include "cli/CliPipeline.h"
+#include "core/LineParser.h"
+#include "core/CsvRecordWriter.h"
+#include "core/RecordingFile.h"
+#include "core/PipelineGraph.h"
+
+#include <QTimer>
+#include <QTextStream>
+
+namespace {
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+} // namespace
+
+CliPipeline::CliPipeline(const CliOptions &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+{
+    m_statsTimer = new QTimer(this);
+    connect(m_statsTimer, &QTimer::timeout, this, &CliPipeline::onStatsTimer);
+
+    m_durationTimer = new QTimer(this);
+    m_durationTimer->setSingleShot(true);
+    connect(m_durationTimer, &QTimer::timeout, this, [this]() {
+        finish(0, QStringLiteral("duration reached"));
+    });
+}
+
+CliPipeline::~CliPipeline()
+{
+    m_pipeline.reset();
+    if (m_csvWriter) {
+        m_csvWriter->close();
+    }
+    if (m_nativeWriter) {
+        m_nativeWriter->close();
+    }
+}
+
+bool CliPipeline::start()
+{
+    if (!m_options.outputPath.isEmpty()) {
+        if (m_options.nativeFormat) {
+            m_nativeWriter = std::make_unique<RecordingWriter>();
+            if (!m_nativeWriter->open(m_options.outputPath)) {
+                m_errorString = m_nativeWriter->errorString();
+                m_nativeWriter.reset();
+                return false;
+            }
+        } else {
+            m_csvWriter = std::make_unique<CsvRecordWriter>(m_options.includeTimestamp);
+            if (!m_csvWriter->open(m_options.outputPath)) {
+                m_errorString = m_csvWriter->errorString();
+                m_csvWriter.reset();
+                return false;
+            }
+        }
+    }
+
+    // Every packet is recorded; the display rate limit does not apply
+    m_parser = std::make_unique<LineParser>(m_options.parser);
+    m_parser->setRateLimitEnabled(false);
+    connect(m_parser.get(), &LineParser::batchForLogging, this, &CliPipeline::onBatch);
+    
+    if (!m_options.pipelinePath.isEmpty()) {
+        m_pipeline = std::make_unique<PipelineGraph>();
+        m_pipeline->bindSink("record", [this](const PacketBatch &batch) { onBatch(batch); });
+        if (!m_pipeline->loadFile(m_options.pipelinePath)) {
+            m_errorString = m_pipeline->errorString();
+            m_pipeline.reset();
+            return false;
+        }
+    }
+
+    SerialManager &serial = SerialManager::instance();
+    connect(&serial, &SerialManager::rawBytesReady, this, &CliPipeline::onRawBytes);
+    connect(&serial, &SerialManager::connectionStateChanged,
+            this, &CliPipeline::onConnectionStateChanged);
+    connect(&serial, &SerialManager::errorOccurred, this, &CliPipeline::onError);
+    connect(&serial, &SerialManager::replayFinished, this, &CliPipeline::onReplayFinished);
+    connect(&serial, &SerialManager::rawCaptureStateChanged,
+            this, [](bool, const QString &message) {
+                err() << "raw capture: " << message << Qt::endl;
+            });
+
+    m_clock.start();
+    PipelineMetrics::instance().reset();
+    serial.connectPort(m_options.serial);
+
+    if (m_options.durationMs > 0) {
+        m_durationTimer->start(static_cast<int>(m_options.durationMs));
+    }
+    if (m_options.statsIntervalMs > 0) {
+        m_statsTimer->start(m_options.statsIntervalMs);
+    }
+    return true;
+}
+
+void CliPipeline::stop()
+{
+    finish(0, QStringLiteral("interrupted"));
+}
+
+void CliPipeline::onRawBytes(const QByteArray &data)
+{
+    if (m_pipeline) {
+        m_pipeline->feed("serial", data);
+    } else {
+        m_parser->parse(data);
+    }
+}
+
+void CliPipeline::onBatch(const PacketBatch &batch)
+{
+    for (const GenericDataPacket &packet : batch) {
+        if (m_options.maxPackets > 0 && m_packets >= m_options.maxPackets) {
+            return;
+        }
+
+        if (m_csvWriter) {
+            m_csvWriter->append(packet);
+        } else if (m_nativeWriter && !m_nativeWriter->append(packet) && m_writeError.isEmpty()) {
+            m_writeError = m_nativeWriter->errorString();
+        }
+
+        m_packets++;
+        if (m_options.maxPackets > 0 && m_packets >= m_options.maxPackets) {
+            finish(0, QStringLiteral("packet limit reached"));
+        }
+    }
+}
+
+void CliPipeline::onConnectionStateChanged(bool connected, const QString &message)
+{
+    err() << message << Qt::endl;
+
+    if (connected) {
+        m_connected = true;
+        if (!m_options.rawCapture.path.isEmpty()) {
+            SerialManager::instance().startRawCapture(m_options.rawCapture);
+        }
+        return;
+    }
+
+    const bool wasConnected = m_connected;
+    m_connected = false;
+    if (m_finished) {
+        // Port closed after finish(): chunks queued before it are parsed
+        complete();
+    } else if (wasConnected && m_options.serial.kind != PortKind::Replay) {
+        finish(1, QStringLiteral("disconnected"));
+    }
+    // A replay that ends on its own finishes from onReplayFinished()
+}
+
+void CliPipeline::onError(const QString &error)
+{
+    err() << "error: " << error << Qt::endl;
+    if (!m_connected && !m_finished) {
+        finish(1, QStringLiteral("could not open source"));
+    }
+}
+
+void CliPipeline::onReplayFinished(const ReplayStats &stats)
+{
+    err() << QString("replay: %1 bytes in %2 ms%3")
+        .arg(stats.bytes)
+        .arg(stats.elapsedNs / 1000000)
+        .arg(stats.completed ? QString() : QStringLiteral(" (stopped early)")) << Qt::endl;
+    finish(stats.completed ? 0 : 1, QStringLiteral("replay finished"));
+}
+
+void CliPipeline::onStatsTimer()
+{
+    const MetricsSnapshot current = PipelineMetrics::instance().snapshot();
+    err() << QString("%1 s: %2 packets (%3/s), %4 KiB/s, %5 parse errors")
+        .arg(m_clock.elapsed() / 1000)
+        .arg(m_packets)
+        .arg(current.rate(MetricCounter::PacketsParsed, m_lastStats), 0, 'f', 0)
+        .arg(current.rate(MetricCounter::BytesRead, m_lastStats) / 1024.0, 0, 'f', 1)
+        .arg(current.counter(MetricCounter::ParseErrors)) << Qt::endl;
+    m_lastStats = current;
+}
+
+void CliPipeline::finish(int exitCode, const QString &reason)
+{
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+    m_exitCode = exitCode;
+    m_stopReason = reason;
+    m_statsTimer->stop();
+    m_durationTimer->stop();
+
+    if (!m_connected) {
+        complete();
+        return;
+    }
+
+    // Raw capture is flushed by the worker before it closes the port;
+    // complete() follows from onConnectionStateChanged(false)
+    SerialManager &serial = SerialManager::instance();
+    if (!m_options.rawCapture.path.isEmpty()) {
+        serial.stopRawCapture();
+    }
+    serial.disconnectPort();
+}
+
+void CliPipeline::complete()
+{
+    // Batches still inside pool or pinned stages reach the sinks first
+    if (m_pipeline) {
+        m_pipeline->clear();
+    }
+    if (m_csvWriter && !m_csvWriter->close() && m_writeError.isEmpty()) {
+        m_writeError = m_csvWriter->errorString();
+    }
+    if (m_nativeWriter && !m_nativeWriter->close() && m_writeError.isEmpty()) {
+        m_writeError = m_nativeWriter->errorString();
+    }
+    m_csvWriter.reset();
+    m_nativeWriter.reset();
+
+    const MetricsSnapshot metrics = PipelineMetrics::instance().snapshot();
+    err() << QString("stopped (%1) after %2 ms: %3 bytes, %4 packets recorded, %5 parse errors")
+        .arg(m_stopReason)
+        .arg(m_clock.elapsed())
+        .arg(metrics.counter(MetricCounter::BytesRead))
+        .arg(m_packets)
+        .arg(metrics.counter(MetricCounter::ParseErrors)) << Qt::endl;
+    if (metrics.counter(MetricCounter::ChunksDropped) > 0) {
+        err() << QString("overload: %1 chunks (%2 bytes) dropped")
+            .arg(metrics.counter(MetricCounter::ChunksDropped))
+            .arg(metrics.counter(MetricCounter::BytesDropped)) << Qt::endl;
+    }
+    if (!m_writeError.isEmpty()) {
+        err() << "write error: " << m_writeError << Qt::endl;
+        m_exitCode = 1;
+    }
+
+    emit finished(m_exitCode);
+}
@@ -0,0 +1,203 @@
+/**
+ * @file main.cpp
+ * @brief comstudio-cli entry point (headless capture -> parse -> record)
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFileInfo>
+#include <QSerialPortInfo>
+#include <QTextStream>
+#include <QTimer>
+#include <atomic>
+#include <csignal>
+
+#include "cli/CliPipeline.h"
+#include "core/RecordingFile.h"
+
+namespace {
+
+std::atomic<bool> g_interrupted{false};
+
+void onSignal(int)
+{
+    g_interrupted.store(true);
+}
+
+QVector<int> parseIntList(const QString &text, bool *ok)
+{
+    QVector<int> values;
+    *ok = true;
+    for (const QString &part : text.split(',', Qt::SkipEmptyParts)) {
+        values.append(part.trimmed().toInt(ok));
+        if (!*ok) {
+            break;
+        }
+    }
+    return values;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("comstudio-cli");
+    QCoreApplication::setApplicationVersion("0.1");
+    QCoreApplication::setOrganizationName("ComStudio");
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless serial capture, parse and record");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    const QCommandLineOption listOption("list-ports", "List serial ports and exit.");
+    const QCommandLineOption portOption({"p", "port"}, "Serial port to open.", "name");
+    const QCommandLineOption baudOption({"b", "baud"}, "Baud rate (default 115200).", "rate", "115200");
+    const QCommandLineOption replayOption("replay", "Replay a .csraw capture or text log instead of a port.", "file");
+    const QCommandLineOption speedOption("replay-speed", "Replay time multiplier, 0.1 to 1000 (default 1).", "factor", "1");
+    const QCommandLineOption maxSpeedOption("max-speed", "Replay as fast as the parser keeps up.");
+    const QCommandLineOption generateOption("generate", "Use the synthetic data generator (lines/s).", "rate");
+    const QCommandLineOption overloadOption("overload", "When parsing falls behind: block, drop-oldest, drop-newest\n"
+                                            "or decimate (default; same as block without a display).", "policy");
+    const QCommandLineOption queueChunksOption("queue-chunks", "Read chunks queued before the overload policy applies.", "count");
+    const QCommandLineOption delimiterOption({"d", "delimiter"}, "Field delimiter (default ',').", "text", ",");
+    const QCommandLineOption fieldsOption("fields", "Fields to record, e.g. 0,1,2 (default all).", "list");
+    const QCommandLineOption namesOption("names", "Channel names, e.g. X,Y,Z.", "list");
+    const QCommandLineOption idFieldOption("id-field", "Field holding the sensor ID.", "index");
+    const QCommandLineOption acceptIdOption("accept-id", "Only record this sensor ID.", "id");
+    const QCommandLineOption pipelineOption("pipeline", "Stage graph config (JSON); its \"record\" sink is recorded.", "file");
+    const QCommandLineOption labelsOption("strip-labels", "Strip 'label:' prefixes from values.");
+    const QCommandLineOption checksumOption("checksum", "Drop lines without a valid NMEA-style '*XX' checksum.");
+    const QCommandLineOption outputOption({"o", "output"}, "Record parsed packets to this file.", "file");
+    const QCommandLineOption formatOption("format", "csv or native (default: from the file suffix).", "format");
+    const QCommandLineOption noTimestampOption("no-timestamp", "Omit the CSV Timestamp column.");
+    const QCommandLineOption rawOption("raw", "Also capture raw bytes to this .csraw file.", "file");
+    const QCommandLineOption rawCompressOption("raw-compress", "Compress raw capture blocks.");
+    const QCommandLineOption durationOption({"t", "duration"}, "Stop after this many seconds.", "seconds");
+    const QCommandLineOption packetsOption({"n", "packets"}, "Stop after this many packets.", "count");
+    const QCommandLineOption statsOption("stats", "Print throughput every N seconds.", "seconds");
+
+    parser.addOptions({listOption, portOption, baudOption, replayOption, speedOption, maxSpeedOption,
+                       generateOption, overloadOption, queueChunksOption, delimiterOption, fieldsOption,
+                       namesOption, idFieldOption, acceptIdOption, pipelineOption, labelsOption, checksumOption,
+                       outputOption, formatOption, noTimestampOption, rawOption, rawCompressOption,
+                       durationOption, packetsOption, statsOption});
+    parser.process(app);
+
+    if (parser.isSet(listOption)) {
+        for (const QSerialPortInfo &info : SerialManager::availablePorts()) {
+            out << info.portName() << '\t' << info.description() << Qt::endl;
+        }
+        return 0;
+    }
+
+    CliOptions options;
+    bool ok = true;
+
+    // Source
+    if (parser.isSet(replayOption)) {
+        options.serial.kind = PortKind::Replay;
+        options.serial.replayPath = parser.value(replayOption);
+        options.serial.replaySpeed = parser.value(speedOption).toDouble(&ok);
+        options.serial.replayMaxSpeed = parser.isSet(maxSpeedOption);
+        if (ok && (options.serial.replaySpeed < 0.1 || options.serial.replaySpeed > 1000.0)) {
+            err << "--replay-speed must be between 0.1 and 1000" << Qt::endl;
+            return 2;
+        }
+    } else if (parser.isSet(generateOption)) {
+        options.serial.kind = PortKind::Generator;
+        options.serial.generator.linesPerSecond = parser.value(generateOption).toDouble(&ok);
+    } else if (parser.isSet(portOption)) {
+        options.serial.portName = parser.value(portOption);
+        options.serial.baudRate = parser.value(baudOption).toInt(&ok);
+    } else {
+        err << "No source: use --port, --replay or --generate (see --help)" << Qt::endl;
+        return 2;
+    }
+    if (ok && parser.isSet(overloadOption)) {
+        options.serial.ingest.policy = IngestQueueSettings::policyFromName(parser.value(overloadOption), &ok);
+    }
+    if (ok && parser.isSet(queueChunksOption)) {
+        options.serial.ingest.maxChunks = parser.value(queueChunksOption).toInt(&ok);
+        ok = ok && options.serial.ingest.maxChunks > 0;
+    }
+    if (!ok) {
+        err << "Invalid source option" << Qt::endl;
+        return 2;
+    }
+
+    // Parser
+    options.parser.delimiter = parser.value(delimiterOption);
+    options.parser.stripLabels = parser.isSet(labelsOption);
+    options.parser.verifyChecksum = parser.isSet(checksumOption);
+    if (parser.isSet(fieldsOption)) {
+        options.parser.dataFields = parseIntList(parser.value(fieldsOption), &ok);
+    }
+    if (parser.isSet(namesOption)) {
+        options.parser.channelNames = parser.value(namesOption).split(',');
+    }
+    if (ok && parser.isSet(idFieldOption)) {
+        options.parser.idFieldIndex = parser.value(idFieldOption).toInt(&ok);
+    }
+    options.parser.acceptSensorId = parser.value(acceptIdOption);
+    options.pipelinePath = parser.value(pipelineOption);
+    if (!ok) {
+        err << "Invalid parser option" << Qt::endl;
+        return 2;
+    }
+
+    // Outputs
+    options.outputPath = parser.value(outputOption);
+    const QString format = parser.isSet(formatOption)
+        ? parser.value(formatOption).toLower()
+        : (QFileInfo(options.outputPath).suffix() == RecordingFormat::FileSuffix
+               ? QStringLiteral("native") : QStringLiteral("csv"));
+    if (format != "csv" && format != "native") {
+        err << "Unknown format: " << format << Qt::endl;
+        return 2;
+    }
+    options.nativeFormat = format == "native";
+    options.includeTimestamp = !parser.isSet(noTimestampOption);
+    options.rawCapture.path = parser.value(rawOption);
+    options.rawCapture.compress = parser.isSet(rawCompressOption);
+
+    // Stop conditions
+    if (parser.isSet(durationOption)) {
+        options.durationMs = static_cast<qint64>(parser.value(durationOption).toDouble(&ok) * 1000);
+    }
+    if (ok && parser.isSet(packetsOption)) {
+        options.maxPackets = parser.value(packetsOption).toULongLong(&ok);
+    }
+    if (ok && parser.isSet(statsOption)) {
+        options.statsIntervalMs = static_cast<int>(parser.value(statsOption).toDouble(&ok) * 1000);
+    }
+    if (!ok) {
+        err << "Invalid stop condition" << Qt::endl;
+        return 2;
+    }
+
+    CliPipeline pipeline(options);
+    QObject::connect(&pipeline, &CliPipeline::finished, &app, &QCoreApplication::exit,
+                     Qt::QueuedConnection);
+    if (!pipeline.start()) {
+        err << "Cannot start: " << pipeline.errorString() << Qt::endl;
+        return 1;
+    }
+
+    // Ctrl+C / SIGTERM stop the pipeline cleanly (outputs are closed)
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    QTimer signalPoll;
+    QObject::connect(&signalPoll, &QTimer::timeout, &pipeline, [&pipeline]() {
+        if (g_interrupted.exchange(false)) {
+            pipeline.stop();
+        }
+    });
+    signalPoll.start(100);
+
+    return app.exec();
+}
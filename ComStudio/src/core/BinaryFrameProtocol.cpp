@@ -0,0 +1,196 @@
+/**
+ * @file BinaryFrameProtocol.cpp
+ * @brief Implementation of BinaryFrameProtocol
+ */
+
+#include "core/BinaryFrameProtocol.h"
+#include "core/PipelineMetrics.h"
+#include "core/LatencyTracer.h"
+#include "core/TraceRecorder.h"
+
+BinaryFrameProtocol::BinaryFrameProtocol(QObject *parent)
+    : FramedProtocol(parent)
+{
+}
+
+QString BinaryFrameProtocol::description() const
+{
+    if (!m_decoder.isValid()) {
+        return QStringLiteral("Custom binary frames (no schema loaded)");
+    }
+    QString text = QString("Schema '%1': %2 channels, %3-byte frames")
+        .arg(m_decoder.schema().name)
+        .arg(m_decoder.channelNames().size())
+        .arg(m_decoder.minFrameSize());
+    if (framer()) {
+        text += QString(" in %1 framing").arg(framer()->name());
+    }
+    return text;
+}
+
+void BinaryFrameProtocol::reset()
+{
+    m_buffer.clear();
+    FramedProtocol::reset();
+}
+
+bool BinaryFrameProtocol::setSchema(const FrameSchema &schema)
+{
+    FrameDecoder decoder;
+    if (!decoder.compile(schema)) {
+        m_errorString = decoder.errorString();
+        return false;
+    }
+    return useDecoder(decoder);
+}
+
+bool BinaryFrameProtocol::loadSchema(const QString &path)
+{
+    FrameDecoder decoder;
+    if (!decoder.loadFile(path)) {
+        m_errorString = decoder.errorString();
+        return false;
+    }
+    return useDecoder(decoder);
+}
+
+bool BinaryFrameProtocol::useDecoder(const FrameDecoder &decoder)
+{
+    std::unique_ptr<Framer> newFramer;
+    if (!decoder.schema().framing.isEmpty()) {
+        newFramer = Framer::create(decoder.schema().framing, m_errorString);
+        if (!newFramer) {
+            return false;
+        }
+    }
+    m_decoder = decoder;
+    setFramer(std::move(newFramer));
+    m_errorString.clear();
+    reset();
+    return true;
+}
+
+FrameClaim BinaryFrameProtocol::claimFrame(QByteArrayView data) const
+{
+    if (framer()) {
+        return FramedProtocol::claimFrame(data);
+    }
+    if (!m_decoder.isValid() || m_decoder.schema().sync.isEmpty()) {
+        return FrameClaim::noMatch();
+    }
+    const QByteArrayView sync(m_decoder.schema().sync);
+    if (data.size() < sync.size()) {
+        return sync.startsWith(data) ? FrameClaim::needMore() : FrameClaim::noMatch();
+    }
+    if (!data.startsWith(sync)) {
+        return FrameClaim::noMatch();
+    }
+
+    const qsizetype length = m_decoder.frameLength(data);
+    if (length < 0) {
+        return FrameClaim::noMatch();
+    }
+    if (length == 0 || data.size() < length) {
+        return FrameClaim::needMore();
+    }
+    return m_decoder.checksumOk(data.first(length)) ? FrameClaim::match(length) : FrameClaim::noMatch();
+}
+
+void BinaryFrameProtocol::parse(const QByteArray &data)
+{
+    if (framer()) {
+        FramedProtocol::parse(data);
+        return;
+    }
+    TRACE_SCOPE("BinaryFrameProtocol::parse");
+    if (!m_decoder.isValid()) {
+        return;
+    }
+    auto &metrics = PipelineMetrics::instance();
+
+    m_buffer.append(data);
+    const QByteArrayView view(m_buffer);
+    const QByteArrayView sync(m_decoder.schema().sync);
+
+    qsizetype pos = 0;
+    while (pos < view.size()) {
+        if (!sync.isEmpty()) {
+            const qsizetype start = view.indexOf(sync, pos);
+            if (start < 0) {
+                // Keep what could be the start of a split sync sequence
+                pos = qMax(pos, view.size() - (sync.size() - 1));
+                break;
+            }
+            pos = start;
+        }
+
+        const QByteArrayView rest = view.sliced(pos);
+        const qsizetype length = m_decoder.frameLength(rest);
+        if (length == 0 || (length > 0 && rest.size() < length)) {
+            break;  // Wait for the rest of the frame
+        }
+        if (length < 0) {
+            metrics.add(MetricCounter::ParseErrors);
+            emit parseError("Frame length out of range",
+                            rest.first(qMin<qsizetype>(rest.size(), m_decoder.minFrameSize())).toByteArray());
+            pos++;
+            continue;
+        }
+        const QByteArrayView frame = rest.first(length);
+        if (!m_decoder.checksumOk(frame)) {
+            metrics.add(MetricCounter::ChecksumRejects);
+            metrics.add(MetricCounter::ParseErrors);
+            emit parseError("Frame checksum mismatch", frame.toByteArray());
+            pos++;
+            continue;
+        }
+
+        decodeFrame(frame.data());
+        pos += length;
+    }
+    m_buffer.remove(0, pos);
+
+    metrics.setGauge(MetricGauge::ParserBufferBytes, m_buffer.size());
+    publishBatches();
+}
+
+void BinaryFrameProtocol::processFrame(QByteArrayView frame)
+{
+    // The framer already delimited the frame; check it against the layout
+    auto &metrics = PipelineMetrics::instance();
+    const char *error = nullptr;
+    if (!frame.startsWith(QByteArrayView(m_decoder.schema().sync))) {
+        error = "Frame does not start with the sync bytes";
+    } else if (m_decoder.frameLength(frame) != frame.size()) {
+        error = "Frame size does not match the schema";
+    } else if (!m_decoder.checksumOk(frame)) {
+        metrics.add(MetricCounter::ChecksumRejects);
+        error = "Frame checksum mismatch";
+    }
+    if (error) {
+        metrics.add(MetricCounter::ParseErrors);
+        emit parseError(error, frame.toByteArray());
+        return;
+    }
+    decodeFrame(frame.data());
+}
+
+void BinaryFrameProtocol::decodeFrame(const char *frame)
+{
+    GenericDataPacket packet;
+    packet.packetIndex = nextPacketIndex();
+    packet.traceId = LatencyTracer::instance().currentTrace();
+    {
+        StageTimer timer(MetricStage::Parse);
+        const QStringList &names = m_decoder.channelNames();
+        packet.values.resize(names.size());
+        packet.channelNames = names;    // Shared with the decoder, no copy
+        m_decoder.decode(frame, packet.values.data());
+        for (int i = 0; i < names.size(); ++i) {
+            packet.channels.insert(names.at(i), packet.values.at(i));
+        }
+        packet.isValid = true;
+    }
+    LatencyTracer::instance().mark(packet.traceId, LatencyStage::Parse);
+    addPacket(std::move(packet));
+}
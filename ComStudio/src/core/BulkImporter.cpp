@@ -0,0 +1,309 @@
+/**
+ * @file BulkImporter.cpp
+ * @brief Implementation of BulkImporter
+ */
+
+#include "core/BulkImporter.h"
+#include "core/LineParser.h"
+#include "core/Checksum.h"
+
+#include <QDateTime>
+#include <QThread>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Find the next line ending in [pos, end)
+ * @return Pointer to the line ending, or nullptr if none
+ */
+const char *findLineEnding(const char *pos, const char *end, const QByteArray &ending)
+{
+    const char first = ending.at(0);
+    const qsizetype length = ending.size();
+    while (pos < end) {
+        const void *hit = std::memchr(pos, first, static_cast<size_t>(end - pos));
+        if (!hit) {
+            return nullptr;
+        }
+        const char *candidate = static_cast<const char *>(hit);
+        if (length == 1 || (end - candidate >= length
+                            && std::memcmp(candidate, ending.constData(), length) == 0)) {
+            return candidate;
+        }
+        pos = candidate + 1;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+BulkImporter::BulkImporter(QObject *parent)
+    : QObject(parent)
+{
+}
+
+BulkImporter::~BulkImporter()
+{
+    // Tasks reference the mapped file; wait before QFile unmaps it
+    m_cancelled = true;
+    m_pool.waitForDone();
+}
+
+QVector<QPair<qint64, qint64>> BulkImporter::splitLineAligned(const char *data, qint64 size,
+                                                                qint64 chunkSize)
+{
+    QVector<QPair<qint64, qint64>> chunks;
+    chunkSize = qMax<qint64>(4096, chunkSize);
+
+    qint64 offset = 0;
+    while (offset < size) {
+        qint64 end = qMin(offset + chunkSize, size);
+        if (end < size) {
+            // Extend to the end of the current line
+            const void *newline = std::memchr(data + end, '\n', static_cast<size_t>(size - end));
+            end = newline ? static_cast<const char *>(newline) - data + 1 : size;
+        }
+        chunks.append(qMakePair(offset, end - offset));
+        offset = end;
+    }
+    return chunks;
+}
+
+ImportChunkResult BulkImporter::parseChunk(const char *data, qint64 size,
+                                           const ParserConfig &config,
+                                           const std::atomic<bool> *cancelled)
+{
+    ImportChunkResult result;
+    const QByteArray ending = config.lineEnding.isEmpty()
+        ? QByteArray("\n") : config.lineEnding.toUtf8();
+
+    const char *pos = data;
+    const char *end = data + size;
+    QString lineText;
+
+    while (pos < end) {
+        if ((result.lines & 0xFFF) == 0 && cancelled
+            && cancelled->load(std::memory_order_relaxed)) {
+            break;
+        }
+
+        const char *lineEnd = findLineEnding(pos, end, ending);
+        const char *next = lineEnd ? lineEnd + ending.size() : end;
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        qint64 length = lineEnd - pos;
+        const char *lineStart = pos;
+        pos = next;
+
+        if (length > config.maxLineLength) {
+            result.errors++;
+            continue;
+        }
+        if (config.verifyChecksum && length > 0) {
+            qsizetype bodySize = 0;
+            if (Checksum::checkNmea(QByteArrayView(lineStart, length), &bodySize) != NmeaChecksum::Valid) {
+                result.errors++;
+                continue;
+            }
+            length = bodySize;
+        }
+
+        lineText = QString::fromUtf8(lineStart, static_cast<qsizetype>(length));
+        QStringView lineView(lineText);
+        if (config.trimWhitespace) {
+            lineView = lineView.trimmed();
+        }
+        if (lineView.isEmpty() && config.skipEmptyLines) {
+            continue;
+        }
+
+        // Same numbering as the streaming parser: every processed line counts
+        GenericDataPacket packet;
+        packet.packetIndex = result.lines++;
+
+        if (!LineParser::parseLine(lineView, config, packet) || !packet.hasData()) {
+            if (!packet.errorMessage.isEmpty()) {
+                result.errors++;
+            }
+            continue;
+        }
+        if (!packet.isValid) {
+            result.errors++;
+        }
+        result.packets.append(std::move(packet));
+    }
+
+    return result;
+}
+
+bool BulkImporter::start(const QString &path, const ParserConfig &config,
+                         const ImportOptions &options)
+{
+    if (m_running) {
+        m_errorString = tr("An import is already running");
+        return false;
+    }
+
+    m_errorString.clear();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    m_size = m_file.size();
+    m_data = nullptr;
+    if (m_size > 0) {
+        m_data = reinterpret_cast<const char *>(m_file.map(0, m_size));
+        if (!m_data) {
+            m_errorString = tr("Cannot map file: %1").arg(m_file.errorString());
+            m_file.close();
+            return false;
+        }
+    }
+
+    m_config = config;
+    m_deviceClock.configure(config);
+    m_options = options;
+    if (m_options.baseTimestamp == 0) {
+        m_options.baseTimestamp = QDateTime::currentMSecsSinceEpoch();
+    }
+
+    const int threads = options.threads > 0 ? options.threads : QThread::idealThreadCount();
+    m_pool.setMaxThreadCount(qMax(1, threads));
+    m_maxInFlight = m_pool.maxThreadCount() + 2;
+
+    m_chunks = splitLineAligned(m_data, m_size, options.chunkSize);
+    m_results.clear();
+    m_results.resize(m_chunks.size());
+    m_nextToSchedule = 0;
+    m_nextToMerge = 0;
+    m_inFlight = 0;
+    m_nextPacketIndex = 0;
+    m_bytesMerged = 0;
+    m_stats = ImportStats();
+    m_cancelled = false;
+    m_running = true;
+    m_clock.start();
+
+    if (m_chunks.isEmpty()) {
+        QMetaObject::invokeMethod(this, [this]() { finish(); }, Qt::QueuedConnection);
+        return true;
+    }
+
+    scheduleTasks();
+    return true;
+}
+
+void BulkImporter::cancel()
+{
+    if (!m_running) {
+        return;
+    }
+    m_cancelled = true;
+    QMetaObject::invokeMethod(this, [this]() {
+        if (m_running && m_inFlight == 0) {
+            finish();
+        }
+    }, Qt::QueuedConnection);
+}
+
+void BulkImporter::scheduleTasks()
+{
+    // Bound the window of unmerged chunks, not just running tasks,
+    // so one slow chunk cannot let finished results pile up
+    while (!m_cancelled
+           && m_nextToSchedule < m_chunks.size()
+           && m_nextToSchedule - m_nextToMerge < m_maxInFlight) {
+        const int index = m_nextToSchedule++;
+        m_inFlight++;
+
+        m_pool.start([this, index]() {
+            const auto &chunk = m_chunks[index];
+            ImportChunkResult result = parseChunk(m_data + chunk.first, chunk.second,
+                                                  m_config, &m_cancelled);
+            {
+                QMutexLocker locker(&m_resultMutex);
+                m_results[index] = std::move(result);
+            }
+            QMetaObject::invokeMethod(this, [this]() {
+                m_inFlight--;
+                mergeReadyChunks();
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void BulkImporter::mergeReadyChunks()
+{
+    if (!m_running) {
+        return;
+    }
+
+    if (m_cancelled) {
+        if (m_inFlight == 0) {
+            finish();
+        }
+        return;
+    }
+
+    while (m_nextToMerge < m_chunks.size()) {
+        std::optional<ImportChunkResult> ready;
+        {
+            QMutexLocker locker(&m_resultMutex);
+            if (!m_results[m_nextToMerge].has_value()) {
+                break;
+            }
+            ready.swap(m_results[m_nextToMerge]);
+        }
+
+        // Chunk-relative indices become global; time is synthesized from the
+        // line number. Device counters unwrap here, where chunks are in order
+        ImportChunkResult &result = *ready;
+        for (GenericDataPacket &packet : result.packets) {
+            packet.packetIndex += m_nextPacketIndex;
+            packet.timestamp = m_options.baseTimestamp
+                + static_cast<qint64>(packet.packetIndex) * m_options.sampleIntervalUs / 1000;
+            m_deviceClock.stamp(packet);
+        }
+        m_nextPacketIndex += result.lines;
+
+        m_stats.lines += result.lines;
+        m_stats.errors += result.errors;
+        const qsizetype packetCount = result.packets.size();
+        m_stats.packets += static_cast<quint64>(packetCount);
+        m_bytesMerged += m_chunks[m_nextToMerge].second;
+        m_nextToMerge++;
+
+        if (packetCount > 0) {
+            emit packetsReady(PacketBatch(std::move(result.packets)));
+        }
+        emit progress(m_bytesMerged, m_size);
+    }
+
+    if (m_nextToMerge == m_chunks.size()) {
+        finish();
+        return;
+    }
+    scheduleTasks();
+}
+
+void BulkImporter::finish()
+{
+    m_running = false;
+    m_stats.bytes = m_bytesMerged;
+    m_stats.elapsedMs = m_clock.elapsed();
+    m_stats.cancelled = m_cancelled;
+
+    m_results.clear();
+    m_chunks.clear();
+    if (m_data) {
+        m_file.unmap(reinterpret_cast<uchar *>(const_cast<char *>(m_data)));
+        m_data = nullptr;
+    }
+    m_file.close();
+
+    emit finished(m_stats);
+}
@@ -0,0 +1,285 @@
+/**
+ * @file Checksum.cpp
+ * @brief Implementation of the Checksum functions
+ */
+
+#include "core/Checksum.h"
+
+#include <QtEndian>
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CHECKSUM_CRC32C_SSE42
+#include <nmmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#elif defined(__ARM_FEATURE_CRC32)
+#define CHECKSUM_CRC32C_ARM
+#include <arm_acle.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Slice-by-8 tables: [k][b] is the CRC of byte b followed by k zero bytes
+ */
+using SliceTables = std::array<std::array<quint32, 256>, 8>;
+
+/**
+ * @brief Tables of a reflected (LSB-first) CRC of up to 32 bits
+ */
+SliceTables reflectedTables(quint32 poly)
+{
+    SliceTables t{};
+    for (quint32 i = 0; i < 256; ++i) {
+        quint32 c = i;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? (c >> 1) ^ poly : c >> 1;
+        }
+        t[0][i] = c;
+    }
+    for (int k = 1; k < 8; ++k) {
+        for (int i = 0; i < 256; ++i) {
+            t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+        }
+    }
+    return t;
+}
+
+/**
+ * @brief Tables of a 16-bit MSB-first CRC
+ */
+SliceTables msbFirst16Tables(quint16 poly)
+{
+    SliceTables t{};
+    for (quint32 i = 0; i < 256; ++i) {
+        quint32 c = i << 8;
+        for (int k = 0; k < 8; ++k) {
+            c = ((c & 0x8000) ? (c << 1) ^ poly : c << 1) & 0xFFFF;
+        }
+        t[0][i] = c;
+    }
+    for (int k = 1; k < 8; ++k) {
+        for (int i = 0; i < 256; ++i) {
+            t[k][i] = ((t[k - 1][i] << 8) & 0xFFFF) ^ t[0][t[k - 1][i] >> 8];
+        }
+    }
+    return t;
+}
+
+quint32 reflectedCrc(const SliceTables &t, quint32 crc, const char *p, qsizetype size)
+{
+    while (size >= 8) {
+        const quint32 one = qFromLittleEndian<quint32>(p) ^ crc;
+        const quint32 two = qFromLittleEndian<quint32>(p + 4);
+        crc = t[7][one & 0xFF] ^ t[6][(one >> 8) & 0xFF] ^ t[5][(one >> 16) & 0xFF] ^ t[4][one >> 24]
+              ^ t[3][two & 0xFF] ^ t[2][(two >> 8) & 0xFF] ^ t[1][(two >> 16) & 0xFF] ^ t[0][two >> 24];
+        p += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = (crc >> 8) ^ t[0][(crc ^ static_cast<quint8>(*p++)) & 0xFF];
+    }
+    return crc;
+}
+
+quint32 msbFirst16Crc(const SliceTables &t, quint32 crc, const char *p, qsizetype size)
+{
+    const auto *b = reinterpret_cast<const quint8 *>(p);
+    while (size >= 8) {
+        crc = t[7][b[0] ^ (crc >> 8)] ^ t[6][b[1] ^ (crc & 0xFF)] ^ t[5][b[2]] ^ t[4][b[3]]
+              ^ t[3][b[4]] ^ t[2][b[5]] ^ t[1][b[6]] ^ t[0][b[7]];
+        b += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = ((crc << 8) & 0xFFFF) ^ t[0][(crc >> 8) ^ *b++];
+    }
+    return crc;
+}
+
+const SliceTables &crc32cTables()
+{
+    static const SliceTables tables = reflectedTables(0x82F63B78u);
+    return tables;
+}
+
+#if defined(CHECKSUM_CRC32C_SSE42)
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("sse4.2")))
+#endif
+quint32 crc32cHardware(quint32 crc, const char *p, qsizetype size)
+{
+    quint64 c = crc;
+    while (size >= 8) {
+        quint64 word;
+        std::memcpy(&word, p, sizeof(word));
+        c = _mm_crc32_u64(c, word);
+        p += 8;
+        size -= 8;
+    }
+    quint32 c32 = static_cast<quint32>(c);
+    while (size-- > 0) {
+        c32 = _mm_crc32_u8(c32, static_cast<quint8>(*p++));
+    }
+    return c32;
+}
+
+bool cpuHasCrc32c()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.2");
+#endif
+}
+
+#elif defined(CHECKSUM_CRC32C_ARM)
+
+quint32 crc32cHardware(quint32 crc, const char *p, qsizetype size)
+{
+    while (size >= 8) {
+        quint64 word;
+        std::memcpy(&word, p, sizeof(word));
+        crc = __crc32cd(crc, word);
+        p += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = __crc32cb(crc, static_cast<quint8>(*p++));
+    }
+    return crc;
+}
+
+bool cpuHasCrc32c()
+{
+    return true;    // Compiled for a CPU with the CRC extension
+}
+
+#endif
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+} // namespace
+
+quint8 Checksum::sum8(QByteArrayView data)
+{
+    // A wide accumulator lets the compiler vectorize the loop
+    quint32 sum = 0;
+    for (char byte : data) {
+        sum += static_cast<quint8>(byte);
+    }
+    return static_cast<quint8>(sum);
+}
+
+quint8 Checksum::xor8(QByteArrayView data)
+{
+    const char *p = data.data();
+    qsizetype size = data.size();
+    quint64 acc = 0;
+    while (size >= 8) {
+        quint64 word;
+        std::memcpy(&word, p, sizeof(word));
+        acc ^= word;
+        p += 8;
+        size -= 8;
+    }
+    acc ^= acc >> 32;
+    acc ^= acc >> 16;
+    acc ^= acc >> 8;
+    quint8 result = static_cast<quint8>(acc);
+    while (size-- > 0) {
+        result ^= static_cast<quint8>(*p++);
+    }
+    return result;
+}
+
+quint16 Checksum::crc16Modbus(QByteArrayView data)
+{
+    static const SliceTables tables = reflectedTables(0xA001);
+    return static_cast<quint16>(reflectedCrc(tables, 0xFFFF, data.data(), data.size()));
+}
+
+quint16 Checksum::crc16Ccitt(QByteArrayView data)
+{
+    static const SliceTables tables = msbFirst16Tables(0x1021);
+    return static_cast<quint16>(msbFirst16Crc(tables, 0xFFFF, data.data(), data.size()));
+}
+
+quint32 Checksum::crc32(QByteArrayView data)
+{
+    static const SliceTables tables = reflectedTables(0xEDB88320u);
+    return ~reflectedCrc(tables, 0xFFFFFFFFu, data.data(), data.size());
+}
+
+quint32 Checksum::crc32c(QByteArrayView data)
+{
+#if defined(CHECKSUM_CRC32C_SSE42) || defined(CHECKSUM_CRC32C_ARM)
+    static const bool hardware = cpuHasCrc32c();
+    if (hardware) {
+        return ~crc32cHardware(0xFFFFFFFFu, data.data(), data.size());
+    }
+#endif
+    return crc32cSoftware(data);
+}
+
+quint32 Checksum::crc32cSoftware(QByteArrayView data)
+{
+    return ~reflectedCrc(crc32cTables(), 0xFFFFFFFFu, data.data(), data.size());
+}
+
+bool Checksum::hasHardwareCrc32c()
+{
+#if defined(CHECKSUM_CRC32C_SSE42) || defined(CHECKSUM_CRC32C_ARM)
+    return cpuHasCrc32c();
+#else
+    return false;
+#endif
+}
+
+NmeaChecksum Checksum::checkNmea(QByteArrayView line, qsizetype *bodySize)
+{
+    qsizetype end = line.size();
+    while (end > 0 && (line[end - 1] == ' ' || line[end - 1] == '\t' || line[end - 1] == '\r')) {
+        --end;
+    }
+    if (end < 3 || line[end - 3] != '*') {
+        return NmeaChecksum::Missing;
+    }
+    const int high = hexValue(line[end - 2]);
+    const int low = hexValue(line[end - 1]);
+    if (high < 0 || low < 0) {
+        return NmeaChecksum::Missing;
+    }
+
+    const qsizetype star = end - 3;
+    qsizetype begin = 0;
+    while (begin < star && (line[begin] == ' ' || line[begin] == '\t')) {
+        ++begin;
+    }
+    if (begin < star && (line[begin] == '$' || line[begin] == '!')) {
+        ++begin;
+    }
+    if (bodySize) {
+        *bodySize = star;
+    }
+    return xor8(line.sliced(begin, star - begin)) == ((high << 4) | low) ? NmeaChecksum::Valid
+                                                                          : NmeaChecksum::Mismatch;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file CsvRecordWriter.cpp
+ * @brief Implementation of CsvRecordWriter
+ */
+
+#include "core/CsvRecordWriter.h"
+
+CsvRecordWriter::CsvRecordWriter(bool includeTimestamp)
+    : m_includeTimestamp(includeTimestamp)
+{
+}
+
+bool CsvRecordWriter::open(const QString &path)
+{
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+    setDevice(&m_file);
+    return true;
+}
+
+void CsvRecordWriter::setDevice(QIODevice *device)
+{
+    m_stream.setDevice(device);
+    m_headerWritten = false;
+    m_columns = 0;
+    m_recordCount = 0;
+}
+
+void CsvRecordWriter::append(const GenericDataPacket &packet)
+{
+    // Header on first packet (to know channel count)
+    if (!m_headerWritten) {
+        m_columns = packet.values.size();
+        writeHeader();
+        m_headerWritten = true;
+    }
+    m_columns = qMax(m_columns, static_cast<int>(packet.values.size()));
+
+    // Written field by field: no per-row QStringList
+    if (m_includeTimestamp) {
+        m_stream << packet.timestamp << ',';
+    }
+    m_stream << packet.packetIndex << ',' << packet.sensorId;
+
+    for (int i = 0; i < m_columns; ++i) {
+        m_stream << ',';
+        if (i < packet.values.size()) {
+            m_stream << QString::number(packet.values[i], 'f', 6);
+        }
+    }
+    m_stream << '\n';
+    m_recordCount++;
+}
+
+bool CsvRecordWriter::close()
+{
+    m_stream.flush();
+    const bool ok = m_stream.status() == QTextStream::Ok;
+    if (!ok) {
+        m_errorString = m_stream.device() ? m_stream.device()->errorString()
+                                          : QStringLiteral("Write failed");
+    }
+    m_stream.setDevice(nullptr);
+    m_file.close();
+    return ok;
+}
+
+void CsvRecordWriter::writeHeader()
+{
+    if (m_includeTimestamp) {
+        m_stream << "Timestamp,";
+    }
+    m_stream << "PacketIndex,SensorID";
+    for (int i = 0; i < m_columns; ++i) {
+        m_stream << ",Ch" << i;
+    }
+    m_stream << '\n';
+}
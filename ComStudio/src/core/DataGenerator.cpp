@@ -0,0 +1,164 @@
+/**
+ * @file DataGenerator.cpp
+ * @brief Implementation of DataGenerator
+ */
+
+#include "core/DataGenerator.h"
+
+#include <QtEndian>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+constexpr double TwoPi = 6.283185307179586;
+constexpr double SpikeAmplitude = 10.0;
+constexpr double NominalRate = 1000.0;      ///< Time base when the rate is unlimited
+const char JustFloatTail[4] = {0x00, 0x00, static_cast<char>(0x80), 0x7F};
+const char *const Labels[] = {"X", "Y", "Z", "W"};
+}
+
+DataGenerator::DataGenerator(const GeneratorSettings &settings, quint32 seed)
+    : m_settings(settings)
+    , m_rng(seed)
+{
+    m_settings.channels = qBound(1, settings.channels, 64);
+    m_settings.sensorCount = qMax(1, settings.sensorCount);
+
+    m_frequencies.reserve(m_settings.channels);
+    for (int c = 0; c < m_settings.channels; ++c) {
+        m_frequencies.append(0.5 + c * 0.75);
+    }
+}
+
+int DataGenerator::produce(qint64 elapsedNs, QByteArray &out, qsizetype maxBytes)
+{
+    const double seconds = elapsedNs / 1e9;
+
+    quint64 lineTarget = std::numeric_limits<quint64>::max();
+    if (m_settings.linesPerSecond > 0.0) {
+        lineTarget = static_cast<quint64>(seconds * m_settings.linesPerSecond);
+    }
+    quint64 byteBudget = std::numeric_limits<quint64>::max();
+    if (m_settings.baudLimit > 0) {
+        byteBudget = static_cast<quint64>(seconds * m_settings.baudLimit / 10.0);
+    }
+
+    const qsizetype start = out.size();
+    int produced = 0;
+    while (m_lineIndex < lineTarget && m_bytes < byteBudget && out.size() - start < maxBytes) {
+        generate(1, out);
+        produced++;
+    }
+    return produced;
+}
+
+void DataGenerator::generate(int count, QByteArray &out)
+{
+    for (int i = 0; i < count; ++i) {
+        const qsizetype before = out.size();
+        if (m_settings.format == GeneratorFormat::JustFloat) {
+            appendBinaryFrame(out);
+        } else {
+            appendTextLine(out);
+        }
+        m_bytes += static_cast<quint64>(out.size() - before);
+        m_lineIndex++;
+    }
+}
+
+double DataGenerator::sample(int channel)
+{
+    const double rate = m_settings.linesPerSecond > 0.0 ? m_settings.linesPerSecond : NominalRate;
+    const double t = m_lineIndex / rate;
+    double value = std::sin(TwoPi * m_frequencies[channel] * t);
+
+    if (m_settings.noise > 0.0) {
+        value += m_settings.noise * m_noise(m_rng);
+    }
+    if (m_settings.spikeProbability > 0.0 && m_uniform(m_rng) < m_settings.spikeProbability) {
+        value += (m_uniform(m_rng) < 0.5 ? -SpikeAmplitude : SpikeAmplitude);
+    }
+    return value;
+}
+
+void DataGenerator::appendTextLine(QByteArray &out)
+{
+    const qsizetype lineStart = out.size();
+    char number[32];
+
+    if (m_settings.format == GeneratorFormat::IdPrefixed) {
+        out.append(QByteArray::number(static_cast<int>(m_lineIndex % m_settings.sensorCount) + 1));
+        out.append(',');
+    }
+
+    for (int c = 0; c < m_settings.channels; ++c) {
+        if (c > 0) {
+            out.append(',');
+        }
+        if (m_settings.format == GeneratorFormat::Labeled) {
+            if (c < 4) {
+                out.append(Labels[c]);
+            } else {
+                out.append('C');
+                out.append(QByteArray::number(c));
+            }
+            out.append(':');
+        }
+        auto result = std::to_chars(number, number + sizeof(number), sample(c),
+                                    std::chars_format::fixed, 4);
+        out.append(number, static_cast<qsizetype>(result.ptr - number));
+    }
+    out.append('\n');
+
+    if (m_settings.malformedProbability > 0.0 && m_uniform(m_rng) < m_settings.malformedProbability) {
+        corruptLine(out, lineStart);
+    }
+}
+
+void DataGenerator::appendBinaryFrame(QByteArray &out)
+{
+    for (int c = 0; c < m_settings.channels; ++c) {
+        const float value = static_cast<float>(sample(c));
+        quint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        char bytes[4];
+        qToLittleEndian(bits, bytes);
+        out.append(bytes, 4);
+    }
+
+    // A malformed frame loses the last tail byte, so it merges with the next frame
+    const bool malformed = m_settings.malformedProbability > 0.0
+        && m_uniform(m_rng) < m_settings.malformedProbability;
+    out.append(JustFloatTail, malformed ? 3 : 4);
+}
+
+void DataGenerator::corruptLine(QByteArray &out, qsizetype lineStart)
+{
+    const qsizetype length = out.size() - lineStart - 1;  // Without '\n'
+    if (length < 2) {
+        return;
+    }
+
+    const int mode = static_cast<int>(m_uniform(m_rng) * 3);
+    switch (mode) {
+        case 0: {
+            // Truncated line (lost bytes)
+            const qsizetype cut = lineStart + 1 + static_cast<qsizetype>(m_uniform(m_rng) * (length - 1));
+            out.truncate(cut);
+            out.append('\n');
+            break;
+        }
+        case 1: {
+            // Bit error turning a character into garbage
+            const qsizetype pos = lineStart + static_cast<qsizetype>(m_uniform(m_rng) * length);
+            out[pos] = '#';
+            break;
+        }
+        default:
+            // Extra non-numeric token
+            out.insert(out.size() - 1, ",ERR");
+            break;
+    }
+}
@@ -0,0 +1,114 @@
+/**
+ * @file DeviceClock.cpp
+ * @brief Implementation of DeviceClock
+ */
+
+#include "core/DeviceClock.h"
+
+#include <cmath>
+
+DeviceClock::DeviceClock(const ParserConfig &config)
+{
+    configure(config);
+}
+
+void DeviceClock::configure(const ParserConfig &config)
+{
+    m_source = config.xAxisSource;
+    m_tickBits = (config.deviceTickBits > 0 && config.deviceTickBits < 64) ? config.deviceTickBits : 0;
+    m_tickSeconds = config.deviceTickSeconds > 0 ? config.deviceTickSeconds : 1.0;
+    m_fitDrift = config.fitClockDrift;
+    reset();
+}
+
+void DeviceClock::reset()
+{
+    m_started = false;
+    m_lastRaw = 0;
+    m_ticks = 0.0;
+    m_fitStarted = false;
+    m_sumW = m_sumX = m_sumY = m_sumXX = m_sumXY = 0.0;
+    m_rate = 1.0;
+    m_offset = 0.0;
+}
+
+void DeviceClock::stamp(GenericDataPacket &packet)
+{
+    switch (m_source) {
+        case XAxisSource::Timestamp:
+            break;
+        case XAxisSource::Counter:
+            packet.sampleTime = static_cast<double>(packet.packetIndex);
+            packet.hasSampleTime = true;
+            break;
+        case XAxisSource::FieldIndex:
+            if (packet.hasSampleTime) {
+                packet.sampleTime = toSeconds(packet.sampleTime, packet.timestamp / 1000.0);
+            }
+            break;
+    }
+}
+
+double DeviceClock::toSeconds(double ticks, double hostSeconds)
+{
+    if (m_tickBits == 0) {
+        m_ticks = ticks;    // Free-running value (seconds, 64-bit counter)
+    } else {
+        const quint64 mask = (quint64(1) << m_tickBits) - 1;
+        const quint64 raw = static_cast<quint64>(std::llround(ticks)) & mask;
+        if (!m_started) {
+            m_ticks = static_cast<double>(raw);
+        } else {
+            // Modular difference; a wrap is a small forward step, anything
+            // in the upper half is the device restarting its counter
+            const quint64 delta = (raw - m_lastRaw) & mask;
+            if (delta <= (mask >> 1)) {
+                m_ticks += static_cast<double>(delta);
+            } else {
+                m_fitStarted = false;
+            }
+        }
+        m_lastRaw = raw;
+    }
+    m_started = true;
+
+    const double deviceSeconds = m_ticks * m_tickSeconds;
+    if (!m_fitDrift) {
+        return deviceSeconds;
+    }
+
+    if (!m_fitStarted) {
+        m_fitStarted = true;
+        m_deviceOrigin = deviceSeconds;
+        m_hostOrigin = hostSeconds;
+        m_sumW = m_sumX = m_sumY = m_sumXX = m_sumXY = 0.0;
+        m_rate = 1.0;
+        m_offset = 0.0;
+    }
+    const double x = deviceSeconds - m_deviceOrigin;
+    addFitPoint(x, hostSeconds - m_hostOrigin);
+    return m_hostOrigin + m_offset + m_rate * x;
+}
+
+void DeviceClock::addFitPoint(double x, double y)
+{
+    // Exponentially weighted least squares, so the fit follows slow
+    // drift changes (temperature) and forgets a restart quickly
+    const double decay = 1.0 - 1.0 / FitWindow;
+    m_sumW = m_sumW * decay + 1.0;
+    m_sumX = m_sumX * decay + x;
+    m_sumY = m_sumY * decay + y;
+    m_sumXX = m_sumXX * decay + x * x;
+    m_sumXY = m_sumXY * decay + x * y;
+
+    const double denominator = m_sumW * m_sumXX - m_sumX * m_sumX;
+    double rate = 1.0;
+    if (m_sumW >= MinFitWeight && denominator > 1e-12 * m_sumW * m_sumW) {
+        rate = (m_sumW * m_sumXY - m_sumX * m_sumY) / denominator;
+        if (std::abs(rate - 1.0) > MaxDrift) {
+            rate = 1.0;     // Too few distinct device times yet, or a bad field
+        }
+    }
+    m_rate = rate;
+    m_offset = (m_sumY - m_rate * m_sumX) / m_sumW;
+}
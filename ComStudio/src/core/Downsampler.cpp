@@ -0,0 +1,165 @@
+/**
+ * @file Downsampler.cpp
+ * @brief Implementation of the LTTB and Min-Max downsamplers
+ */
+
+#include "core/Downsampler.h"
+
+#include <QtGlobal>
+
+namespace Downsampler {
+
+void downsample(DownsampleMode mode, const QVector<double> &x, const QVector<double> &y,
+                int maxPoints, QVector<double> &outX, QVector<double> &outY)
+{
+    if (mode == DownsampleMode::MinMax) {
+        minMax(x, y, maxPoints, outX, outY);
+    } else {
+        lttb(x, y, maxPoints, outX, outY);
+    }
+}
+
+void lttb(const QVector<double> &x, const QVector<double> &y,
+          int maxPoints, QVector<double> &outX, QVector<double> &outY)
+{
+    const int dataSize = x.size();
+    if (dataSize <= maxPoints) {
+        outX = x;
+        outY = y;
+        return;
+    }
+
+    outX.clear();
+    outY.clear();
+    outX.reserve(maxPoints);
+    outY.reserve(maxPoints);
+
+    // Always include first point
+    outX.append(x.first());
+    outY.append(y.first());
+
+    // Bucket size (first and last points are fixed)
+    const double bucketSize = static_cast<double>(dataSize - 2) / (maxPoints - 2);
+
+    int prevSelectedIdx = 0;  // Index of last selected point
+
+    for (int bucket = 0; bucket < maxPoints - 2; ++bucket) {
+        // Current bucket range
+        int bucketStart = static_cast<int>(bucket * bucketSize) + 1;
+        int bucketEnd = static_cast<int>((bucket + 1) * bucketSize) + 1;
+        bucketEnd = qMin(bucketEnd, dataSize - 1);
+
+        // Next bucket range (for averaging)
+        int nextBucketStart = bucketEnd;
+        int nextBucketEnd = static_cast<int>((bucket + 2) * bucketSize) + 1;
+        nextBucketEnd = qMin(nextBucketEnd, dataSize);
+
+        // Calculate average point of next bucket (point C in triangle)
+        double avgX = 0, avgY = 0;
+        int nextCount = nextBucketEnd - nextBucketStart;
+        if (nextCount > 0) {
+            for (int i = nextBucketStart; i < nextBucketEnd; ++i) {
+                avgX += x[i];
+                avgY += y[i];
+            }
+            avgX /= nextCount;
+            avgY /= nextCount;
+        } else {
+            // Last bucket - use last point
+            avgX = x.last();
+            avgY = y.last();
+        }
+
+        // Point A (previously selected point)
+        double ax = x[prevSelectedIdx];
+        double ay = y[prevSelectedIdx];
+
+        // Find point in current bucket that maximizes triangle area
+        double maxArea = -1;
+        int maxAreaIdx = bucketStart;
+
+        for (int i = bucketStart; i < bucketEnd; ++i) {
+            double area = qAbs((ax - avgX) * (y[i] - ay) - (ax - x[i]) * (avgY - ay));
+            if (area > maxArea) {
+                maxArea = area;
+                maxAreaIdx = i;
+            }
+        }
+
+        outX.append(x[maxAreaIdx]);
+        outY.append(y[maxAreaIdx]);
+        prevSelectedIdx = maxAreaIdx;
+    }
+
+    // Always include last point
+    outX.append(x.last());
+    outY.append(y.last());
+}
+
+void minMax(const QVector<double> &x, const QVector<double> &y,
+            int maxPoints, QVector<double> &outX, QVector<double> &outY)
+{
+    const int dataSize = x.size();
+    if (dataSize <= maxPoints) {
+        outX = x;
+        outY = y;
+        return;
+    }
+
+    const int numBuckets = maxPoints / 2;
+    outX.clear();
+    outY.clear();
+    outX.reserve(numBuckets * 2 + 2);
+    outY.reserve(numBuckets * 2 + 2);
+
+    // Always include first point
+    outX.append(x.first());
+    outY.append(y.first());
+
+    const double bucketSize = static_cast<double>(dataSize - 2) / numBuckets;
+
+    for (int bucket = 0; bucket < numBuckets; ++bucket) {
+        int startIdx = 1 + static_cast<int>(bucket * bucketSize);
+        int endIdx = 1 + static_cast<int>((bucket + 1) * bucketSize);
+        endIdx = qMin(endIdx, dataSize - 1);
+
+        if (startIdx >= endIdx) continue;
+
+        // Find min and max in this bucket
+        int minIdx = startIdx, maxIdx = startIdx;
+        double minVal = y[startIdx];
+        double maxVal = y[startIdx];
+
+        for (int i = startIdx + 1; i < endIdx; ++i) {
+            if (y[i] < minVal) {
+                minVal = y[i];
+                minIdx = i;
+            }
+            if (y[i] > maxVal) {
+                maxVal = y[i];
+                maxIdx = i;
+            }
+        }
+
+        // Add min and max in time order to preserve signal shape
+        if (minIdx <= maxIdx) {
+            outX.append(x[minIdx]);
+            outY.append(minVal);
+            if (minIdx != maxIdx) {
+                outX.append(x[maxIdx]);
+                outY.append(maxVal);
+            }
+        } else {
+            outX.append(x[maxIdx]);
+            outY.append(maxVal);
+            outX.append(x[minIdx]);
+            outY.append(minVal);
+        }
+    }
+
+    // Always include last point
+    outX.append(x.last());
+    outY.append(y.last());
+}
+
+} // namespace Downsampler
@@ -0,0 +1,453 @@
+/**
+ * @file FrameSchema.cpp
+ * @brief Implementation of FrameSchema and FrameDecoder
+ */
+
+#include "core/FrameSchema.h"
+#include "core/Checksum.h"
+#include "core/Framer.h"
+
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSet>
+#include <QtEndian>
+
+namespace {
+
+int typeSize(FrameFieldType type)
+{
+    switch (type) {
+        case FrameFieldType::U8:
+        case FrameFieldType::I8:  return 1;
+        case FrameFieldType::U16:
+        case FrameFieldType::I16: return 2;
+        case FrameFieldType::U32:
+        case FrameFieldType::I32:
+        case FrameFieldType::F32: return 4;
+        case FrameFieldType::F64: return 8;
+    }
+    return 1;
+}
+
+bool isUnsigned(FrameFieldType type)
+{
+    return type == FrameFieldType::U8 || type == FrameFieldType::U16 || type == FrameFieldType::U32;
+}
+
+bool typeFromName(const QString &name, FrameFieldType &type)
+{
+    static const QHash<QString, FrameFieldType> types = {
+        {"u8", FrameFieldType::U8},   {"i8", FrameFieldType::I8},
+        {"u16", FrameFieldType::U16}, {"i16", FrameFieldType::I16},
+        {"u32", FrameFieldType::U32}, {"i32", FrameFieldType::I32},
+        {"f32", FrameFieldType::F32}, {"f64", FrameFieldType::F64},
+    };
+    const auto it = types.constFind(name);
+    if (it == types.constEnd()) {
+        return false;
+    }
+    type = it.value();
+    return true;
+}
+
+bool endianFromName(const QString &name, bool &bigEndian)
+{
+    if (name == "little") {
+        bigEndian = false;
+    } else if (name == "big") {
+        bigEndian = true;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool checksumFromName(const QString &name, FrameChecksum &checksum)
+{
+    static const QHash<QString, FrameChecksum> checksums = {
+        {"none", FrameChecksum::None},
+        {"sum8", FrameChecksum::Sum8},
+        {"xor8", FrameChecksum::Xor8},
+        {"crc16", FrameChecksum::Crc16Modbus},
+        {"crc16-modbus", FrameChecksum::Crc16Modbus},
+        {"crc16-ccitt", FrameChecksum::Crc16Ccitt},
+        {"crc32", FrameChecksum::Crc32},
+        {"crc32c", FrameChecksum::Crc32c},
+    };
+    const auto it = checksums.constFind(name);
+    if (it == checksums.constEnd()) {
+        return false;
+    }
+    checksum = it.value();
+    return true;
+}
+
+int checksumSize(FrameChecksum checksum)
+{
+    switch (checksum) {
+        case FrameChecksum::None:        return 0;
+        case FrameChecksum::Sum8:
+        case FrameChecksum::Xor8:        return 1;
+        case FrameChecksum::Crc16Modbus:
+        case FrameChecksum::Crc16Ccitt:  return 2;
+        case FrameChecksum::Crc32:
+        case FrameChecksum::Crc32c:      return 4;
+    }
+    return 0;
+}
+
+quint64 readUnsigned(const char *p, int size, bool bigEndian)
+{
+    quint64 value = 0;
+    for (int i = 0; i < size; ++i) {
+        value = (value << 8) | static_cast<quint8>(p[bigEndian ? i : size - 1 - i]);
+    }
+    return value;
+}
+
+/**
+ * @brief Read count adjacent values of one wire type
+ *
+ * Instantiated per type and byte order, so the loop body is a single
+ * unaligned load (plus a byte swap for the foreign order).
+ */
+template <typename T, bool BigEndian>
+void readRun(const char *p, int count, double *out)
+{
+    for (int i = 0; i < count; ++i, p += sizeof(T)) {
+        if constexpr (sizeof(T) == 1) {
+            out[i] = static_cast<T>(*p);
+        } else if constexpr (BigEndian) {
+            out[i] = static_cast<double>(qFromBigEndian<T>(p));
+        } else {
+            out[i] = static_cast<double>(qFromLittleEndian<T>(p));
+        }
+    }
+}
+
+} // namespace
+
+bool FrameSchema::fromJson(const QJsonObject &json, FrameSchema &schema, QString &error)
+{
+    schema = FrameSchema();
+    schema.name = json.value("name").toString();
+
+    const QString endian = json.value("endian").toString("little");
+    bool bigEndian = false;
+    if (!endianFromName(endian, bigEndian)) {
+        error = QString("endian must be little or big, not '%1'").arg(endian);
+        return false;
+    }
+    if (json.contains("sync") && !Framer::bytesFromHex(json.value("sync").toString(), schema.sync)) {
+        error = "sync: expected hex bytes such as \"AA 55\"";
+        return false;
+    }
+
+    if (json.contains("length")) {
+        const QJsonObject length = json.value("length").toObject();
+        schema.lengthAt = length.value("at").toInt(-1);
+        if (schema.lengthAt < 0) {
+            error = "length: 'at' (byte offset of the length field) is required";
+            return false;
+        }
+        if (!typeFromName(length.value("type").toString("u8"), schema.lengthType)
+            || !isUnsigned(schema.lengthType)) {
+            error = "length: type must be u8, u16 or u32";
+            return false;
+        }
+        if (!endianFromName(length.value("endian").toString(endian), schema.lengthBigEndian)) {
+            error = "length: endian must be little or big";
+            return false;
+        }
+        schema.lengthAdjust = length.value("adjust").toInt(0);
+    }
+    schema.size = json.value("size").toInt(0);
+    schema.maxSize = json.value("maxSize").toInt(schema.maxSize);
+
+    for (const QJsonValue &value : json.value("fields").toArray()) {
+        const QJsonObject object = value.toObject();
+        FrameField field;
+        field.name = object.value("name").toString();
+        const QString type = object.value("type").toString();
+        if (!typeFromName(type, field.type)) {
+            error = QString("field '%1': unknown type '%2'").arg(field.name, type);
+            return false;
+        }
+        if (!endianFromName(object.value("endian").toString(endian), field.bigEndian)) {
+            error = QString("field '%1': endian must be little or big").arg(field.name);
+            return false;
+        }
+        field.at = object.value("at").toInt(-1);
+        if (object.contains("bits")) {
+            const QJsonArray bits = object.value("bits").toArray();
+            field.bitShift = bits.at(0).toInt(-1);
+            field.bitWidth = bits.at(1).toInt(0);
+        }
+        field.scale = object.value("scale").toDouble(1.0);
+        field.offset = object.value("offset").toDouble(0.0);
+        schema.fields.append(field);
+    }
+
+    if (json.contains("checksum")) {
+        const QJsonObject checksum = json.value("checksum").toObject();
+        const QString type = checksum.value("type").toString("none");
+        if (!checksumFromName(type, schema.checksum)) {
+            error = QString("checksum: unknown type '%1'").arg(type);
+            return false;
+        }
+        schema.checksumFrom = checksum.value("from").toInt(-1);
+        if (!endianFromName(checksum.value("endian").toString(endian), schema.checksumBigEndian)) {
+            error = "checksum: endian must be little or big";
+            return false;
+        }
+    }
+
+    if (json.contains("framing")) {
+        schema.framing = json.value("framing").toObject();
+        if (!Framer::create(schema.framing, error)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FrameDecoder::load(const QJsonObject &json)
+{
+    FrameSchema schema;
+    if (!FrameSchema::fromJson(json, schema, m_errorString)) {
+        m_valid = false;
+        return false;
+    }
+    return compile(schema);
+}
+
+bool FrameDecoder::loadFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_errorString = QString("%1: %2").arg(path, file.errorString());
+        m_valid = false;
+        return false;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!document.isObject()) {
+        m_errorString = QString("%1: %2").arg(path, parseError.error != QJsonParseError::NoError
+                                                        ? parseError.errorString()
+                                                        : QStringLiteral("not a JSON object"));
+        m_valid = false;
+        return false;
+    }
+    return load(document.object());
+}
+
+bool FrameDecoder::compile(const FrameSchema &schema)
+{
+    m_valid = false;
+    m_program.clear();
+    m_channelNames.clear();
+    m_schema = schema;
+    m_errorString.clear();
+
+    auto fail = [this](const QString &error) {
+        m_errorString = error;
+        m_program.clear();
+        m_channelNames.clear();
+        return false;
+    };
+
+    if (m_schema.fields.isEmpty()) {
+        return fail("schema has no fields");
+    }
+
+    m_checksumSize = checksumSize(m_schema.checksum);
+    const int syncSize = static_cast<int>(m_schema.sync.size());
+    int cursor = syncSize;      // Next offset for fields without "at"
+    int end = syncSize;         // End of the furthest field
+    m_lengthSize = 0;
+    if (m_schema.lengthAt >= 0) {
+        m_lengthSize = typeSize(m_schema.lengthType);
+        if (m_schema.lengthAt < syncSize) {
+            return fail("length field overlaps the sync bytes");
+        }
+        cursor = qMax(cursor, m_schema.lengthAt + m_lengthSize);
+        end = qMax(end, cursor);
+    }
+
+    QSet<QString> names;
+    const FrameField *previous = nullptr;
+    for (int i = 0; i < m_schema.fields.size(); ++i) {
+        FrameField &field = m_schema.fields[i];
+        if (field.name.isEmpty() || names.contains(field.name)) {
+            return fail(QString("field %1: missing or duplicate name '%2'").arg(i).arg(field.name));
+        }
+        names.insert(field.name);
+
+        const int size = typeSize(field.type);
+        if (field.bitWidth > 0) {
+            if (!isUnsigned(field.type) || field.bitShift < 0 || field.bitShift + field.bitWidth > size * 8) {
+                return fail(QString("field '%1': bits must lie within an unsigned type").arg(field.name));
+            }
+        }
+        if (field.at < 0) {
+            // Bitfields of one container follow each other at the same offset
+            const bool sharesContainer = previous && field.bitWidth > 0 && previous->bitWidth > 0
+                                         && previous->type == field.type;
+            field.at = sharesContainer ? previous->at : cursor;
+        }
+        cursor = field.at + size;
+        end = qMax(end, cursor);
+        previous = &field;
+        m_channelNames.append(field.name);
+    }
+
+    m_minSize = end + m_checksumSize;
+    if (m_schema.lengthAt < 0) {
+        if (m_schema.size == 0) {
+            m_schema.size = m_minSize;
+        } else if (m_schema.size < m_minSize) {
+            return fail(QString("size %1 is smaller than the fields and checksum (%2 bytes)")
+                            .arg(m_schema.size).arg(m_minSize));
+        }
+        m_minSize = m_schema.size;
+    }
+    if (m_schema.maxSize < m_minSize) {
+        m_schema.maxSize = m_minSize;
+    }
+    if (m_schema.checksumFrom < 0) {
+        m_schema.checksumFrom = syncSize;
+    }
+    if (m_schema.checksum != FrameChecksum::None && m_schema.checksumFrom > m_minSize - m_checksumSize) {
+        return fail("checksum: 'from' lies beyond the checksum");
+    }
+
+    // Flatten into ops; adjacent fields of one kind and scaling share an op
+    for (int i = 0; i < m_schema.fields.size(); ++i) {
+        const FrameField &field = m_schema.fields[i];
+        Op op;
+        op.size = static_cast<quint8>(typeSize(field.type));
+        op.at = field.at;
+        op.channel = i;
+        op.scale = field.scale;
+        op.offset = field.offset;
+        op.scaled = field.scale != 1.0 || field.offset != 0.0;
+        op.bigEndian = field.bigEndian;
+        if (field.bitWidth > 0) {
+            op.kind = OpKind::Bits;
+            op.bitShift = static_cast<quint8>(field.bitShift);
+            op.bitWidth = static_cast<quint8>(field.bitWidth);
+        } else {
+            const bool big = field.bigEndian;
+            switch (field.type) {
+                case FrameFieldType::U8:  op.kind = OpKind::U8; break;
+                case FrameFieldType::I8:  op.kind = OpKind::I8; break;
+                case FrameFieldType::U16: op.kind = big ? OpKind::U16Be : OpKind::U16Le; break;
+                case FrameFieldType::I16: op.kind = big ? OpKind::I16Be : OpKind::I16Le; break;
+                case FrameFieldType::U32: op.kind = big ? OpKind::U32Be : OpKind::U32Le; break;
+                case FrameFieldType::I32: op.kind = big ? OpKind::I32Be : OpKind::I32Le; break;
+                case FrameFieldType::F32: op.kind = big ? OpKind::F32Be : OpKind::F32Le; break;
+                case FrameFieldType::F64: op.kind = big ? OpKind::F64Be : OpKind::F64Le; break;
+            }
+        }
+
+        if (!m_program.isEmpty()) {
+            Op &last = m_program.last();
+            if (op.kind != OpKind::Bits && last.kind == op.kind
+                && last.at + last.count * last.size == op.at
+                && last.scale == op.scale && last.offset == op.offset) {
+                last.count++;
+                continue;
+            }
+        }
+        m_program.append(op);
+    }
+
+    m_valid = true;
+    return true;
+}
+
+qsizetype FrameDecoder::frameLength(QByteArrayView data) const
+{
+    if (m_schema.lengthAt < 0) {
+        return m_schema.size;
+    }
+    if (data.size() < m_schema.lengthAt + m_lengthSize) {
+        return 0;
+    }
+    const qint64 length = static_cast<qint64>(readUnsigned(data.data() + m_schema.lengthAt, m_lengthSize,
+                                                           m_schema.lengthBigEndian))
+                          + m_schema.lengthAdjust;
+    if (length < m_minSize || length > m_schema.maxSize) {
+        return -1;
+    }
+    return length;
+}
+
+quint32 FrameDecoder::computeChecksum(QByteArrayView frame) const
+{
+    const qsizetype from = m_schema.checksumFrom;
+    const QByteArrayView covered = frame.sliced(from, frame.size() - m_checksumSize - from);
+    switch (m_schema.checksum) {
+        case FrameChecksum::None:
+            return 0;
+        case FrameChecksum::Sum8:
+            return Checksum::sum8(covered);
+        case FrameChecksum::Xor8:
+            return Checksum::xor8(covered);
+        case FrameChecksum::Crc16Modbus:
+            return Checksum::crc16Modbus(covered);
+        case FrameChecksum::Crc16Ccitt:
+            return Checksum::crc16Ccitt(covered);
+        case FrameChecksum::Crc32:
+            return Checksum::crc32(covered);
+        case FrameChecksum::Crc32c:
+            return Checksum::crc32c(covered);
+    }
+    return 0;
+}
+
+bool FrameDecoder::checksumOk(QByteArrayView frame) const
+{
+    if (m_checksumSize == 0) {
+        return true;
+    }
+    const quint64 stored = readUnsigned(frame.data() + frame.size() - m_checksumSize, m_checksumSize,
+                                        m_schema.checksumBigEndian);
+    return stored == computeChecksum(frame);
+}
+
+void FrameDecoder::decode(const char *frame, double *values) const
+{
+    for (const Op &op : m_program) {
+        const char *p = frame + op.at;
+        double *out = values + op.channel;
+        switch (op.kind) {
+            case OpKind::U8:    readRun<quint8, false>(p, op.count, out); break;
+            case OpKind::I8:    readRun<qint8, false>(p, op.count, out); break;
+            case OpKind::U16Le: readRun<quint16, false>(p, op.count, out); break;
+            case OpKind::U16Be: readRun<quint16, true>(p, op.count, out); break;
+            case OpKind::I16Le: readRun<qint16, false>(p, op.count, out); break;
+            case OpKind::I16Be: readRun<qint16, true>(p, op.count, out); break;
+            case OpKind::U32Le: readRun<quint32, false>(p, op.count, out); break;
+            case OpKind::U32Be: readRun<quint32, true>(p, op.count, out); break;
+            case OpKind::I32Le: readRun<qint32, false>(p, op.count, out); break;
+            case OpKind::I32Be: readRun<qint32, true>(p, op.count, out); break;
+            case OpKind::F32Le: readRun<float, false>(p, op.count, out); break;
+            case OpKind::F32Be: readRun<float, true>(p, op.count, out); break;
+            case OpKind::F64Le: readRun<double, false>(p, op.count, out); break;
+            case OpKind::F64Be: readRun<double, true>(p, op.count, out); break;
+            case OpKind::Bits: {
+                const quint64 raw = readUnsigned(p, op.size, op.bigEndian);
+                *out = static_cast<double>((raw >> op.bitShift) & ((quint64(1) << op.bitWidth) - 1));
+                break;
+            }
+        }
+        if (op.scaled) {
+            for (int i = 0; i < op.count; ++i) {
+                out[i] = out[i] * op.scale + op.offset;
+            }
+        }
+    }
+}
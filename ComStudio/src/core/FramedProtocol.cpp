@@ -0,0 +1,135 @@
+/**
+ * @file FramedProtocol.cpp
+ * @brief Implementation of FramedProtocol
+ */
+
+#include "core/FramedProtocol.h"
+#include "core/PipelineMetrics.h"
+#include "core/TraceRecorder.h"
+
+FramedProtocol::FramedProtocol(QObject *parent)
+    : BaseProtocol(parent)
+{
+    m_elapsedTimer.start();
+}
+
+void FramedProtocol::setTargetDisplayRate(int hz)
+{
+    m_targetIntervalMs = hz > 0 ? 1000.0 / hz : 0;
+}
+
+void FramedProtocol::setFramer(std::unique_ptr<Framer> framer)
+{
+    m_framer = std::move(framer);
+    m_reportedResyncs = 0;
+}
+
+void FramedProtocol::parse(const QByteArray &data)
+{
+    TRACE_SCOPE("FramedProtocol::parse");
+    if (!m_framer) {
+        return;
+    }
+    auto &metrics = PipelineMetrics::instance();
+
+    m_framer->push(data);
+    QByteArrayView frame;
+    while (m_framer->nextFrame(frame)) {
+        processFrame(frame);
+    }
+
+    const quint64 resyncs = m_framer->resyncs();
+    if (resyncs > m_reportedResyncs) {
+        metrics.add(MetricCounter::ParseErrors, resyncs - m_reportedResyncs);
+        emit parseError(QString("%1 framing error, skipped to the next frame").arg(m_framer->name()), QByteArray());
+        m_reportedResyncs = resyncs;
+    }
+
+    metrics.setGauge(MetricGauge::ParserBufferBytes, m_framer->buffered());
+    publishBatches();
+}
+
+void FramedProtocol::reset()
+{
+    if (m_framer) {
+        m_framer->reset();
+    }
+    m_reportedResyncs = 0;
+    resetBatches();
+}
+
+FrameClaim FramedProtocol::claimFrame(QByteArrayView data) const
+{
+    return m_framer ? m_framer->claimFrame(data) : FrameClaim::noMatch();
+}
+
+const QString &FramedProtocol::channelName(int index)
+{
+    while (m_channelNames.size() <= index) {
+        m_channelNames.append(QString("Ch%1").arg(m_channelNames.size()));
+    }
+    return m_channelNames.at(index);
+}
+
+void FramedProtocol::resetBatches()
+{
+    m_batchPackets.clear();
+    m_displayIndices.clear();
+    m_packetCounter = 0;
+    m_lastEmit = -1;
+}
+
+void FramedProtocol::addPacket(GenericDataPacket &&packet)
+{
+    auto &metrics = PipelineMetrics::instance();
+    metrics.add(MetricCounter::PacketsParsed);
+
+    // Every packet is logged; the display batch is the subset that
+    // passes the rate limit
+    bool display = true;
+    if (m_targetIntervalMs > 0) {
+        const qint64 now = m_elapsedTimer.elapsed();
+        if (m_lastEmit < 0 || (now - m_lastEmit) >= m_targetIntervalMs) {
+            m_lastEmit = now;
+        } else {
+            metrics.add(MetricCounter::PacketsRateLimited);
+            display = false;
+        }
+    }
+    if (display && m_displayDecimation > 1 && (m_decimationCounter++ % m_displayDecimation) != 0) {
+        metrics.add(MetricCounter::PacketsDecimated);
+        display = false;
+    }
+    if (display) {
+        m_displayIndices.append(m_batchPackets.size());
+    }
+    m_batchPackets.append(std::move(packet));
+}
+
+void FramedProtocol::publishBatches()
+{
+    if (m_batchPackets.isEmpty()) {
+        return;
+    }
+
+    // The batch owns the packets from here on; consumers share it
+    QVector<GenericDataPacket> packets;
+    packets.swap(m_batchPackets);
+    const PacketBatch batch(std::move(packets));
+
+    QVector<qsizetype> displayIndices;
+    displayIndices.swap(m_displayIndices);
+
+    emit batchForLogging(batch);
+
+    if (displayIndices.size() == batch.size()) {
+        emit batchParsed(batch);
+    } else if (!displayIndices.isEmpty()) {
+        QVector<GenericDataPacket> shown;
+        shown.reserve(displayIndices.size());
+        for (qsizetype index : std::as_const(displayIndices)) {
+            shown.append(batch.at(index));
+        }
+        emit batchParsed(PacketBatch(std::move(shown)));
+    }
+}
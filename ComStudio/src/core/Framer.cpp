@@ -0,0 +1,418 @@
+/**
+ * @file Framer.cpp
+ * @brief Implementation of Framer and the COBS, SLIP, length-prefix and fixed-size framers
+ */
+
+#include "core/Framer.h"
+
+#include <cctype>
+#include <cstring>
+
+namespace {
+
+constexpr char SlipEnd = '\xC0';
+constexpr char SlipEsc = '\xDB';
+constexpr char SlipEscEnd = '\xDC';
+constexpr char SlipEscEsc = '\xDD';
+
+quint64 readUnsigned(const char *p, int size, bool bigEndian)
+{
+    quint64 value = 0;
+    for (int i = 0; i < size; ++i) {
+        value = (value << 8) | static_cast<quint8>(p[bigEndian ? i : size - 1 - i]);
+    }
+    return value;
+}
+
+/**
+ * @brief Encoded size of the largest COBS frame (one code byte per 254 data bytes)
+ */
+qsizetype cobsMaxEncoded(qsizetype maxFrameSize)
+{
+    return maxFrameSize + maxFrameSize / 254 + 1;
+}
+
+/**
+ * @brief Claim for formats with a start marker; sync must be non-empty
+ * @return NoMatch/NeedMore while deciding, Match(0) if data starts with sync
+ */
+FrameClaim claimSync(QByteArrayView data, QByteArrayView sync)
+{
+    if (data.size() < sync.size()) {
+        return sync.startsWith(data) ? FrameClaim::needMore() : FrameClaim::noMatch();
+    }
+    return data.startsWith(sync) ? FrameClaim::match(0) : FrameClaim::noMatch();
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Framer
+
+Framer::Framer(qsizetype maxFrameSize)
+    : m_maxFrameSize(qMax<qsizetype>(1, maxFrameSize))
+{
+}
+
+std::unique_ptr<Framer> Framer::create(const QJsonObject &config, QString &error)
+{
+    const QString type = config.value("type").toString();
+    const int maxSize = config.value("maxSize").toInt(4096);
+    if (maxSize <= 0) {
+        error = "framing: maxSize must be positive";
+        return nullptr;
+    }
+    QByteArray sync;
+    if (config.contains("sync") && !bytesFromHex(config.value("sync").toString(), sync)) {
+        error = "framing: sync: expected hex bytes such as \"AA 55\"";
+        return nullptr;
+    }
+
+    if (type == "cobs") {
+        return std::make_unique<CobsFramer>(maxSize);
+    }
+    if (type == "slip") {
+        return std::make_unique<SlipFramer>(maxSize);
+    }
+    if (type == "length") {
+        const int bytes = config.value("bytes").toInt(1);
+        const QString endian = config.value("endian").toString("little");
+        if (bytes != 1 && bytes != 2 && bytes != 4) {
+            error = "framing: bytes must be 1, 2 or 4";
+            return nullptr;
+        }
+        if (endian != "little" && endian != "big") {
+            error = "framing: endian must be little or big";
+            return nullptr;
+        }
+        return std::make_unique<LengthPrefixFramer>(bytes, endian == "big", config.value("adjust").toInt(0),
+                                                    sync, maxSize);
+    }
+    if (type == "fixed") {
+        const int size = config.value("size").toInt(0);
+        if (size <= 0) {
+            error = "framing: fixed needs a positive size";
+            return nullptr;
+        }
+        return std::make_unique<FixedSizeFramer>(size, sync);
+    }
+    error = QString("framing: unknown type '%1' (cobs, slip, length or fixed)").arg(type);
+    return nullptr;
+}
+
+bool Framer::bytesFromHex(const QString &text, QByteArray &bytes)
+{
+    QByteArray digits = text.toLatin1();
+    digits.replace(" ", "");
+    if (digits.size() % 2 != 0) {
+        return false;
+    }
+    for (char c : std::as_const(digits)) {
+        if (!std::isxdigit(static_cast<unsigned char>(c))) {
+            return false;
+        }
+    }
+    bytes = QByteArray::fromHex(digits);
+    return true;
+}
+
+bool Framer::isText(QByteArrayView data)
+{
+    for (char c : data) {
+        if (!((c >= 0x20 && c < 0x7F) || c == '\t' || c == '\n' || c == '\r')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+qsizetype Framer::textLineLength(QByteArrayView data)
+{
+    const qsizetype newline = data.indexOf('\n');
+    if (newline < 0 || !isText(data.first(newline))) {
+        return 0;
+    }
+    return newline + 1;
+}
+
+void Framer::push(QByteArrayView data)
+{
+    if (data.isEmpty()) {
+        return;
+    }
+    if (m_end + data.size() > m_buffer.size()) {
+        // Move the unread bytes to the front before growing
+        const qsizetype unread = m_end - m_begin;
+        if (m_begin > 0) {
+            std::memmove(m_buffer.data(), m_buffer.constData() + m_begin, static_cast<size_t>(unread));
+            m_begin = 0;
+            m_end = unread;
+        }
+        if (m_end + data.size() > m_buffer.size()) {
+            m_buffer.resize(qMax(m_end + data.size(), 2 * m_buffer.size()));
+        }
+    }
+    std::memcpy(m_buffer.data() + m_end, data.data(), static_cast<size_t>(data.size()));
+    m_end += data.size();
+}
+
+bool Framer::nextFrame(QByteArrayView &frame)
+{
+    while (m_begin < m_end) {
+        qsizetype consumed = 0;
+        const Scan result = scan(m_buffer.data() + m_begin, m_end - m_begin, consumed, frame);
+        m_begin += qBound<qsizetype>(0, consumed, m_end - m_begin);
+        if (result == Scan::Frame) {
+            return true;
+        }
+        if (result == Scan::NeedMore) {
+            break;
+        }
+        if (result == Scan::Corrupt) {
+            m_resyncs++;
+            if (consumed == 0) {
+                m_begin++;
+            }
+        }
+    }
+    if (m_begin == m_end) {
+        m_begin = m_end = 0;
+    }
+    return false;
+}
+
+void Framer::reset()
+{
+    m_begin = 0;
+    m_end = 0;
+    m_resyncs = 0;
+}
+
+// ---------------------------------------------------------------------------
+// CobsFramer
+
+FrameClaim CobsFramer::claimFrame(QByteArrayView data) const
+{
+    // COBS has no start marker: keep away from text lines
+    if (Framer::textLineLength(data) > 0) {
+        return FrameClaim::noMatch();
+    }
+    const qsizetype maxEncoded = cobsMaxEncoded(m_maxFrameSize);
+    const qsizetype limit = qMin(data.size(), maxEncoded + 1);
+    const qsizetype end = data.first(limit).indexOf('\0');
+    if (end >= 0) {
+        return FrameClaim::match(end + 1);
+    }
+    if (limit > maxEncoded || Framer::isText(data)) {
+        return FrameClaim::noMatch();
+    }
+    return FrameClaim::needMore();
+}
+
+Framer::Scan CobsFramer::scan(char *data, qsizetype size, qsizetype &consumed, QByteArrayView &frame)
+{
+    const qsizetype maxEncoded = cobsMaxEncoded(m_maxFrameSize);
+    const void *hit = std::memchr(data, 0, static_cast<size_t>(qMin(size, maxEncoded + 1)));
+    if (!hit) {
+        if (size > maxEncoded) {
+            consumed = size;    // No delimiter in reach: resync at the next one
+            return Scan::Corrupt;
+        }
+        return Scan::NeedMore;
+    }
+    const qsizetype end = static_cast<const char *>(hit) - data;
+    consumed = end + 1;
+    if (end == 0) {
+        return Scan::Skip;      // Leading or repeated delimiter
+    }
+
+    // Decode in place; the output never overtakes the input
+    qsizetype read = 0;
+    qsizetype write = 0;
+    while (read < end) {
+        const int code = static_cast<quint8>(data[read++]);
+        if (read + code - 1 > end) {
+            return Scan::Corrupt;
+        }
+        for (int i = 1; i < code; ++i) {
+            data[write++] = data[read++];
+        }
+        if (code != 0xFF && read < end) {
+            data[write++] = '\0';
+        }
+    }
+    if (write > m_maxFrameSize) {
+        return Scan::Corrupt;
+    }
+    frame = QByteArrayView(data, write);
+    return Scan::Frame;
+}
+
+// ---------------------------------------------------------------------------
+// SlipFramer
+
+FrameClaim SlipFramer::claimFrame(QByteArrayView data) const
+{
+    if (data.isEmpty() || data.front() != SlipEnd) {
+        return FrameClaim::noMatch();
+    }
+    if (data.size() > 1 && data.at(1) == SlipEnd) {
+        return FrameClaim::match(1);    // Empty frame; the next END starts a frame
+    }
+    const qsizetype maxRecord = 2 * m_maxFrameSize + 2;    // END, escaped payload, END
+    const qsizetype end = data.first(qMin(data.size(), maxRecord)).indexOf(SlipEnd, 1);
+    if (end >= 0) {
+        return FrameClaim::match(end + 1);
+    }
+    return data.size() >= maxRecord ? FrameClaim::noMatch() : FrameClaim::needMore();
+}
+
+Framer::Scan SlipFramer::scan(char *data, qsizetype size, qsizetype &consumed, QByteArrayView &frame)
+{
+    const qsizetype maxEncoded = 2 * m_maxFrameSize;
+    const void *hit = std::memchr(data, static_cast<unsigned char>(SlipEnd),
+                                  static_cast<size_t>(qMin(size, maxEncoded + 1)));
+    if (!hit) {
+        if (size > maxEncoded) {
+            consumed = size;
+            return Scan::Corrupt;
+        }
+        return Scan::NeedMore;
+    }
+    const qsizetype end = static_cast<const char *>(hit) - data;
+    consumed = end + 1;
+    if (end == 0) {
+        return Scan::Skip;
+    }
+
+    qsizetype write = 0;
+    for (qsizetype read = 0; read < end; ++read) {
+        char c = data[read];
+        if (c == SlipEsc) {
+            if (++read == end) {
+                return Scan::Corrupt;
+            }
+            if (data[read] == SlipEscEnd) {
+                c = SlipEnd;
+            } else if (data[read] == SlipEscEsc) {
+                c = SlipEsc;
+            } else {
+                return Scan::Corrupt;
+            }
+        }
+        data[write++] = c;
+    }
+    if (write > m_maxFrameSize) {
+        return Scan::Corrupt;
+    }
+    frame = QByteArrayView(data, write);
+    return Scan::Frame;
+}
+
+// ---------------------------------------------------------------------------
+// LengthPrefixFramer
+
+LengthPrefixFramer::LengthPrefixFramer(int lengthBytes, bool bigEndian, int adjust,
+                                       const QByteArray &sync, qsizetype maxFrameSize)
+    : Framer(maxFrameSize)
+    , m_lengthBytes(lengthBytes)
+    , m_bigEndian(bigEndian)
+    , m_adjust(adjust)
+    , m_sync(sync)
+{
+}
+
+qsizetype LengthPrefixFramer::payloadSize(const char *data) const
+{
+    const qint64 size = static_cast<qint64>(readUnsigned(data + m_sync.size(), m_lengthBytes, m_bigEndian))
+                        + m_adjust;
+    return (size < 0 || size > m_maxFrameSize) ? -1 : static_cast<qsizetype>(size);
+}
+
+FrameClaim LengthPrefixFramer::claimFrame(QByteArrayView data) const
+{
+    if (m_sync.isEmpty()) {
+        return FrameClaim::noMatch();
+    }
+    const FrameClaim sync = claimSync(data, m_sync);
+    if (sync.result != FrameClaim::Match) {
+        return sync;
+    }
+    const qsizetype header = m_sync.size() + m_lengthBytes;
+    if (data.size() < header) {
+        return FrameClaim::needMore();
+    }
+    const qsizetype payload = payloadSize(data.data());
+    if (payload < 0) {
+        return FrameClaim::noMatch();
+    }
+    return data.size() < header + payload ? FrameClaim::needMore() : FrameClaim::match(header + payload);
+}
+
+Framer::Scan LengthPrefixFramer::scan(char *data, qsizetype size, qsizetype &consumed, QByteArrayView &frame)
+{
+    if (!m_sync.isEmpty()) {
+        const qsizetype start = QByteArrayView(data, size).indexOf(m_sync);
+        if (start != 0) {
+            // Noise before the sync bytes; keep a possibly split sync
+            consumed = start > 0 ? start : size - (m_sync.size() - 1);
+            return consumed > 0 ? Scan::Corrupt : Scan::NeedMore;
+        }
+    }
+    const qsizetype header = m_sync.size() + m_lengthBytes;
+    if (size < header) {
+        return Scan::NeedMore;
+    }
+    const qsizetype payload = payloadSize(data);
+    if (payload < 0) {
+        consumed = 1;
+        return Scan::Corrupt;
+    }
+    if (size < header + payload) {
+        return Scan::NeedMore;
+    }
+    frame = QByteArrayView(data + header, payload);
+    consumed = header + payload;
+    return Scan::Frame;
+}
+
+// ---------------------------------------------------------------------------
+// FixedSizeFramer
+
+FixedSizeFramer::FixedSizeFramer(qsizetype size, const QByteArray &sync)
+    : Framer(size)
+    , m_size(qMax<qsizetype>(1, size))
+    , m_sync(sync)
+{
+}
+
+FrameClaim FixedSizeFramer::claimFrame(QByteArrayView data) const
+{
+    if (m_sync.isEmpty()) {
+        return FrameClaim::noMatch();
+    }
+    const FrameClaim sync = claimSync(data, m_sync);
+    if (sync.result != FrameClaim::Match) {
+        return sync;
+    }
+    const qsizetype record = m_sync.size() + m_size;
+    return data.size() < record ? FrameClaim::needMore() : FrameClaim::match(record);
+}
+
+Framer::Scan FixedSizeFramer::scan(char *data, qsizetype size, qsizetype &consumed, QByteArrayView &frame)
+{
+    if (!m_sync.isEmpty()) {
+        const qsizetype start = QByteArrayView(data, size).indexOf(m_sync);
+        if (start != 0) {
+            consumed = start > 0 ? start : size - (m_sync.size() - 1);
+            return consumed > 0 ? Scan::Corrupt : Scan::NeedMore;
+        }
+    }
+    const qsizetype record = m_sync.size() + m_size;
+    if (size < record) {
+        return Scan::NeedMore;
+    }
+    frame = QByteArrayView(data + m_sync.size(), m_size);
+    consumed = record;
+    return Scan::Frame;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file IngestQueue.cpp
+ * @brief Implementation of IngestQueue
+ */
+
+#include "core/IngestQueue.h"
+#include "core/PipelineMetrics.h"
+
+#include <QMutexLocker>
+
+QString IngestQueueSettings::policyName(OverloadPolicy policy)
+{
+    switch (policy) {
+        case OverloadPolicy::Block:           return "block";
+        case OverloadPolicy::DropOldest:      return "drop-oldest";
+        case OverloadPolicy::DropNewest:      return "drop-newest";
+        case OverloadPolicy::DecimateDisplay: return "decimate";
+    }
+    return QString();
+}
+
+OverloadPolicy IngestQueueSettings::policyFromName(const QString &name, bool *ok)
+{
+    for (OverloadPolicy policy : {OverloadPolicy::Block, OverloadPolicy::DropOldest,
+                                  OverloadPolicy::DropNewest, OverloadPolicy::DecimateDisplay}) {
+        if (name == policyName(policy)) {
+            if (ok) *ok = true;
+            return policy;
+        }
+    }
+    if (ok) *ok = false;
+    return OverloadPolicy::DecimateDisplay;
+}
+
+void IngestQueue::setSettings(const IngestQueueSettings &settings)
+{
+    QMutexLocker locker(&m_mutex);
+    m_settings = settings;
+    m_settings.maxChunks = qMax(1, m_settings.maxChunks);
+    m_settings.maxBytes = qMax<qsizetype>(1, m_settings.maxBytes);
+}
+
+IngestQueueSettings IngestQueue::settings() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_settings;
+}
+
+bool IngestQueue::tryAdmit()
+{
+    QMutexLocker locker(&m_mutex);
+    if (hasRoomLocked()) {
+        return true;
+    }
+    if (!m_readerWaiting) {
+        m_readerWaiting = true;
+        PipelineMetrics::instance().add(MetricCounter::ReaderStalls);
+    }
+    return false;
+}
+
+bool IngestQueue::push(IngestChunk chunk)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!hasRoomLocked()) {
+            if (m_settings.policy == OverloadPolicy::DropNewest) {
+                auto &metrics = PipelineMetrics::instance();
+                metrics.add(MetricCounter::ChunksDropped);
+                metrics.add(MetricCounter::BytesDropped, static_cast<quint64>(chunk.data.size()));
+                return false;
+            }
+            if (m_settings.policy == OverloadPolicy::DropOldest) {
+                while (!m_chunks.empty() && !hasRoomLocked()) {
+                    dropFrontLocked();
+                }
+            }
+        }
+        m_bytes += chunk.data.size();
+        m_chunks.push_back(std::move(chunk));
+    }
+    return !m_wakePending.exchange(true, std::memory_order_acq_rel);
+}
+
+bool IngestQueue::pop(IngestChunk &chunk, bool &wakeReader)
+{
+    QMutexLocker locker(&m_mutex);
+    wakeReader = false;
+    if (m_chunks.empty()) {
+        return false;
+    }
+    chunk = std::move(m_chunks.front());
+    m_chunks.pop_front();
+    m_bytes -= chunk.data.size();
+    if (m_readerWaiting && hasRoomLocked()) {
+        m_readerWaiting = false;
+        wakeReader = true;
+    }
+    return true;
+}
+
+bool IngestQueue::finishDrain()
+{
+    // Cleared first: a push() racing with the check below wakes the consumer again
+    m_wakePending.store(false, std::memory_order_release);
+    QMutexLocker locker(&m_mutex);
+    if (m_chunks.empty()) {
+        return false;
+    }
+    m_wakePending.store(true, std::memory_order_release);
+    return true;
+}
+
+int IngestQueue::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_chunks.size());
+}
+
+qsizetype IngestQueue::bytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_bytes;
+}
+
+double IngestQueue::fillRatio() const
+{
+    QMutexLocker locker(&m_mutex);
+    return qMax(static_cast<double>(m_chunks.size()) / m_settings.maxChunks,
+                static_cast<double>(m_bytes) / m_settings.maxBytes);
+}
+
+bool IngestQueue::hasRoomLocked() const
+{
+    return static_cast<int>(m_chunks.size()) < m_settings.maxChunks && m_bytes < m_settings.maxBytes;
+}
+
+void IngestQueue::dropFrontLocked()
+{
+    auto &metrics = PipelineMetrics::instance();
+    metrics.add(MetricCounter::ChunksDropped);
+    metrics.add(MetricCounter::BytesDropped, static_cast<quint64>(m_chunks.front().data.size()));
+    m_bytes -= m_chunks.front().data.size();
+    m_chunks.pop_front();
+}
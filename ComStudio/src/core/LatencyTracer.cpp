@@ -0,0 +1,129 @@
+/**
+ * @file LatencyTracer.cpp
+ * @brief Implementation of LatencyTracer
+ */
+
+#include "core/LatencyTracer.h"
+
+#include <QElapsedTimer>
+
+namespace {
+
+/**
+ * @brief Process-wide monotonic clock, started on first use
+ */
+const QElapsedTimer &monotonicClock()
+{
+    static const QElapsedTimer clock = []() {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock;
+}
+
+QString formatNs(quint64 ns)
+{
+    if (ns < 1000000) {
+        return QString("%1 us").arg(ns / 1000.0, 0, 'f', 1);
+    }
+    return QString("%1 ms").arg(ns / 1000000.0, 0, 'f', 2);
+}
+
+} // namespace
+
+LatencyTracer& LatencyTracer::instance()
+{
+    static LatencyTracer instance;
+    return instance;
+}
+
+LatencyTracer::LatencyTracer()
+{
+    monotonicClock();
+}
+
+qint64 LatencyTracer::nowNs()
+{
+    return monotonicClock().nsecsElapsed();
+}
+
+void LatencyTracer::beginChunk(quint64 traceId, qint64 readNs)
+{
+    m_currentTrace = traceId;
+    if (traceId == 0) {
+        return;
+    }
+
+    OpenTrace &trace = m_ring[traceId & (RingSize - 1)];
+    trace.id = traceId;
+    trace.readNs = readNs;
+    trace.stampedMask = 0;
+    m_stats.chunksTraced++;
+}
+
+void LatencyTracer::mark(quint64 traceId, LatencyStage stage)
+{
+    if (traceId == 0) {
+        return;
+    }
+
+    OpenTrace &trace = m_ring[traceId & (RingSize - 1)];
+    if (trace.id != traceId) {
+        m_stats.tracesLost++;
+        return;
+    }
+
+    const quint32 bit = 1u << static_cast<int>(stage);
+    if (trace.stampedMask & bit) {
+        return;
+    }
+    trace.stampedMask |= bit;
+
+    const quint64 latency = static_cast<quint64>(qMax<qint64>(0, nowNs() - trace.readNs));
+    const int index = static_cast<int>(stage);
+    m_stats.stages[index].add(latency);
+    m_stats.maxNs[index] = qMax(m_stats.maxNs[index], latency);
+}
+
+void LatencyTracer::reset()
+{
+    m_ring.fill(OpenTrace());
+    m_currentTrace = 0;
+    m_stats = LatencySnapshot();
+}
+
+QString LatencyTracer::stageName(LatencyStage stage)
+{
+    switch (stage) {
+        case LatencyStage::Parse:        return "parse";
+        case LatencyStage::BufferInsert: return "buffer_insert";
+        case LatencyStage::PlotCommit:   return "plot_commit";
+        case LatencyStage::Screen:       return "on_screen";
+        case LatencyStage::Count:        break;
+    }
+    return QString();
+}
+
+QString LatencyTracer::report(const LatencySnapshot &snapshot)
+{
+    QString text = QString("Byte-to-pixel latency (%1 chunks traced, %2 late stamps)\n")
+        .arg(snapshot.chunksTraced)
+        .arg(snapshot.tracesLost);
+
+    for (int i = 0; i < LatencyStageCount; ++i) {
+        const auto stage = static_cast<LatencyStage>(i);
+        const StageHistogram &h = snapshot.stage(stage);
+        if (h.items == 0) {
+            text += QString("  read -> %1: no samples\n").arg(stageName(stage));
+            continue;
+        }
+        text += QString("  read -> %1: n=%2 p50=%3 p99=%4 max=%5\n")
+            .arg(stageName(stage))
+            .arg(h.items)
+            .arg(formatNs(h.percentileNs(0.5)))
+            .arg(formatNs(h.percentileNs(0.99)))
+            .arg(formatNs(snapshot.maxNs[i]));
+    }
+    return text;
+}
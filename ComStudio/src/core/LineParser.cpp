@@ -4,13 +4,21 @@
  */
 
 #include "core/LineParser.h"
+#include "core/PipelineMetrics.h"
+#include "core/LatencyTracer.h"
+#include "core/TraceRecorder.h"
+#include "core/SensorRegistry.h"
+#include "core/Checksum.h"
+#include <QCoreApplication>
 #include <QDebug>
+#include <QThread>
 #include <charconv>
 #include <cstring>
 
 LineParser::LineParser(QObject *parent)
     : BaseProtocol(parent)
     , m_config(ParserConfig::csvDefault())
+    , m_clock(m_config)
 {
     m_elapsedTimer.start();
     m_timerStarted = true;
@@ -19,6 +27,7 @@ LineParser::LineParser(QObject *parent)
 LineParser::LineParser(const ParserConfig &config, QObject *parent)
     : BaseProtocol(parent)
     , m_config(config)
+    , m_clock(config)
 {
     m_elapsedTimer.start();
     m_timerStarted = true;
@@ -27,6 +36,7 @@ LineParser::LineParser(const ParserConfig &config, QObject *parent)
 void LineParser::setConfig(const ParserConfig &config)
 {
     m_config = config;
+    m_clock.configure(config);
     reset();
 }
 
@@ -43,16 +53,43 @@ void LineParser::setTargetDisplayRate(int hz)
 void LineParser::reset()
 {
     m_buffer.clear();
+    m_batchPackets.clear();
+    m_displayIndices.clear();
     m_packetCounter = 0;
-    m_lastEmitTimestamp = 0;
+    m_lastEmitBySensor.clear();
+    m_clock.reset();
     if (!m_timerStarted) {
         m_elapsedTimer.start();
         m_timerStarted = true;
     }
 }
 
+FrameClaim LineParser::claimFrame(QByteArrayView data) const
+{
+    const QByteArray lineEnding = m_config.lineEnding.toUtf8();
+    if (lineEnding.isEmpty()) {
+        return FrameClaim::noMatch();
+    }
+    const qsizetype limit = qMin<qsizetype>(data.size(), qsizetype(m_config.maxLineLength) + lineEnding.size());
+    const qsizetype pos = data.first(limit).indexOf(lineEnding);
+    if (pos >= 0) {
+        return FrameClaim::match(pos + lineEnding.size());
+    }
+    if (limit < qsizetype(m_config.maxLineLength) + lineEnding.size()) {
+        return FrameClaim::needMore();
+    }
+    return FrameClaim::match(limit);
+}
+
 void LineParser::parse(const QByteArray &data)
 {
+    TRACE_SCOPE("LineParser::parse");
+    
+    // LatencyTracer is GUI-thread only; a pipeline stage on the pool
+    // parses untraced
+    const QCoreApplication *app = QCoreApplication::instance();
+    m_traced = app && QThread::currentThread() == app->thread();
+    
     // Append new data to buffer
     m_buffer.append(data);
     
@@ -64,6 +101,7 @@ void LineParser::parse(const QByteArray &data)
     while ((pos = m_buffer.indexOf(lineEnding)) != -1) {
         // Check for buffer overflow
         if (pos > m_config.maxLineLength) {
+            PipelineMetrics::instance().add(MetricCounter::ParseErrors);
             emit parseError("Line too long, discarding", m_buffer.left(pos));
             m_buffer.remove(0, pos + lineEndLen);
             continue;
@@ -78,6 +116,20 @@ void LineParser::parse(const QByteArray &data)
             continue;
         }
         
+        // Corrupted lines are dropped before they reach the plot
+        if (m_config.verifyChecksum) {
+            qsizetype bodySize = 0;
+            const NmeaChecksum check = Checksum::checkNmea(lineBytes, &bodySize);
+            if (check != NmeaChecksum::Valid) {
+                PipelineMetrics::instance().add(MetricCounter::ChecksumRejects);
+                PipelineMetrics::instance().add(MetricCounter::ParseErrors);
+                emit parseError(check == NmeaChecksum::Missing ? "Line checksum missing" : "Line checksum mismatch",
+                                lineBytes);
+                continue;
+            }
+            lineBytes.truncate(bodySize);
+        }
+        
         // Convert to string view for zero-allocation parsing
         QString lineStr = QString::fromUtf8(lineBytes);
         QStringView lineView(lineStr);
@@ -95,13 +147,49 @@ void LineParser::parse(const QByteArray &data)
     
     // Check for buffer overflow on incomplete line
     if (m_buffer.size() > m_config.maxLineLength) {
+        PipelineMetrics::instance().add(MetricCounter::ParseErrors);
         emit parseError("Buffer overflow, clearing", m_buffer);
         m_buffer.clear();
     }
+
+    PipelineMetrics::instance().setGauge(MetricGauge::ParserBufferBytes, m_buffer.size());
+    publishBatches();
+}
+
+void LineParser::publishBatches()
+{
+    if (m_batchPackets.isEmpty()) {
+        return;
+    }
+    
+    // The batch owns the packets from here on; consumers share it
+    QVector<GenericDataPacket> packets;
+    packets.swap(m_batchPackets);
+    const PacketBatch batch(std::move(packets));
+    
+    QVector<qsizetype> displayIndices;
+    displayIndices.swap(m_displayIndices);
+    
+    emit batchForLogging(batch);
+    
+    if (displayIndices.size() == batch.size()) {
+        emit batchParsed(batch);
+    } else if (!displayIndices.isEmpty()) {
+        // Rate limited: at most one display packet per interval
+        QVector<GenericDataPacket> shown;
+        shown.reserve(displayIndices.size());
+        for (qsizetype index : std::as_const(displayIndices)) {
+            shown.append(batch.at(index));
+        }
+        emit batchParsed(PacketBatch(std::move(shown)));
+    }
 }
 
 void LineParser::processLine(QStringView line)
 {
+    auto &metrics = PipelineMetrics::instance();
+    metrics.add(MetricCounter::LinesFramed);
+    
     // Always emit raw line for terminal display (no rate limit)
     emit rawLineReady(line.toString());
     
@@ -110,100 +198,162 @@ void LineParser::processLine(QStringView line)
     packet.rawData = line.toUtf8();
     packet.displayText = line.toString();
     packet.packetIndex = m_packetCounter++;
+    packet.traceId = m_traced ? LatencyTracer::instance().currentTrace() : 0;
+    
+    bool parsed;
+    {
+        // Only field extraction; emissions below run the downstream stages
+        StageTimer timer(MetricStage::Parse);
+        parsed = parseLine(line, m_config, packet);
+    }
+    if (m_traced) {
+        LatencyTracer::instance().mark(packet.traceId, LatencyStage::Parse);
+    }
+    
+    if (!parsed) {
+        if (!packet.errorMessage.isEmpty()) {
+            metrics.add(MetricCounter::ParseErrors);
+            emit parseError(packet.errorMessage, packet.rawData);
+        }
+        return;  // No tokens, or discarded by the ID filter
+    }
+    
+    m_clock.stamp(packet);
+    
+    if (packet.hasData()) {
+        metrics.add(MetricCounter::PacketsParsed);
+        
+        // Every packet is logged (no rate limit); the display batch is
+        // the subset that passes the rate limit
+        bool display = true;
+        if (m_rateLimitEnabled && m_targetIntervalMs > 0) {
+            // Each sensor gets the full display rate
+            const qsizetype slot = packet.sensorKey + 1;
+            if (slot >= m_lastEmitBySensor.size()) {
+                m_lastEmitBySensor.resize(slot + 1, 0);
+            }
+            qint64 &lastEmit = m_lastEmitBySensor[slot];
+            qint64 now = m_elapsedTimer.elapsed();
+            if (lastEmit == 0 || (now - lastEmit) >= m_targetIntervalMs) {
+                lastEmit = now;
+            } else {
+                metrics.add(MetricCounter::PacketsRateLimited);
+                display = false;
+            }
+        }
+        if (display && m_displayDecimation > 1 && (m_decimationCounter++ % m_displayDecimation) != 0) {
+            metrics.add(MetricCounter::PacketsDecimated);
+            display = false;
+        }
+        if (display) {
+            m_displayIndices.append(m_batchPackets.size());
+        }
+        m_batchPackets.append(std::move(packet));
+    } else if (!packet.errorMessage.isEmpty()) {
+        metrics.add(MetricCounter::ParseErrors);
+        emit parseError(packet.errorMessage, packet.rawData);
+    }
+}
+
+bool LineParser::parseLine(QStringView line, const ParserConfig &config, GenericDataPacket &packet,
+                           int *failedField)
+{
+    if (failedField) {
+        *failedField = -1;
+    }
     
     // Split by delimiter
-    QStringView delimView(m_config.delimiter);
+    QStringView delimView(config.delimiter);
     QVector<QStringView> tokens = splitLine(line, delimView);
     
     if (tokens.isEmpty()) {
         packet.isValid = false;
         packet.errorMessage = "No tokens found";
-        emit parseError(packet.errorMessage, packet.rawData);
-        return;
+        return false;
     }
     
     // Check sensor ID if configured
-    if (m_config.idFieldIndex >= 0) {
-        if (m_config.idFieldIndex < tokens.size()) {
-            QStringView idToken = tokens[m_config.idFieldIndex];
-            if (m_config.trimWhitespace) {
+    if (config.idFieldIndex >= 0) {
+        if (config.idFieldIndex < tokens.size()) {
+            QStringView idToken = tokens[config.idFieldIndex];
+            if (config.trimWhitespace) {
                 idToken = idToken.trimmed();
             }
             
-            // Store the full ID string (supports alphanumeric like "d1", "#5", etc.)
-            QString idStr = idToken.toString();
-            packet.sensorId = idStr;
-            
-            // Filter by sensor ID if configured (case-insensitive comparison)
-            if (!m_config.acceptSensorId.isEmpty()) {
-                // Compare the ID - support both exact match and numeric extraction
-                bool matches = false;
-                
-                // Try exact match first (case-insensitive)
-                if (idStr.compare(m_config.acceptSensorId, Qt::CaseInsensitive) == 0) {
-                    matches = true;
-                } else {
-                    // Try to extract numeric part and compare
-                    // This handles cases like "#12820" matching "12820" or "d1" matching "1"
-                    QString idNumeric, filterNumeric;
-                    
-                    // Extract numeric part from ID
-                    for (const QChar &c : idStr) {
-                        if (c.isDigit() || c == '-') idNumeric += c;
-                    }
-                    // Extract numeric part from filter
-                    for (const QChar &c : m_config.acceptSensorId) {
-                        if (c.isDigit() || c == '-') filterNumeric += c;
-                    }
-                    
-                    if (!idNumeric.isEmpty() && !filterNumeric.isEmpty() && 
-                        idNumeric == filterNumeric) {
-                        matches = true;
-                    }
-                }
-                
-                if (!matches) {
-                    return; // Discard packet silently
-                }
+            // Filter by sensor ID if configured
+            if (!config.acceptSensorId.isEmpty()
+                && !SensorRegistry::idMatches(idToken, config.acceptSensorId)) {
+                return false; // Discard packet silently
             }
+            
+            // Intern the ID (supports alphanumeric like "d1", "#5", etc.);
+            // known IDs share the registry's string instead of a copy
+            auto &sensors = SensorRegistry::instance();
+            packet.sensorKey = sensors.intern(idToken);
+            packet.sensorId = packet.sensorKey >= 0 ? sensors.name(packet.sensorKey)
+                                                    : idToken.toString();
         }
     }
     
     // Determine which fields to extract
     QVector<int> fieldsToExtract;
-    if (m_config.dataFields.isEmpty()) {
-        // Extract all fields (except ID field if set)
+    if (config.dataFields.isEmpty()) {
+        // Extract all fields (except the ID and x-axis fields if set)
+        const int xField = config.xAxisSource == XAxisSource::FieldIndex ? config.xAxisFieldIndex : -1;
         for (int i = 0; i < tokens.size(); ++i) {
-            if (i != m_config.idFieldIndex) {
+            if (i != config.idFieldIndex && i != xField) {
                 fieldsToExtract.append(i);
             }
         }
     } else {
-        fieldsToExtract = m_config.dataFields;
+        fieldsToExtract = config.dataFields;
     }
     
     // Extract values
     bool hasError = false;
+    
+    // Device timestamp: raw ticks, converted by the caller's DeviceClock
+    if (config.xAxisSource == XAxisSource::FieldIndex) {
+        const int xField = config.xAxisFieldIndex;
+        std::optional<double> ticks;
+        if (xField >= 0 && xField < tokens.size()) {
+            ticks = extractNumber(config.trimWhitespace ? tokens[xField].trimmed() : tokens[xField], config);
+        }
+        if (ticks.has_value()) {
+            packet.sampleTime = ticks.value();
+            packet.hasSampleTime = true;
+        } else {
+            hasError = true;
+            packet.errorMessage = QString("No device timestamp in field %1").arg(xField);
+            if (failedField) {
+                *failedField = xField;
+            }
+        }
+    }
     for (int i = 0; i < fieldsToExtract.size(); ++i) {
         int fieldIdx = fieldsToExtract[i];
         
         if (fieldIdx < 0 || fieldIdx >= tokens.size()) {
             hasError = true;
-            packet.errorMessage = QString("Field index %1 out of range").arg(fieldIdx);
+            packet.errorMessage = QString("Field index %1 out of range (have %2 fields)")
+                .arg(fieldIdx).arg(tokens.size());
+            if (failedField) {
+                *failedField = fieldIdx;
+            }
             continue;
         }
         
         QStringView token = tokens[fieldIdx];
-        if (m_config.trimWhitespace) {
+        if (config.trimWhitespace) {
             token = token.trimmed();
         }
         
-        auto maybeValue = extractNumber(token, m_config);
+        auto maybeValue = extractNumber(token, config);
         if (maybeValue.has_value()) {
             // Determine channel name
             QString channelName;
-            if (i < m_config.channelNames.size()) {
-                channelName = m_config.channelNames[i];
+            if (i < config.channelNames.size()) {
+                channelName = config.channelNames[i];
             } else {
                 channelName = QString("Ch%1").arg(i);
             }
@@ -214,29 +364,14 @@ void LineParser::processLine(QStringView line)
             packet.errorMessage = QString("Failed to parse field %1: '%2'")
                 .arg(fieldIdx)
                 .arg(token.toString());
+            if (failedField) {
+                *failedField = fieldIdx;
+            }
         }
     }
     
     packet.isValid = packet.hasData() && !hasError;
-    
-    if (packet.hasData()) {
-        // Always emit for logging (no rate limit) - use for recording
-        emit dataForLogging(packet);
-        
-        // Rate-limited emission for display (plotting/terminal parsed mode)
-        if (!m_rateLimitEnabled || m_targetIntervalMs <= 0) {
-            // No rate limiting - emit every packet
-            emit dataParsed(packet);
-        } else {
-            qint64 now = m_elapsedTimer.elapsed();
-            if (m_lastEmitTimestamp == 0 || (now - m_lastEmitTimestamp) >= m_targetIntervalMs) {
-                m_lastEmitTimestamp = now;
-                emit dataParsed(packet);
-            }
-        }
-    } else if (hasError) {
-        emit parseError(packet.errorMessage, packet.rawData);
-    }
+    return true;
 }
 
 std::optional<double> LineParser::extractNumber(QStringView token, const ParserConfig &config)
@@ -317,6 +452,16 @@ ParseResult LineParser::testParse(const QString &sampleLine, const ParserConfig
     
     QStringView lineView(sampleLine);
     
+    if (config.verifyChecksum) {
+        const NmeaChecksum check = Checksum::checkNmea(sampleLine.toUtf8());
+        if (check != NmeaChecksum::Valid) {
+            result.success = false;
+            result.errorMessage = check == NmeaChecksum::Missing ? "Line checksum missing" : "Line checksum mismatch";
+            return result;
+        }
+        lineView = lineView.first(lineView.lastIndexOf(u'*'));
+    }
+    
     if (config.trimWhitespace) {
         lineView = lineView.trimmed();
     }
@@ -327,65 +472,26 @@ ParseResult LineParser::testParse(const QString &sampleLine, const ParserConfig
         return result;
     }
     
-    // Split by delimiter
-    QStringView delimView(config.delimiter);
-    QVector<QStringView> tokens = splitLine(lineView, delimView);
-    
-    if (tokens.isEmpty()) {
-        result.success = false;
-        result.errorMessage = "No tokens found";
-        return result;
-    }
-    
     // Store field texts
+    const QVector<QStringView> tokens = splitLine(lineView, QStringView(config.delimiter));
     for (const auto &token : tokens) {
         result.fieldTexts.append(token.toString());
     }
     
-    // Determine which fields to extract
-    QVector<int> fieldsToExtract;
-    if (config.dataFields.isEmpty()) {
-        for (int i = 0; i < tokens.size(); ++i) {
-            if (i != config.idFieldIndex) {
-                fieldsToExtract.append(i);
-            }
-        }
-    } else {
-        fieldsToExtract = config.dataFields;
-    }
-    
-    // Try to extract values
-    result.success = true;
-    for (int i = 0; i < fieldsToExtract.size(); ++i) {
-        int fieldIdx = fieldsToExtract[i];
-        
-        if (fieldIdx < 0 || fieldIdx >= tokens.size()) {
-            result.success = false;
-            result.errorMessage = QString("Field index %1 out of range (have %2 fields)")
-                .arg(fieldIdx).arg(tokens.size());
-            result.failedFieldIndex = fieldIdx;
-            continue;
-        }
-        
-        QStringView token = tokens[fieldIdx];
-        if (config.trimWhitespace) {
-            token = token.trimmed();
-        }
-        
-        auto maybeValue = extractNumber(token, config);
-        if (maybeValue.has_value()) {
-            result.values.append(maybeValue.value());
-        } else {
-            result.success = false;
-            result.errorMessage = QString("Failed to parse field %1: '%2'")
-                .arg(fieldIdx).arg(token.toString());
-            result.failedFieldIndex = fieldIdx;
-        }
+    // Same field selection as the streaming parser (ID and x-axis fields excluded)
+    GenericDataPacket packet;
+    if (!parseLine(lineView, config, packet, &result.failedFieldIndex)) {
+        result.success = false;
+        result.errorMessage = packet.errorMessage.isEmpty() ? "Sensor ID rejected by filter"
+                                                            : packet.errorMessage;
+        return result;
     }
     
-    if (result.success && result.values.isEmpty()) {
-        result.success = false;
-        result.errorMessage = "No numeric values extracted";
+    result.values = packet.values;
+    result.success = packet.isValid;
+    if (!result.success) {
+        result.errorMessage = packet.errorMessage.isEmpty() ? "No numeric values extracted"
+                                                            : packet.errorMessage;
     }
     
     return result;
@@ -0,0 +1,401 @@
+/**
+ * @file NmeaProtocol.cpp
+ * @brief Implementation of NmeaProtocol
+ */
+
+#include "core/NmeaProtocol.h"
+#include "core/PipelineMetrics.h"
+#include "core/LatencyTracer.h"
+#include "core/TraceRecorder.h"
+#include "core/SensorRegistry.h"
+
+#include <array>
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+using FieldKind = NmeaProtocol::FieldKind;
+
+struct ChannelSpec
+{
+    quint8 field;           ///< Field index (0 = address)
+    FieldKind kind;
+    const char *name;
+};
+
+constexpr int MaxSentenceChannels = 7;
+
+struct SentenceSpec
+{
+    char type[4];
+    int channelCount;
+    ChannelSpec channels[MaxSentenceChannels];
+};
+
+constexpr SentenceSpec Sentences[] = {
+    {"GGA", 7, {{1, FieldKind::Time, "time"}, {2, FieldKind::Latitude, "lat"}, {4, FieldKind::Longitude, "lon"},
+                {6, FieldKind::Number, "fix"}, {7, FieldKind::Number, "sats"}, {8, FieldKind::Number, "hdop"},
+                {9, FieldKind::Number, "alt"}}},
+    {"RMC", 6, {{1, FieldKind::Time, "time"}, {2, FieldKind::Status, "valid"}, {3, FieldKind::Latitude, "lat"},
+                {5, FieldKind::Longitude, "lon"}, {7, FieldKind::Number, "sog"}, {8, FieldKind::Number, "cog"}}},
+    {"GLL", 4, {{1, FieldKind::Latitude, "lat"}, {3, FieldKind::Longitude, "lon"}, {5, FieldKind::Time, "time"},
+                {6, FieldKind::Status, "valid"}}},
+    {"VTG", 3, {{1, FieldKind::Number, "cog"}, {5, FieldKind::Number, "sog"}, {7, FieldKind::Number, "sog_kmh"}}},
+    {"GSA", 4, {{2, FieldKind::Number, "fix_type"}, {15, FieldKind::Number, "pdop"},
+                {16, FieldKind::Number, "hdop"}, {17, FieldKind::Number, "vdop"}}},
+    {"GSV", 1, {{3, FieldKind::Number, "sats_in_view"}}},
+    {"HDT", 1, {{1, FieldKind::Number, "heading"}}},
+    {"MWV", 3, {{1, FieldKind::Number, "wind_angle"}, {3, FieldKind::Number, "wind_speed"},
+                {5, FieldKind::Status, "valid"}}},
+    {"DBT", 1, {{3, FieldKind::Number, "depth_m"}}},
+    {"ZDA", 4, {{1, FieldKind::Time, "time"}, {2, FieldKind::Number, "day"}, {3, FieldKind::Number, "month"},
+                {4, FieldKind::Number, "year"}}},
+};
+constexpr int SentenceCount = sizeof(Sentences) / sizeof(Sentences[0]);
+
+/**
+ * @brief Hash of the three type letters; collision-free for Sentences (checked below)
+ */
+constexpr unsigned sentenceHash(quint8 a, quint8 b, quint8 c)
+{
+    return (a * 2u + b * 6u + c) & 15u;
+}
+
+constexpr std::array<qint8, 16> buildSlots()
+{
+    std::array<qint8, 16> slots{};
+    for (qint8 &slot : slots) {
+        slot = -1;
+    }
+    for (int i = 0; i < SentenceCount; ++i) {
+        const char *type = Sentences[i].type;
+        slots[sentenceHash(type[0], type[1], type[2])] = static_cast<qint8>(i);
+    }
+    return slots;
+}
+
+constexpr std::array<qint8, 16> SentenceSlots = buildSlots();
+
+constexpr bool slotsArePerfect()
+{
+    int used = 0;
+    for (qint8 slot : SentenceSlots) {
+        used += slot >= 0 ? 1 : 0;
+    }
+    return used == SentenceCount;
+}
+
+static_assert(slotsArePerfect(), "NMEA sentence hash has a collision; change the multipliers");
+
+/**
+ * @brief Find a sentence type
+ * @param type Three letters
+ * @return Index into Sentences, -1 if not supported
+ */
+int findSentence(const char *type)
+{
+    const int slot = SentenceSlots[sentenceHash(static_cast<quint8>(type[0]), static_cast<quint8>(type[1]),
+                                                static_cast<quint8>(type[2]))];
+    if (slot < 0 || std::memcmp(Sentences[slot].type, type, 3) != 0) {
+        return -1;
+    }
+    return slot;
+}
+
+bool toNumber(QByteArrayView field, double &value)
+{
+    if (field.isEmpty()) {
+        return false;
+    }
+    const char *end = field.data() + field.size();
+    const auto [ptr, ec] = std::from_chars(field.data(), end, value);
+    return ec == std::errc() && ptr == end;
+}
+
+int hexDigit(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief Check whether a byte can appear in a sentence
+ */
+bool isSentenceByte(char c)
+{
+    return c >= 0x20 && c < 0x7F;
+}
+
+} // namespace
+
+NmeaProtocol::NmeaProtocol(QObject *parent)
+    : FramedProtocol(parent)
+{
+    auto &sensors = SensorRegistry::instance();
+    for (const SentenceSpec &spec : Sentences) {
+        QStringList names;
+        for (int i = 0; i < spec.channelCount; ++i) {
+            names.append(QString::fromLatin1(spec.channels[i].name));
+        }
+        m_sentenceChannels.append(names);
+        m_sentenceIds.append(QString::fromLatin1(spec.type));
+        m_sentenceKeys.append(sensors.intern(m_sentenceIds.last()));
+    }
+}
+
+QString NmeaProtocol::description() const
+{
+    return QString("GPS/marine sentences: %1").arg(sentenceTypes().join(", "));
+}
+
+QStringList NmeaProtocol::sentenceTypes()
+{
+    QStringList types;
+    for (const SentenceSpec &spec : Sentences) {
+        types.append(QString::fromLatin1(spec.type));
+    }
+    return types;
+}
+
+void NmeaProtocol::reset()
+{
+    m_buffer.clear();
+    FramedProtocol::reset();
+}
+
+bool NmeaProtocol::toDegrees(QByteArrayView value, char hemisphere, FieldKind kind, double &degrees)
+{
+    double limit = 0.0;
+    if (kind == FieldKind::Latitude && (hemisphere == 'N' || hemisphere == 'S')) {
+        limit = 90.0;
+    } else if (kind == FieldKind::Longitude && (hemisphere == 'E' || hemisphere == 'W')) {
+        limit = 180.0;
+    } else {
+        return false;
+    }
+
+    double raw = 0.0;
+    if (!toNumber(value, raw) || raw < 0) {
+        return false;
+    }
+    const double whole = static_cast<double>(static_cast<qint64>(raw / 100));
+    const double minutes = raw - whole * 100;
+    if (minutes >= 60.0) {
+        return false;
+    }
+    degrees = whole + minutes / 60.0;
+    if (degrees > limit) {
+        return false;
+    }
+    if (hemisphere == 'S' || hemisphere == 'W') {
+        degrees = -degrees;
+    }
+    return true;
+}
+
+bool NmeaProtocol::toSecondsOfDay(QByteArrayView value, double &seconds)
+{
+    if (value.size() < 6) {
+        return false;
+    }
+    for (int i = 0; i < 4; ++i) {
+        if (value[i] < '0' || value[i] > '9') {
+            return false;
+        }
+    }
+    const int hours = (value[0] - '0') * 10 + (value[1] - '0');
+    const int minutes = (value[2] - '0') * 10 + (value[3] - '0');
+    double secs = 0.0;
+    if (!toNumber(value.sliced(4), secs) || hours >= 24 || minutes >= 60 || secs < 0 || secs >= 61.0) {
+        return false;
+    }
+    seconds = hours * 3600.0 + minutes * 60.0 + secs;
+    return true;
+}
+
+FrameClaim NmeaProtocol::claimFrame(QByteArrayView data) const
+{
+    if (data.isEmpty() || (data.front() != '$' && data.front() != '!')) {
+        return FrameClaim::noMatch();
+    }
+    const qsizetype limit = qMin(data.size(), MaxSentenceLength + 1);
+    for (qsizetype i = 1; i < limit; ++i) {
+        const char c = data[i];
+        if (c == '\n') {
+            return i > 6 ? FrameClaim::match(i + 1) : FrameClaim::noMatch();
+        }
+        // Address: talker and type letters up to the first comma
+        const bool address = i <= 5 ? ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) : true;
+        if (!address || (!isSentenceByte(c) && c != '\r')) {
+            return FrameClaim::noMatch();
+        }
+    }
+    return limit > MaxSentenceLength ? FrameClaim::noMatch() : FrameClaim::needMore();
+}
+
+void NmeaProtocol::parse(const QByteArray &data)
+{
+    TRACE_SCOPE("NmeaProtocol::parse");
+
+    m_buffer.append(data);
+    const char *bytes = m_buffer.constData();
+    const qsizetype size = m_buffer.size();
+
+    qsizetype start = 0;
+    while (start < size) {
+        const void *hit = std::memchr(bytes + start, '\n', static_cast<size_t>(size - start));
+        if (!hit) {
+            break;
+        }
+        const qsizetype end = static_cast<const char *>(hit) - bytes;
+        processFrame(QByteArrayView(bytes + start, end - start));
+        start = end + 1;
+    }
+
+    if (size - start > MaxSentenceLength) {
+        PipelineMetrics::instance().add(MetricCounter::ParseErrors);
+        emit parseError("NMEA sentence too long, discarding", m_buffer.mid(start));
+        start = size;
+    }
+    m_buffer.remove(0, start);
+
+    PipelineMetrics::instance().setGauge(MetricGauge::ParserBufferBytes, m_buffer.size());
+    publishBatches();
+}
+
+void NmeaProtocol::processFrame(QByteArrayView sentence)
+{
+    auto &metrics = PipelineMetrics::instance();
+
+    while (!sentence.isEmpty() && (sentence.back() == '\r' || sentence.back() == ' ')) {
+        sentence.chop(1);
+    }
+    if (sentence.isEmpty()) {
+        return;
+    }
+    if (sentence.size() > MaxSentenceLength || (sentence.front() != '$' && sentence.front() != '!')) {
+        metrics.add(MetricCounter::ParseErrors);
+        emit parseError("Not an NMEA sentence", sentence.toByteArray());
+        return;
+    }
+    metrics.add(MetricCounter::LinesFramed);
+    emit rawLineReady(QString::fromLatin1(sentence.data(), sentence.size()));
+
+    // One pass: field views and the XOR of everything between '$' and '*'
+    std::array<QByteArrayView, MaxFields> fields;
+    int fieldCount = 0;
+    quint8 sum = 0;
+    qsizetype fieldStart = 1;
+    qsizetype pos = 1;
+    for (; pos < sentence.size(); ++pos) {
+        const char c = sentence[pos];
+        if (c == '*') {
+            break;
+        }
+        sum ^= static_cast<quint8>(c);
+        if (c == ',') {
+            if (fieldCount < MaxFields) {
+                fields[fieldCount++] = sentence.sliced(fieldStart, pos - fieldStart);
+            }
+            fieldStart = pos + 1;
+        }
+    }
+    if (fieldCount < MaxFields) {
+        fields[fieldCount++] = sentence.sliced(fieldStart, pos - fieldStart);
+    }
+
+    if (pos < sentence.size()) {
+        const bool ok = sentence.size() == pos + 3
+                        && hexDigit(sentence[pos + 1]) >= 0 && hexDigit(sentence[pos + 2]) >= 0
+                        && ((hexDigit(sentence[pos + 1]) << 4) | hexDigit(sentence[pos + 2])) == sum;
+        if (!ok) {
+            metrics.add(MetricCounter::ChecksumRejects);
+            metrics.add(MetricCounter::ParseErrors);
+            emit parseError("NMEA checksum mismatch", sentence.toByteArray());
+            return;
+        }
+    } else if (m_requireChecksum) {
+        metrics.add(MetricCounter::ChecksumRejects);
+        metrics.add(MetricCounter::ParseErrors);
+        emit parseError("NMEA checksum missing", sentence.toByteArray());
+        return;
+    }
+
+    // Address "TTSSS": talker ID, then the type (proprietary $P... sentences are not mapped)
+    const QByteArrayView address = fields[0];
+    const int type = address.size() == 5 ? findSentence(address.data() + 2) : -1;
+    if (type < 0) {
+        return;
+    }
+    const SentenceSpec &spec = Sentences[type];
+    const QStringList &names = m_sentenceChannels.at(type);
+
+    GenericDataPacket packet;
+    packet.traceId = LatencyTracer::instance().currentTrace();
+    packet.sensorKey = m_sentenceKeys.at(type);
+    packet.sensorId = m_sentenceIds.at(type);
+    const char *badField = nullptr;     // First malformed mapped field
+    {
+        StageTimer timer(MetricStage::Parse);
+        packet.values.reserve(spec.channelCount);
+        packet.channelNames.reserve(spec.channelCount);
+        for (int i = 0; i < spec.channelCount; ++i) {
+            const ChannelSpec &channel = spec.channels[i];
+            if (channel.field >= fieldCount || fields[channel.field].isEmpty()) {
+                continue;   // Not reported (e.g. no fix yet)
+            }
+            const QByteArrayView field = fields[channel.field];
+            double value = 0.0;
+            bool ok = false;
+            switch (channel.kind) {
+                case FieldKind::Number:
+                    ok = toNumber(field, value);
+                    break;
+                case FieldKind::Latitude:
+                case FieldKind::Longitude: {
+                    const QByteArrayView hemisphere = channel.field + 1 < fieldCount ? fields[channel.field + 1]
+                                                                                   : QByteArrayView();
+                    ok = hemisphere.size() == 1 && toDegrees(field, hemisphere.front(), channel.kind, value);
+                    break;
+                }
+                case FieldKind::Time:
+                    ok = toSecondsOfDay(field, value);
+                    break;
+                case FieldKind::Status:
+                    ok = field.size() == 1 && (field.front() == 'A' || field.front() == 'V');
+                    value = field.front() == 'A' ? 1.0 : 0.0;
+                    break;
+            }
+            if (!ok) {
+                badField = channel.name;
+                break;
+            }
+            packet.channels.insert(names.at(i), value);
+            packet.values.append(value);
+            packet.channelNames.append(names.at(i));
+        }
+        packet.isValid = packet.hasData();
+    }
+    LatencyTracer::instance().mark(packet.traceId, LatencyStage::Parse);
+
+    // A malformed field drops the whole sentence, like a checksum error
+    if (badField) {
+        metrics.add(MetricCounter::ParseErrors);
+        emit parseError(QString("NMEA %1: malformed field '%2'").arg(m_sentenceIds.at(type), QLatin1String(badField)),
+                        sentence.toByteArray());
+        return;
+    }
+    if (packet.hasData()) {
+        packet.packetIndex = nextPacketIndex();
+        addPacket(std::move(packet));
+    }
+}
@@ -0,0 +1,411 @@
+/**
+ * @file PipelineGraph.cpp
+ * @brief Implementation of PipelineGraph and PipelineStage::emitOutput
+ */
+
+#include "core/PipelineGraph.h"
+#include "core/PipelineStages.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <QThread>
+
+namespace {
+
+QHash<QString, PipelineGraph::StageFactory> &stageRegistry()
+{
+    static QHash<QString, PipelineGraph::StageFactory> registry;
+    return registry;
+}
+
+void ensureBuiltinStages()
+{
+    static const bool registered = []() {
+        registerBuiltinStages();
+        return true;
+    }();
+    Q_UNUSED(registered);
+}
+
+bool threadFromName(const QString &name, StageThread &thread)
+{
+    if (name == "gui") {
+        thread = StageThread::Gui;
+    } else if (name == "pool") {
+        thread = StageThread::Pool;
+    } else if (name == "pinned") {
+        thread = StageThread::Pinned;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Find a port by name; an empty name selects the only port
+ */
+int portIndex(const QVector<StagePort> &ports, const QString &name)
+{
+    if (name.isEmpty()) {
+        return ports.size() == 1 ? 0 : -1;
+    }
+    for (int i = 0; i < ports.size(); ++i) {
+        if (ports[i].name == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+void PipelineStage::emitOutput(int output, const StageData &data)
+{
+    if (m_graph) {
+        m_graph->route(m_slot, output, data);
+    }
+}
+
+PipelineGraph::PipelineGraph(QObject *parent)
+    : QObject(parent)
+{
+    m_pool.setObjectName("PipelinePool");
+}
+
+PipelineGraph::~PipelineGraph()
+{
+    clear();
+}
+
+void PipelineGraph::registerStageType(const QString &type, StageFactory factory)
+{
+    stageRegistry().insert(type, std::move(factory));
+}
+
+QStringList PipelineGraph::stageTypes()
+{
+    ensureBuiltinStages();
+    QStringList types = stageRegistry().keys();
+    types.sort();
+    return types;
+}
+
+void PipelineGraph::bindProtocol(const QString &name, ProtocolHandler *handler)
+{
+    m_protocols.insert(name, handler);
+}
+
+void PipelineGraph::bindSink(const QString &name, PacketSink sink)
+{
+    m_sinks.insert(name, std::move(sink));
+}
+
+bool PipelineGraph::load(const QJsonObject &config)
+{
+    clear();
+    m_errorString.clear();
+    if (!build(config)) {
+        // Nothing has run yet; drop the partial graph without finish()
+        for (auto &slot : m_slots) {
+            if (slot->pinnedThread) {
+                slot->pinnedThread->quit();
+                slot->pinnedThread->wait();
+            }
+        }
+        m_slots.clear();
+        m_slotById.clear();
+        return false;
+    }
+    return true;
+}
+
+bool PipelineGraph::loadFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_errorString = QString("%1: %2").arg(path, file.errorString());
+        return false;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!document.isObject()) {
+        m_errorString = QString("%1: %2").arg(path, parseError.error != QJsonParseError::NoError
+                                                        ? parseError.errorString()
+                                                        : QStringLiteral("not a JSON object"));
+        return false;
+    }
+    return load(document.object());
+}
+
+bool PipelineGraph::build(const QJsonObject &config)
+{
+    ensureBuiltinStages();
+
+    const int poolThreads = config.value("poolThreads").toInt(0);
+    m_pool.setMaxThreadCount(poolThreads > 0 ? poolThreads : QThread::idealThreadCount());
+
+    for (const QJsonValue &value : config.value("stages").toArray()) {
+        const QJsonObject stageConfig = value.toObject();
+        const QString id = stageConfig.value("id").toString();
+        const QString type = stageConfig.value("type").toString();
+        if (id.isEmpty() || id.contains('.') || m_slotById.contains(id)) {
+            m_errorString = QString("invalid or duplicate stage id '%1'").arg(id);
+            return false;
+        }
+        const StageFactory factory = stageRegistry().value(type);
+        if (!factory) {
+            m_errorString = QString("stage '%1': unknown type '%2'").arg(id, type);
+            return false;
+        }
+
+        auto slot = std::make_unique<StageSlot>();
+        slot->stage = factory();
+        slot->stage->m_graph = this;
+        slot->stage->m_slot = static_cast<int>(m_slots.size());
+        slot->stage->m_id = id;
+        slot->stage->setObjectName(id);
+        slot->thread = slot->stage->defaultThread();
+        if (stageConfig.contains("thread")
+            && !threadFromName(stageConfig.value("thread").toString(), slot->thread)) {
+            m_errorString = QString("stage '%1': thread must be gui, pool or pinned").arg(id);
+            return false;
+        }
+        if (slot->stage->requiresGuiThread() && slot->thread != StageThread::Gui) {
+            m_errorString = QString("stage '%1': type '%2' runs on the gui thread only").arg(id, type);
+            return false;
+        }
+        if (!slot->stage->configure(stageConfig, *this)) {
+            m_errorString = QString("stage '%1': %2").arg(id, slot->stage->errorString());
+            return false;
+        }
+        slot->routes.resize(slot->stage->outputs().size());
+
+        if (slot->thread == StageThread::Pinned) {
+            slot->pinnedThread = std::make_unique<QThread>();
+            slot->pinnedThread->setObjectName(QString("Stage:%1").arg(id));
+            slot->stage->moveToThread(slot->pinnedThread.get());
+            slot->pinnedThread->start();
+        }
+
+        m_slotById.insert(id, static_cast<int>(m_slots.size()));
+        m_slots.push_back(std::move(slot));
+    }
+
+    for (const QJsonValue &value : config.value("links").toArray()) {
+        const QJsonObject link = value.toObject();
+        if (!addLink(link.value("from").toString(), link.value("to").toString())) {
+            return false;
+        }
+    }
+
+    if (hasCycle()) {
+        m_errorString = "links form a cycle";
+        return false;
+    }
+    return true;
+}
+
+bool PipelineGraph::addLink(const QString &from, const QString &to)
+{
+    const QString fromStage = from.section('.', 0, 0);
+    const QString toStage = to.section('.', 0, 0);
+    if (!m_slotById.contains(fromStage) || !m_slotById.contains(toStage)) {
+        m_errorString = QString("link %1 -> %2: unknown stage").arg(from, to);
+        return false;
+    }
+
+    const int source = m_slotById.value(fromStage);
+    const int target = m_slotById.value(toStage);
+    const QVector<StagePort> outputs = m_slots[source]->stage->outputs();
+    const QVector<StagePort> inputs = m_slots[target]->stage->inputs();
+    const int output = portIndex(outputs, from.section('.', 1));
+    const int input = portIndex(inputs, to.section('.', 1));
+    if (output < 0 || input < 0) {
+        m_errorString = QString("link %1 -> %2: unknown port").arg(from, to);
+        return false;
+    }
+    if (outputs[output].type != inputs[input].type) {
+        m_errorString = QString("link %1 -> %2: port types differ").arg(from, to);
+        return false;
+    }
+
+    m_slots[source]->routes[output].append({target, input});
+    return true;
+}
+
+bool PipelineGraph::hasCycle() const
+{
+    // Kahn's algorithm: a cycle leaves stages with incoming links
+    const int count = static_cast<int>(m_slots.size());
+    QVector<int> incoming(count, 0);
+    for (const auto &slot : m_slots) {
+        for (const QVector<Route> &routes : slot->routes) {
+            for (const Route &route : routes) {
+                incoming[route.slot]++;
+            }
+        }
+    }
+    QVector<int> ready;
+    for (int i = 0; i < count; ++i) {
+        if (incoming[i] == 0) {
+            ready.append(i);
+        }
+    }
+    int visited = 0;
+    while (!ready.isEmpty()) {
+        const int slot = ready.takeLast();
+        visited++;
+        for (const QVector<Route> &routes : m_slots[slot]->routes) {
+            for (const Route &route : routes) {
+                if (--incoming[route.slot] == 0) {
+                    ready.append(route.slot);
+                }
+            }
+        }
+    }
+    return visited != count;
+}
+
+void PipelineGraph::clear()
+{
+    if (m_slots.empty()) {
+        return;
+    }
+
+    drainAll();
+    for (auto &slot : m_slots) {
+        if (slot->pinnedThread) {
+            slot->pinnedThread->quit();
+            slot->pinnedThread->wait();
+        }
+        slot->stage->finish();
+    }
+    m_generation++;
+    m_slots.clear();
+    m_slotById.clear();
+}
+
+void PipelineGraph::feed(const QString &sourceId, const QByteArray &data)
+{
+    const int slot = m_slotById.value(sourceId, -1);
+    if (slot < 0) {
+        return;
+    }
+    if (auto *source = qobject_cast<SourceStage *>(m_slots[slot]->stage.get())) {
+        source->push(data);
+    }
+}
+
+QStringList PipelineGraph::stageIds() const
+{
+    QStringList ids;
+    for (const auto &slot : m_slots) {
+        ids.append(slot->stage->id());
+    }
+    return ids;
+}
+
+void PipelineGraph::route(int slot, int output, const StageData &data)
+{
+    for (const Route &route : std::as_const(m_slots[slot]->routes[output])) {
+        deliver(route.slot, route.input, data);
+    }
+}
+
+void PipelineGraph::deliver(int index, int input, const StageData &data)
+{
+    StageSlot &slot = *m_slots[index];
+    QMutexLocker locker(&slot.mutex);
+
+    // Fast path: a GUI stage that is idle runs inline, exactly like a
+    // direct signal connection
+    if (slot.thread == StageThread::Gui && !slot.scheduled && slot.mailbox.empty()
+        && QThread::currentThread() == thread()) {
+        slot.scheduled = true;
+        locker.unlock();
+        slot.stage->process(input, data);
+        drainSlot(index, m_generation);
+        return;
+    }
+
+    slot.mailbox.emplace_back(input, data);
+    if (slot.scheduled) {
+        return;
+    }
+    slot.scheduled = true;
+    locker.unlock();
+    schedule(index);
+}
+
+void PipelineGraph::schedule(int index)
+{
+    const quint64 generation = m_generation;
+    switch (m_slots[index]->thread) {
+        case StageThread::Gui:
+            QMetaObject::invokeMethod(this, [this, index, generation]() {
+                drainSlot(index, generation);
+            }, Qt::QueuedConnection);
+            break;
+        case StageThread::Pool:
+            m_pool.start([this, index, generation]() { drainSlot(index, generation); });
+            break;
+        case StageThread::Pinned:
+            QMetaObject::invokeMethod(m_slots[index]->stage.get(), [this, index, generation]() {
+                drainSlot(index, generation);
+            }, Qt::QueuedConnection);
+            break;
+    }
+}
+
+void PipelineGraph::drainSlot(int index, quint64 generation)
+{
+    // Posted before the graph was rebuilt
+    if (generation != m_generation) {
+        return;
+    }
+
+    StageSlot &slot = *m_slots[index];
+    while (true) {
+        QMutexLocker locker(&slot.mutex);
+        if (slot.mailbox.empty()) {
+            slot.scheduled = false;
+            return;
+        }
+        const std::pair<int, StageData> item = std::move(slot.mailbox.front());
+        slot.mailbox.pop_front();
+        locker.unlock();
+        slot.stage->process(item.first, item.second);
+    }
+}
+
+void PipelineGraph::drainAll()
+{
+    // Links form a DAG, so every pass empties at least one more level
+    for (size_t pass = 0; pass <= m_slots.size(); ++pass) {
+        m_pool.waitForDone();
+        bool idle = true;
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            StageSlot &slot = *m_slots[i];
+            {
+                QMutexLocker locker(&slot.mutex);
+                if (slot.mailbox.empty()) {
+                    continue;
+                }
+            }
+            idle = false;
+            if (slot.thread == StageThread::Gui) {
+                drainSlot(static_cast<int>(i), m_generation);
+            } else if (slot.thread == StageThread::Pinned) {
+                // Runs after the drains already posted to that thread
+                QMetaObject::invokeMethod(slot.stage.get(), []() {}, Qt::BlockingQueuedConnection);
+            }
+        }
+        if (idle) {
+            return;
+        }
+    }
+    qWarning() << "PipelineGraph: batches still queued after draining";
+}
@@ -0,0 +1,264 @@
+/**
+ * @file PipelineMetrics.cpp
+ * @brief Implementation of PipelineMetrics
+ */
+
+#include "core/PipelineMetrics.h"
+
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtAlgorithms>
+
+// ============================================================================
+// StageHistogram / MetricsSnapshot
+// ============================================================================
+
+int StageHistogram::bucketFor(quint64 ns)
+{
+    if (ns == 0) {
+        return 0;
+    }
+    const int bucket = 64 - qCountLeadingZeroBits(ns);
+    return qMin(bucket, Buckets - 1);
+}
+
+quint64 StageHistogram::bucketUpperNs(int bucket)
+{
+    return bucket <= 0 ? 1 : (quint64(1) << bucket);
+}
+
+quint64 StageHistogram::percentileNs(double fraction) const
+{
+    if (items == 0) {
+        return 0;
+    }
+
+    const quint64 target = qMax<quint64>(1, static_cast<quint64>(fraction * items + 0.5));
+    quint64 seen = 0;
+    for (int b = 0; b < Buckets; ++b) {
+        seen += buckets[b];
+        if (seen >= target) {
+            return bucketUpperNs(b);
+        }
+    }
+    // Buckets read while writers update them can sum to slightly less than items
+    for (int b = Buckets - 1; b >= 0; --b) {
+        if (buckets[b]) {
+            return bucketUpperNs(b);
+        }
+    }
+    return 0;
+}
+
+double MetricsSnapshot::rate(MetricCounter c, const MetricsSnapshot &previous) const
+{
+    // Previous snapshot from before a reset: fall back to the average since reset
+    const bool sameEpoch = previous.uptimeNs > 0 && previous.uptimeNs < uptimeNs
+        && previous.counter(c) <= counter(c);
+    const qint64 dtNs = sameEpoch ? uptimeNs - previous.uptimeNs : uptimeNs;
+    const quint64 delta = sameEpoch ? counter(c) - previous.counter(c) : counter(c);
+    return dtNs > 0 ? delta * 1e9 / dtNs : 0.0;
+}
+
+// ============================================================================
+// PipelineMetrics
+// ============================================================================
+
+PipelineMetrics& PipelineMetrics::instance()
+{
+    static PipelineMetrics instance;
+    return instance;
+}
+
+PipelineMetrics::PipelineMetrics()
+{
+    m_clock.start();
+}
+
+void PipelineMetrics::record(MetricStage s, qint64 ns, quint64 items)
+{
+    if (items == 0) {
+        return;
+    }
+    AtomicHistogram &h = m_stages[static_cast<int>(s)];
+    const quint64 total = static_cast<quint64>(qMax<qint64>(0, ns));
+    h.items.fetch_add(items, std::memory_order_relaxed);
+    h.totalNs.fetch_add(total, std::memory_order_relaxed);
+    h.buckets[StageHistogram::bucketFor(total / items)].fetch_add(items, std::memory_order_relaxed);
+}
+
+MetricsSnapshot PipelineMetrics::snapshot() const
+{
+    MetricsSnapshot snap;
+    snap.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    snap.uptimeNs = m_clock.nsecsElapsed();
+
+    for (int i = 0; i < MetricCounterCount; ++i) {
+        snap.counters[i] = m_counters[i].load(std::memory_order_relaxed);
+    }
+    for (int i = 0; i < MetricGaugeCount; ++i) {
+        snap.gauges[i] = m_gauges[i].load(std::memory_order_relaxed);
+    }
+    for (int i = 0; i < MetricStageCount; ++i) {
+        const AtomicHistogram &h = m_stages[i];
+        StageHistogram &out = snap.stages[i];
+        out.items = h.items.load(std::memory_order_relaxed);
+        out.totalNs = h.totalNs.load(std::memory_order_relaxed);
+        for (int b = 0; b < StageHistogram::Buckets; ++b) {
+            out.buckets[b] = h.buckets[b].load(std::memory_order_relaxed);
+        }
+    }
+    return snap;
+}
+
+void PipelineMetrics::reset()
+{
+    for (auto &counter : m_counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (auto &h : m_stages) {
+        h.items.store(0, std::memory_order_relaxed);
+        h.totalNs.store(0, std::memory_order_relaxed);
+        for (auto &bucket : h.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+    m_clock.restart();
+}
+
+QString PipelineMetrics::counterName(MetricCounter c)
+{
+    switch (c) {
+        case MetricCounter::BytesRead:          return "bytes_read";
+        case MetricCounter::ChunksRead:         return "chunks_read";
+        case MetricCounter::LinesFramed:        return "lines_framed";
+        case MetricCounter::PacketsParsed:      return "packets_parsed";
+        case MetricCounter::PacketsRateLimited: return "packets_rate_limited";
+        case MetricCounter::ParseErrors:        return "parse_errors";
+        case MetricCounter::TerminalLines:      return "terminal_lines";
+        case MetricCounter::PlotFrames:         return "plot_frames";
+        case MetricCounter::GuiStalls:          return "gui_stalls";
+        case MetricCounter::CursorPacketsLost:  return "cursor_packets_lost";
+        case MetricCounter::ChunksDropped:      return "chunks_dropped";
+        case MetricCounter::BytesDropped:       return "bytes_dropped";
+        case MetricCounter::ReaderStalls:       return "reader_stalls";
+        case MetricCounter::PacketsDecimated:   return "packets_decimated";
+        case MetricCounter::BytesUnclaimed:     return "bytes_unclaimed";
+        case MetricCounter::ChecksumRejects:    return "checksum_rejects";
+        case MetricCounter::Count:              break;
+    }
+    return QString();
+}
+
+QString PipelineMetrics::gaugeName(MetricGauge g)
+{
+    switch (g) {
+        case MetricGauge::SerialPendingChunks:  return "serial_pending_chunks";
+        case MetricGauge::SerialPendingBytes:   return "serial_pending_bytes";
+        case MetricGauge::ParserBufferBytes:    return "parser_buffer_bytes";
+        case MetricGauge::DataBufferPackets:    return "data_buffer_packets";
+        case MetricGauge::TerminalPendingLines: return "terminal_pending_lines";
+        case MetricGauge::PlotterPendingPoints: return "plotter_pending_points";
+        case MetricGauge::Count:                break;
+    }
+    return QString();
+}
+
+QString PipelineMetrics::stageName(MetricStage s)
+{
+    switch (s) {
+        case MetricStage::Read:           return "read";
+        case MetricStage::Parse:          return "parse";
+        case MetricStage::BufferInsert:   return "buffer_insert";
+        case MetricStage::TerminalAppend: return "terminal_append";
+        case MetricStage::PlotRender:     return "plot_render";
+        case MetricStage::Count:          break;
+    }
+    return QString();
+}
+
+QByteArray PipelineMetrics::toCsv(const MetricsSnapshot &current, const MetricsSnapshot &previous)
+{
+    QByteArray csv;
+    csv.append("kind,name,value,rate_per_s,mean_ns,p50_ns,p99_ns,max_ns\n");
+
+    for (int i = 0; i < MetricCounterCount; ++i) {
+        const auto c = static_cast<MetricCounter>(i);
+        csv.append(QString("counter,%1,%2,%3,,,,\n")
+            .arg(counterName(c))
+            .arg(current.counter(c))
+            .arg(current.rate(c, previous), 0, 'f', 1)
+            .toUtf8());
+    }
+    for (int i = 0; i < MetricGaugeCount; ++i) {
+        const auto g = static_cast<MetricGauge>(i);
+        csv.append(QString("gauge,%1,%2,,,,,\n")
+            .arg(gaugeName(g))
+            .arg(current.gauge(g))
+            .toUtf8());
+    }
+    for (int i = 0; i < MetricStageCount; ++i) {
+        const auto s = static_cast<MetricStage>(i);
+        const StageHistogram &h = current.stage(s);
+        csv.append(QString("stage,%1,%2,,%3,%4,%5,%6\n")
+            .arg(stageName(s))
+            .arg(h.items)
+            .arg(h.meanNs(), 0, 'f', 0)
+            .arg(h.percentileNs(0.5))
+            .arg(h.percentileNs(0.99))
+            .arg(h.maxNs())
+            .toUtf8());
+    }
+    return csv;
+}
+
+QByteArray PipelineMetrics::toJson(const MetricsSnapshot &current, const MetricsSnapshot &previous)
+{
+    QJsonObject counters;
+    for (int i = 0; i < MetricCounterCount; ++i) {
+        const auto c = static_cast<MetricCounter>(i);
+        QJsonObject entry;
+        entry["total"] = static_cast<qint64>(current.counter(c));
+        entry["rate_per_s"] = current.rate(c, previous);
+        counters[counterName(c)] = entry;
+    }
+
+    QJsonObject gauges;
+    for (int i = 0; i < MetricGaugeCount; ++i) {
+        const auto g = static_cast<MetricGauge>(i);
+        gauges[gaugeName(g)] = current.gauge(g);
+    }
+
+    QJsonObject stages;
+    for (int i = 0; i < MetricStageCount; ++i) {
+        const auto s = static_cast<MetricStage>(i);
+        const StageHistogram &h = current.stage(s);
+        QJsonObject entry;
+        entry["items"] = static_cast<qint64>(h.items);
+        entry["mean_ns"] = h.meanNs();
+        entry["p50_ns"] = static_cast<qint64>(h.percentileNs(0.5));
+        entry["p99_ns"] = static_cast<qint64>(h.percentileNs(0.99));
+        entry["max_ns"] = static_cast<qint64>(h.maxNs());
+
+        // Sparse histogram: upper bound (ns) -> items
+        QJsonArray buckets;
+        for (int b = 0; b < StageHistogram::Buckets; ++b) {
+            if (h.buckets[b]) {
+                buckets.append(QJsonArray{static_cast<qint64>(StageHistogram::bucketUpperNs(b)),
+                                          static_cast<qint64>(h.buckets[b])});
+            }
+        }
+        entry["histogram"] = buckets;
+        stages[stageName(s)] = entry;
+    }
+
+    QJsonObject root;
+    root["timestamp"] = QDateTime::fromMSecsSinceEpoch(current.timestampMs).toString(Qt::ISODateWithMs);
+    root["uptime_s"] = current.uptimeNs / 1e9;
+    root["counters"] = counters;
+    root["gauges"] = gauges;
+    root["stages"] = stages;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
@@ -0,0 +1,340 @@
+/**
+ * @file PipelineStages.cpp
+ * @brief Implementation of the built-in PipelineGraph stages
+ */
+
+#include "core/PipelineStages.h"
+#include "core/LineParser.h"
+#include "core/CsvRecordWriter.h"
+#include "core/SensorRegistry.h"
+
+#include <QDebug>
+#include <QJsonArray>
+
+namespace {
+
+QVector<StagePort> decoderOutputs()
+{
+    return {{"packets", StageDataType::Packets}, {"display", StageDataType::Packets}};
+}
+
+template <typename Stage>
+void registerStage(const QString &type)
+{
+    PipelineGraph::registerStageType(type, []() { return std::make_unique<Stage>(); });
+}
+
+/**
+ * @brief Copy a batch through a per-packet transform (false drops the packet)
+ */
+template <typename Transform>
+PacketBatch transformBatch(const PacketBatch &batch, Transform transform)
+{
+    QVector<GenericDataPacket> out;
+    out.reserve(batch.size());
+    for (const GenericDataPacket &packet : batch) {
+        GenericDataPacket copy = packet;
+        if (transform(copy)) {
+            out.append(std::move(copy));
+        }
+    }
+    return PacketBatch(std::move(out));
+}
+
+} // namespace
+
+void registerBuiltinStages()
+{
+    registerStage<SourceStage>("source");
+    registerStage<ProtocolStage>("protocol");
+    registerStage<LineParserStage>("line_parser");
+    registerStage<FilterStage>("filter");
+    registerStage<DeriveStage>("derive");
+    registerStage<DecimateStage>("decimate");
+    registerStage<SinkStage>("sink");
+    registerStage<CsvExportStage>("csv_export");
+}
+
+// ============================================================================
+// ProtocolStage
+// ============================================================================
+
+QVector<StagePort> ProtocolStage::outputs() const
+{
+    return decoderOutputs();
+}
+
+bool ProtocolStage::configure(const QJsonObject &config, const PipelineGraph &graph)
+{
+    const QString target = config.value("target").toString("protocol");
+    m_handler = graph.protocol(target);
+    if (!m_handler) {
+        m_errorString = QString("no protocol handler bound as '%1'").arg(target);
+        return false;
+    }
+    connect(m_handler, &ProtocolHandler::batchForLogging, this, [this](const PacketBatch &batch) {
+        emitOutput(0, StageData::fromPackets(batch));
+    }, Qt::DirectConnection);
+    connect(m_handler, &ProtocolHandler::batchParsed, this, [this](const PacketBatch &batch) {
+        emitOutput(1, StageData::fromPackets(batch));
+    }, Qt::DirectConnection);
+    return true;
+}
+
+void ProtocolStage::process(int, const StageData &data)
+{
+    if (m_handler) {
+        m_handler->processRawData(data.bytes);
+    }
+}
+
+// ============================================================================
+// LineParserStage
+// ============================================================================
+
+LineParserStage::LineParserStage() = default;
+
+LineParserStage::~LineParserStage() = default;
+
+QVector<StagePort> LineParserStage::outputs() const
+{
+    return decoderOutputs();
+}
+
+bool LineParserStage::configure(const QJsonObject &config, const PipelineGraph &)
+{
+    ParserConfig parserConfig = ParserConfig::csvDefault();
+    parserConfig.delimiter = config.value("delimiter").toString(parserConfig.delimiter);
+    parserConfig.idFieldIndex = config.value("idField").toInt(parserConfig.idFieldIndex);
+    parserConfig.acceptSensorId = config.value("acceptId").toString();
+    parserConfig.stripLabels = config.value("stripLabels").toBool(parserConfig.stripLabels);
+    parserConfig.verifyChecksum = config.value("checksum").toBool(false);
+    if (config.contains("xField")) {
+        parserConfig.xAxisSource = XAxisSource::FieldIndex;
+        parserConfig.xAxisFieldIndex = config.value("xField").toInt();
+        parserConfig.deviceTickBits = config.value("tickBits").toInt(parserConfig.deviceTickBits);
+        const double tickRate = config.value("tickRate").toDouble(1000.0);
+        if (tickRate <= 0) {
+            m_errorString = "tickRate must be positive";
+            return false;
+        }
+        parserConfig.deviceTickSeconds = 1.0 / tickRate;
+        parserConfig.fitClockDrift = config.value("fitDrift").toBool(false);
+    }
+    for (const QJsonValue &field : config.value("fields").toArray()) {
+        parserConfig.dataFields.append(field.toInt());
+    }
+    for (const QJsonValue &name : config.value("names").toArray()) {
+        parserConfig.channelNames.append(name.toString());
+    }
+    if (parserConfig.delimiter.isEmpty()) {
+        m_errorString = "empty delimiter";
+        return false;
+    }
+
+    m_parser = std::make_unique<LineParser>(parserConfig);
+    const int displayRate = config.value("displayRate").toInt(60);
+    m_parser->setRateLimitEnabled(displayRate > 0);
+    if (displayRate > 0) {
+        m_parser->setTargetDisplayRate(displayRate);
+    }
+
+    // Direct: the parser is driven from whichever thread runs this stage
+    connect(m_parser.get(), &LineParser::batchForLogging, this, [this](const PacketBatch &batch) {
+        emitOutput(0, StageData::fromPackets(batch));
+    }, Qt::DirectConnection);
+    connect(m_parser.get(), &LineParser::batchParsed, this, [this](const PacketBatch &batch) {
+        emitOutput(1, StageData::fromPackets(batch));
+    }, Qt::DirectConnection);
+    return true;
+}
+
+void LineParserStage::process(int, const StageData &data)
+{
+    m_parser->parse(data.bytes);
+}
+
+// ============================================================================
+// FilterStage
+// ============================================================================
+
+bool FilterStage::configure(const QJsonObject &config, const PipelineGraph &)
+{
+    m_sensorKey = SensorRegistry::instance().intern(config.value("sensor").toString());
+    for (const QJsonValue &channel : config.value("channels").toArray()) {
+        m_channels.append(channel.toString());
+    }
+    return true;
+}
+
+void FilterStage::process(int, const StageData &data)
+{
+    const PacketBatch out = transformBatch(data.packets, [this](GenericDataPacket &packet) {
+        if (m_sensorKey >= 0 && packet.sensorKey != m_sensorKey) {
+            return false;
+        }
+        if (m_channels.isEmpty()) {
+            return true;
+        }
+        QMap<QString, double> channels;
+        QVector<double> values;
+        QStringList names;
+        for (const QString &name : std::as_const(m_channels)) {
+            auto it = packet.channels.constFind(name);
+            if (it != packet.channels.constEnd()) {
+                channels.insert(name, it.value());
+                values.append(it.value());
+                names.append(name);
+            }
+        }
+        packet.channels = channels;
+        packet.values = values;
+        packet.channelNames = names;
+        return packet.hasData();
+    });
+    if (!out.isEmpty()) {
+        emitOutput(0, StageData::fromPackets(out));
+    }
+}
+
+// ============================================================================
+// DeriveStage
+// ============================================================================
+
+bool DeriveStage::configure(const QJsonObject &config, const PipelineGraph &)
+{
+    m_name = config.value("name").toString();
+    const QJsonObject terms = config.value("terms").toObject();
+    for (auto it = terms.constBegin(); it != terms.constEnd(); ++it) {
+        m_terms.append({it.key(), it.value().toDouble(1.0)});
+    }
+    for (const QJsonValue &channel : config.value("product").toArray()) {
+        m_product.append(channel.toString());
+    }
+    m_offset = config.value("offset").toDouble(0.0);
+    m_scale = config.value("scale").toDouble(1.0);
+
+    if (m_name.isEmpty()) {
+        m_errorString = "derived channel needs a \"name\"";
+        return false;
+    }
+    if (m_terms.isEmpty() == m_product.isEmpty()) {
+        m_errorString = "derived channel needs either \"terms\" or \"product\"";
+        return false;
+    }
+    return true;
+}
+
+void DeriveStage::process(int, const StageData &data)
+{
+    const PacketBatch out = transformBatch(data.packets, [this](GenericDataPacket &packet) {
+        double value = m_product.isEmpty() ? m_offset : m_scale;
+        for (const auto &term : std::as_const(m_terms)) {
+            auto it = packet.channels.constFind(term.first);
+            if (it == packet.channels.constEnd()) {
+                return true;
+            }
+            value += term.second * it.value();
+        }
+        for (const QString &name : std::as_const(m_product)) {
+            auto it = packet.channels.constFind(name);
+            if (it == packet.channels.constEnd()) {
+                return true;
+            }
+            value *= it.value();
+        }
+        packet.addChannel(m_name, value);
+        return true;
+    });
+    emitOutput(0, StageData::fromPackets(out));
+}
+
+// ============================================================================
+// DecimateStage
+// ============================================================================
+
+bool DecimateStage::configure(const QJsonObject &config, const PipelineGraph &)
+{
+    m_factor = config.value("factor").toInt(1);
+    if (m_factor < 1) {
+        m_errorString = "decimation factor must be at least 1";
+        return false;
+    }
+    return true;
+}
+
+void DecimateStage::process(int, const StageData &data)
+{
+    if (m_factor == 1) {
+        emitOutput(0, data);
+        return;
+    }
+    QVector<GenericDataPacket> kept;
+    for (const GenericDataPacket &packet : data.packets) {
+        if (m_seen++ % m_factor == 0) {
+            kept.append(packet);
+        }
+    }
+    if (!kept.isEmpty()) {
+        emitOutput(0, StageData::fromPackets(PacketBatch(std::move(kept))));
+    }
+}
+
+// ============================================================================
+// SinkStage
+// ============================================================================
+
+bool SinkStage::configure(const QJsonObject &config, const PipelineGraph &graph)
+{
+    const QString target = config.value("target").toString();
+    m_sink = graph.sink(target);
+    if (!m_sink) {
+        m_errorString = QString("no sink bound as '%1'").arg(target);
+        return false;
+    }
+    return true;
+}
+
+void SinkStage::process(int, const StageData &data)
+{
+    m_sink(data.packets);
+}
+
+// ============================================================================
+// CsvExportStage
+// ============================================================================
+
+CsvExportStage::CsvExportStage() = default;
+
+CsvExportStage::~CsvExportStage() = default;
+
+bool CsvExportStage::configure(const QJsonObject &config, const PipelineGraph &)
+{
+    const QString path = config.value("path").toString();
+    if (path.isEmpty()) {
+        m_errorString = "csv_export needs a \"path\"";
+        return false;
+    }
+    m_writer = std::make_unique<CsvRecordWriter>(config.value("timestamp").toBool(true));
+    if (!m_writer->open(path)) {
+        m_errorString = m_writer->errorString();
+        m_writer.reset();
+        return false;
+    }
+    return true;
+}
+
+void CsvExportStage::process(int, const StageData &data)
+{
+    for (const GenericDataPacket &packet : data.packets) {
+        m_writer->append(packet);
+    }
+}
+
+void CsvExportStage::finish()
+{
+    if (m_writer && !m_writer->close()) {
+        qWarning() << "csv_export" << id() << "failed:" << m_writer->errorString();
+    }
+    m_writer.reset();
+}
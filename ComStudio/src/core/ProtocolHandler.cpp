@@ -4,8 +4,17 @@
  */
 
 #include "core/ProtocolHandler.h"
+#include "core/PipelineMetrics.h"
 #include <QDebug>
 
+namespace {
+
+// A protocol waiting for more bytes than this is overruled; protocols
+// bound their own frames (line length, length fields) well below it
+constexpr qsizetype MaxDemuxPendingBytes = 1024 * 1024;
+
+} // namespace
+
 ProtocolHandler::ProtocolHandler(QObject *parent)
     : QObject(parent)
 {
@@ -38,13 +47,16 @@ void ProtocolHandler::unregisterProtocol(const QString &id)
         return;
     }
     
-    // If removing active protocol, disconnect signals
+    disconnectProtocolSignals(m_protocols[id].get());
     if (id == m_activeProtocolId) {
-        disconnectProtocolSignals(m_protocols[id].get());
         m_activeProtocolId.clear();
     }
+    if (m_demuxIds.removeAll(id) > 0) {
+        m_demuxOrder.removeAll(m_protocols[id].get());
+    }
     
     m_protocols.remove(id);
+    updateConnections();
 }
 
 bool ProtocolHandler::setActiveProtocol(const QString &id)
@@ -54,14 +66,8 @@ bool ProtocolHandler::setActiveProtocol(const QString &id)
         return false;
     }
     
-    // Disconnect from previous protocol
-    if (!m_activeProtocolId.isEmpty() && m_protocols.contains(m_activeProtocolId)) {
-        disconnectProtocolSignals(m_protocols[m_activeProtocolId].get());
-    }
-    
-    // Connect to new protocol
     m_activeProtocolId = id;
-    connectProtocolSignals(m_protocols[id].get());
+    updateConnections();
     
     // Reset parser state for clean start
     m_protocols[id]->reset();
@@ -98,26 +104,129 @@ BaseProtocol* ProtocolHandler::protocol(const QString &id) const
     return m_protocols[id].get();
 }
 
+bool ProtocolHandler::setDemuxProtocols(const QStringList &ids)
+{
+    QVector<BaseProtocol *> order;
+    for (const QString &id : ids) {
+        if (!m_protocols.contains(id)) {
+            qWarning() << "ProtocolHandler: Unknown protocol" << id;
+            return false;
+        }
+        order.append(m_protocols[id].get());
+    }
+    
+    m_demuxIds = ids;
+    m_demuxOrder = order;
+    m_demuxBuffer.clear();
+    updateConnections();
+    for (BaseProtocol *proto : std::as_const(m_demuxOrder)) {
+        proto->reset();
+    }
+    return true;
+}
+
 void ProtocolHandler::resetParser()
 {
-    if (auto *proto = activeProtocol()) {
+    if (isDemultiplexing()) {
+        m_demuxBuffer.clear();
+        for (BaseProtocol *proto : std::as_const(m_demuxOrder)) {
+            proto->reset();
+        }
+    } else if (auto *proto = activeProtocol()) {
         proto->reset();
     }
 }
 
 void ProtocolHandler::processRawData(const QByteArray &data)
 {
-    if (auto *proto = activeProtocol()) {
+    if (isDemultiplexing()) {
+        demultiplex(data);
+    } else if (auto *proto = activeProtocol()) {
         proto->parse(data);
     }
 }
 
+void ProtocolHandler::demultiplex(const QByteArray &data)
+{
+    // parse() runs the consumers synchronously; keep the scanned buffer
+    // out of their reach
+    QByteArray buffer;
+    buffer.swap(m_demuxBuffer);
+    buffer.append(data);
+    const QByteArrayView view(buffer);
+    
+    qsizetype pos = 0;
+    qsizetype runStart = 0;             // Consecutive frames of one owner go in one parse()
+    BaseProtocol *runOwner = nullptr;   // nullptr = unclaimed run
+    qsizetype unclaimed = 0;
+    
+    auto flushRun = [&]() {
+        if (runOwner && pos > runStart) {
+            runOwner->parse(buffer.mid(runStart, pos - runStart));
+        }
+    };
+    
+    while (pos < view.size()) {
+        const QByteArrayView rest = view.sliced(pos);
+        BaseProtocol *owner = nullptr;
+        qsizetype length = 1;
+        bool waiting = false;
+        for (BaseProtocol *proto : std::as_const(m_demuxOrder)) {
+            const FrameClaim claim = proto->claimFrame(rest);
+            if (claim.result == FrameClaim::Match) {
+                owner = proto;
+                length = qBound<qsizetype>(1, claim.length, rest.size());
+                break;
+            }
+            if (claim.result == FrameClaim::NeedMore) {
+                waiting = rest.size() < MaxDemuxPendingBytes;
+                break;
+            }
+        }
+        if (waiting) {
+            break;
+        }
+        
+        if (owner != runOwner) {
+            flushRun();
+            runOwner = owner;
+            runStart = pos;
+        }
+        if (!owner) {
+            unclaimed++;    // Resynchronize one byte further
+        }
+        pos += length;
+    }
+    flushRun();
+    
+    if (unclaimed > 0) {
+        PipelineMetrics::instance().add(MetricCounter::BytesUnclaimed, unclaimed);
+    }
+    m_demuxBuffer = buffer.sliced(pos);
+}
+
+void ProtocolHandler::updateConnections()
+{
+    for (const ProtocolPtr &proto : std::as_const(m_protocols)) {
+        disconnectProtocolSignals(proto.get());
+    }
+    if (isDemultiplexing()) {
+        for (BaseProtocol *proto : std::as_const(m_demuxOrder)) {
+            connectProtocolSignals(proto);
+        }
+    } else {
+        connectProtocolSignals(activeProtocol());
+    }
+}
+
 void ProtocolHandler::connectProtocolSignals(BaseProtocol *protocol)
 {
     if (!protocol) return;
     
-    connect(protocol, &BaseProtocol::dataParsed,
-            this, &ProtocolHandler::dataParsed);
+    connect(protocol, &BaseProtocol::batchParsed,
+            this, &ProtocolHandler::batchParsed);
+    connect(protocol, &BaseProtocol::batchForLogging,
+            this, &ProtocolHandler::batchForLogging);
     connect(protocol, &BaseProtocol::parseError,
             this, &ProtocolHandler::parseError);
 }
@@ -126,8 +235,10 @@ void ProtocolHandler::disconnectProtocolSignals(BaseProtocol *protocol)
 {
     if (!protocol) return;
     
-    disconnect(protocol, &BaseProtocol::dataParsed,
-               this, &ProtocolHandler::dataParsed);
+    disconnect(protocol, &BaseProtocol::batchParsed,
+               this, &ProtocolHandler::batchParsed);
+    disconnect(protocol, &BaseProtocol::batchForLogging,
+               this, &ProtocolHandler::batchForLogging);
     disconnect(protocol, &BaseProtocol::parseError,
                this, &ProtocolHandler::parseError);
 }
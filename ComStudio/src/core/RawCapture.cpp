@@ -0,0 +1,290 @@
+/**
+ * @file RawCapture.cpp
+ * @brief Implementation of the raw capture writer and reader
+ */
+
+#include "core/RawCapture.h"
+#include "core/TraceRecorder.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QtEndian>
+
+// ============================================================================
+// RawCaptureWriter Implementation
+// ============================================================================
+
+RawCaptureWriter::~RawCaptureWriter()
+{
+    close();
+}
+
+QString RawCaptureWriter::partPath(const QString &path, int partNumber)
+{
+    const QFileInfo info(path);
+    const QString directory = path.left(path.size() - info.fileName().size());
+    QString suffix = info.suffix();
+    if (suffix.isEmpty()) {
+        suffix = RawCaptureFormat::FileSuffix;
+    }
+    return QString("%1%2_%3.%4")
+        .arg(directory, info.completeBaseName())
+        .arg(partNumber, 4, 10, QChar('0'))
+        .arg(suffix);
+}
+
+bool RawCaptureWriter::open(const RawCaptureSettings &settings)
+{
+    close();
+
+    m_settings = settings;
+    m_settings.blockSize = qMax(4096, settings.blockSize);
+    m_errorString.clear();
+    m_partNumber = 0;
+    m_bytesCaptured = 0;
+
+    // Reserve once; block is cleared (capacity kept) after every write
+    m_block.clear();
+    m_block.reserve(m_settings.blockSize + RawCaptureFormat::RecordHeaderSize);
+
+    m_clock.start();
+    m_startEpochMs = QDateTime::currentMSecsSinceEpoch();
+
+    return openNextPart();
+}
+
+bool RawCaptureWriter::append(const QByteArray &data)
+{
+    if (!m_file.isOpen()) {
+        return false;
+    }
+
+    char header[RawCaptureFormat::RecordHeaderSize];
+    qToLittleEndian(static_cast<quint64>(m_clock.nsecsElapsed()), header);
+    qToLittleEndian(static_cast<quint32>(data.size()), header + 8);
+    m_block.append(header, sizeof(header));
+    m_block.append(data);
+    m_bytesCaptured += static_cast<quint64>(data.size());
+
+    if (m_block.size() < m_settings.blockSize) {
+        return true;
+    }
+    if (!flush()) {
+        return false;
+    }
+    if (shouldRotate()) {
+        return openNextPart();
+    }
+    return true;
+}
+
+bool RawCaptureWriter::flush()
+{
+    TRACE_SCOPE("RawCaptureWriter::flush");
+
+    if (!m_file.isOpen() || m_block.isEmpty()) {
+        return m_file.isOpen();
+    }
+
+    bool ok;
+    if (m_settings.compress) {
+        const QByteArray stored = qCompress(m_block, m_settings.compressionLevel);
+        char header[RawCaptureFormat::BlockHeaderSize];
+        qToLittleEndian(static_cast<quint32>(stored.size()), header);
+        qToLittleEndian(static_cast<quint32>(m_block.size()), header + 4);
+        ok = m_file.write(header, sizeof(header)) == sizeof(header)
+            && m_file.write(stored) == stored.size();
+    } else {
+        ok = m_file.write(m_block) == m_block.size();
+    }
+    m_block.resize(0);
+
+    if (!ok) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool RawCaptureWriter::periodicFlush()
+{
+    if (!flush()) {
+        return false;
+    }
+    if (m_file.isOpen() && shouldRotate()) {
+        return openNextPart();
+    }
+    return m_file.isOpen();
+}
+
+void RawCaptureWriter::close()
+{
+    if (m_file.isOpen()) {
+        flush();
+        m_file.close();
+    }
+}
+
+bool RawCaptureWriter::shouldRotate() const
+{
+    if (m_settings.rotateBytes > 0 && m_file.size() >= m_settings.rotateBytes) {
+        return true;
+    }
+    if (m_settings.rotateSeconds > 0
+        && m_clock.nsecsElapsed() - m_partStartNs >= m_settings.rotateSeconds * 1000000000LL) {
+        return true;
+    }
+    return false;
+}
+
+bool RawCaptureWriter::openNextPart()
+{
+    if (m_file.isOpen()) {
+        flush();
+        m_file.close();
+    }
+
+    ++m_partNumber;
+    const bool rotating = m_settings.rotateBytes > 0 || m_settings.rotateSeconds > 0;
+    m_file.setFileName(rotating ? partPath(m_settings.path, m_partNumber) : m_settings.path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    char header[RawCaptureFormat::FileHeaderSize];
+    qToLittleEndian(RawCaptureFormat::FileMagic, header);
+    qToLittleEndian(RawCaptureFormat::Version, header + 4);
+    qToLittleEndian(static_cast<quint16>(m_settings.compress ? RawCaptureFormat::FlagCompressed : 0),
+                    header + 6);
+    qToLittleEndian(static_cast<quint64>(m_startEpochMs), header + 8);
+    qToLittleEndian(static_cast<quint32>(m_partNumber), header + 16);
+    qToLittleEndian(static_cast<quint32>(0), header + 20);
+
+    if (m_file.write(header, sizeof(header)) != sizeof(header)) {
+        m_errorString = m_file.errorString();
+        m_file.close();
+        return false;
+    }
+    m_partStartNs = m_clock.nsecsElapsed();
+    return true;
+}
+
+// ============================================================================
+// RawCaptureReader Implementation
+// ============================================================================
+
+bool RawCaptureReader::open(const QString &path)
+{
+    close();
+    m_errorString.clear();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    char header[RawCaptureFormat::FileHeaderSize];
+    if (m_file.read(header, sizeof(header)) != sizeof(header)
+        || qFromLittleEndian<quint32>(header) != RawCaptureFormat::FileMagic) {
+        m_errorString = QString("Not a raw capture file");
+        m_file.close();
+        return false;
+    }
+
+    const quint16 version = qFromLittleEndian<quint16>(header + 4);
+    if (version > RawCaptureFormat::Version) {
+        m_errorString = QString("Unsupported capture version %1").arg(version);
+        m_file.close();
+        return false;
+    }
+
+    const quint16 flags = qFromLittleEndian<quint16>(header + 6);
+    m_compressed = (flags & RawCaptureFormat::FlagCompressed) != 0;
+    m_startEpochMs = static_cast<qint64>(qFromLittleEndian<quint64>(header + 8));
+    m_partNumber = static_cast<int>(qFromLittleEndian<quint32>(header + 16));
+    m_block.clear();
+    m_blockPos = 0;
+    return true;
+}
+
+void RawCaptureReader::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_block.clear();
+    m_blockPos = 0;
+}
+
+bool RawCaptureReader::rewind()
+{
+    m_block.clear();
+    m_blockPos = 0;
+    return m_file.isOpen() && m_file.seek(RawCaptureFormat::FileHeaderSize);
+}
+
+bool RawCaptureReader::loadBlock()
+{
+    char header[RawCaptureFormat::BlockHeaderSize];
+    if (m_file.read(header, sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+
+    const quint32 storedSize = qFromLittleEndian<quint32>(header);
+    const quint32 rawSize = qFromLittleEndian<quint32>(header + 4);
+    const QByteArray stored = m_file.read(storedSize);
+    if (stored.size() != static_cast<qsizetype>(storedSize)) {
+        return false;  // Truncated tail
+    }
+
+    m_block = qUncompress(stored);
+    m_blockPos = 0;
+    if (m_block.size() != static_cast<qsizetype>(rawSize)) {
+        m_errorString = QString("Corrupt block at offset %1")
+            .arg(m_file.pos() - storedSize - RawCaptureFormat::BlockHeaderSize);
+        m_block.clear();
+        return false;
+    }
+    return true;
+}
+
+bool RawCaptureReader::readNext(qint64 &timestampNs, QByteArray &data)
+{
+    if (!m_file.isOpen()) {
+        return false;
+    }
+
+    if (!m_compressed) {
+        char header[RawCaptureFormat::RecordHeaderSize];
+        if (m_file.read(header, sizeof(header)) != sizeof(header)) {
+            return false;
+        }
+        timestampNs = static_cast<qint64>(qFromLittleEndian<quint64>(header));
+        const quint32 length = qFromLittleEndian<quint32>(header + 8);
+        data = m_file.read(length);
+        return data.size() == static_cast<qsizetype>(length);
+    }
+
+    if (m_blockPos >= m_block.size() && !loadBlock()) {
+        return false;
+    }
+
+    if (m_block.size() - m_blockPos < RawCaptureFormat::RecordHeaderSize) {
+        m_errorString = QString("Truncated record in block");
+        return false;
+    }
+    const char *record = m_block.constData() + m_blockPos;
+    timestampNs = static_cast<qint64>(qFromLittleEndian<quint64>(record));
+    const quint32 length = qFromLittleEndian<quint32>(record + 8);
+    m_blockPos += RawCaptureFormat::RecordHeaderSize;
+
+    if (m_block.size() - m_blockPos < static_cast<qsizetype>(length)) {
+        m_errorString = QString("Truncated record in block");
+        return false;
+    }
+    data = m_block.mid(m_blockPos, length);
+    m_blockPos += length;
+    return true;
+}
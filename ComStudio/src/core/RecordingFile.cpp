@@ -0,0 +1,923 @@
+/**
+ * @file RecordingFile.cpp
+ * @brief Implementation of the native recording writer and reader
+ */
+
+#include "core/RecordingFile.h"
+#include "core/TraceRecorder.h"
+#include "core/SensorRegistry.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QTextStream>
+#include <QtAlgorithms>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// ============================================================================
+// Encoding helpers
+// ============================================================================
+
+void putU16(QByteArray &out, quint16 value)
+{
+    char bytes[2];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, 2);
+}
+
+void putU32(QByteArray &out, quint32 value)
+{
+    char bytes[4];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, 4);
+}
+
+void putU64(QByteArray &out, quint64 value)
+{
+    char bytes[8];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, 8);
+}
+
+void putI64(QByteArray &out, qint64 value)
+{
+    putU64(out, static_cast<quint64>(value));
+}
+
+void putVarint(QByteArray &out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+void putString(QByteArray &out, const QString &text)
+{
+    const QByteArray utf8 = text.toUtf8();
+    const quint16 length = static_cast<quint16>(qMin(utf8.size(), 0xFFFF));
+    putU16(out, length);
+    out.append(utf8.constData(), length);
+}
+
+quint64 zigzagEncode(qint64 value)
+{
+    return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+}
+
+qint64 zigzagDecode(quint64 value)
+{
+    return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+}
+
+/**
+ * XOR encoding: each value is XORed with the previous one. Slowly
+ * changing signals share sign, exponent and high mantissa bits, so
+ * the XOR has long runs of zero bytes at both ends. Only the
+ * significant middle bytes are stored, prefixed by a header byte
+ * (leading zero bytes << 4 | significant byte count). A repeated
+ * value costs a single zero byte.
+ */
+void putXorColumn(QByteArray &out, const QVector<double> &column)
+{
+    quint64 previous = 0;
+    for (double value : column) {
+        quint64 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const quint64 delta = bits ^ previous;
+        previous = bits;
+
+        if (delta == 0) {
+            out.append('\0');
+            continue;
+        }
+
+        const int leading = qCountLeadingZeroBits(delta) / 8;
+        const int trailing = qCountTrailingZeroBits(delta) / 8;
+        const int significant = 8 - leading - trailing;
+
+        out.append(static_cast<char>((leading << 4) | significant));
+        quint64 payload = delta >> (trailing * 8);
+        for (int i = 0; i < significant; ++i) {
+            out.append(static_cast<char>(payload & 0xFF));
+            payload >>= 8;
+        }
+    }
+}
+
+/**
+ * @brief Bounds-checked little-endian reader over a byte span
+ *
+ * Any out-of-range read latches the reader into a failed state and
+ * returns zero, so decoders can check ok() once at the end.
+ */
+class ByteReader
+{
+public:
+    ByteReader(const char *data, qsizetype size)
+        : m_pos(data), m_end(data + size) {}
+
+    bool ok() const { return m_ok; }
+    qsizetype remaining() const { return m_end - m_pos; }
+
+    quint16 u16() { return fixed<quint16>(); }
+    quint32 u32() { return fixed<quint32>(); }
+    quint64 u64() { return fixed<quint64>(); }
+    qint64 i64() { return static_cast<qint64>(fixed<quint64>()); }
+
+    quint64 varint()
+    {
+        quint64 value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (m_pos >= m_end) {
+                m_ok = false;
+                return 0;
+            }
+            const quint8 byte = static_cast<quint8>(*m_pos++);
+            value |= static_cast<quint64>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        m_ok = false;
+        return 0;
+    }
+
+    QString string()
+    {
+        const quint16 length = u16();
+        if (!need(length)) {
+            return QString();
+        }
+        QString text = QString::fromUtf8(m_pos, length);
+        m_pos += length;
+        return text;
+    }
+
+    void xorColumn(QVector<double> &column, int rows)
+    {
+        column.resize(rows);
+        quint64 previous = 0;
+        for (int row = 0; row < rows; ++row) {
+            if (!need(1)) {
+                return;
+            }
+            const quint8 header = static_cast<quint8>(*m_pos++);
+            const int significant = header & 0x0F;
+            const int leading = header >> 4;
+
+            if (significant != 0) {
+                if (leading + significant > 8 || !need(significant)) {
+                    m_ok = false;
+                    return;
+                }
+                quint64 payload = 0;
+                for (int i = 0; i < significant; ++i) {
+                    payload |= static_cast<quint64>(static_cast<quint8>(m_pos[i])) << (8 * i);
+                }
+                m_pos += significant;
+                const int trailing = 8 - leading - significant;
+                previous ^= payload << (trailing * 8);
+            }
+
+            double value;
+            std::memcpy(&value, &previous, sizeof(value));
+            column[row] = value;
+        }
+    }
+
+private:
+    bool need(qsizetype count)
+    {
+        if (!m_ok || m_end - m_pos < count) {
+            m_ok = false;
+            return false;
+        }
+        return true;
+    }
+
+    template<typename T>
+    T fixed()
+    {
+        if (!need(sizeof(T))) {
+            return 0;
+        }
+        T value = qFromLittleEndian<T>(m_pos);
+        m_pos += sizeof(T);
+        return value;
+    }
+
+    const char *m_pos;
+    const char *m_end;
+    bool m_ok = true;
+};
+
+/**
+ * @brief Decode a chunk payload (everything after the chunk header)
+ */
+bool decodeChunk(const QByteArray &payload, RecordingChunk &chunk)
+{
+    ByteReader reader(payload.constData(), payload.size());
+
+    const quint32 rows = reader.u32();
+    const qint64 firstTimestamp = reader.i64();
+    reader.i64();  // lastTimestamp (index only)
+    const quint64 firstIndex = reader.u64();
+
+    const quint16 channelCount = reader.u16();
+    chunk.channelNames.clear();
+    for (int i = 0; i < channelCount; ++i) {
+        chunk.channelNames.append(reader.string());
+    }
+
+    const quint16 sensorCount = reader.u16();
+    chunk.sensorIds.clear();
+    for (int i = 0; i < sensorCount; ++i) {
+        chunk.sensorIds.append(reader.string());
+    }
+
+    // Every row after the first costs at least one timestamp byte
+    if (!reader.ok() || rows == 0 || rows > static_cast<quint64>(reader.remaining()) + 1) {
+        return false;
+    }
+
+    const int rowCount = static_cast<int>(rows);
+
+    chunk.timestamps.resize(rowCount);
+    chunk.timestamps[0] = firstTimestamp;
+    qint64 delta = 0;
+    for (int i = 1; i < rowCount; ++i) {
+        delta += zigzagDecode(reader.varint());
+        chunk.timestamps[i] = chunk.timestamps[i - 1] + delta;
+    }
+
+    chunk.packetIndices.resize(rowCount);
+    chunk.packetIndices[0] = firstIndex;
+    for (int i = 1; i < rowCount; ++i) {
+        chunk.packetIndices[i] = chunk.packetIndices[i - 1]
+            + static_cast<quint64>(zigzagDecode(reader.varint()));
+    }
+
+    chunk.sensorRefs.clear();
+    if (sensorCount > 1) {
+        chunk.sensorRefs.resize(rowCount);
+        for (int i = 0; i < rowCount; ++i) {
+            const quint64 ref = reader.varint();
+            if (ref >= sensorCount) {
+                return false;
+            }
+            chunk.sensorRefs[i] = static_cast<int>(ref);
+        }
+    }
+
+    chunk.columns.resize(channelCount);
+    for (int c = 0; c < channelCount; ++c) {
+        reader.xorColumn(chunk.columns[c], rowCount);
+    }
+
+    return reader.ok();
+}
+
+// ============================================================================
+// CSV helpers
+// ============================================================================
+
+/**
+ * RFC 4180 field: quoted if it contains a separator, quote or line
+ * break, with embedded quotes doubled.
+ */
+QString csvField(const QString &text)
+{
+    if (!text.contains(QLatin1Char(',')) && !text.contains(QLatin1Char('"'))
+        && !text.contains(QLatin1Char('\n')) && !text.contains(QLatin1Char('\r'))) {
+        return text;
+    }
+    QString quoted = text;
+    quoted.replace(QLatin1Char('"'), QLatin1String("\"\""));
+    return QLatin1Char('"') + quoted + QLatin1Char('"');
+}
+
+} // namespace
+
+// ============================================================================
+// RecordingChunk Implementation
+// ============================================================================
+
+QString RecordingChunk::sensorIdAt(int row) const
+{
+    if (sensorRefs.isEmpty()) {
+        return sensorIds.value(0);
+    }
+    return sensorIds.value(sensorRefs.value(row));
+}
+
+GenericDataPacket RecordingChunk::packetAt(int row) const
+{
+    GenericDataPacket packet;
+    if (row < 0 || row >= rowCount()) {
+        return packet;
+    }
+
+    packet.timestamp = timestamps[row];
+    packet.packetIndex = packetIndices[row];
+    packet.sensorId = sensorIdAt(row);
+    packet.sensorKey = SensorRegistry::instance().intern(packet.sensorId);
+    for (int c = 0; c < channelNames.size(); ++c) {
+        packet.addChannel(channelNames[c], columns[c][row]);
+    }
+    packet.isValid = packet.hasData();
+    return packet;
+}
+
+int RecordingChunk::lowerBound(qint64 timestamp) const
+{
+    auto it = std::lower_bound(timestamps.cbegin(), timestamps.cend(), timestamp);
+    return static_cast<int>(it - timestamps.cbegin());
+}
+
+// ============================================================================
+// RecordingWriter Implementation
+// ============================================================================
+
+RecordingWriter::RecordingWriter(int rowsPerChunk)
+    : m_rowsPerChunk(qMax(1, rowsPerChunk))
+{
+}
+
+RecordingWriter::~RecordingWriter()
+{
+    close();
+}
+
+bool RecordingWriter::open(const QString &path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    m_rowCount = 0;
+    m_schema.clear();
+    m_timestamps.clear();
+    m_packetIndices.clear();
+    m_sensorDict.clear();
+    m_sensorRefs.clear();
+    m_columns.clear();
+    m_schemas.clear();
+    m_index.clear();
+    m_errorString.clear();
+
+    QByteArray header;
+    putU32(header, RecordingFormat::FileMagic);
+    putU16(header, RecordingFormat::Version);
+    putU16(header, 0);  // flags
+    putI64(header, QDateTime::currentMSecsSinceEpoch());
+
+    if (m_file.write(header) != header.size()) {
+        m_errorString = m_file.errorString();
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+bool RecordingWriter::append(const GenericDataPacket &packet)
+{
+    if (!m_file.isOpen()) {
+        return false;
+    }
+    if (packet.channelNames.size() != packet.values.size()) {
+        m_errorString = "Packet channel names do not match its values";
+        return false;
+    }
+
+    bool ok = true;
+    if (!m_timestamps.isEmpty()) {
+        const bool spanExceeded = m_maxChunkSpanMs > 0
+            && packet.timestamp - m_timestamps.first() > m_maxChunkSpanMs;
+        if (m_timestamps.size() >= m_rowsPerChunk || spanExceeded || !matchesSchema(packet)) {
+            ok = writeChunk();
+        }
+    }
+
+    if (m_timestamps.isEmpty()) {
+        beginChunk(packet);
+    }
+
+    m_timestamps.append(packet.timestamp);
+    m_packetIndices.append(packet.packetIndex);
+
+    int sensorRef = m_sensorDict.indexOf(packet.sensorId);
+    if (sensorRef < 0) {
+        sensorRef = m_sensorDict.size();
+        m_sensorDict.append(packet.sensorId);
+    }
+    m_sensorRefs.append(sensorRef);
+
+    for (int column = 0; column < m_schema.size(); ++column) {
+        m_columns[column].append(packet.values.at(column));
+    }
+
+    ++m_rowCount;
+    return ok;
+}
+
+bool RecordingWriter::flush()
+{
+    return writeChunk();
+}
+
+bool RecordingWriter::close()
+{
+    if (!m_file.isOpen()) {
+        return true;
+    }
+
+    bool ok = writeChunk();
+    ok = writeIndex() && ok;
+    m_file.close();
+    return ok;
+}
+
+bool RecordingWriter::matchesSchema(const GenericDataPacket &packet) const
+{
+    return packet.channelNames == m_schema;
+}
+
+void RecordingWriter::beginChunk(const GenericDataPacket &packet)
+{
+    // Columns follow packet.values so packetAt() restores the parse order
+    m_schema = packet.channelNames;
+    m_columns.resize(m_schema.size());
+    for (auto &column : m_columns) {
+        column.clear();
+        column.reserve(m_rowsPerChunk);
+    }
+    m_timestamps.reserve(m_rowsPerChunk);
+    m_packetIndices.reserve(m_rowsPerChunk);
+    m_sensorRefs.reserve(m_rowsPerChunk);
+}
+
+bool RecordingWriter::writeChunk()
+{
+    TRACE_SCOPE("RecordingWriter::writeChunk");
+
+    if (m_timestamps.isEmpty() || !m_file.isOpen()) {
+        return true;
+    }
+
+    const int rows = m_timestamps.size();
+    QByteArray &out = m_encodeBuffer;
+    out.clear();
+    out.reserve(64 + rows * (4 + m_schema.size() * 9));
+
+    putU32(out, RecordingFormat::ChunkMagic);
+    putU32(out, 0);  // payload size, patched below
+
+    putU32(out, static_cast<quint32>(rows));
+    putI64(out, m_timestamps.first());
+    putI64(out, m_timestamps.last());
+    putU64(out, m_packetIndices.first());
+
+    putU16(out, static_cast<quint16>(m_schema.size()));
+    for (const QString &name : m_schema) {
+        putString(out, name);
+    }
+
+    putU16(out, static_cast<quint16>(m_sensorDict.size()));
+    for (const QString &id : m_sensorDict) {
+        putString(out, id);
+    }
+
+    // Timestamps: delta-of-delta, so a steady sample rate costs one byte per row
+    qint64 previousDelta = 0;
+    for (int i = 1; i < rows; ++i) {
+        const qint64 delta = m_timestamps[i] - m_timestamps[i - 1];
+        putVarint(out, zigzagEncode(delta - previousDelta));
+        previousDelta = delta;
+    }
+
+    // Packet indices: plain delta (usually 1)
+    for (int i = 1; i < rows; ++i) {
+        putVarint(out, zigzagEncode(static_cast<qint64>(m_packetIndices[i] - m_packetIndices[i - 1])));
+    }
+
+    if (m_sensorDict.size() > 1) {
+        for (int ref : m_sensorRefs) {
+            putVarint(out, static_cast<quint64>(ref));
+        }
+    }
+
+    for (const auto &column : m_columns) {
+        putXorColumn(out, column);
+    }
+
+    qToLittleEndian(static_cast<quint32>(out.size() - RecordingFormat::ChunkHeaderSize),
+                    out.data() + 4);
+
+    RecordingIndexEntry entry;
+    entry.firstTimestamp = m_timestamps.first();
+    entry.lastTimestamp = m_timestamps.last();
+    entry.offset = static_cast<quint64>(m_file.pos());
+    entry.rowCount = static_cast<quint32>(rows);
+
+    int schemaId = m_schemas.indexOf(m_schema);
+    if (schemaId < 0) {
+        schemaId = m_schemas.size();
+        m_schemas.append(m_schema);
+    }
+    entry.schemaId = static_cast<quint16>(schemaId);
+
+    m_timestamps.clear();
+    m_packetIndices.clear();
+    m_sensorDict.clear();
+    m_sensorRefs.clear();
+    for (auto &column : m_columns) {
+        column.clear();
+    }
+
+    if (m_file.write(out) != out.size() || !m_file.flush()) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    m_index.append(entry);
+    return true;
+}
+
+bool RecordingWriter::writeIndex()
+{
+    const quint64 indexOffset = static_cast<quint64>(m_file.pos());
+
+    QByteArray out;
+    out.reserve(64 + m_index.size() * 30);
+
+    putU32(out, RecordingFormat::IndexMagic);
+    putU16(out, static_cast<quint16>(m_schemas.size()));
+    for (const QStringList &schema : m_schemas) {
+        putU16(out, static_cast<quint16>(schema.size()));
+        for (const QString &name : schema) {
+            putString(out, name);
+        }
+    }
+
+    putU32(out, static_cast<quint32>(m_index.size()));
+    for (const auto &entry : m_index) {
+        putI64(out, entry.firstTimestamp);
+        putI64(out, entry.lastTimestamp);
+        putU64(out, entry.offset);
+        putU32(out, entry.rowCount);
+        putU16(out, entry.schemaId);
+    }
+
+    putU64(out, indexOffset);
+    putU32(out, RecordingFormat::TrailerMagic);
+
+    if (m_file.write(out) != out.size()) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// RecordingReader Implementation
+// ============================================================================
+
+bool RecordingReader::open(const QString &path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    const QByteArray header = m_file.read(RecordingFormat::FileHeaderSize);
+    ByteReader reader(header.constData(), header.size());
+    const quint32 magic = reader.u32();
+    const quint16 version = reader.u16();
+
+    if (!reader.ok() || magic != RecordingFormat::FileMagic) {
+        m_errorString = QStringLiteral("Not a ComStudio recording");
+        m_file.close();
+        return false;
+    }
+    if (version > RecordingFormat::Version) {
+        m_errorString = QString("Unsupported recording version %1").arg(version);
+        m_file.close();
+        return false;
+    }
+
+    if (!loadIndex()) {
+        rebuildIndex();
+    }
+    return true;
+}
+
+void RecordingReader::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_index.clear();
+    m_schemas.clear();
+    m_recovered = false;
+}
+
+quint64 RecordingReader::rowCount() const
+{
+    quint64 total = 0;
+    for (const auto &entry : m_index) {
+        total += entry.rowCount;
+    }
+    return total;
+}
+
+qint64 RecordingReader::firstTimestamp() const
+{
+    return m_index.isEmpty() ? 0 : m_index.first().firstTimestamp;
+}
+
+qint64 RecordingReader::lastTimestamp() const
+{
+    return m_index.isEmpty() ? 0 : m_index.last().lastTimestamp;
+}
+
+QStringList RecordingReader::allChannelNames() const
+{
+    QStringList names;
+    for (const auto &entry : m_index) {
+        for (const QString &name : m_schemas.value(entry.schemaId)) {
+            if (!names.contains(name)) {
+                names.append(name);
+            }
+        }
+    }
+    return names;
+}
+
+int RecordingReader::findChunk(qint64 timestamp) const
+{
+    auto it = std::lower_bound(m_index.cbegin(), m_index.cend(), timestamp,
+        [](const RecordingIndexEntry &entry, qint64 value) {
+            return entry.lastTimestamp < value;
+        });
+    if (it == m_index.cend()) {
+        return -1;
+    }
+    return static_cast<int>(it - m_index.cbegin());
+}
+
+bool RecordingReader::readChunk(int chunkIndex, RecordingChunk &chunk)
+{
+    if (chunkIndex < 0 || chunkIndex >= m_index.size()) {
+        m_errorString = QString("Chunk %1 out of range").arg(chunkIndex);
+        return false;
+    }
+
+    if (!m_file.seek(static_cast<qint64>(m_index[chunkIndex].offset))) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    const QByteArray header = m_file.read(RecordingFormat::ChunkHeaderSize);
+    ByteReader reader(header.constData(), header.size());
+    const quint32 magic = reader.u32();
+    const quint32 payloadSize = reader.u32();
+    if (!reader.ok() || magic != RecordingFormat::ChunkMagic) {
+        m_errorString = QString("Corrupt chunk header at chunk %1").arg(chunkIndex);
+        return false;
+    }
+
+    m_payload.resize(payloadSize);
+    if (m_file.read(m_payload.data(), payloadSize) != static_cast<qint64>(payloadSize)) {
+        m_errorString = QString("Truncated chunk %1").arg(chunkIndex);
+        return false;
+    }
+
+    if (!decodeChunk(m_payload, chunk)) {
+        m_errorString = QString("Corrupt chunk payload at chunk %1").arg(chunkIndex);
+        return false;
+    }
+    return true;
+}
+
+bool RecordingReader::seek(qint64 timestamp, RecordingChunk &chunk, int &row)
+{
+    const int chunkIndex = findChunk(timestamp);
+    if (chunkIndex < 0 || !readChunk(chunkIndex, chunk)) {
+        return false;
+    }
+
+    row = chunk.lowerBound(timestamp);
+    return row < chunk.rowCount();
+}
+
+bool RecordingReader::loadIndex()
+{
+    const qint64 fileSize = m_file.size();
+    if (fileSize < RecordingFormat::FileHeaderSize + RecordingFormat::TrailerSize) {
+        return false;
+    }
+
+    if (!m_file.seek(fileSize - RecordingFormat::TrailerSize)) {
+        return false;
+    }
+    const QByteArray trailer = m_file.read(RecordingFormat::TrailerSize);
+    ByteReader trailerReader(trailer.constData(), trailer.size());
+    const quint64 indexOffset = trailerReader.u64();
+    const quint32 magic = trailerReader.u32();
+
+    const quint64 indexEnd = static_cast<quint64>(fileSize - RecordingFormat::TrailerSize);
+    if (!trailerReader.ok() || magic != RecordingFormat::TrailerMagic
+        || indexOffset < static_cast<quint64>(RecordingFormat::FileHeaderSize)
+        || indexOffset >= indexEnd) {
+        return false;
+    }
+
+    if (!m_file.seek(static_cast<qint64>(indexOffset))) {
+        return false;
+    }
+    const QByteArray data = m_file.read(static_cast<qint64>(indexEnd - indexOffset));
+    ByteReader reader(data.constData(), data.size());
+
+    if (reader.u32() != RecordingFormat::IndexMagic) {
+        return false;
+    }
+
+    QVector<QStringList> schemas;
+    const quint16 schemaCount = reader.u16();
+    for (int s = 0; s < schemaCount && reader.ok(); ++s) {
+        const quint16 nameCount = reader.u16();
+        QStringList names;
+        for (int i = 0; i < nameCount && reader.ok(); ++i) {
+            names.append(reader.string());
+        }
+        schemas.append(names);
+    }
+
+    constexpr int EntrySize = 30;
+    const quint32 entryCount = reader.u32();
+    if (!reader.ok() || static_cast<quint64>(entryCount) * EntrySize > static_cast<quint64>(reader.remaining())) {
+        return false;
+    }
+
+    QVector<RecordingIndexEntry> index;
+    index.reserve(static_cast<int>(entryCount));
+    for (quint32 i = 0; i < entryCount; ++i) {
+        RecordingIndexEntry entry;
+        entry.firstTimestamp = reader.i64();
+        entry.lastTimestamp = reader.i64();
+        entry.offset = reader.u64();
+        entry.rowCount = reader.u32();
+        entry.schemaId = reader.u16();
+        if (entry.schemaId >= schemaCount) {
+            return false;
+        }
+        index.append(entry);
+    }
+
+    if (!reader.ok()) {
+        return false;
+    }
+
+    m_schemas = schemas;
+    m_index = index;
+    m_recovered = false;
+    return true;
+}
+
+bool RecordingReader::rebuildIndex()
+{
+    m_index.clear();
+    m_schemas.clear();
+    m_recovered = true;
+
+    const qint64 fileSize = m_file.size();
+    qint64 pos = RecordingFormat::FileHeaderSize;
+
+    while (pos + RecordingFormat::ChunkHeaderSize <= fileSize) {
+        if (!m_file.seek(pos)) {
+            break;
+        }
+
+        const QByteArray header = m_file.read(RecordingFormat::ChunkHeaderSize);
+        ByteReader headerReader(header.constData(), header.size());
+        const quint32 magic = headerReader.u32();
+        const quint32 payloadSize = headerReader.u32();
+        const qint64 chunkEnd = pos + RecordingFormat::ChunkHeaderSize + payloadSize;
+        if (!headerReader.ok() || magic != RecordingFormat::ChunkMagic || chunkEnd > fileSize) {
+            break;  // Torn write or start of the index
+        }
+
+        m_payload.resize(payloadSize);
+        if (m_file.read(m_payload.data(), payloadSize) != static_cast<qint64>(payloadSize)) {
+            break;
+        }
+
+        ByteReader reader(m_payload.constData(), m_payload.size());
+        RecordingIndexEntry entry;
+        entry.rowCount = reader.u32();
+        entry.firstTimestamp = reader.i64();
+        entry.lastTimestamp = reader.i64();
+        entry.offset = static_cast<quint64>(pos);
+        reader.u64();  // firstIndex
+
+        QStringList names;
+        const quint16 nameCount = reader.u16();
+        for (int i = 0; i < nameCount && reader.ok(); ++i) {
+            names.append(reader.string());
+        }
+        if (!reader.ok()) {
+            break;
+        }
+
+        int schemaId = m_schemas.indexOf(names);
+        if (schemaId < 0) {
+            schemaId = m_schemas.size();
+            m_schemas.append(names);
+        }
+        entry.schemaId = static_cast<quint16>(schemaId);
+
+        m_index.append(entry);
+        pos = chunkEnd;
+    }
+
+    return true;
+}
+
+bool RecordingReader::convertToCsv(const QString &recordingPath, const QString &csvPath,
+                                   QString *errorMessage)
+{
+    RecordingReader reader;
+    if (!reader.open(recordingPath)) {
+        if (errorMessage) *errorMessage = reader.errorString();
+        return false;
+    }
+
+    QFile csvFile(csvPath);
+    if (!csvFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        if (errorMessage) *errorMessage = csvFile.errorString();
+        return false;
+    }
+
+    QTextStream stream(&csvFile);
+
+    // Header covers every channel seen anywhere in the recording
+    const QStringList names = reader.allChannelNames();
+    QHash<QString, int> columnOf;
+    for (int i = 0; i < names.size(); ++i) {
+        columnOf.insert(names[i], i);
+    }
+
+    stream << "Timestamp,PacketIndex,SensorID";
+    for (const QString &name : names) {
+        stream << ',' << csvField(name);
+    }
+    stream << '\n';
+
+    RecordingChunk chunk;
+    QVector<int> sourceColumn(names.size());
+
+    for (int c = 0; c < reader.chunkCount(); ++c) {
+        if (!reader.readChunk(c, chunk)) {
+            if (errorMessage) *errorMessage = reader.errorString();
+            return false;
+        }
+
+        // Map output columns to this chunk's columns (-1 = not present)
+        sourceColumn.fill(-1);
+        for (int i = 0; i < chunk.channelNames.size(); ++i) {
+            sourceColumn[columnOf.value(chunk.channelNames[i])] = i;
+        }
+
+        for (int row = 0; row < chunk.rowCount(); ++row) {
+            stream << chunk.timestamps[row] << ','
+                   << chunk.packetIndices[row] << ','
+                   << csvField(chunk.sensorIdAt(row));
+            for (int source : sourceColumn) {
+                stream << ',';
+                if (source >= 0) {
+                    stream << QString::number(chunk.columns[source][row], 'f', 6);
+                }
+            }
+            stream << '\n';
+        }
+    }
+
+    stream.flush();
+    if (stream.status() != QTextStream::Ok) {
+        if (errorMessage) *errorMessage = csvFile.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file ReplaySource.cpp
+ * @brief Implementation of ReplaySource
+ */
+
+#include "core/ReplaySource.h"
+
+#include <QFileInfo>
+#include <QtEndian>
+
+namespace {
+constexpr qint64 LogChunkSize = 4096;   ///< Bytes read per text log chunk
+}
+
+bool ReplaySource::open(const QString &path, qint64 logBytesPerSecond)
+{
+    close();
+    m_errorString.clear();
+    m_logBytesPerSecond = qMax<qint64>(1, logBytesPerSecond);
+
+    // A rotating capture has no file at its base path, only numbered parts
+    QString source = path;
+    if (!QFileInfo::exists(path) && QFileInfo::exists(RawCaptureWriter::partPath(path, 1))) {
+        source = RawCaptureWriter::partPath(path, 1);
+    }
+
+    // Sniff the magic to pick the reader
+    QFile probe(source);
+    if (!probe.open(QIODevice::ReadOnly)) {
+        m_errorString = probe.errorString();
+        return false;
+    }
+    const QByteArray magic = probe.read(4);
+    probe.close();
+
+    m_isCapture = magic.size() == 4
+        && qFromLittleEndian<quint32>(magic.constData()) == RawCaptureFormat::FileMagic;
+
+    if (m_isCapture) {
+        if (!m_capture.open(source)) {
+            m_errorString = m_capture.errorString();
+            return false;
+        }
+        m_startEpochMs = m_capture.startEpochMs();
+        m_totalBytes = m_capture.fileSize();
+
+        // Parts are named <base>_0001.<suffix>, ... (RawCaptureWriter::partPath())
+        const QFileInfo info(source);
+        const QString tag = QString("_%1").arg(m_capture.partNumber(), 4, 10, QChar('0'));
+        if (m_capture.partNumber() > 0 && info.completeBaseName().endsWith(tag)) {
+            m_partBase = source.left(source.size() - info.fileName().size())
+                         + info.completeBaseName().chopped(tag.size()) + '.' + info.suffix();
+            for (int part = m_capture.partNumber() + 1;; ++part) {
+                const QFileInfo next(RawCaptureWriter::partPath(m_partBase, part));
+                if (!next.exists()) {
+                    break;
+                }
+                m_totalBytes += next.size();
+            }
+        }
+        return true;
+    }
+
+    m_log.setFileName(source);
+    if (!m_log.open(QIODevice::ReadOnly)) {
+        m_errorString = m_log.errorString();
+        return false;
+    }
+    return true;
+}
+
+void ReplaySource::close()
+{
+    m_capture.close();
+    m_partBase.clear();
+    m_startEpochMs = 0;
+    m_doneBytes = 0;
+    m_totalBytes = 0;
+    if (m_log.isOpen()) {
+        m_log.close();
+    }
+    m_logCarry.clear();
+    m_hasFirst = false;
+    m_firstNs = 0;
+    m_logBytes = 0;
+}
+
+bool ReplaySource::next(QByteArray &data, qint64 &offsetNs)
+{
+    if (m_isCapture) {
+        qint64 timestampNs = 0;
+        while (!m_capture.readNext(timestampNs, data)) {
+            if (!m_capture.errorString().isEmpty() || !openNextPart()) {
+                return false;
+            }
+        }
+        if (!m_hasFirst) {
+            m_firstNs = timestampNs;
+            m_hasFirst = true;
+        }
+        offsetNs = timestampNs - m_firstNs;
+        return true;
+    }
+
+    if (!m_log.isOpen()) {
+        return false;
+    }
+
+    // Line-aligned chunks so a replayed log looks like line-buffered device output
+    data = m_logCarry;
+    m_logCarry.clear();
+    while (true) {
+        const QByteArray block = m_log.read(LogChunkSize);
+        data.append(block);
+        if (block.isEmpty()) {
+            break;  // End of file: return whatever is left
+        }
+        const qsizetype lastNewline = data.lastIndexOf('\n');
+        if (lastNewline >= 0) {
+            m_logCarry = data.mid(lastNewline + 1);
+            data.truncate(lastNewline + 1);
+            break;
+        }
+    }
+    if (data.isEmpty()) {
+        return false;
+    }
+
+    offsetNs = static_cast<qint64>(m_logBytes * 1000000000ULL
+                                   / static_cast<quint64>(m_logBytesPerSecond));
+    m_logBytes += static_cast<quint64>(data.size());
+    return true;
+}
+
+bool ReplaySource::openNextPart()
+{
+    if (m_partBase.isEmpty()) {
+        return false;
+    }
+    const int part = m_capture.partNumber() + 1;
+    const QString path = RawCaptureWriter::partPath(m_partBase, part);
+    if (!QFileInfo::exists(path)) {
+        return false;   // Last part: clean end
+    }
+
+    m_doneBytes += m_capture.fileSize();
+    m_capture.close();
+    if (!m_capture.open(path)) {
+        return false;
+    }
+    // monotonicNs keeps counting across the parts of one session only
+    if (m_capture.startEpochMs() != m_startEpochMs || m_capture.partNumber() != part) {
+        m_capture.close();
+        m_errorString = QString("%1 is not part %2 of this capture").arg(QFileInfo(path).fileName()).arg(part);
+        return false;
+    }
+    return true;
+}
+
+QString ReplaySource::errorString() const
+{
+    if (!m_errorString.isEmpty() || !m_isCapture) {
+        return m_errorString;
+    }
+    return m_capture.errorString();
+}
+
+double ReplaySource::progress() const
+{
+    if (m_isCapture) {
+        return m_totalBytes > 0 ? qMin(1.0, static_cast<double>(m_doneBytes + m_capture.position()) / m_totalBytes)
+                                : 1.0;
+    }
+    const qint64 size = m_log.size();
+    return size > 0 ? static_cast<double>(m_log.pos()) / size : 1.0;
+}
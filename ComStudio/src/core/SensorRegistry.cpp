@@ -0,0 +1,110 @@
+/**
+ * @file SensorRegistry.cpp
+ * @brief Implementation of SensorRegistry
+ */
+
+#include "core/SensorRegistry.h"
+
+#include <QHash>
+
+SensorRegistry &SensorRegistry::instance()
+{
+    static SensorRegistry instance;
+    return instance;
+}
+
+SensorRegistry::SensorRegistry()
+    : m_buckets(BucketCount, 0)
+{
+    m_names.reserve(MaxSensors);
+}
+
+qsizetype SensorRegistry::probe(QStringView id, size_t hash) const
+{
+    // Linear probing; the table never fills beyond half, so this ends
+    qsizetype bucket = static_cast<qsizetype>(hash & (BucketCount - 1));
+    while (m_buckets[bucket] != 0 && m_names[m_buckets[bucket] - 1] != id) {
+        bucket = (bucket + 1) & (BucketCount - 1);
+    }
+    return bucket;
+}
+
+int SensorRegistry::intern(QStringView id)
+{
+    if (id.isEmpty()) {
+        return -1;
+    }
+
+    const size_t hash = qHash(id);
+    {
+        QReadLocker locker(&m_lock);
+        const int stored = m_buckets[probe(id, hash)];
+        if (stored != 0) {
+            return stored - 1;
+        }
+    }
+
+    // Probe again: another thread may have added it in between
+    QWriteLocker locker(&m_lock);
+    const qsizetype bucket = probe(id, hash);
+    if (m_buckets[bucket] != 0) {
+        return m_buckets[bucket] - 1;
+    }
+    if (m_names.size() >= MaxSensors) {
+        return -1;
+    }
+    m_names.append(id.toString());
+    m_buckets[bucket] = static_cast<int>(m_names.size());
+    return static_cast<int>(m_names.size()) - 1;
+}
+
+int SensorRegistry::find(QStringView id) const
+{
+    if (id.isEmpty()) {
+        return -1;
+    }
+    QReadLocker locker(&m_lock);
+    return m_buckets[probe(id, qHash(id))] - 1;
+}
+
+QString SensorRegistry::name(int key) const
+{
+    QReadLocker locker(&m_lock);
+    return m_names.value(key);
+}
+
+int SensorRegistry::count() const
+{
+    QReadLocker locker(&m_lock);
+    return static_cast<int>(m_names.size());
+}
+
+bool SensorRegistry::idMatches(QStringView id, QStringView filter)
+{
+    if (id.compare(filter, Qt::CaseInsensitive) == 0) {
+        return true;
+    }
+
+    // Compare the digits (and signs) of both in place
+    auto isNumeric = [](QChar c) { return c.isDigit() || c == u'-'; };
+    qsizetype i = 0;
+    qsizetype j = 0;
+    bool matched = false;
+    while (true) {
+        while (i < id.size() && !isNumeric(id[i])) {
+            ++i;
+        }
+        while (j < filter.size() && !isNumeric(filter[j])) {
+            ++j;
+        }
+        if (i == id.size() || j == filter.size()) {
+            return matched && i == id.size() && j == filter.size();
+        }
+        if (id[i] != filter[j]) {
+            return false;
+        }
+        matched = true;
+        ++i;
+        ++j;
+    }
+}
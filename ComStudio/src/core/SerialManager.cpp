@@ -4,7 +4,33 @@
  */
 
 #include "core/SerialManager.h"
+#include "core/PipelineMetrics.h"
+#include "core/LatencyTracer.h"
+#include "core/TraceRecorder.h"
 #include <QDebug>
+#include <QFileInfo>
+#include <QTimer>
+
+namespace {
+constexpr int MaxPendingReplayChunks = 4;           ///< Max-speed replay back-pressure limit
+constexpr qsizetype MaxReplayBatchBytes = 64 * 1024; ///< Bytes per max-speed emission
+constexpr int GeneratorTickMs = 5;                  ///< Generator emission period
+constexpr qint64 BlockingReadBufferBytes = 64 * 1024; ///< QSerialPort buffer while the reader waits
+constexpr qint64 DrainSliceMs = 8;                  ///< GUI thread time per drain pass
+constexpr double OverloadOnRatio = 0.5;             ///< Queue fill that reports overload
+constexpr double OverloadOffRatio = 0.25;           ///< Queue fill that clears it again
+
+QString generatorFormatName(GeneratorFormat format)
+{
+    switch (format) {
+        case GeneratorFormat::Csv:        return "CSV";
+        case GeneratorFormat::Labeled:    return "labeled";
+        case GeneratorFormat::IdPrefixed: return "ID-prefixed";
+        case GeneratorFormat::JustFloat:  return "JustFloat";
+    }
+    return QString();
+}
+}
 
 // ============================================================================
 // SerialWorker Implementation
@@ -28,6 +54,23 @@ void SerialWorker::openPort(const SerialSettings &settings)
     if (m_serialPort && m_serialPort->isOpen()) {
         m_serialPort->close();
     }
+    m_serialPort.reset();
+    if (m_replay) {
+        finishReplay(false);
+    }
+    if (m_generator) {
+        stopGenerator("Generator stopped");
+    }
+    m_queue.setSettings(settings.ingest);
+    
+    if (settings.kind == PortKind::Replay) {
+        openReplay(settings);
+        return;
+    }
+    if (settings.kind == PortKind::Generator) {
+        openGenerator(settings);
+        return;
+    }
     
     m_serialPort = std::make_unique<QSerialPort>();
     
@@ -39,6 +82,12 @@ void SerialWorker::openPort(const SerialSettings &settings)
     m_serialPort->setStopBits(settings.stopBits);
     m_serialPort->setFlowControl(settings.flowControl);
     
+    // A waiting reader leaves data in a bounded port buffer, so the driver
+    // buffer and flow control (if any) hold off the sender
+    if (settings.ingest.blocks()) {
+        m_serialPort->setReadBufferSize(BlockingReadBufferBytes);
+    }
+    
     // Connect signals
     connect(m_serialPort.get(), &QSerialPort::readyRead,
             this, &SerialWorker::handleReadyRead);
@@ -63,6 +112,14 @@ void SerialWorker::openPort(const SerialSettings &settings)
 
 void SerialWorker::closePort()
 {
+    if (m_replay) {
+        finishReplay(false);
+        return;
+    }
+    if (m_generator) {
+        stopGenerator("Disconnected");
+        return;
+    }
     if (m_serialPort) {
         if (m_serialPort->isOpen()) {
             m_serialPort->close();
@@ -74,6 +131,14 @@ void SerialWorker::closePort()
 
 void SerialWorker::writeData(const QByteArray &data)
 {
+    if (m_replay) {
+        emit errorOccurred("Cannot write: replay source is read-only");
+        return;
+    }
+    if (m_generator) {
+        emit errorOccurred("Cannot write: generator is read-only");
+        return;
+    }
     if (m_serialPort && m_serialPort->isOpen()) {
         qint64 written = m_serialPort->write(data);
         if (written != data.size()) {
@@ -89,9 +154,290 @@ void SerialWorker::handleReadyRead()
 {
     if (!m_serialPort) return;
     
+    // Blocking policies: leave the bytes in the port until the queue has room
+    if (m_queue.settings().blocks() && !m_queue.tryAdmit()) {
+        return;
+    }
+    
+    TRACE_SCOPE("SerialWorker::handleReadyRead");
+    const qint64 readNs = LatencyTracer::nowNs();
+    StageTimer timer(MetricStage::Read);
     QByteArray data = m_serialPort->readAll();
     if (!data.isEmpty()) {
-        emit rawBytesReady(data);
+        // Capture before anything else touches the bytes
+        if (m_capture && !m_capture->append(data)) {
+            emit errorOccurred(QString("Raw capture write failed: %1")
+                .arg(m_capture->errorString()));
+            stopCapture();
+        }
+        emitChunk(data, readNs);
+    }
+}
+
+void SerialWorker::resumeReading()
+{
+    if (m_serialPort && m_serialPort->bytesAvailable() > 0) {
+        handleReadyRead();
+    }
+}
+
+void SerialWorker::emitChunk(const QByteArray &data, qint64 readNs)
+{
+    auto &metrics = PipelineMetrics::instance();
+    metrics.add(MetricCounter::BytesRead, static_cast<quint64>(data.size()));
+    metrics.add(MetricCounter::ChunksRead);
+    
+    if (m_replay) {
+        m_replayStats.bytes += static_cast<quint64>(data.size());
+        m_replayStats.chunks++;
+    }
+    
+    IngestChunk chunk;
+    chunk.data = data;
+    chunk.traceId = m_nextTraceId++;
+    chunk.readNs = readNs < 0 ? LatencyTracer::nowNs() : readNs;
+    const bool wake = m_queue.push(std::move(chunk));
+    metrics.setGauge(MetricGauge::SerialPendingChunks, m_queue.size());
+    metrics.setGauge(MetricGauge::SerialPendingBytes, m_queue.bytes());
+    if (wake) {
+        emit chunksQueued();
+    }
+}
+
+bool SerialWorker::sourceMayEmit() const
+{
+    return m_queue.size() < MaxPendingReplayChunks;
+}
+
+void SerialWorker::openReplay(const SerialSettings &settings)
+{
+    auto replay = std::make_unique<ReplaySource>();
+    
+    // Text logs are paced like the selected baud rate (10 bits per byte)
+    if (!replay->open(settings.replayPath, qMax(1, settings.baudRate / 10))) {
+        emit connectionStateChanged(false,
+            QString("Failed to open %1: %2")
+                .arg(settings.replayPath)
+                .arg(replay->errorString()));
+        return;
+    }
+    
+    m_replay = std::move(replay);
+    m_replaySpeed = qBound(0.1, settings.replaySpeed, 1000.0);
+    m_replayMaxSpeed = settings.replayMaxSpeed;
+    m_replayStats = ReplayStats();
+    m_replayStats.maxSpeed = m_replayMaxSpeed;
+    m_replayHasNext = m_replay->next(m_replayNext, m_replayNextNs);
+    
+    // Created here so the timer lives in the worker thread
+    if (!m_replayTimer) {
+        m_replayTimer = new QTimer(this);
+        m_replayTimer->setSingleShot(true);
+        m_replayTimer->setTimerType(Qt::PreciseTimer);
+        connect(m_replayTimer, &QTimer::timeout,
+                this, &SerialWorker::handleReplayTick);
+    }
+    
+    emit connectionStateChanged(true,
+        QString("Replaying %1 @ %2")
+            .arg(QFileInfo(settings.replayPath).fileName())
+            .arg(m_replayMaxSpeed ? QString("max speed") : QString("%1x").arg(m_replaySpeed)));
+    
+    m_replayClock.start();
+    m_replayTimer->start(0);
+}
+
+void SerialWorker::handleReplayTick()
+{
+    if (!m_replay) return;
+    
+    if (m_replayMaxSpeed) {
+        // Back-pressure: only keep a few batches queued towards the GUI thread
+        if (!sourceMayEmit()) {
+            m_replayTimer->start(1);
+            return;
+        }
+        
+        // Coalesce chunks; the parser is stream based so boundaries don't matter
+        QByteArray batch;
+        while (m_replayHasNext && batch.size() < MaxReplayBatchBytes) {
+            batch.append(m_replayNext);
+            m_replayHasNext = m_replay->next(m_replayNext, m_replayNextNs);
+        }
+        if (!batch.isEmpty()) {
+            emitChunk(batch);
+        }
+        if (m_replayHasNext) {
+            m_replayTimer->start(0);
+        } else {
+            finishReplay(m_replay->errorString().isEmpty());
+        }
+        return;
+    }
+    
+    // Timed replay: emit everything that is due, then sleep until the next chunk
+    const qint64 nowNs = m_replayClock.nsecsElapsed();
+    while (m_replayHasNext) {
+        const qint64 dueNs = static_cast<qint64>(m_replayNextNs / m_replaySpeed);
+        if (dueNs > nowNs) {
+            m_replayTimer->start(static_cast<int>((dueNs - nowNs) / 1000000));
+            return;
+        }
+        // Blocking policies hold the replay like a stalled reader
+        if (m_queue.settings().blocks() && !m_queue.tryAdmit()) {
+            m_replayTimer->start(1);
+            return;
+        }
+        emitChunk(m_replayNext);
+        m_replayHasNext = m_replay->next(m_replayNext, m_replayNextNs);
+    }
+    finishReplay(m_replay->errorString().isEmpty());
+}
+
+void SerialWorker::finishReplay(bool completed)
+{
+    if (m_replayTimer) {
+        m_replayTimer->stop();
+    }
+    
+    m_replayStats.elapsedNs = m_replayClock.nsecsElapsed();
+    m_replayStats.completed = completed;
+    const QString error = m_replay->errorString();
+    m_replay.reset();
+    m_replayNext.clear();
+    m_replayHasNext = false;
+    
+    QString message;
+    if (completed) {
+        message = "Replay finished";
+    } else if (!error.isEmpty()) {
+        message = QString("Replay error: %1").arg(error);
+    } else {
+        message = "Replay stopped";
+    }
+    emit connectionStateChanged(false, message);
+    emit replayFinished(m_replayStats);
+}
+
+void SerialWorker::openGenerator(const SerialSettings &settings)
+{
+    GeneratorSettings generator = settings.generator;
+    if (generator.linesPerSecond <= 0.0 && generator.baudLimit <= 0) {
+        qInfo() << "Generator running unthrottled; pipeline back-pressure limits the rate";
+    }
+    m_generator = std::make_unique<DataGenerator>(generator);
+    
+    // Created here so the timer lives in the worker thread
+    if (!m_generatorTimer) {
+        m_generatorTimer = new QTimer(this);
+        m_generatorTimer->setTimerType(Qt::PreciseTimer);
+        m_generatorTimer->setInterval(GeneratorTickMs);
+        connect(m_generatorTimer, &QTimer::timeout,
+                this, &SerialWorker::handleGeneratorTick);
+    }
+    
+    QString rate = generator.linesPerSecond > 0.0
+        ? QString("%1 lines/s").arg(generator.linesPerSecond)
+        : QString("unlimited");
+    if (generator.baudLimit > 0) {
+        rate += QString(", %1 baud").arg(generator.baudLimit);
+    }
+    emit connectionStateChanged(true,
+        QString("Generator: %1 ch, %2, %3")
+            .arg(m_generator->settings().channels)
+            .arg(generatorFormatName(generator.format))
+            .arg(rate));
+    
+    m_generatorClock.start();
+    m_generatorTimer->start();
+}
+
+void SerialWorker::handleGeneratorTick()
+{
+    if (!m_generator) return;
+    
+    // Back-pressure: don't outrun the GUI thread. Rate-limited modes catch
+    // up on the next tick because production is driven by elapsed time.
+    if (!sourceMayEmit()) {
+        return;
+    }
+    
+    QByteArray chunk;
+    m_generator->produce(m_generatorClock.nsecsElapsed(), chunk, MaxReplayBatchBytes);
+    if (!chunk.isEmpty()) {
+        if (m_capture && !m_capture->append(chunk)) {
+            emit errorOccurred(QString("Raw capture write failed: %1")
+                .arg(m_capture->errorString()));
+            stopCapture();
+        }
+        emitChunk(chunk);
+    }
+}
+
+void SerialWorker::stopGenerator(const QString &message)
+{
+    if (m_generatorTimer) {
+        m_generatorTimer->stop();
+    }
+    const quint64 lines = m_generator->linesGenerated();
+    const quint64 bytes = m_generator->bytesGenerated();
+    const qint64 elapsedMs = m_generatorClock.elapsed();
+    m_generator.reset();
+    
+    qInfo() << "Generator produced" << lines << "lines," << bytes << "bytes in"
+            << elapsedMs << "ms";
+    emit connectionStateChanged(false, message);
+}
+
+void SerialWorker::startCapture(const RawCaptureSettings &settings)
+{
+    stopCapture();
+    
+    auto capture = std::make_unique<RawCaptureWriter>();
+    if (!capture->open(settings)) {
+        emit captureStateChanged(false,
+            QString("Raw capture failed: %1").arg(capture->errorString()));
+        return;
+    }
+    m_capture = std::move(capture);
+    
+    // Created here so the timer lives in the worker thread
+    if (!m_captureFlushTimer) {
+        m_captureFlushTimer = new QTimer(this);
+        m_captureFlushTimer->setInterval(1000);
+        connect(m_captureFlushTimer, &QTimer::timeout,
+                this, &SerialWorker::handleCaptureFlush);
+    }
+    m_captureFlushTimer->start();
+    
+    emit captureStateChanged(true,
+        QString("Capturing to %1").arg(QFileInfo(m_capture->currentPath()).fileName()));
+}
+
+void SerialWorker::stopCapture()
+{
+    if (!m_capture) return;
+    
+    if (m_captureFlushTimer) {
+        m_captureFlushTimer->stop();
+    }
+    m_capture->close();
+    const quint64 bytes = m_capture->bytesCaptured();
+    const int parts = m_capture->partCount();
+    m_capture.reset();
+    
+    emit captureStateChanged(false,
+        QString("Captured %1 bytes in %2 file(s)").arg(bytes).arg(parts));
+}
+
+void SerialWorker::handleCaptureFlush()
+{
+    if (!m_capture) return;
+    
+    if (!m_capture->periodicFlush()) {
+        emit errorOccurred(QString("Raw capture write failed: %1")
+            .arg(m_capture->errorString()));
+        stopCapture();
     }
 }
 
@@ -157,6 +503,7 @@ SerialManager::~SerialManager()
 void SerialManager::initWorkerThread()
 {
     m_workerThread = std::make_unique<QThread>();
+    m_workerThread->setObjectName("SerialWorker");
     m_worker = new SerialWorker();  // Will be owned by thread
     m_worker->moveToThread(m_workerThread.get());
     
@@ -167,13 +514,18 @@ void SerialManager::initWorkerThread()
             m_worker, &SerialWorker::closePort);
     connect(this, &SerialManager::requestWriteData,
             m_worker, &SerialWorker::writeData);
+    connect(this, &SerialManager::requestStartCapture,
+            m_worker, &SerialWorker::startCapture);
+    connect(this, &SerialManager::requestStopCapture,
+            m_worker, &SerialWorker::stopCapture);
     
     // Connect worker signals back to manager (thread-safe)
-    connect(m_worker, &SerialWorker::rawBytesReady,
-            this, &SerialManager::rawBytesReady,
-            Qt::QueuedConnection);
+    connect(m_worker, &SerialWorker::chunksQueued,
+            this, [this]() { drainQueue(); }, Qt::QueuedConnection);
     connect(m_worker, &SerialWorker::connectionStateChanged,
             this, [this](bool connected, const QString &message) {
+                // Chunks read before the state change are delivered first
+                drainQueue(true);
                 {
                     QMutexLocker locker(&m_mutex);
                     m_isConnected = connected;
@@ -183,6 +535,14 @@ void SerialManager::initWorkerThread()
     connect(m_worker, &SerialWorker::errorOccurred,
             this, &SerialManager::errorOccurred,
             Qt::QueuedConnection);
+    connect(m_worker, &SerialWorker::captureStateChanged,
+            this, &SerialManager::rawCaptureStateChanged,
+            Qt::QueuedConnection);
+    connect(m_worker, &SerialWorker::replayFinished,
+            this, [this](const ReplayStats &stats) {
+                drainQueue(true);
+                emit replayFinished(stats);
+            }, Qt::QueuedConnection);
     
     // Clean up worker when thread finishes
     connect(m_workerThread.get(), &QThread::finished,
@@ -191,6 +551,49 @@ void SerialManager::initWorkerThread()
     m_workerThread->start();
 }
 
+void SerialManager::drainQueue(bool all)
+{
+    IngestQueue &queue = m_worker->queue();
+    updateOverload();
+    
+    QElapsedTimer slice;
+    slice.start();
+    IngestChunk chunk;
+    bool wakeReader = false;
+    while (queue.pop(chunk, wakeReader)) {
+        if (wakeReader) {
+            QMetaObject::invokeMethod(m_worker, &SerialWorker::resumeReading, Qt::QueuedConnection);
+        }
+        // Stages downstream of this emit stamp the current trace
+        LatencyTracer::instance().beginChunk(chunk.traceId, chunk.readNs);
+        // Receivers are direct connections, so the chunk is processed now
+        emit rawBytesReady(chunk.data);
+        if (!all && slice.elapsed() >= DrainSliceMs) {
+            break;
+        }
+    }
+    
+    auto &metrics = PipelineMetrics::instance();
+    metrics.setGauge(MetricGauge::SerialPendingChunks, queue.size());
+    metrics.setGauge(MetricGauge::SerialPendingBytes, queue.bytes());
+    updateOverload();
+    
+    // Leftovers wait behind the events that queued up meanwhile (paint, input)
+    if (queue.finishDrain()) {
+        QMetaObject::invokeMethod(this, [this]() { drainQueue(); }, Qt::QueuedConnection);
+    }
+}
+
+void SerialManager::updateOverload()
+{
+    const double fill = m_worker->queue().fillRatio();
+    const bool overloaded = m_overloaded ? fill > OverloadOffRatio : fill >= OverloadOnRatio;
+    if (overloaded != m_overloaded) {
+        m_overloaded = overloaded;
+        emit overloadChanged(overloaded);
+    }
+}
+
 QList<QSerialPortInfo> SerialManager::availablePorts()
 {
     return QSerialPortInfo::availablePorts();
@@ -226,3 +629,13 @@ void SerialManager::sendData(const QByteArray &data)
 {
     emit requestWriteData(data);
 }
+
+void SerialManager::startRawCapture(const RawCaptureSettings &settings)
+{
+    emit requestStartCapture(settings);
+}
+
+void SerialManager::stopRawCapture()
+{
+    emit requestStopCapture();
+}
@@ -0,0 +1,135 @@
+/**
+ * @file StallWatchdog.cpp
+ * @brief Implementation of StallWatchdog
+ */
+
+#include "core/StallWatchdog.h"
+#include "core/LatencyTracer.h"
+#include "core/TraceRecorder.h"
+
+#include <QThread>
+#include <QTimer>
+#include <QDebug>
+
+QString StallReport::toString() const
+{
+    QString text = QString("GUI stall: %1 ms, culprit: %2\n")
+        .arg(durationNs / 1000000.0, 0, 'f', 1)
+        .arg(culprit);
+
+    int total = 0;
+    for (int count : stageSamples) {
+        total += count;
+    }
+    for (auto it = stageSamples.cbegin(); it != stageSamples.cend(); ++it) {
+        text += QString("  active %1: %2% of samples\n")
+            .arg(it.key())
+            .arg(total ? 100 * it.value() / total : 0);
+    }
+    for (int i = 0; i < MetricGaugeCount; ++i) {
+        text += QString("  peak %1: %2\n")
+            .arg(PipelineMetrics::gaugeName(static_cast<MetricGauge>(i)))
+            .arg(peakGauges[i]);
+    }
+    return text;
+}
+
+StallWatchdog::StallWatchdog(QObject *parent)
+    : QObject(parent)
+{
+    m_heartbeat = new QTimer(this);
+    m_heartbeat->setTimerType(Qt::PreciseTimer);
+    m_heartbeat->setInterval(HEARTBEAT_INTERVAL_MS);
+    connect(m_heartbeat, &QTimer::timeout, this, &StallWatchdog::onHeartbeat);
+}
+
+StallWatchdog::~StallWatchdog()
+{
+    stop();
+}
+
+void StallWatchdog::start(int thresholdMs)
+{
+    if (isRunning()) {
+        return;
+    }
+
+    TraceRecorder::publishActiveStage();
+    m_thresholdNs = static_cast<qint64>(thresholdMs) * 1000000;
+    m_lastBeatNs.store(LatencyTracer::nowNs(), std::memory_order_relaxed);
+    m_running.store(true, std::memory_order_relaxed);
+
+    m_heartbeat->start();
+    m_thread.reset(QThread::create([this]() { watchLoop(); }));
+    m_thread->setObjectName("StallWatchdog");
+    m_thread->start(QThread::HighPriority);
+}
+
+void StallWatchdog::stop()
+{
+    if (!isRunning()) {
+        return;
+    }
+
+    m_running.store(false, std::memory_order_relaxed);
+    m_heartbeat->stop();
+    m_thread->wait();
+    m_thread.reset();
+}
+
+void StallWatchdog::onHeartbeat()
+{
+    m_lastBeatNs.store(LatencyTracer::nowNs(), std::memory_order_release);
+}
+
+void StallWatchdog::watchLoop()
+{
+    const qint64 intervalNs = static_cast<qint64>(HEARTBEAT_INTERVAL_MS) * 1000000;
+    bool stalled = false;
+    qint64 stallStartNs = 0;
+    StallReport report;
+
+    while (m_running.load(std::memory_order_relaxed)) {
+        QThread::msleep(POLL_INTERVAL_MS);
+
+        const qint64 lastBeatNs = m_lastBeatNs.load(std::memory_order_acquire);
+        const qint64 lateNs = LatencyTracer::nowNs() - lastBeatNs - intervalNs;
+
+        if (lateNs > m_thresholdNs) {
+            if (!stalled) {
+                stalled = true;
+                stallStartNs = lastBeatNs + intervalNs;
+                report = StallReport();
+            }
+
+            const char *stage = TraceRecorder::activeStage();
+            if (report.stageSamples.isEmpty()) {
+                // Logged now in case the GUI never recovers
+                qWarning() << "GUI stall in progress, active stage:" << (stage ? stage : "idle");
+            }
+            report.stageSamples[stage ? QString::fromLatin1(stage) : QStringLiteral("idle")]++;
+
+            // Gauges written off the GUI thread (SerialPendingChunks/Bytes) keep
+            // growing while it is blocked: that is the ingest queue backlog
+            const MetricsSnapshot snapshot = PipelineMetrics::instance().snapshot();
+            for (int i = 0; i < MetricGaugeCount; ++i) {
+                report.peakGauges[i] = qMax(report.peakGauges[i], snapshot.gauges[i]);
+            }
+        } else if (stalled) {
+            stalled = false;
+            report.durationNs = lastBeatNs - stallStartNs;
+
+            int best = 0;
+            for (auto it = report.stageSamples.cbegin(); it != report.stageSamples.cend(); ++it) {
+                if (it.value() > best) {
+                    best = it.value();
+                    report.culprit = it.key();
+                }
+            }
+
+            PipelineMetrics::instance().add(MetricCounter::GuiStalls);
+            qWarning().noquote() << report.toString();
+            emit stallDetected(report);
+        }
+    }
+}
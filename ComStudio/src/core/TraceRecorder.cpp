@@ -0,0 +1,138 @@
+/**
+ * @file TraceRecorder.cpp
+ * @brief Implementation of TraceRecorder
+ */
+
+#include "core/TraceRecorder.h"
+#include "core/LatencyTracer.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+std::atomic<bool> TraceRecorder::s_enabled{false};
+std::atomic<const char*> TraceRecorder::s_activeStage{nullptr};
+thread_local bool TraceRecorder::t_publishStage = false;
+
+qint64 TraceScope::now()
+{
+    return LatencyTracer::nowNs();
+}
+
+TraceRecorder& TraceRecorder::instance()
+{
+    static TraceRecorder instance;
+    return instance;
+}
+
+void TraceRecorder::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+TraceRecorder::ThreadRing& TraceRecorder::localRing()
+{
+    thread_local std::shared_ptr<ThreadRing> ring;
+    if (!ring) {
+        ring = std::make_shared<ThreadRing>();
+
+        QThread *thread = QThread::currentThread();
+        if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+            ring->threadName = "GUI";
+        } else if (thread && !thread->objectName().isEmpty()) {
+            ring->threadName = thread->objectName();
+        }
+
+        QMutexLocker locker(&m_mutex);
+        ring->threadId = m_rings.size() + 1;
+        if (ring->threadName.isEmpty()) {
+            ring->threadName = QString("Thread %1").arg(ring->threadId);
+        }
+        m_rings.append(ring);
+    }
+    return *ring;
+}
+
+void TraceRecorder::record(const char *name, qint64 startNs, qint64 durationNs)
+{
+    ThreadRing &ring = localRing();
+    const quint64 index = ring.written.load(std::memory_order_relaxed);
+    TraceEvent &event = ring.events[index % RingCapacity];
+    event.name = name;
+    event.startNs = startNs;
+    event.durationNs = durationNs;
+    ring.written.store(index + 1, std::memory_order_release);
+}
+
+void TraceRecorder::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    for (const auto &ring : std::as_const(m_rings)) {
+        ring->written.store(0, std::memory_order_relaxed);
+    }
+}
+
+QByteArray TraceRecorder::exportChromeJson()
+{
+    // Scopes that were already open may still finish while we read;
+    // the event they overwrite is the oldest one in the ring.
+    const bool wasEnabled = isEnabled();
+    setEnabled(false);
+
+    QJsonArray events;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const auto &ring : std::as_const(m_rings)) {
+            QJsonObject meta;
+            meta["name"] = "thread_name";
+            meta["ph"] = "M";
+            meta["pid"] = 1;
+            meta["tid"] = ring->threadId;
+            meta["args"] = QJsonObject{{"name", ring->threadName}};
+            events.append(meta);
+
+            const quint64 written = ring->written.load(std::memory_order_acquire);
+            const quint64 first = written > static_cast<quint64>(RingCapacity)
+                ? written - RingCapacity : 0;
+            for (quint64 i = first; i < written; ++i) {
+                const TraceEvent &event = ring->events[i % RingCapacity];
+                if (!event.name) {
+                    continue;
+                }
+                QJsonObject entry;
+                entry["name"] = QString::fromLatin1(event.name);
+                entry["ph"] = "X";
+                entry["pid"] = 1;
+                entry["tid"] = ring->threadId;
+                entry["ts"] = event.startNs / 1000.0;       // Chrome uses microseconds
+                entry["dur"] = event.durationNs / 1000.0;
+                events.append(entry);
+            }
+        }
+    }
+
+    setEnabled(wasEnabled);
+
+    QJsonObject root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = "ns";
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool TraceRecorder::writeChromeJson(const QString &path, QString *errorString)
+{
+    const QByteArray json = exportChromeJson();
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || file.write(json) != json.size()) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
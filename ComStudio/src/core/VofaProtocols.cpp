@@ -0,0 +1,169 @@
+/**
+ * @file VofaProtocols.cpp
+ * @brief Implementation of JustFloatProtocol and FireWaterProtocol
+ */
+
+#include "core/VofaProtocols.h"
+#include "core/PipelineMetrics.h"
+#include "core/LatencyTracer.h"
+#include "core/TraceRecorder.h"
+
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+const char JustFloatTail[JustFloatProtocol::TailSize] = {'\x00', '\x00', '\x80', '\x7F'};
+
+} // namespace
+
+JustFloatProtocol::JustFloatProtocol(QObject *parent)
+    : FramedProtocol(parent)
+{
+}
+
+void JustFloatProtocol::reset()
+{
+    m_buffer.clear();
+    FramedProtocol::reset();
+}
+
+FrameClaim JustFloatProtocol::claimFrame(QByteArrayView data) const
+{
+    if (framer()) {
+        return FramedProtocol::claimFrame(data);
+    }
+    // A text line ending first belongs to the line parser, even if a
+    // frame follows it (the tail is not printable, so it cannot be inside)
+    if (Framer::textLineLength(data) > 0) {
+        return FrameClaim::noMatch();
+    }
+    // Only whole floats can precede the tail
+    const qsizetype limit = qMin(data.size(), MaxFrameBytes);
+    for (qsizetype pos = 0; pos + TailSize <= limit; pos += 4) {
+        if (std::memcmp(data.data() + pos, JustFloatTail, TailSize) == 0) {
+            return FrameClaim::match(pos + TailSize);
+        }
+    }
+    if (limit == MaxFrameBytes || Framer::isText(data)) {
+        return FrameClaim::noMatch();
+    }
+    return FrameClaim::needMore();
+}
+
+void JustFloatProtocol::parse(const QByteArray &data)
+{
+    if (framer()) {
+        FramedProtocol::parse(data);
+        return;
+    }
+    TRACE_SCOPE("JustFloatProtocol::parse");
+    auto &metrics = PipelineMetrics::instance();
+
+    m_buffer.append(data);
+    const char *bytes = m_buffer.constData();
+    const qsizetype size = m_buffer.size();
+
+    qsizetype frameStart = 0;
+    qsizetype search = 0;
+    while (search < size) {
+        const void *hit = std::memchr(bytes + search, JustFloatTail[TailSize - 1], size_t(size - search));
+        if (!hit) {
+            break;
+        }
+        const qsizetype tailEnd = static_cast<const char *>(hit) - bytes + 1;
+        const qsizetype tail = tailEnd - TailSize;
+        search = tailEnd;
+        if (tail < frameStart || std::memcmp(bytes + tail, JustFloatTail, TailSize - 1) != 0) {
+            continue;
+        }
+
+        const qsizetype payload = tail - frameStart;
+        if (payload > MaxFrameBytes - TailSize) {
+            // Started mid-frame or lost bytes: restart after this tail
+            metrics.add(MetricCounter::ParseErrors);
+            emit parseError("JustFloat frame too long, resynchronizing",
+                            m_buffer.mid(frameStart, tailEnd - frameStart));
+            frameStart = tailEnd;
+            continue;
+        }
+        if (payload % 4 != 0) {
+            continue;   // An Inf pattern straddling two floats
+        }
+        if (payload > 0) {
+            decodeFrame(bytes + frameStart, static_cast<int>(payload / 4));
+        }
+        frameStart = tailEnd;
+    }
+
+    // Keep the incomplete frame; without a tail in reach it is noise
+    if (size - frameStart > MaxFrameBytes) {
+        metrics.add(MetricCounter::ParseErrors);
+        emit parseError("JustFloat frame tail not found, discarding", m_buffer.mid(frameStart));
+        frameStart = size - (TailSize - 1);
+    }
+    m_buffer.remove(0, frameStart);
+
+    metrics.setGauge(MetricGauge::ParserBufferBytes, m_buffer.size());
+    publishBatches();
+}
+
+void JustFloatProtocol::processFrame(QByteArrayView frame)
+{
+    // The framer delimits the frame, so the tail is optional
+    if (frame.endsWith(QByteArrayView(JustFloatTail, TailSize))) {
+        frame.chop(TailSize);
+    }
+    if (frame.isEmpty() || frame.size() % 4 != 0 || frame.size() > MaxChannels * 4) {
+        PipelineMetrics::instance().add(MetricCounter::ParseErrors);
+        emit parseError("JustFloat payload is not a whole number of floats", frame.toByteArray());
+        return;
+    }
+    decodeFrame(frame.data(), static_cast<int>(frame.size() / 4));
+}
+
+void JustFloatProtocol::decodeFrame(const char *payload, int count)
+{
+    GenericDataPacket packet;
+    packet.packetIndex = nextPacketIndex();
+    packet.traceId = LatencyTracer::instance().currentTrace();
+    {
+        StageTimer timer(MetricStage::Parse);
+        packet.values.resize(count);
+        packet.channelNames.reserve(count);
+        double *values = packet.values.data();
+        for (int i = 0; i < count; ++i) {
+            values[i] = qFromLittleEndian<float>(payload + 4 * i);
+            packet.channels.insert(channelName(i), values[i]);
+            packet.channelNames.append(channelName(i));
+        }
+        packet.isValid = true;
+    }
+    LatencyTracer::instance().mark(packet.traceId, LatencyStage::Parse);
+    addPacket(std::move(packet));
+}
+
+FireWaterProtocol::FireWaterProtocol(QObject *parent)
+    : LineParser(fireWaterConfig(), parent)
+{
+}
+
+ParserConfig FireWaterProtocol::fireWaterConfig()
+{
+    ParserConfig config = ParserConfig::labeledDefault();
+    config.lineEnding = "\n";
+    config.trimWhitespace = true;   // Also drops a "\r" before the "\n"
+    return config;
+}
+
+ParserConfig FireWaterProtocol::fireWaterConfig(const ParserConfig &settings)
+{
+    ParserConfig config = fireWaterConfig();
+    config.xAxisSource = settings.xAxisSource;
+    config.xAxisFieldIndex = settings.xAxisFieldIndex;
+    config.deviceTickBits = settings.deviceTickBits;
+    config.deviceTickSeconds = settings.deviceTickSeconds;
+    config.fitClockDrift = settings.fitClockDrift;
+    config.verifyChecksum = settings.verifyChecksum;
+    return config;
+}
@@ -4,7 +4,13 @@
  */
 
 #include "models/DataBuffer.h"
+#include "models/PacketCursor.h"
+#include "core/PipelineMetrics.h"
+#include "core/LatencyTracer.h"
+#include "core/TraceRecorder.h"
 #include <QDebug>
+#include <QThread>
+#include <algorithm>
 
 DataBuffer::DataBuffer(int maxSize, QObject *parent)
     : QObject(parent)
@@ -12,34 +18,87 @@ DataBuffer::DataBuffer(int maxSize, QObject *parent)
 {
 }
 
+DataBuffer::~DataBuffer()
+{
+    QMutexLocker locker(&m_cursorMutex);
+    for (PacketCursor *cursor : std::as_const(m_cursors)) {
+        cursor->m_log = nullptr;
+    }
+}
+
+std::deque<DataBuffer::StoredBatch>::const_iterator DataBuffer::batchAt(quint64 sequence) const
+{
+    // Last batch starting at or before sequence
+    auto it = std::upper_bound(m_batches.cbegin(), m_batches.cend(), sequence,
+                               [](quint64 value, const StoredBatch &stored) {
+                                   return value < stored.firstSequence;
+                               });
+    return std::prev(it);
+}
+
+template <typename Visitor>
+void DataBuffer::forEachPacket(int start, Visitor &&visit) const
+{
+    if (start >= count()) {
+        return;
+    }
+    const quint64 sequence = m_firstSequence + static_cast<quint64>(start);
+    auto it = batchAt(sequence);
+    qsizetype offset = static_cast<qsizetype>(sequence - it->firstSequence);
+    for (; it != m_batches.cend(); ++it, offset = 0) {
+        for (qsizetype i = offset; i < it->batch.size(); ++i) {
+            if (!visit(it->batch.at(i))) {
+                return;
+            }
+        }
+    }
+}
+
+void DataBuffer::trimToMaxSize()
+{
+    while (count() > m_maxSize && !m_batches.empty()) {
+        StoredBatch &oldest = m_batches.front();
+        const qsizetype excess = count() - m_maxSize;
+        if (oldest.batch.size() <= excess) {
+            // Whole batch expired: release our reference
+            m_firstSequence += static_cast<quint64>(oldest.batch.size());
+            m_batches.pop_front();
+        } else {
+            oldest.batch = oldest.batch.mid(excess);
+            oldest.firstSequence += static_cast<quint64>(excess);
+            m_firstSequence += static_cast<quint64>(excess);
+        }
+    }
+}
+
 void DataBuffer::setMaxSize(int size)
 {
     QWriteLocker locker(&m_lock);
     m_maxSize = size;
     
     // Trim if necessary
-    while (static_cast<int>(m_packets.size()) > m_maxSize) {
-        m_packets.pop_front();
-    }
+    trimToMaxSize();
 }
 
 int DataBuffer::size() const
 {
     QReadLocker locker(&m_lock);
-    return static_cast<int>(m_packets.size());
+    return count();
 }
 
 bool DataBuffer::isEmpty() const
 {
     QReadLocker locker(&m_lock);
-    return m_packets.empty();
+    return count() == 0;
 }
 
 GenericDataPacket DataBuffer::packetAt(int index) const
 {
     QReadLocker locker(&m_lock);
-    if (index >= 0 && index < static_cast<int>(m_packets.size())) {
-        return m_packets[index];
+    if (index >= 0 && index < count()) {
+        const quint64 sequence = m_firstSequence + static_cast<quint64>(index);
+        auto it = batchAt(sequence);
+        return it->batch.at(static_cast<qsizetype>(sequence - it->firstSequence));
     }
     return GenericDataPacket();
 }
@@ -47,8 +106,8 @@ GenericDataPacket DataBuffer::packetAt(int index) const
 GenericDataPacket DataBuffer::lastPacket() const
 {
     QReadLocker locker(&m_lock);
-    if (!m_packets.empty()) {
-        return m_packets.back();
+    if (count() > 0) {
+        return m_batches.back().batch.last();
     }
     return GenericDataPacket();
 }
@@ -57,10 +116,11 @@ QVector<GenericDataPacket> DataBuffer::allPackets() const
 {
     QReadLocker locker(&m_lock);
     QVector<GenericDataPacket> result;
-    result.reserve(static_cast<int>(m_packets.size()));
-    for (const auto &packet : m_packets) {
+    result.reserve(count());
+    forEachPacket(0, [&](const GenericDataPacket &packet) {
         result.append(packet);
-    }
+        return true;
+    });
     return result;
 }
 
@@ -69,17 +129,21 @@ QVector<GenericDataPacket> DataBuffer::packets(int start, int count) const
     QReadLocker locker(&m_lock);
     QVector<GenericDataPacket> result;
     
-    int packetCount = static_cast<int>(m_packets.size());
-    if (start < 0 || start >= packetCount) {
+    if (start < 0 || start >= this->count()) {
         return result;
     }
     
-    int end = qMin(start + count, packetCount);
+    int end = qMin(start + count, this->count());
     result.reserve(end - start);
     
-    for (int i = start; i < end; ++i) {
-        result.append(m_packets[i]);
-    }
+    int index = start;
+    forEachPacket(start, [&](const GenericDataPacket &packet) {
+        if (index++ >= end) {
+            return false;
+        }
+        result.append(packet);
+        return true;
+    });
     
     return result;
 }
@@ -87,57 +151,66 @@ QVector<GenericDataPacket> DataBuffer::packets(int start, int count) const
 void DataBuffer::channelData(const QString &channelName,
                              QVector<double> &timestamps,
                              QVector<double> &values,
-                             int maxPoints) const
+                             int maxPoints,
+                             int sensorKey) const
 {
     QReadLocker locker(&m_lock);
     
     timestamps.clear();
     values.clear();
     
-    int count = static_cast<int>(m_packets.size());
+    const int stored = count();
     int start = 0;
-    if (maxPoints > 0 && count > maxPoints) {
-        start = count - maxPoints;
+    if (maxPoints > 0 && stored > maxPoints) {
+        start = stored - maxPoints;
     }
     
-    timestamps.reserve(count - start);
-    values.reserve(count - start);
+    timestamps.reserve(stored - start);
+    values.reserve(stored - start);
     
-    for (int i = start; i < count; ++i) {
-        const auto &packet = m_packets[i];
-        if (packet.channels.contains(channelName)) {
-            timestamps.append(static_cast<double>(packet.timestamp));
-            values.append(packet.channels.value(channelName));
+    forEachPacket(start, [&](const GenericDataPacket &packet) {
+        if (sensorKey != AnySensor && packet.sensorKey != sensorKey) {
+            return true;
         }
-    }
+        auto it = packet.channels.constFind(channelName);
+        if (it != packet.channels.constEnd()) {
+            timestamps.append(packet.xTime());
+            values.append(it.value());
+        }
+        return true;
+    });
 }
 
 void DataBuffer::channelDataByIndex(int channelIndex,
                                     QVector<double> &timestamps,
                                     QVector<double> &values,
-                                    int maxPoints) const
+                                    int maxPoints,
+                                    int sensorKey) const
 {
     QReadLocker locker(&m_lock);
     
     timestamps.clear();
     values.clear();
     
-    int count = static_cast<int>(m_packets.size());
+    const int stored = count();
     int start = 0;
-    if (maxPoints > 0 && count > maxPoints) {
-        start = count - maxPoints;
+    if (maxPoints > 0 && stored > maxPoints) {
+        start = stored - maxPoints;
     }
     
-    timestamps.reserve(count - start);
-    values.reserve(count - start);
+    timestamps.reserve(stored - start);
+    values.reserve(stored - start);
     
-    for (int i = start; i < count; ++i) {
-        const auto &packet = m_packets[i];
+    forEachPacket(start, [&](const GenericDataPacket &packet) {
+        if (sensorKey != AnySensor && packet.sensorKey != sensorKey) {
+            return true;
+        }
         if (channelIndex >= 0 && channelIndex < packet.values.size()) {
-            timestamps.append(static_cast<double>(packet.timestamp));
+            timestamps.append(packet.xTime());
             values.append(packet.values[channelIndex]);
         }
-    }
+        return true;
+    });
 }
 
 QStringList DataBuffer::channelNames() const
@@ -152,65 +225,205 @@ int DataBuffer::maxChannelCount() const
     return m_maxChannelCount;
 }
 
+QVector<int> DataBuffer::sensors() const
+{
+    QReadLocker locker(&m_lock);
+    return m_sensors;
+}
+
+QStringList DataBuffer::sensorChannelNames(int sensorKey) const
+{
+    QReadLocker locker(&m_lock);
+    return m_sensorChannels.value(sensorKey);
+}
+
+quint64 DataBuffer::firstSequence() const
+{
+    QReadLocker locker(&m_lock);
+    return m_firstSequence;
+}
+
+quint64 DataBuffer::endSequence() const
+{
+    QReadLocker locker(&m_lock);
+    return m_nextSequence;
+}
+
+PacketCursor *DataBuffer::openCursor(const QString &name, QObject *parent)
+{
+    auto *cursor = new PacketCursor(this, name, endSequence(), parent);
+    QMutexLocker locker(&m_cursorMutex);
+    m_cursors.append(cursor);
+    return cursor;
+}
+
+void DataBuffer::closeCursor(PacketCursor *cursor)
+{
+    QMutexLocker locker(&m_cursorMutex);
+    m_cursors.removeOne(cursor);
+
+    // A slot closing a cursor on the waking thread must not wait for itself
+    QThread *self = QThread::currentThread();
+    auto wakingElsewhere = [this, self]() {
+        for (QThread *thread : std::as_const(m_wakingThreads)) {
+            if (thread != self) {
+                return true;
+            }
+        }
+        return false;
+    };
+    while (wakingElsewhere()) {
+        m_wakeDone.wait(&m_cursorMutex);
+    }
+}
+
+QVector<PacketBatch> DataBuffer::readFrom(quint64 &sequence, qint64 maxPackets, quint64 &lost) const
+{
+    QReadLocker locker(&m_lock);
+    QVector<PacketBatch> result;
+    
+    // Packets removed by clear() were not lost, only trimmed ones count
+    sequence = qMax(sequence, m_clearedSequence);
+    lost = 0;
+    if (sequence < m_firstSequence) {
+        lost = m_firstSequence - sequence;
+        sequence = m_firstSequence;
+    }
+    if (sequence >= m_nextSequence) {
+        return result;
+    }
+    
+    qint64 remaining = maxPackets > 0 ? maxPackets : static_cast<qint64>(m_nextSequence - sequence);
+    for (auto it = batchAt(sequence); it != m_batches.cend() && remaining > 0; ++it) {
+        const qsizetype offset = static_cast<qsizetype>(sequence - it->firstSequence);
+        const PacketBatch slice = it->batch.mid(offset, remaining);
+        result.append(slice);
+        sequence += static_cast<quint64>(slice.size());
+        remaining -= slice.size();
+    }
+    return result;
+}
+
+qint64 DataBuffer::availableFrom(quint64 sequence) const
+{
+    QReadLocker locker(&m_lock);
+    const quint64 start = qMax(sequence, m_firstSequence);
+    return start < m_nextSequence ? static_cast<qint64>(m_nextSequence - start) : 0;
+}
+
 void DataBuffer::addPacket(const GenericDataPacket &packet)
 {
+    addBatch(PacketBatch(QVector<GenericDataPacket>{packet}));
+}
+
+void DataBuffer::addBatch(const PacketBatch &batch)
+{
+    TRACE_SCOPE("DataBuffer::addBatch");
+    
+    if (batch.isEmpty()) {
+        return;
+    }
+    
+    QStringList newChannels;
+    QVector<int> newSensors;
     {
+        StageTimer timer(MetricStage::BufferInsert, static_cast<quint64>(batch.size()));
         QWriteLocker locker(&m_lock);
         
-        // Add packet to buffer
-        m_packets.push_back(packet);
+        // Store the reference; older packets are trimmed from the front
+        m_batches.push_back({m_nextSequence, batch});
+        m_nextSequence += static_cast<quint64>(batch.size());
+        trimToMaxSize();
         
-        // Trim if over capacity
-        while (static_cast<int>(m_packets.size()) > m_maxSize) {
-            m_packets.pop_front();
-        }
-        
-        // Track channel names
-        bool newChannels = false;
-        for (auto it = packet.channels.constBegin(); it != packet.channels.constEnd(); ++it) {
-            if (!m_channelNames.contains(it.key())) {
-                m_channelNames.append(it.key());
-                newChannels = true;
+        // Channel names and counts are tracked over the whole batch
+        int groupKey = 0;
+        QStringList *group = nullptr;   // Consecutive packets often share a sensor
+        for (const auto &packet : batch) {
+            if (!group || packet.sensorKey != groupKey) {
+                groupKey = packet.sensorKey;
+                auto groupIt = m_sensorChannels.find(groupKey);
+                if (groupIt == m_sensorChannels.end()) {
+                    groupIt = m_sensorChannels.insert(groupKey, QStringList());
+                    m_sensors.append(groupKey);
+                    newSensors.append(groupKey);
+                }
+                group = &groupIt.value();
             }
-        }
-        
-        // Track max channel count
-        if (packet.channelCount() > m_maxChannelCount) {
-            m_maxChannelCount = packet.channelCount();
-        }
-        
-        // Emit channel added signals outside lock scope
-        if (newChannels) {
             for (auto it = packet.channels.constBegin(); it != packet.channels.constEnd(); ++it) {
-                if (!m_channelNames.contains(it.key())) {
-                    // This won't be reached due to logic above, but keeping for clarity
+                if (!m_knownChannels.contains(it.key())) {
+                    m_knownChannels.insert(it.key());
+                    m_channelNames.append(it.key());
+                    newChannels.append(it.key());
+                }
+                if (!group->contains(it.key())) {  // Groups hold a few names
+                    group->append(it.key());
                 }
             }
+            if (packet.channelCount() > m_maxChannelCount) {
+                m_maxChannelCount = packet.channelCount();
+            }
         }
+        PipelineMetrics::instance().setGauge(MetricGauge::DataBufferPackets, count());
     }
     
-    // Emit signals outside lock
-    emit dataUpdated(packet);
+    // One mark per source chunk (consecutive packets share a trace)
+    quint64 lastTrace = 0;
+    for (const auto &packet : batch) {
+        if (packet.traceId != 0 && packet.traceId != lastTrace) {
+            LatencyTracer::instance().mark(packet.traceId, LatencyStage::BufferInsert);
+            lastTrace = packet.traceId;
+        }
+    }
     
-    // Check for new channels and emit signals
-    for (auto it = packet.channels.constBegin(); it != packet.channels.constEnd(); ++it) {
-        QReadLocker locker(&m_lock);
-        // Find if this was a newly added channel
-        int idx = m_channelNames.indexOf(it.key());
-        if (idx == m_channelNames.size() - 1) {
-            locker.unlock();
-            emit channelAdded(it.key());
+    // Pick the idle cursors under the lock, emit outside it: a slot may
+    // open or close cursors
+    QVector<PacketCursor *> waking;
+    {
+        QMutexLocker locker(&m_cursorMutex);
+        for (PacketCursor *cursor : std::as_const(m_cursors)) {
+            if (cursor->armReadyRead()) {
+                waking.append(cursor);
+            }
+        }
+        if (!waking.isEmpty()) {
+            m_wakingThreads.append(QThread::currentThread());
         }
     }
+    if (!waking.isEmpty()) {
+        for (PacketCursor *cursor : std::as_const(waking)) {
+            {
+                // Closed by an earlier slot of this pass
+                QMutexLocker locker(&m_cursorMutex);
+                if (!m_cursors.contains(cursor)) {
+                    continue;
+                }
+            }
+            emit cursor->readyRead();
+        }
+        QMutexLocker locker(&m_cursorMutex);
+        m_wakingThreads.removeOne(QThread::currentThread());
+        m_wakeDone.wakeAll();
+    }
+    for (const QString &name : newChannels) {
+        emit channelAdded(name);
+    }
+    for (int sensorKey : newSensors) {
+        emit sensorAdded(sensorKey);
+    }
 }
 
 void DataBuffer::clear()
 {
     {
         QWriteLocker locker(&m_lock);
-        m_packets.clear();
+        m_batches.clear();
+        m_firstSequence = m_nextSequence;
+        m_clearedSequence = m_nextSequence;
         m_channelNames.clear();
+        m_knownChannels.clear();
         m_maxChannelCount = 0;
+        m_sensors.clear();
+        m_sensorChannels.clear();
     }
     
     emit cleared();
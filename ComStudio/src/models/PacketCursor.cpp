@@ -0,0 +1,65 @@
+/**
+ * @file PacketCursor.cpp
+ * @brief Implementation of PacketCursor
+ */
+
+#include "models/PacketCursor.h"
+#include "models/DataBuffer.h"
+#include "core/PipelineMetrics.h"
+
+PacketCursor::PacketCursor(DataBuffer *log, const QString &name, quint64 position, QObject *parent)
+    : QObject(parent)
+    , m_log(log)
+    , m_name(name)
+    , m_position(position)
+{
+}
+
+PacketCursor::~PacketCursor()
+{
+    if (m_log) {
+        m_log->closeCursor(this);
+    }
+}
+
+qint64 PacketCursor::available() const
+{
+    return m_log ? m_log->availableFrom(m_position) : 0;
+}
+
+QVector<PacketBatch> PacketCursor::read(qint64 maxPackets)
+{
+    // Re-arm first so an append during the read is not missed
+    m_readyPending.store(false);
+    if (!m_log) {
+        return QVector<PacketBatch>();
+    }
+
+    quint64 lost = 0;
+    QVector<PacketBatch> batches = m_log->readFrom(m_position, maxPackets, lost);
+    if (lost > 0) {
+        m_lostTotal += lost;
+        PipelineMetrics::instance().add(MetricCounter::CursorPacketsLost, lost);
+        emit fellBehind(lost);
+    }
+    return batches;
+}
+
+qint64 PacketCursor::skip(qint64 count)
+{
+    if (!m_log || count <= 0) {
+        return 0;
+    }
+    const quint64 first = m_log->firstSequence();
+    const qint64 skipped = qMin(count, available());
+    m_position = qMax(m_position, first) + static_cast<quint64>(skipped);
+    return skipped;
+}
+
+void PacketCursor::seekToEnd()
+{
+    m_readyPending.store(false);
+    if (m_log) {
+        m_position = m_log->endSequence();
+    }
+}
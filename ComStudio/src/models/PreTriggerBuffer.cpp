@@ -0,0 +1,157 @@
+/**
+ * @file PreTriggerBuffer.cpp
+ * @brief Implementation of PreTriggerBuffer and RecordingTrigger
+ */
+
+#include "models/PreTriggerBuffer.h"
+
+// ============================================================================
+// PreTriggerBuffer Implementation
+// ============================================================================
+
+PreTriggerBuffer::PreTriggerBuffer(int capacity)
+{
+    setCapacity(capacity);
+}
+
+void PreTriggerBuffer::setCapacity(int capacity)
+{
+    capacity = qMax(1, capacity);
+    m_slots = QVector<GenericDataPacket>(capacity);
+    m_slotBytes = QVector<qint64>(capacity, 0);
+    m_head = 0;
+    m_count = 0;
+    m_bytes = 0;
+}
+
+void PreTriggerBuffer::push(const GenericDataPacket &packet)
+{
+    if (m_count == m_slots.size()) {
+        popOldest();
+    }
+
+    const int slot = (m_head + m_count) % m_slots.size();
+    const qint64 bytes = estimateBytes(packet);
+    m_slots[slot] = packet;
+    m_slotBytes[slot] = bytes;
+    m_bytes += bytes;
+    ++m_count;
+
+    // Enforce age and memory limits (always keep the newest packet)
+    while (m_count > 1) {
+        const bool tooOld = m_maxAgeMs > 0
+            && packet.timestamp - m_slots[m_head].timestamp > m_maxAgeMs;
+        const bool tooBig = m_maxBytes > 0 && m_bytes > m_maxBytes;
+        if (!tooOld && !tooBig) {
+            break;
+        }
+        popOldest();
+    }
+}
+
+int PreTriggerBuffer::drain(const std::function<void(const GenericDataPacket &)> &sink)
+{
+    const int drained = m_count;
+    while (m_count > 0) {
+        sink(m_slots[m_head]);
+        popOldest();
+    }
+    m_head = 0;
+    return drained;
+}
+
+void PreTriggerBuffer::clear()
+{
+    while (m_count > 0) {
+        popOldest();
+    }
+    m_head = 0;
+}
+
+qint64 PreTriggerBuffer::spanMs() const
+{
+    if (m_count < 2) {
+        return 0;
+    }
+    const int newest = (m_head + m_count - 1) % m_slots.size();
+    return m_slots[newest].timestamp - m_slots[m_head].timestamp;
+}
+
+void PreTriggerBuffer::popOldest()
+{
+    m_bytes -= m_slotBytes[m_head];
+    m_slotBytes[m_head] = 0;
+    m_slots[m_head] = m_emptyPacket;
+    m_head = (m_head + 1) % m_slots.size();
+    --m_count;
+}
+
+qint64 PreTriggerBuffer::estimateBytes(const GenericDataPacket &packet)
+{
+    // Rough heap footprint: containers plus payloads (QMap nodes ~64 bytes)
+    return static_cast<qint64>(sizeof(GenericDataPacket))
+        + packet.rawData.size()
+        + packet.displayText.size() * 2
+        + packet.sensorId.size() * 2
+        + packet.values.size() * static_cast<qint64>(sizeof(double))
+        + packet.channels.size() * 64;
+}
+
+// ============================================================================
+// RecordingTrigger Implementation
+// ============================================================================
+
+bool RecordingTrigger::setConfig(const TriggerConfig &config)
+{
+    m_config = config;
+    m_hasPrevious = false;
+
+    if (config.type == TriggerType::LinePattern) {
+        m_regex.setPattern(config.pattern);
+        m_regex.optimize();
+        return m_regex.isValid() && !config.pattern.isEmpty();
+    }
+    return true;
+}
+
+bool RecordingTrigger::checkPacket(const GenericDataPacket &packet)
+{
+    if (m_config.type != TriggerType::ChannelThreshold) {
+        return false;
+    }
+    if (m_config.channelIndex < 0 || m_config.channelIndex >= packet.values.size()) {
+        return false;
+    }
+
+    const double value = packet.values[m_config.channelIndex];
+    bool fired = false;
+
+    if (m_hasPrevious) {
+        const bool rising = m_previousValue < m_config.threshold && value >= m_config.threshold;
+        const bool falling = m_previousValue > m_config.threshold && value <= m_config.threshold;
+        switch (m_config.edge) {
+            case TriggerEdge::Rising:
+                fired = rising;
+                break;
+            case TriggerEdge::Falling:
+                fired = falling;
+                break;
+            case TriggerEdge::Either:
+                fired = rising || falling;
+                break;
+        }
+    }
+
+    m_previousValue = value;
+    m_hasPrevious = true;
+    return fired;
+}
+
+bool RecordingTrigger::checkLine(const QString &line) const
+{
+    if (m_config.type != TriggerType::LinePattern || m_config.pattern.isEmpty()
+        || !m_regex.isValid()) {
+        return false;
+    }
+    return m_regex.match(line).hasMatch();
+}
@@ -10,10 +10,17 @@
 #include "ui/ParserConfigWidget.h"
 #include "ui/AutoSendDialog.h"
 #include "ui/RecordingWidget.h"
+#include "ui/MetricsWidget.h"
 #include "core/SerialManager.h"
 #include "core/ProtocolHandler.h"
 #include "core/LineParser.h"
+#include "core/VofaProtocols.h"
+#include "core/BinaryFrameProtocol.h"
+#include "core/NmeaProtocol.h"
 #include "core/ParserConfig.h"
+#include "core/BulkImporter.h"
+#include "core/StallWatchdog.h"
+#include "core/PipelineGraph.h"
 #include "models/DataBuffer.h"
 
 #include <QTabWidget>
@@ -30,6 +37,38 @@
 #include <QApplication>
 #include <QSplitter>
 #include <QStackedWidget>
+#include <QDebug>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QInputDialog>
+#include <QProgressDialog>
+#include <QJsonDocument>
+
+namespace {
+
+/**
+ * Stage graph used when no pipeline config is loaded: the selected
+ * protocol feeds every packet to the record log and the rate-limited
+ * subset to the display log.
+ */
+const char *DefaultPipelineConfig = R"({
+    "stages": [
+        { "id": "serial",  "type": "source" },
+        { "id": "decoder", "type": "protocol", "target": "protocol" },
+        { "id": "record",  "type": "sink", "target": "record" },
+        { "id": "display", "type": "sink", "target": "display" }
+    ],
+    "links": [
+        { "from": "serial.out",      "to": "decoder.in" },
+        { "from": "decoder.packets", "to": "record.in" },
+        { "from": "decoder.display", "to": "display.in" }
+    ]
+})";
+
+/// Protocol combo entry that splits the stream between all protocols
+const char *DemuxProtocolItem = "*demux";
+
+} // namespace
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -40,13 +79,19 @@ MainWindow::MainWindow(QWidget *parent)
     // Initialize backend components
     m_protocolHandler = std::make_unique<ProtocolHandler>();
     m_dataBuffer = std::make_unique<DataBuffer>(10000);
+    m_recordLog = std::make_unique<DataBuffer>(RECORD_LOG_PACKETS);
+    m_pipeline = std::make_unique<PipelineGraph>();
+    m_stallWatchdog = new StallWatchdog(this);
     
     setupUi();
     setupMenus();
     setupStatusBar();
     initProtocolHandler();
+    initPipeline();
     connectSignals();
     loadSettings();
+    
+    m_stallWatchdog->start();
 }
 
 MainWindow::~MainWindow()
@@ -114,6 +159,19 @@ void MainWindow::setupUi()
     
     addDockWidget(Qt::BottomDockWidgetArea, m_recordingDock);
     m_recordingDock->hide();  // Hidden by default for clean UI
+    
+    // Pipeline metrics dock (hidden by default)
+    m_metricsDock = new QDockWidget(tr("Metrics"), this);
+    m_metricsDock->setFeatures(QDockWidget::DockWidgetClosable |
+                               QDockWidget::DockWidgetMovable |
+                               QDockWidget::DockWidgetFloatable);
+    m_metricsDock->setAllowedAreas(Qt::LeftDockWidgetArea | Qt::RightDockWidgetArea);
+    
+    m_metricsWidget = new MetricsWidget();
+    m_metricsDock->setWidget(m_metricsWidget);
+    
+    addDockWidget(Qt::RightDockWidgetArea, m_metricsDock);
+    m_metricsDock->hide();
 }
 
 void MainWindow::setupMenus()
@@ -124,6 +182,19 @@ void MainWindow::setupMenus()
     QAction *refreshAction = fileMenu->addAction(tr("&Refresh Ports"));
     connect(refreshAction, &QAction::triggered, m_serialSettings, &SerialSettingsWidget::refreshPorts);
     
+    QAction *importAction = fileMenu->addAction(tr("&Import Data..."));
+    importAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_I));
+    connect(importAction, &QAction::triggered, this, &MainWindow::onImportData);
+    
+    QAction *pipelineAction = fileMenu->addAction(tr("Load &Pipeline Config..."));
+    connect(pipelineAction, &QAction::triggered, this, &MainWindow::onLoadPipeline);
+    
+    QAction *defaultPipelineAction = fileMenu->addAction(tr("Default Pipeline"));
+    connect(defaultPipelineAction, &QAction::triggered, this, [this]() { loadPipeline(QString()); });
+    
+    QAction *frameSchemaAction = fileMenu->addAction(tr("Load &Frame Schema..."));
+    connect(frameSchemaAction, &QAction::triggered, this, &MainWindow::onLoadFrameSchema);
+    
     fileMenu->addSeparator();
     
     QAction *exitAction = fileMenu->addAction(tr("E&xit"));
@@ -145,6 +216,10 @@ void MainWindow::setupMenus()
     recordingAction->setText(tr("Recording Panel"));
     viewMenu->addAction(recordingAction);
     
+    QAction *metricsAction = m_metricsDock->toggleViewAction();
+    metricsAction->setText(tr("Metrics Panel"));
+    viewMenu->addAction(metricsAction);
+    
     viewMenu->addSeparator();
     
     m_splitViewAction = viewMenu->addAction(tr("Split View (Terminal + Plotter)"));
@@ -237,8 +312,39 @@ void MainWindow::initProtocolHandler()
     // Connect LineParser-specific signals directly
     connect(m_lineParser, &LineParser::rawLineReady,
             this, &MainWindow::onRawLineReady);
-    connect(m_lineParser, &LineParser::dataForLogging,
-            this, &MainWindow::onDataForLogging);
+    
+    // VOFA+ protocols (binary JustFloat and text FireWater)
+    auto justFloat = std::make_shared<JustFloatProtocol>();
+    m_framedProtocols.append(justFloat.get());
+    m_protocolHandler->registerProtocol("justfloat", justFloat);
+    
+    auto fireWater = std::make_shared<FireWaterProtocol>();
+    m_fireWater = fireWater.get();
+    m_protocolHandler->registerProtocol("firewater", fireWater);
+    m_fireWater->setTargetDisplayRate(60);
+    m_fireWater->setRateLimitEnabled(true);
+    m_fireWater->setConfig(FireWaterProtocol::fireWaterConfig(m_lineParser->config()));
+    connect(m_fireWater, &LineParser::rawLineReady,
+            this, &MainWindow::onRawLineReady);
+    
+    // Custom binary frames, decoded by a schema from File > Load Frame Schema
+    auto binaryFrame = std::make_shared<BinaryFrameProtocol>();
+    m_binaryFrame = binaryFrame.get();
+    m_framedProtocols.append(binaryFrame.get());
+    m_protocolHandler->registerProtocol("binary", binaryFrame);
+    
+    // GPS/marine NMEA 0183 sentences, one channel group per sentence type
+    auto nmea = std::make_shared<NmeaProtocol>();
+    m_nmea = nmea.get();
+    m_framedProtocols.append(nmea.get());
+    m_protocolHandler->registerProtocol("nmea", nmea);
+    m_nmea->setRequireChecksum(m_lineParser->config().verifyChecksum);
+    connect(m_nmea, &NmeaProtocol::rawLineReady,
+            this, &MainWindow::onRawLineReady);
+    
+    for (FramedProtocol *framed : std::as_const(m_framedProtocols)) {
+        framed->setTargetDisplayRate(60);
+    }
     
     // Initialize parser config widget with current config
     if (m_parserConfig && m_lineParser) {
@@ -252,6 +358,9 @@ void MainWindow::initProtocolHandler()
             m_protocolCombo->addItem(proto->name(), id);
         }
     }
+    if (m_protocolHandler->registeredProtocols().size() > 1) {
+        m_protocolCombo->addItem(tr("All (demultiplex)"), QString(DemuxProtocolItem));
+    }
 }
 
 void MainWindow::connectSignals()
@@ -270,21 +379,47 @@ void MainWindow::connectSignals()
             this, &MainWindow::onSerialError);
     connect(&serial, &SerialManager::rawBytesReady,
             this, &MainWindow::onRawBytesReceived);
+    connect(&serial, &SerialManager::replayFinished,
+            this, &MainWindow::onReplayFinished);
+    connect(&serial, &SerialManager::overloadChanged,
+            this, &MainWindow::onIngestOverloadChanged);
+    
+    // Raw byte capture runs in the serial worker thread
+    connect(m_recordingWidget, &RecordingWidget::rawCaptureStartRequested,
+            &serial, &SerialManager::startRawCapture);
+    connect(m_recordingWidget, &RecordingWidget::rawCaptureStopRequested,
+            &serial, &SerialManager::stopRawCapture);
+    connect(&serial, &SerialManager::rawCaptureStateChanged,
+            m_recordingWidget, &RecordingWidget::onRawCaptureStateChanged);
+    
+    // Status bar packet counter follows the metrics refresh (all packets, not rate-limited)
+    connect(m_metricsWidget, &MetricsWidget::snapshotUpdated,
+            this, [this](const MetricsSnapshot &current, const MetricsSnapshot &previous) {
+                m_packetCountLabel->setText(tr("Packets: %1 (%2/s)")
+                    .arg(current.counter(MetricCounter::PacketsParsed))
+                    .arg(current.rate(MetricCounter::PacketsParsed, previous), 0, 'f', 0));
+            });
     
-    // Protocol handler connections (rate-limited for display)
-    connect(m_protocolHandler.get(), &ProtocolHandler::dataParsed,
-            this, &MainWindow::onDataParsed);
+    // Full stall report goes to the log; the status bar names the culprit
+    connect(m_stallWatchdog, &StallWatchdog::stallDetected,
+            this, [this](const StallReport &report) {
+                statusBar()->showMessage(tr("UI stalled for %1 ms in %2")
+                    .arg(report.durationNs / 1000000)
+                    .arg(report.culprit), 5000);
+            });
     
     // Terminal send connection
     connect(m_terminal, &TerminalWidget::sendData,
             this, &MainWindow::onSendData);
     
-    // Rate-limited data to plotter (through data buffer)
-    connect(m_dataBuffer.get(), &DataBuffer::dataUpdated,
-            m_plotter, &PlotterWidget::addData);
+    // Consumers pull from the logs through their own cursors:
+    // rate-limited display data to plotter and terminal
+    m_plotter->setSource(m_dataBuffer.get());
+    m_terminal->setSource(m_dataBuffer.get());
     
-    // Note: Recording uses onDataForLogging (connected in initProtocolHandler)
-    // which is NOT rate-limited, ensuring all data is logged
+    // Note: Recording reads the log filled by onDataForLogging (the "record"
+    // sink of the pipeline), which is NOT rate-limited, ensuring all data is logged
+    m_recordingWidget->setSource(m_recordLog.get());
     
     // Parser config connections
     connect(m_parserConfig, &ParserConfigWidget::configApplied,
@@ -295,6 +430,10 @@ void MainWindow::connectSignals()
             this, [this](int hz) {
                 if (m_lineParser) {
                     m_lineParser->setTargetDisplayRate(hz);
+                    m_fireWater->setTargetDisplayRate(hz);
+                    for (FramedProtocol *framed : std::as_const(m_framedProtocols)) {
+                        framed->setTargetDisplayRate(hz);
+                    }
                     statusBar()->showMessage(tr("Display rate set to %1 Hz").arg(hz), 2000);
                 }
             });
@@ -324,9 +463,11 @@ void MainWindow::onConnectionStateChanged(bool connected, const QString &message
     m_statusLabel->setText(message);
     
     if (connected) {
-        m_packetCount = 0;
-        m_packetCountLabel->setText(tr("Packets: 0"));
+        m_sessionLines = 0;
+        m_sessionPackets = 0;
+        m_sessionClock.start();
         m_protocolHandler->resetParser();
+        m_metricsWidget->resetMetrics();
     }
 }
 
@@ -335,11 +476,216 @@ void MainWindow::onSerialError(const QString &error)
     statusBar()->showMessage(tr("Error: %1").arg(error), 5000);
 }
 
+void MainWindow::onIngestOverloadChanged(bool overloaded)
+{
+    const OverloadPolicy policy = SerialManager::instance().currentSettings().ingest.policy;
+    if (overloaded && policy != OverloadPolicy::DecimateDisplay) {
+        statusBar()->showMessage(tr("Input overloaded: reader %1")
+            .arg(policy == OverloadPolicy::Block ? tr("blocked") : tr("dropping chunks")), 5000);
+        return;
+    }
+    
+    m_displayDecimation = overloaded ? OVERLOAD_DISPLAY_DECIMATION : 1;
+    if (m_lineParser) {
+        m_lineParser->setDisplayDecimation(m_displayDecimation);
+        m_fireWater->setDisplayDecimation(m_displayDecimation);
+        for (FramedProtocol *framed : std::as_const(m_framedProtocols)) {
+            framed->setDisplayDecimation(m_displayDecimation);
+        }
+    }
+    statusBar()->showMessage(overloaded
+        ? tr("Input overloaded: display decimated 1:%1, recording continues").arg(m_displayDecimation)
+        : tr("Input caught up: full display"), 5000);
+}
+
+void MainWindow::initPipeline()
+{
+    // Endpoints the pipeline config can refer to by name
+    m_pipeline->bindProtocol("protocol", m_protocolHandler.get());
+    m_pipeline->bindSink("display", [this](const PacketBatch &batch) { onDataParsed(batch); });
+    m_pipeline->bindSink("record", [this](const PacketBatch &batch) { onDataForLogging(batch); });
+    
+    QSettings settings("ComStudio", "ComStudio");
+    loadPipeline(settings.value("pipelineConfig").toString());
+}
+
+bool MainWindow::loadPipeline(const QString &path)
+{
+    if (!path.isEmpty() && m_pipeline->loadFile(path)) {
+        m_pipelinePath = path;
+        statusBar()->showMessage(tr("Pipeline: %1 (%2 stages)")
+            .arg(QFileInfo(path).fileName()).arg(m_pipeline->stageIds().size()), 5000);
+        return true;
+    }
+    
+    const QString error = m_pipeline->errorString();
+    m_pipelinePath.clear();
+    if (!m_pipeline->load(QJsonDocument::fromJson(DefaultPipelineConfig).object())) {
+        qWarning() << "Default pipeline failed:" << m_pipeline->errorString();
+    }
+    if (path.isEmpty()) {
+        statusBar()->showMessage(tr("Pipeline: default"), 3000);
+        return true;
+    }
+    QMessageBox::warning(this, tr("Pipeline Config"),
+        tr("Could not load the pipeline config, using the default pipeline.\n\n%1").arg(error));
+    return false;
+}
+
+void MainWindow::onLoadPipeline()
+{
+    const QString path = QFileDialog::getOpenFileName(this, tr("Load Pipeline Config"),
+        m_pipelinePath, tr("Pipeline Config (*.json);;All Files (*)"));
+    if (!path.isEmpty()) {
+        loadPipeline(path);
+    }
+}
+
+bool MainWindow::loadFrameSchema(const QString &path, bool quiet)
+{
+    if (!m_binaryFrame->loadSchema(path)) {
+        if (quiet) {
+            qWarning() << "Frame schema:" << m_binaryFrame->errorString();
+        } else {
+            QMessageBox::warning(this, tr("Frame Schema"),
+                tr("Could not load the frame schema.\n\n%1").arg(m_binaryFrame->errorString()));
+        }
+        return false;
+    }
+    m_frameSchemaPath = path;
+    statusBar()->showMessage(tr("Frame schema: %1").arg(m_binaryFrame->description()), 5000);
+    return true;
+}
+
+void MainWindow::onLoadFrameSchema()
+{
+    const QString path = QFileDialog::getOpenFileName(this, tr("Load Frame Schema"),
+        m_frameSchemaPath, tr("Frame Schema (*.json);;All Files (*)"));
+    if (path.isEmpty() || !loadFrameSchema(path)) {
+        return;
+    }
+    const int index = m_protocolCombo->findData(QStringLiteral("binary"));
+    if (index >= 0) {
+        m_protocolCombo->setCurrentIndex(index);
+    }
+}
+
+void MainWindow::onReplayFinished(const ReplayStats &stats)
+{
+    // Queued after the last chunk, so every replayed byte has been parsed by now
+    const double seconds = m_sessionClock.isValid()
+        ? m_sessionClock.nsecsElapsed() / 1e9 : stats.elapsedNs / 1e9;
+    if (seconds <= 0.0) {
+        return;
+    }
+    
+    const QString summary = tr("Replay %1: %2 lines (%3 lines/s), %4 packets (%5 packets/s), "
+                               "%6 MB/s in %7 s")
+        .arg(stats.completed ? tr("finished") : tr("stopped"))
+        .arg(m_sessionLines)
+        .arg(m_sessionLines / seconds, 0, 'f', 0)
+        .arg(m_sessionPackets)
+        .arg(m_sessionPackets / seconds, 0, 'f', 0)
+        .arg(stats.bytes / seconds / (1024.0 * 1024.0), 0, 'f', 2)
+        .arg(seconds, 0, 'f', 2);
+    
+    m_statusLabel->setText(summary);
+    qInfo().noquote() << summary;
+}
+
+void MainWindow::onImportData()
+{
+    if (m_importer && m_importer->isRunning()) {
+        return;
+    }
+    
+    QString path = QFileDialog::getOpenFileName(this,
+        tr("Import Data"),
+        QString(),
+        tr("Data Files (*.csv *.txt *.log);;All Files (*)"));
+    if (path.isEmpty()) {
+        return;
+    }
+    
+    // Lines carry no host time; the step between them is a setting. The
+    // plot only holds the display log, so say how much of the file it keeps.
+    const ParserConfig config = m_lineParser->config();
+    QSettings settings("ComStudio", "ComStudio");
+    QString prompt = tr("Time between lines (ms):");
+    if (config.xAxisSource == XAxisSource::FieldIndex) {
+        prompt += tr("\nThe plot uses the device timestamp in field %1.").arg(config.xAxisFieldIndex);
+    }
+    prompt += tr("\nThe plot keeps the last %1 packets of the file.").arg(m_dataBuffer->maxSize());
+    bool ok = false;
+    const double intervalMs = QInputDialog::getDouble(this, tr("Import Data"), prompt,
+        settings.value("import/sampleIntervalMs", 1.0).toDouble(), 0.001, 3600000.0, 3, &ok);
+    if (!ok) {
+        return;
+    }
+    settings.setValue("import/sampleIntervalMs", intervalMs);
+    
+    ImportOptions options;
+    options.sampleIntervalUs = qMax<qint64>(1, qRound64(intervalMs * 1000.0));
+    
+    if (!m_importer) {
+        m_importer = std::make_unique<BulkImporter>();
+        connect(m_importer.get(), &BulkImporter::packetsReady,
+                m_dataBuffer.get(), &DataBuffer::addBatch);
+        connect(m_importer.get(), &BulkImporter::finished,
+                this, &MainWindow::onImportFinished);
+    }
+    
+    // Parse with the current parser settings (delimiter, fields, labels, ID filter)
+    if (!m_importer->start(path, config, options)) {
+        QMessageBox::warning(this, tr("Import Failed"),
+            tr("Could not import %1:\n%2").arg(path, m_importer->errorString()));
+        return;
+    }
+    
+    m_dataBuffer->clear();
+    m_plotter->clear();
+    
+    m_importProgress = new QProgressDialog(tr("Importing %1...").arg(QFileInfo(path).fileName()),
+                                           tr("Cancel"), 0, 1000, this);
+    m_importProgress->setWindowModality(Qt::WindowModal);
+    m_importProgress->setMinimumDuration(300);
+    m_importProgress->setAttribute(Qt::WA_DeleteOnClose);
+    connect(m_importProgress, &QProgressDialog::canceled,
+            m_importer.get(), &BulkImporter::cancel);
+    connect(m_importer.get(), &BulkImporter::progress,
+            m_importProgress, [this](qint64 done, qint64 total) {
+                if (total > 0) {
+                    m_importProgress->setValue(static_cast<int>(done * 1000 / total));
+                }
+            });
+}
+
+void MainWindow::onImportFinished(const ImportStats &stats)
+{
+    if (m_importProgress) {
+        m_importProgress->close();
+        m_importProgress = nullptr;
+    }
+    
+    const double seconds = qMax<qint64>(1, stats.elapsedMs) / 1000.0;
+    m_statusLabel->setText(
+        tr("Import %1: %2 lines, %3 packets, %4 errors in %5 s (%6 MB/s)")
+            .arg(stats.cancelled ? tr("cancelled") : tr("finished"))
+            .arg(stats.lines)
+            .arg(stats.packets)
+            .arg(stats.errors)
+            .arg(seconds, 0, 'f', 2)
+            .arg(stats.bytes / seconds / (1024.0 * 1024.0), 0, 'f', 1)
+        + (stats.packets > quint64(m_dataBuffer->maxSize())
+               ? tr(", plot holds the last %1").arg(m_dataBuffer->maxSize())
+               : QString()));
+}
+
 void MainWindow::onRawBytesReceived(const QByteArray &data)
 {
-    // Send to protocol handler for parsing
-    // The parser will emit rawLineReady, dataParsed (rate-limited), and dataForLogging
-    m_protocolHandler->processRawData(data);
+    // Into the stage graph; with the default graph the protocol handler
+    // parses inline and the sinks fill the display and record logs
+    m_pipeline->feed("serial", data);
     
     // Note: Raw terminal display is now handled by onRawLineReady
     // to avoid double-processing and ensure proper line handling
@@ -347,6 +693,15 @@ void MainWindow::onRawBytesReceived(const QByteArray &data)
 
 void MainWindow::onRawLineReady(const QString &line)
 {
+    m_sessionLines++;
+    
+    // Line pattern trigger for armed pre-trigger recording (never decimated)
+    m_recordingWidget->checkRawLine(line);
+    
+    if (m_displayDecimation > 1 && m_sessionLines % m_displayDecimation != 0) {
+        return;
+    }
+    
     // Send raw line to terminal (for raw/hex mode display)
     m_terminal->appendRawLine(line);
     
@@ -355,31 +710,20 @@ void MainWindow::onRawLineReady(const QString &line)
     m_parserConfig->setSampleLine(m_lastRawLine);
 }
 
-void MainWindow::onDataParsed(const GenericDataPacket &packet)
+void MainWindow::onDataParsed(const PacketBatch &batch)
 {
     // This is RATE-LIMITED data for display only
     
-    // Add to data buffer (will notify plotter)
-    m_dataBuffer->addPacket(packet);
-    
-    // Update terminal in parsed mode
-    m_terminal->appendPacket(packet);
-    
-    // Update packet counter (rate-limited, so less overhead)
-    m_packetCount++;
-    // Only update label periodically to reduce UI overhead
-    static int labelUpdateCounter = 0;
-    if (++labelUpdateCounter >= 5) {  // Update every 5 packets
-        labelUpdateCounter = 0;
-        m_packetCountLabel->setText(tr("Packets: %1").arg(m_packetCount));
-    }
+    // Append to the display log; plotter and terminal pull on their timers
+    m_dataBuffer->addBatch(batch);
 }
 
-void MainWindow::onDataForLogging(const GenericDataPacket &packet)
+void MainWindow::onDataForLogging(const PacketBatch &batch)
 {
     // This is NOT rate-limited - receives ALL packets for data integrity
     // Used exclusively for recording/logging
-    m_recordingWidget->recordPacket(packet);
+    m_sessionPackets += static_cast<quint64>(batch.size());
+    m_recordLog->addBatch(batch);
 }
 
 void MainWindow::onSendData(const QByteArray &data)
@@ -390,6 +734,18 @@ void MainWindow::onSendData(const QByteArray &data)
 void MainWindow::onProtocolChanged(int index)
 {
     QString protocolId = m_protocolCombo->itemData(index).toString();
+    if (protocolId == DemuxProtocolItem) {
+        // Framed protocols claim their sync bytes (and NMEA its "$"
+        // sentences) first; the line parser takes the text in between
+        // (FireWater would compete with it for the same lines)
+        QStringList order = m_protocolHandler->registeredProtocols();
+        order.removeAll("line");
+        order.removeAll("firewater");
+        order.append("line");
+        m_protocolHandler->setDemuxProtocols(order);
+        return;
+    }
+    m_protocolHandler->setDemuxProtocols({});
     m_protocolHandler->setActiveProtocol(protocolId);
 }
 
@@ -414,6 +770,8 @@ void MainWindow::saveSettings()
     settings.setValue("geometry", saveGeometry());
     settings.setValue("windowState", saveState());
     settings.setValue("splitView", m_isSplitView);
+    settings.setValue("pipelineConfig", m_pipelinePath);
+    settings.setValue("frameSchema", m_frameSchemaPath);
     if (m_isSplitView) {
         settings.setValue("splitterState", m_splitter->saveState());
     }
@@ -432,12 +790,28 @@ void MainWindow::loadSettings()
             m_splitter->restoreState(settings.value("splitterState").toByteArray());
         }
     }
+    
+    const QString frameSchema = settings.value("frameSchema").toString();
+    if (!frameSchema.isEmpty()) {
+        loadFrameSchema(frameSchema, true);
+    }
 }
 
 void MainWindow::onParserConfigApplied(const ParserConfig &config)
 {
     if (m_lineParser) {
+        // Points on different timebases cannot share the x-axis
+        const ParserConfig previous = m_lineParser->config();
+        if (previous.xAxisSource != config.xAxisSource
+            || previous.xAxisFieldIndex != config.xAxisFieldIndex
+            || previous.fitClockDrift != config.fitClockDrift) {
+            m_plotter->clear();
+        }
+        m_plotter->setXAxisLabel(config.xAxisSource == XAxisSource::Counter ? tr("Sample")
+                                                                            : tr("Time (s)"));
         m_lineParser->setConfig(config);
+        m_fireWater->setConfig(FireWaterProtocol::fireWaterConfig(config));
+        m_nmea->setRequireChecksum(config.verifyChecksum);
         statusBar()->showMessage(tr("Parser configuration applied"), 3000);
     }
 }
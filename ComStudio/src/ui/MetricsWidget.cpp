@@ -0,0 +1,252 @@
+/**
+ * @file MetricsWidget.cpp
+ * @brief Implementation of MetricsWidget
+ */
+
+#include "ui/MetricsWidget.h"
+#include "core/TraceRecorder.h"
+
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QGroupBox>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QTimer>
+#include <QFile>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QDateTime>
+#include <QDebug>
+
+MetricsWidget::MetricsWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setupUi();
+
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setInterval(REFRESH_INTERVAL_MS);
+    connect(m_refreshTimer, &QTimer::timeout, this, &MetricsWidget::refresh);
+    m_refreshTimer->start();
+
+    m_current = PipelineMetrics::instance().snapshot();
+}
+
+void MetricsWidget::setupUi()
+{
+    auto *mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(8, 8, 8, 8);
+    mainLayout->setSpacing(8);
+
+    // Counters
+    auto *counterGroup = new QGroupBox(tr("Counters"));
+    auto *counterLayout = new QVBoxLayout(counterGroup);
+    m_counterTable = createTable({tr("Counter"), tr("Total"), tr("Rate/s")}, MetricCounterCount);
+    for (int i = 0; i < MetricCounterCount; ++i) {
+        m_counterTable->setItem(i, 0, new QTableWidgetItem(
+            PipelineMetrics::counterName(static_cast<MetricCounter>(i))));
+    }
+    counterLayout->addWidget(m_counterTable);
+    mainLayout->addWidget(counterGroup);
+
+    // Queue depths
+    auto *gaugeGroup = new QGroupBox(tr("Queue Depths"));
+    auto *gaugeLayout = new QVBoxLayout(gaugeGroup);
+    m_gaugeTable = createTable({tr("Queue"), tr("Current")}, MetricGaugeCount);
+    for (int i = 0; i < MetricGaugeCount; ++i) {
+        m_gaugeTable->setItem(i, 0, new QTableWidgetItem(
+            PipelineMetrics::gaugeName(static_cast<MetricGauge>(i))));
+    }
+    gaugeLayout->addWidget(m_gaugeTable);
+    mainLayout->addWidget(gaugeGroup);
+
+    // Stage latencies
+    auto *stageGroup = new QGroupBox(tr("Stage Time per Item"));
+    auto *stageLayout = new QVBoxLayout(stageGroup);
+    m_stageTable = createTable({tr("Stage"), tr("Items"), tr("Mean"), tr("p50"), tr("p99"), tr("Max")},
+                               MetricStageCount);
+    for (int i = 0; i < MetricStageCount; ++i) {
+        m_stageTable->setItem(i, 0, new QTableWidgetItem(
+            PipelineMetrics::stageName(static_cast<MetricStage>(i))));
+    }
+    stageLayout->addWidget(m_stageTable);
+    mainLayout->addWidget(stageGroup);
+
+    // Byte-to-pixel latency (time since the chunk was read)
+    auto *latencyGroup = new QGroupBox(tr("Latency from Read"));
+    auto *latencyLayout = new QVBoxLayout(latencyGroup);
+    m_latencyTable = createTable({tr("Stage"), tr("Chunks"), tr("p50"), tr("p99"), tr("Max")},
+                                 LatencyStageCount);
+    for (int i = 0; i < LatencyStageCount; ++i) {
+        m_latencyTable->setItem(i, 0, new QTableWidgetItem(
+            LatencyTracer::stageName(static_cast<LatencyStage>(i))));
+    }
+    latencyLayout->addWidget(m_latencyTable);
+    mainLayout->addWidget(latencyGroup);
+
+    // Buttons
+    auto *buttonLayout = new QHBoxLayout();
+    m_resetButton = new QPushButton(tr("Reset"));
+    connect(m_resetButton, &QPushButton::clicked, this, &MetricsWidget::resetMetrics);
+    buttonLayout->addWidget(m_resetButton);
+
+    m_dumpLatencyButton = new QPushButton(tr("Dump Latency"));
+    m_dumpLatencyButton->setToolTip(tr("Write the byte-to-pixel latency report to the log"));
+    connect(m_dumpLatencyButton, &QPushButton::clicked, this, &MetricsWidget::dumpLatency);
+    buttonLayout->addWidget(m_dumpLatencyButton);
+
+    m_traceButton = new QPushButton(tr("Record Trace"));
+    m_traceButton->setCheckable(true);
+    m_traceButton->setToolTip(tr("Record pipeline trace events; uncheck to save them as "
+                                 "Chrome trace JSON (chrome://tracing, ui.perfetto.dev)"));
+    connect(m_traceButton, &QPushButton::toggled, this, &MetricsWidget::onTraceToggled);
+    buttonLayout->addWidget(m_traceButton);
+
+    buttonLayout->addStretch();
+
+    m_exportCsvButton = new QPushButton(tr("Export CSV..."));
+    connect(m_exportCsvButton, &QPushButton::clicked, this, &MetricsWidget::onExportCsv);
+    buttonLayout->addWidget(m_exportCsvButton);
+
+    m_exportJsonButton = new QPushButton(tr("Export JSON..."));
+    connect(m_exportJsonButton, &QPushButton::clicked, this, &MetricsWidget::onExportJson);
+    buttonLayout->addWidget(m_exportJsonButton);
+
+    mainLayout->addLayout(buttonLayout);
+}
+
+QTableWidget* MetricsWidget::createTable(const QStringList &headers, int rows)
+{
+    auto *table = new QTableWidget(rows, headers.size());
+    table->setHorizontalHeaderLabels(headers);
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    table->horizontalHeader()->setStretchLastSection(true);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionMode(QAbstractItemView::NoSelection);
+    table->setFocusPolicy(Qt::NoFocus);
+
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 1; col < headers.size(); ++col) {
+            auto *item = new QTableWidgetItem();
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            table->setItem(row, col, item);
+        }
+    }
+
+    // Size to contents so the three tables share the dock without scrolling
+    table->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    table->resizeRowsToContents();
+    int height = table->horizontalHeader()->sizeHint().height() + 2 * table->frameWidth();
+    for (int row = 0; row < rows; ++row) {
+        height += table->rowHeight(row);
+    }
+    table->setFixedHeight(height);
+    return table;
+}
+
+void MetricsWidget::refresh()
+{
+    m_previous = m_current;
+    m_current = PipelineMetrics::instance().snapshot();
+
+    for (int i = 0; i < MetricCounterCount; ++i) {
+        const auto c = static_cast<MetricCounter>(i);
+        m_counterTable->item(i, 1)->setText(QString::number(m_current.counter(c)));
+        m_counterTable->item(i, 2)->setText(QString::number(m_current.rate(c, m_previous), 'f', 0));
+    }
+
+    for (int i = 0; i < MetricGaugeCount; ++i) {
+        m_gaugeTable->item(i, 1)->setText(QString::number(m_current.gauge(static_cast<MetricGauge>(i))));
+    }
+
+    for (int i = 0; i < MetricStageCount; ++i) {
+        const StageHistogram &h = m_current.stage(static_cast<MetricStage>(i));
+        m_stageTable->item(i, 1)->setText(QString::number(h.items));
+        m_stageTable->item(i, 2)->setText(formatNs(h.meanNs()));
+        m_stageTable->item(i, 3)->setText(h.items ? formatNs(h.percentileNs(0.5)) : QString());
+        m_stageTable->item(i, 4)->setText(h.items ? formatNs(h.percentileNs(0.99)) : QString());
+        m_stageTable->item(i, 5)->setText(h.items ? formatNs(h.maxNs()) : QString());
+    }
+
+    const LatencySnapshot latency = LatencyTracer::instance().snapshot();
+    for (int i = 0; i < LatencyStageCount; ++i) {
+        const StageHistogram &h = latency.stages[i];
+        m_latencyTable->item(i, 1)->setText(QString::number(h.items));
+        m_latencyTable->item(i, 2)->setText(h.items ? formatNs(h.percentileNs(0.5)) : QString());
+        m_latencyTable->item(i, 3)->setText(h.items ? formatNs(h.percentileNs(0.99)) : QString());
+        m_latencyTable->item(i, 4)->setText(h.items ? formatNs(latency.maxNs[i]) : QString());
+    }
+
+    emit snapshotUpdated(m_current, m_previous);
+}
+
+void MetricsWidget::resetMetrics()
+{
+    PipelineMetrics::instance().reset();
+    LatencyTracer::instance().reset();
+    m_current = MetricsSnapshot();
+    refresh();
+}
+
+void MetricsWidget::dumpLatency()
+{
+    qInfo().noquote() << LatencyTracer::report(LatencyTracer::instance().snapshot());
+}
+
+void MetricsWidget::onExportCsv()
+{
+    // Export the latest full interval so rates match the table
+    saveExport(PipelineMetrics::toCsv(m_current, m_previous),
+               tr("Export Metrics (CSV)"), tr("CSV Files (*.csv)"), "metrics");
+}
+
+void MetricsWidget::onExportJson()
+{
+    saveExport(PipelineMetrics::toJson(m_current, m_previous),
+               tr("Export Metrics (JSON)"), tr("JSON Files (*.json)"), "metrics");
+}
+
+void MetricsWidget::onTraceToggled(bool recording)
+{
+    TraceRecorder &recorder = TraceRecorder::instance();
+    if (recording) {
+        recorder.clear();
+        recorder.setEnabled(true);
+        m_traceButton->setText(tr("Stop Trace..."));
+        return;
+    }
+
+    recorder.setEnabled(false);
+    m_traceButton->setText(tr("Record Trace"));
+    saveExport(recorder.exportChromeJson(),
+               tr("Save Trace (Chrome JSON)"), tr("JSON Files (*.json)"), "trace");
+}
+
+void MetricsWidget::saveExport(const QByteArray &data, const QString &title,
+                               const QString &filter, const QString &prefix)
+{
+    const QString suggested = QString("%1_%2")
+        .arg(prefix, QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    QString path = QFileDialog::getSaveFileName(this, title, suggested, filter);
+    if (path.isEmpty()) {
+        return;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(data) != data.size()) {
+        QMessageBox::warning(this, tr("Export Failed"),
+            tr("Could not write %1:\n%2").arg(path, file.errorString()));
+    }
+}
+
+QString MetricsWidget::formatNs(double ns)
+{
+    if (ns < 1000.0) {
+        return QString("%1 ns").arg(ns, 0, 'f', 0);
+    }
+    if (ns < 1000000.0) {
+        return QString("%1 us").arg(ns / 1000.0, 0, 'f', 1);
+    }
+    return QString("%1 ms").arg(ns / 1000000.0, 0, 'f', 2);
+}
@@ -13,6 +13,7 @@
 #include <QComboBox>
 #include <QLineEdit>
 #include <QSpinBox>
+#include <QDoubleSpinBox>
 #include <QCheckBox>
 #include <QLabel>
 #include <QPushButton>
@@ -157,7 +158,11 @@ QGroupBox* ParserConfigWidget::createFieldMappingGroup()
     m_xAxisSourceCombo->addItem(tr("Field Index"), static_cast<int>(XAxisSource::FieldIndex));
     connect(m_xAxisSourceCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, [this](int idx) {
-                m_xAxisFieldSpin->setEnabled(idx == 2);  // FieldIndex
+                const bool device = idx == 2;  // FieldIndex
+                m_xAxisFieldSpin->setEnabled(device);
+                m_tickBitsCombo->setEnabled(device);
+                m_tickRateSpin->setEnabled(device);
+                m_fitDriftCheck->setEnabled(device);
                 emit configChanged();
             });
     xAxisLayout->addWidget(m_xAxisSourceCombo);
@@ -173,6 +178,38 @@ QGroupBox* ParserConfigWidget::createFieldMappingGroup()
     xAxisLayout->addStretch();
     layout->addLayout(xAxisLayout);
     
+    // Device clock (Field Index): counter width, tick rate, drift fit
+    auto *clockLayout = new QHBoxLayout();
+    m_tickBitsCombo = new QComboBox();
+    m_tickBitsCombo->addItem(tr("32-bit ticks"), 32);
+    m_tickBitsCombo->addItem(tr("16-bit ticks"), 16);
+    m_tickBitsCombo->addItem(tr("No wrap"), 0);
+    m_tickBitsCombo->setToolTip(tr("Width of the device counter; wraparounds are unwrapped"));
+    m_tickBitsCombo->setEnabled(false);
+    connect(m_tickBitsCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &ParserConfigWidget::configChanged);
+    clockLayout->addWidget(m_tickBitsCombo);
+    
+    m_tickRateSpin = new QDoubleSpinBox();
+    m_tickRateSpin->setRange(0.001, 1e9);
+    m_tickRateSpin->setDecimals(3);
+    m_tickRateSpin->setValue(1000.0);
+    m_tickRateSpin->setSuffix(tr(" ticks/s"));
+    m_tickRateSpin->setToolTip(tr("Device counter rate (1000 for milliseconds, 1 if the field is in seconds)"));
+    m_tickRateSpin->setEnabled(false);
+    connect(m_tickRateSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &ParserConfigWidget::configChanged);
+    clockLayout->addWidget(m_tickRateSpin);
+    
+    m_fitDriftCheck = new QCheckBox(tr("Fit drift to host clock"));
+    m_fitDriftCheck->setToolTip(tr("Keep the device's sample spacing but follow host time"));
+    m_fitDriftCheck->setEnabled(false);
+    connect(m_fitDriftCheck, &QCheckBox::toggled, this, &ParserConfigWidget::configChanged);
+    clockLayout->addWidget(m_fitDriftCheck);
+    
+    clockLayout->addStretch();
+    layout->addLayout(clockLayout);
+    
     return group;
 }
 
@@ -204,7 +241,7 @@ QGroupBox* ParserConfigWidget::createIdFilterGroup()
     // Changed to QLineEdit for alphanumeric ID support (e.g., "d1", "#5", "sensor2")
     m_acceptIdEdit = new QLineEdit();
     m_acceptIdEdit->setPlaceholderText(tr("All (empty = no filter)"));
-    m_acceptIdEdit->setToolTip(tr("Enter sensor ID to filter (e.g., 'd1', '5', '#12820')\nLeave empty to accept all IDs"));
+    m_acceptIdEdit->setToolTip(tr("Enter sensor ID to filter (e.g., 'd1', '5', '#12820')\nLeave empty to keep all IDs; the plotter's Sensors menu picks which are drawn"));
     m_acceptIdEdit->setEnabled(false);
     connect(m_acceptIdEdit, &QLineEdit::textChanged,
             this, &ParserConfigWidget::configChanged);
@@ -247,6 +284,14 @@ QGroupBox* ParserConfigWidget::createOptionsGroup()
             this, &ParserConfigWidget::configChanged);
     layout->addWidget(m_trimWhitespaceCheck);
     
+    // Line checksum
+    m_verifyChecksumCheck = new QCheckBox(tr("Verify '*XX' line checksum (NMEA XOR)"));
+    m_verifyChecksumCheck->setToolTip(tr("Drop lines whose checksum is missing or wrong; rejects are counted as checksum_rejects. "
+                                         "The NMEA protocol then also rejects sentences without one."));
+    connect(m_verifyChecksumCheck, &QCheckBox::toggled,
+            this, &ParserConfigWidget::configChanged);
+    layout->addWidget(m_verifyChecksumCheck);
+    
     // Performance section separator
     auto *perfSeparator = new QFrame();
     perfSeparator->setFrameShape(QFrame::HLine);
@@ -356,6 +401,9 @@ ParserConfig ParserConfigWidget::currentConfig() const
     // X-axis source
     config.xAxisSource = static_cast<XAxisSource>(m_xAxisSourceCombo->currentData().toInt());
     config.xAxisFieldIndex = m_xAxisFieldSpin->value();
+    config.deviceTickBits = m_tickBitsCombo->currentData().toInt();
+    config.deviceTickSeconds = 1.0 / m_tickRateSpin->value();
+    config.fitClockDrift = m_fitDriftCheck->isChecked();
     
     // ID filter
     if (m_enableIdFilterCheck->isChecked()) {
@@ -372,6 +420,7 @@ ParserConfig ParserConfigWidget::currentConfig() const
         config.labelSeparator = m_labelSeparatorEdit->text().at(0);
     }
     config.trimWhitespace = m_trimWhitespaceCheck->isChecked();
+    config.verifyChecksum = m_verifyChecksumCheck->isChecked();
     
     return config;
 }
@@ -409,7 +458,15 @@ void ParserConfigWidget::setConfig(const ParserConfig &config)
         }
     }
     m_xAxisFieldSpin->setValue(config.xAxisFieldIndex);
-    m_xAxisFieldSpin->setEnabled(config.xAxisSource == XAxisSource::FieldIndex);
+    const int tickBitsIndex = m_tickBitsCombo->findData(config.deviceTickBits);
+    m_tickBitsCombo->setCurrentIndex(tickBitsIndex >= 0 ? tickBitsIndex : 0);
+    m_tickRateSpin->setValue(config.deviceTickSeconds > 0 ? 1.0 / config.deviceTickSeconds : 1000.0);
+    m_fitDriftCheck->setChecked(config.fitClockDrift);
+    const bool device = config.xAxisSource == XAxisSource::FieldIndex;
+    m_xAxisFieldSpin->setEnabled(device);
+    m_tickBitsCombo->setEnabled(device);
+    m_tickRateSpin->setEnabled(device);
+    m_fitDriftCheck->setEnabled(device);
     
     // ID filter
     bool hasIdFilter = config.idFieldIndex >= 0;
@@ -424,6 +481,7 @@ void ParserConfigWidget::setConfig(const ParserConfig &config)
     m_labelSeparatorEdit->setText(QString(config.labelSeparator));
     m_labelSeparatorEdit->setEnabled(config.stripLabels);
     m_trimWhitespaceCheck->setChecked(config.trimWhitespace);
+    m_verifyChecksumCheck->setChecked(config.verifyChecksum);
     
     blockSignals(false);
 }
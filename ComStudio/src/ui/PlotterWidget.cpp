@@ -4,7 +4,14 @@
  */
 
 #include "ui/PlotterWidget.h"
+#include "models/DataBuffer.h"
+#include "models/PacketCursor.h"
 #include "ui/ChannelPlotWindow.h"
+#include "core/PipelineMetrics.h"
+#include "core/LatencyTracer.h"
+#include "core/TraceRecorder.h"
+#include "core/Downsampler.h"
+#include "core/SensorRegistry.h"
 #include "qcustomplot.h"
 
 #include <QVBoxLayout>
@@ -14,6 +21,9 @@
 #include <QCheckBox>
 #include <QPushButton>
 #include <QComboBox>
+#include <QMenu>
+#include <QToolButton>
+#include <QSignalBlocker>
 #include <QDateTime>
 #include <QDebug>
 
@@ -37,9 +47,6 @@ PlotterWidget::PlotterWidget(QWidget *parent)
     setupUi();
     setupPlot();
     
-    // Pre-allocate pending data buffer
-    m_pendingData.reserve(PENDING_DATA_RESERVE);
-    
     // Update timer for efficient replotting - slower for better performance
     m_updateTimer = new QTimer(this);
     m_updateTimer->setInterval(50);  // 20 FPS for smoother performance
@@ -101,6 +108,19 @@ void PlotterWidget::setupUi()
             this, &PlotterWidget::onDownsampleModeChanged);
     toolbarLayout->addWidget(m_downsampleModeCombo);
     
+    // Sensor picker (shown once the data carries more than one sensor)
+    m_sensorMenu = new QMenu(this);
+    m_sensorMenu->addAction(tr("Show All"), this, [this]() { setAllSensorsShown(true); });
+    m_sensorMenu->addAction(tr("Hide All"), this, [this]() { setAllSensorsShown(false); });
+    m_sensorMenu->addSeparator();
+    m_sensorButton = new QToolButton();
+    m_sensorButton->setText(tr("Sensors"));
+    m_sensorButton->setMenu(m_sensorMenu);
+    m_sensorButton->setPopupMode(QToolButton::InstantPopup);
+    m_sensorButton->setToolTip(tr("Choose the sensors to plot (all are kept)"));
+    m_sensorButton->setVisible(false);
+    toolbarLayout->addWidget(m_sensorButton);
+    
     toolbarLayout->addStretch();
     
     m_pauseButton = new QPushButton(tr("Pause"));
@@ -177,6 +197,32 @@ void PlotterWidget::setupPlot()
     // Enable legend item selection for pop-out
     m_plot->legend->setSelectableParts(QCPLegend::spItems);
     connect(m_plot, &QCustomPlot::legendDoubleClick, this, &PlotterWidget::onLegendClick);
+    
+    // The queued replot runs outside onUpdateTimer; trace it from its own signals
+    connect(m_plot, &QCustomPlot::beforeReplot, this, [this]() {
+        m_replotStartNs = TraceRecorder::isEnabled() ? LatencyTracer::nowNs() : 0;
+        if (TraceRecorder::publishesActiveStage()) {
+            m_replotPreviousStage = TraceRecorder::swapActiveStage("QCustomPlot::replot");
+        }
+    });
+    
+    // Byte-to-pixel latency ends when the replot with the chunk's points is done
+    connect(m_plot, &QCustomPlot::afterReplot, this, [this]() {
+        if (m_replotStartNs) {
+            TraceRecorder::instance().record("QCustomPlot::replot", m_replotStartNs,
+                                             LatencyTracer::nowNs() - m_replotStartNs);
+            m_replotStartNs = 0;
+        }
+        if (TraceRecorder::publishesActiveStage()) {
+            TraceRecorder::swapActiveStage(m_replotPreviousStage);
+        }
+        
+        auto &tracer = LatencyTracer::instance();
+        for (quint64 traceId : std::as_const(m_replotTraces)) {
+            tracer.mark(traceId, LatencyStage::Screen);
+        }
+        m_replotTraces.clear();
+    });
 }
 
 void PlotterWidget::setTimeWindow(double seconds)
@@ -219,35 +265,28 @@ bool PlotterWidget::isOpenGlEnabled() const
 #endif
 }
 
-void PlotterWidget::addData(const GenericDataPacket &packet)
+void PlotterWidget::setXAxisLabel(const QString &label)
 {
-    if (m_paused || !packet.isValid) {
-        return;
-    }
-    
-    // Initialize start time on first data
-    if (m_startTime == 0) {
-        m_startTime = packet.timestamp;
-    }
-    
-    // Convert timestamp to seconds from start
-    double time = (packet.timestamp - m_startTime) / 1000.0;
-    
-    // Batch the data - actual channel storage happens in timer
-    PendingData pd;
-    pd.timestamp = time;
-    pd.values = packet.values;
-    m_pendingData.append(pd);
-    
-    m_needsReplot = true;
+    m_plot->xAxis->setLabel(label);
+    m_plot->replot();
+}
+
+void PlotterWidget::setSource(DataBuffer *buffer)
+{
+    delete m_cursor;
+    m_cursor = buffer ? buffer->openCursor(QStringLiteral("plotter"), this) : nullptr;
 }
 
 void PlotterWidget::clear()
 {
     m_channelData.clear();
-    m_pendingData.clear();
-    m_pendingData.reserve(PENDING_DATA_RESERVE);
-    m_startTime = 0;
+    if (m_cursor) {
+        m_cursor->seekToEnd();
+    }
+    m_committedTraces.clear();
+    m_replotTraces.clear();
+    m_startTime = 0.0;
+    m_hasStartTime = false;
     
     for (auto *graph : m_graphs) {
         graph->data()->clear();
@@ -265,17 +304,57 @@ void PlotterWidget::setPaused(bool paused)
 
 void PlotterWidget::onUpdateTimer()
 {
+    TRACE_SCOPE("PlotterWidget::onUpdateTimer");
+    
+    // Pull what arrived since the last frame; older points would be
+    // trimmed below anyway, and nothing is taken while paused
+    QVector<PacketBatch> batches;
+    qint64 pulled = 0;
+    if (m_cursor) {
+        if (m_paused) {
+            m_cursor->seekToEnd();
+        } else {
+            const qint64 excess = m_cursor->available() - m_maxDataPoints;
+            if (excess > 0) {
+                m_cursor->skip(excess);
+            }
+            batches = m_cursor->read();
+            for (const auto &batch : std::as_const(batches)) {
+                pulled += batch.size();
+            }
+        }
+    }
+    PipelineMetrics::instance().setGauge(MetricGauge::PlotterPendingPoints, pulled);
+    
     // Process all pending data in batch
-    if (!m_pendingData.isEmpty() && !m_paused) {
-        for (const auto &pd : m_pendingData) {
-            for (int i = 0; i < pd.values.size(); ++i) {
-                auto &channelData = m_channelData[i];
-                channelData.timestamps.append(pd.timestamp);
-                channelData.values.append(pd.values[i]);
+    if (pulled > 0) {
+        TRACE_SCOPE("commit");
+        auto &tracer = LatencyTracer::instance();
+        if (!m_hasStartTime) {
+            m_startTime = batches.first().first().xTime();
+            m_hasStartTime = true;
+        }
+        for (const auto &batch : std::as_const(batches)) {
+            for (const GenericDataPacket &packet : batch) {
+                if (!packet.isValid) {
+                    continue;
+                }
+                if (packet.traceId != 0
+                    && (m_committedTraces.isEmpty() || m_committedTraces.last() != packet.traceId)) {
+                    tracer.mark(packet.traceId, LatencyStage::PlotCommit);
+                    m_committedTraces.append(packet.traceId);
+                }
+                
+                // Host, counter or device time (see DeviceClock), relative to start
+                const double time = packet.xTime() - m_startTime;
+                for (int i = 0; i < packet.values.size(); ++i) {
+                    auto &channelData = m_channelData[seriesFor(packet.sensorKey, i)];
+                    channelData.timestamps.append(time);
+                    channelData.values.append(packet.values[i]);
+                }
             }
         }
-        m_pendingData.clear();
-        m_pendingData.reserve(PENDING_DATA_RESERVE);  // Keep capacity
+        m_needsReplot = true;
         
         // Trim data points in batch - use mid() which is faster than remove()
         for (auto it = m_channelData.begin(); it != m_channelData.end(); ++it) {
@@ -328,158 +407,44 @@ void PlotterWidget::onUpdateTimer()
         return;
     }
     
+    StageTimer frameTimer(MetricStage::PlotRender);
+    PipelineMetrics::instance().add(MetricCounter::PlotFrames);
+    
     // Update graph data with selected downsampling algorithm
     for (auto it = m_channelData.begin(); it != m_channelData.end(); ++it) {
         int channelIndex = it.key();
         const auto &data = it.value();
         
+        // Hidden sensors keep collecting; they are drawn once picked again
+        if (!isSensorShown(channelIndex)) {
+            continue;
+        }
+        
         if (channelIndex < m_graphs.size() && m_graphs[channelIndex]) {
             int dataSize = data.timestamps.size();
             
             // PERFORMANCE: Downsample if too many points
+            QVector<double> dsTime, dsValue;
             if (dataSize > MAX_DISPLAY_POINTS) {
-                QVector<double> dsTime, dsValue;
-                
-                if (m_downsampleMode == DownsampleMode::MinMax) {
-                    // ============================================================
-                    // MIN-MAX DOWNSAMPLING
-                    // Best for catching spikes/glitches - preserves signal envelope
-                    // ============================================================
-                    int numBuckets = MAX_DISPLAY_POINTS / 2;
-                    dsTime.reserve(numBuckets * 2 + 2);
-                    dsValue.reserve(numBuckets * 2 + 2);
-                    
-                    // Always include first point
-                    dsTime.append(data.timestamps.first());
-                    dsValue.append(data.values.first());
-                    
-                    double bucketSize = static_cast<double>(dataSize - 2) / numBuckets;
-                    
-                    for (int bucket = 0; bucket < numBuckets; ++bucket) {
-                        int startIdx = 1 + static_cast<int>(bucket * bucketSize);
-                        int endIdx = 1 + static_cast<int>((bucket + 1) * bucketSize);
-                        endIdx = qMin(endIdx, dataSize - 1);
-                        
-                        if (startIdx >= endIdx) continue;
-                        
-                        // Find min and max in this bucket
-                        int minIdx = startIdx, maxIdx = startIdx;
-                        double minVal = data.values[startIdx];
-                        double maxVal = data.values[startIdx];
-                        
-                        for (int i = startIdx + 1; i < endIdx; ++i) {
-                            if (data.values[i] < minVal) {
-                                minVal = data.values[i];
-                                minIdx = i;
-                            }
-                            if (data.values[i] > maxVal) {
-                                maxVal = data.values[i];
-                                maxIdx = i;
-                            }
-                        }
-                        
-                        // Add min and max in time order to preserve signal shape
-                        if (minIdx <= maxIdx) {
-                            dsTime.append(data.timestamps[minIdx]);
-                            dsValue.append(minVal);
-                            if (minIdx != maxIdx) {
-                                dsTime.append(data.timestamps[maxIdx]);
-                                dsValue.append(maxVal);
-                            }
-                        } else {
-                            dsTime.append(data.timestamps[maxIdx]);
-                            dsValue.append(maxVal);
-                            dsTime.append(data.timestamps[minIdx]);
-                            dsValue.append(minVal);
-                        }
-                    }
-                    
-                    // Always include last point
-                    dsTime.append(data.timestamps.last());
-                    dsValue.append(data.values.last());
-                    
-                } else {
-                    // ============================================================
-                    // LTTB DOWNSAMPLING (default)
-                    // Best for smooth trend visualization - preserves visual shape
-                    // ============================================================
-                    dsTime.reserve(MAX_DISPLAY_POINTS);
-                    dsValue.reserve(MAX_DISPLAY_POINTS);
-                    
-                    // Always include first point
-                    dsTime.append(data.timestamps.first());
-                    dsValue.append(data.values.first());
-                    
-                    // Bucket size (first and last points are fixed)
-                    double bucketSize = static_cast<double>(dataSize - 2) / (MAX_DISPLAY_POINTS - 2);
-                    
-                    int prevSelectedIdx = 0;  // Index of last selected point
-                    
-                    for (int bucket = 0; bucket < MAX_DISPLAY_POINTS - 2; ++bucket) {
-                        // Current bucket range
-                        int bucketStart = static_cast<int>(bucket * bucketSize) + 1;
-                        int bucketEnd = static_cast<int>((bucket + 1) * bucketSize) + 1;
-                        bucketEnd = qMin(bucketEnd, dataSize - 1);
-                        
-                        // Next bucket range (for averaging)
-                        int nextBucketStart = bucketEnd;
-                        int nextBucketEnd = static_cast<int>((bucket + 2) * bucketSize) + 1;
-                        nextBucketEnd = qMin(nextBucketEnd, dataSize);
-                        
-                        // Calculate average point of next bucket (point C in triangle)
-                        double avgX = 0, avgY = 0;
-                        int nextCount = nextBucketEnd - nextBucketStart;
-                        if (nextCount > 0) {
-                            for (int i = nextBucketStart; i < nextBucketEnd; ++i) {
-                                avgX += data.timestamps[i];
-                                avgY += data.values[i];
-                            }
-                            avgX /= nextCount;
-                            avgY /= nextCount;
-                        } else {
-                            // Last bucket - use last point
-                            avgX = data.timestamps.last();
-                            avgY = data.values.last();
-                        }
-                        
-                        // Point A (previously selected point)
-                        double ax = data.timestamps[prevSelectedIdx];
-                        double ay = data.values[prevSelectedIdx];
-                        
-                        // Find point in current bucket that maximizes triangle area
-                        double maxArea = -1;
-                        int maxAreaIdx = bucketStart;
-                        
-                        for (int i = bucketStart; i < bucketEnd; ++i) {
-                            double bx = data.timestamps[i];
-                            double by = data.values[i];
-                            double area = qAbs((ax - avgX) * (by - ay) - (ax - bx) * (avgY - ay));
-                            
-                            if (area > maxArea) {
-                                maxArea = area;
-                                maxAreaIdx = i;
-                            }
-                        }
-                        
-                        dsTime.append(data.timestamps[maxAreaIdx]);
-                        dsValue.append(data.values[maxAreaIdx]);
-                        prevSelectedIdx = maxAreaIdx;
-                    }
-                    
-                    // Always include last point
-                    dsTime.append(data.timestamps.last());
-                    dsValue.append(data.values.last());
-                }
-                
-                m_graphs[channelIndex]->setData(dsTime, dsValue, true);
-            } else {
+                TRACE_SCOPE("downsample");
+                Downsampler::downsample(m_downsampleMode, data.timestamps, data.values,
+                                        MAX_DISPLAY_POINTS, dsTime, dsValue);
+            }
+            
+            TRACE_SCOPE("setData");
+            if (dsTime.isEmpty()) {
                 m_graphs[channelIndex]->setData(data.timestamps, data.values, true);
+            } else {
+                m_graphs[channelIndex]->setData(dsTime, dsValue, true);
             }
         }
     }
     
     updateAxisRanges();
     
+    m_replotTraces += m_committedTraces;
+    m_committedTraces.clear();
+    
     // Use rpQueuedReplot for smoother updates (reduces flicker)
     // rpRefreshHint tells Qt to batch the repaint with other pending paints
     m_plot->replot(QCustomPlot::rpQueuedReplot);
@@ -605,9 +570,9 @@ void PlotterWidget::onChannelReattach(int channelIndex)
         m_detachedWindows.remove(channelIndex);
     }
     
-    // Show in main plot again
+    // Show in main plot again (unless its sensor is not picked)
     if (channelIndex < m_graphs.size()) {
-        m_graphs[channelIndex]->setVisible(true);
+        m_graphs[channelIndex]->setVisible(isSensorShown(channelIndex));
     }
     
     m_needsReplot = true;
@@ -618,7 +583,7 @@ QCPGraph* PlotterWidget::ensureGraph(int channelIndex)
     // Extend graphs vector if needed
     while (m_graphs.size() <= channelIndex) {
         QCPGraph *graph = m_plot->addGraph();
-        graph->setName(QString("Ch%1").arg(m_graphs.size()));
+        graph->setName(m_seriesNames.value(m_graphs.size(), QString("Ch%1").arg(m_graphs.size())));
         
         // Use SOLID pen - explicitly set to avoid any dashed appearance
         QPen pen(channelColor(m_graphs.size()));
@@ -631,6 +596,11 @@ QCPGraph* PlotterWidget::ensureGraph(int channelIndex)
         graph->setAdaptiveSampling(true);  // PERFORMANCE: Enable adaptive sampling
         graph->setLineStyle(QCPGraph::lsLine);  // Simple connected line
         m_graphs.append(graph);
+        
+        if (!isSensorShown(m_graphs.size() - 1)) {
+            graph->setVisible(false);
+            graph->removeFromLegend();
+        }
     }
     
     return m_graphs[channelIndex];
@@ -664,7 +634,11 @@ void PlotterWidget::updateAxisRanges()
             double yMax = std::numeric_limits<double>::lowest();
             
             // OPTIMIZATION: Sample only every Nth point instead of all points
-            for (const auto &data : m_channelData) {
+            for (auto it = m_channelData.cbegin(); it != m_channelData.cend(); ++it) {
+                if (!isSensorShown(it.key())) {
+                    continue;
+                }
+                const auto &data = it.value();
                 int dataSize = data.timestamps.size();
                 if (dataSize == 0) continue;
                 
@@ -713,3 +687,89 @@ QColor PlotterWidget::channelColor(int index) const
 {
     return s_channelColors[index % s_channelColors.size()];
 }
+
+int PlotterWidget::seriesFor(int sensorKey, int channel)
+{
+    const quint64 key = (static_cast<quint64>(static_cast<quint32>(sensorKey)) << 32)
+                        | static_cast<quint32>(channel);
+    auto it = m_seriesIndex.constFind(key);
+    if (it != m_seriesIndex.constEnd()) {
+        return it.value();
+    }
+    
+    if (!m_sensorActions.contains(sensorKey)) {
+        addSensor(sensorKey);
+    }
+    const int series = static_cast<int>(m_seriesSensor.size());
+    m_seriesSensor.append(sensorKey);
+    m_seriesNames.append(sensorKey >= 0
+        ? QString("%1/Ch%2").arg(SensorRegistry::instance().name(sensorKey)).arg(channel)
+        : QString("Ch%1").arg(channel));
+    m_seriesIndex.insert(key, series);
+    return series;
+}
+
+void PlotterWidget::addSensor(int sensorKey)
+{
+    const QString name = sensorKey >= 0 ? SensorRegistry::instance().name(sensorKey) : tr("(no ID)");
+    QAction *action = m_sensorMenu->addAction(name);
+    action->setCheckable(true);
+    action->setChecked(!m_hiddenSensors.contains(sensorKey));
+    connect(action, &QAction::toggled, this, [this, sensorKey](bool checked) {
+        if (checked) {
+            m_hiddenSensors.remove(sensorKey);
+        } else {
+            m_hiddenSensors.insert(sensorKey);
+        }
+        applySensorVisibility();
+    });
+    m_sensorActions.insert(sensorKey, action);
+    applySensorVisibility();
+}
+
+bool PlotterWidget::isSensorShown(int series) const
+{
+    return !m_hiddenSensors.contains(m_seriesSensor.value(series, -1));
+}
+
+void PlotterWidget::setAllSensorsShown(bool shown)
+{
+    for (auto it = m_sensorActions.cbegin(); it != m_sensorActions.cend(); ++it) {
+        const QSignalBlocker blocker(it.value());
+        it.value()->setChecked(shown);
+        if (shown) {
+            m_hiddenSensors.remove(it.key());
+        } else {
+            m_hiddenSensors.insert(it.key());
+        }
+    }
+    applySensorVisibility();
+}
+
+void PlotterWidget::applySensorVisibility()
+{
+    for (int series = 0; series < m_graphs.size(); ++series) {
+        const bool shown = isSensorShown(series);
+        m_graphs[series]->setVisible(shown && !m_detachedChannels.contains(series));
+        if (shown) {
+            m_graphs[series]->addToLegend();
+        } else {
+            m_graphs[series]->removeFromLegend();
+        }
+    }
+    
+    const int total = static_cast<int>(m_sensorActions.size());
+    int shownCount = 0;
+    for (auto it = m_sensorActions.cbegin(); it != m_sensorActions.cend(); ++it) {
+        if (!m_hiddenSensors.contains(it.key())) {
+            shownCount++;
+        }
+    }
+    m_sensorButton->setText(tr("Sensors (%1/%2)").arg(shownCount).arg(total));
+    m_sensorButton->setVisible(total > 1);
+    
+    // Rescale to the picked sensors on the next frame
+    m_cachedYMin = m_cachedYMax = 0;
+    m_autoScaleCounter = 4;
+    m_needsReplot = true;
+}
@@ -4,6 +4,10 @@
  */
 
 #include "ui/RecordingWidget.h"
+#include "core/TraceRecorder.h"
+#include "core/CsvRecordWriter.h"
+#include "models/DataBuffer.h"
+#include "models/PacketCursor.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -13,9 +17,15 @@
 #include <QLineEdit>
 #include <QLabel>
 #include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QGroupBox>
 #include <QFileDialog>
+#include <QComboBox>
 #include <QDateTime>
+#include <QFileInfo>
 #include <QMessageBox>
+#include <QApplication>
+#include <QDebug>
 
 RecordingWidget::RecordingWidget(QWidget *parent)
     : QWidget(parent)
@@ -53,6 +63,28 @@ void RecordingWidget::setupUi()
     
     mainLayout->addLayout(fileLayout);
     
+    // Format row
+    auto *formatLayout = new QHBoxLayout();
+    formatLayout->addWidget(new QLabel(tr("Format:")));
+    
+    m_formatCombo = new QComboBox();
+    m_formatCombo->addItem(tr("CSV"), static_cast<int>(RecordingFileFormat::Csv));
+    m_formatCombo->addItem(tr("Native (.csrec)"), static_cast<int>(RecordingFileFormat::Native));
+    m_formatCombo->setToolTip(tr("Native: compact columnar format with time index,\n"
+                                 "handles channels appearing mid-recording"));
+    connect(m_formatCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &RecordingWidget::onFormatChanged);
+    formatLayout->addWidget(m_formatCombo);
+    
+    formatLayout->addStretch();
+    
+    m_exportCsvButton = new QPushButton(tr("Convert to CSV..."));
+    m_exportCsvButton->setToolTip(tr("Convert a native recording to CSV"));
+    connect(m_exportCsvButton, &QPushButton::clicked, this, &RecordingWidget::onExportCsvClicked);
+    formatLayout->addWidget(m_exportCsvButton);
+    
+    mainLayout->addLayout(formatLayout);
+    
     // Options row
     auto *optionsLayout = new QHBoxLayout();
     
@@ -77,6 +109,9 @@ void RecordingWidget::setupUi()
     
     mainLayout->addLayout(optionsLayout);
     
+    mainLayout->addWidget(createPreTriggerGroup());
+    mainLayout->addWidget(createRawCaptureGroup());
+    
     // Control row
     auto *controlLayout = new QHBoxLayout();
     
@@ -85,6 +120,12 @@ void RecordingWidget::setupUi()
     connect(m_startStopButton, &QPushButton::clicked, this, &RecordingWidget::onStartStopClicked);
     controlLayout->addWidget(m_startStopButton);
     
+    m_triggerNowButton = new QPushButton(tr("Trigger Now"));
+    m_triggerNowButton->setToolTip(tr("Fire the armed trigger manually"));
+    m_triggerNowButton->setEnabled(false);
+    connect(m_triggerNowButton, &QPushButton::clicked, this, &RecordingWidget::onTriggerNowClicked);
+    controlLayout->addWidget(m_triggerNowButton);
+    
     m_statusLabel = new QLabel(tr("Ready"));
     controlLayout->addWidget(m_statusLabel, 1);
     
@@ -93,32 +134,357 @@ void RecordingWidget::setupUi()
     mainLayout->addStretch();
 }
 
+QGroupBox* RecordingWidget::createPreTriggerGroup()
+{
+    m_preTriggerGroup = new QGroupBox(tr("Pre-trigger History"));
+    m_preTriggerGroup->setCheckable(true);
+    m_preTriggerGroup->setChecked(false);
+    m_preTriggerGroup->setToolTip(tr("Continuously keep recent packets and write them\n"
+                                     "to the file when recording starts"));
+    connect(m_preTriggerGroup, &QGroupBox::toggled,
+            this, &RecordingWidget::onPreTriggerSettingsChanged);
+    
+    auto *layout = new QFormLayout(m_preTriggerGroup);
+    layout->setSpacing(6);
+    
+    // History bounds
+    auto *historyLayout = new QHBoxLayout();
+    m_historySecondsSpin = new QSpinBox();
+    m_historySecondsSpin->setRange(1, 600);
+    m_historySecondsSpin->setValue(10);
+    m_historySecondsSpin->setSuffix(tr(" s"));
+    connect(m_historySecondsSpin, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &RecordingWidget::onPreTriggerSettingsChanged);
+    historyLayout->addWidget(m_historySecondsSpin);
+    
+    m_historyMegabytesSpin = new QSpinBox();
+    m_historyMegabytesSpin->setRange(1, 1024);
+    m_historyMegabytesSpin->setValue(32);
+    m_historyMegabytesSpin->setSuffix(tr(" MB"));
+    connect(m_historyMegabytesSpin, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &RecordingWidget::onPreTriggerSettingsChanged);
+    historyLayout->addWidget(m_historyMegabytesSpin);
+    historyLayout->addStretch();
+    layout->addRow(tr("Keep last:"), historyLayout);
+    
+    // Trigger type
+    m_triggerTypeCombo = new QComboBox();
+    m_triggerTypeCombo->addItem(tr("Manual (Start button)"), static_cast<int>(TriggerType::Manual));
+    m_triggerTypeCombo->addItem(tr("Channel threshold"), static_cast<int>(TriggerType::ChannelThreshold));
+    m_triggerTypeCombo->addItem(tr("Line pattern (regex)"), static_cast<int>(TriggerType::LinePattern));
+    connect(m_triggerTypeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &RecordingWidget::onTriggerTypeChanged);
+    layout->addRow(tr("Trigger:"), m_triggerTypeCombo);
+    
+    // Threshold settings
+    auto *thresholdLayout = new QHBoxLayout();
+    m_triggerChannelSpin = new QSpinBox();
+    m_triggerChannelSpin->setRange(0, 63);
+    m_triggerChannelSpin->setPrefix(tr("Ch"));
+    thresholdLayout->addWidget(m_triggerChannelSpin);
+    
+    m_triggerEdgeCombo = new QComboBox();
+    m_triggerEdgeCombo->addItem(tr("Rising"), static_cast<int>(TriggerEdge::Rising));
+    m_triggerEdgeCombo->addItem(tr("Falling"), static_cast<int>(TriggerEdge::Falling));
+    m_triggerEdgeCombo->addItem(tr("Either"), static_cast<int>(TriggerEdge::Either));
+    thresholdLayout->addWidget(m_triggerEdgeCombo);
+    
+    m_triggerLevelSpin = new QDoubleSpinBox();
+    m_triggerLevelSpin->setRange(-1e9, 1e9);
+    m_triggerLevelSpin->setDecimals(4);
+    thresholdLayout->addWidget(m_triggerLevelSpin, 1);
+    layout->addRow(tr("Threshold:"), thresholdLayout);
+    
+    // Pattern settings
+    m_triggerPatternEdit = new QLineEdit();
+    m_triggerPatternEdit->setPlaceholderText(tr("e.g. ERROR|FAULT"));
+    layout->addRow(tr("Pattern:"), m_triggerPatternEdit);
+    
+    onTriggerTypeChanged(m_triggerTypeCombo->currentIndex());
+    
+    return m_preTriggerGroup;
+}
+
+QGroupBox* RecordingWidget::createRawCaptureGroup()
+{
+    auto *group = new QGroupBox(tr("Raw Byte Capture"));
+    group->setToolTip(tr("Store every received chunk with a timestamp,\n"
+                         "before parsing, for later replay"));
+    
+    auto *layout = new QFormLayout(group);
+    layout->setSpacing(6);
+    
+    auto *pathLayout = new QHBoxLayout();
+    m_rawPathEdit = new QLineEdit();
+    m_rawPathEdit->setText(QString("capture_%1.%2")
+        .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"),
+             RawCaptureFormat::FileSuffix));
+    pathLayout->addWidget(m_rawPathEdit, 1);
+    
+    m_rawBrowseButton = new QPushButton(tr("..."));
+    m_rawBrowseButton->setFixedWidth(30);
+    connect(m_rawBrowseButton, &QPushButton::clicked,
+            this, &RecordingWidget::onRawCaptureBrowseClicked);
+    pathLayout->addWidget(m_rawBrowseButton);
+    layout->addRow(tr("File:"), pathLayout);
+    
+    auto *optionsLayout = new QHBoxLayout();
+    m_rawCompressCheck = new QCheckBox(tr("Compress"));
+    m_rawCompressCheck->setToolTip(tr("zlib-compress each 64 KB block"));
+    optionsLayout->addWidget(m_rawCompressCheck);
+    
+    m_rawRotateMegabytesSpin = new QSpinBox();
+    m_rawRotateMegabytesSpin->setRange(0, 4096);
+    m_rawRotateMegabytesSpin->setSpecialValueText(tr("No size limit"));
+    m_rawRotateMegabytesSpin->setSuffix(tr(" MB"));
+    m_rawRotateMegabytesSpin->setToolTip(tr("Start a new file after this size"));
+    optionsLayout->addWidget(m_rawRotateMegabytesSpin);
+    
+    m_rawRotateMinutesSpin = new QSpinBox();
+    m_rawRotateMinutesSpin->setRange(0, 1440);
+    m_rawRotateMinutesSpin->setSpecialValueText(tr("No time limit"));
+    m_rawRotateMinutesSpin->setSuffix(tr(" min"));
+    m_rawRotateMinutesSpin->setToolTip(tr("Start a new file after this time"));
+    optionsLayout->addWidget(m_rawRotateMinutesSpin);
+    layout->addRow(tr("Options:"), optionsLayout);
+    
+    auto *controlLayout = new QHBoxLayout();
+    m_rawCaptureButton = new QPushButton(tr("Start Capture"));
+    m_rawCaptureButton->setCheckable(true);
+    connect(m_rawCaptureButton, &QPushButton::clicked,
+            this, &RecordingWidget::onRawCaptureClicked);
+    controlLayout->addWidget(m_rawCaptureButton);
+    
+    m_rawStatusLabel = new QLabel(tr("Off"));
+    controlLayout->addWidget(m_rawStatusLabel, 1);
+    layout->addRow(controlLayout);
+    
+    return group;
+}
+
+void RecordingWidget::onRawCaptureBrowseClicked()
+{
+    QString path = QFileDialog::getSaveFileName(this,
+        tr("Save Raw Capture"),
+        m_rawPathEdit->text(),
+        tr("Raw Captures (*.csraw);;All Files (*)"));
+    
+    if (!path.isEmpty()) {
+        m_rawPathEdit->setText(path);
+    }
+}
+
+void RecordingWidget::onRawCaptureClicked()
+{
+    if (m_rawCapturing) {
+        emit rawCaptureStopRequested();
+        return;
+    }
+    
+    if (m_rawPathEdit->text().isEmpty()) {
+        QMessageBox::warning(this, tr("Error"), tr("Please specify a capture file path."));
+        m_rawCaptureButton->setChecked(false);
+        return;
+    }
+    
+    RawCaptureSettings settings;
+    settings.path = m_rawPathEdit->text();
+    settings.compress = m_rawCompressCheck->isChecked();
+    settings.rotateBytes = static_cast<qint64>(m_rawRotateMegabytesSpin->value()) * 1024 * 1024;
+    settings.rotateSeconds = static_cast<qint64>(m_rawRotateMinutesSpin->value()) * 60;
+    
+    // Button state follows onRawCaptureStateChanged()
+    m_rawCaptureButton->setEnabled(false);
+    emit rawCaptureStartRequested(settings);
+}
+
+void RecordingWidget::onRawCaptureStateChanged(bool active, const QString &message)
+{
+    m_rawCapturing = active;
+    m_rawCaptureButton->setEnabled(true);
+    m_rawCaptureButton->setChecked(active);
+    m_rawCaptureButton->setText(active ? tr("Stop Capture") : tr("Start Capture"));
+    m_rawPathEdit->setEnabled(!active);
+    m_rawBrowseButton->setEnabled(!active);
+    m_rawCompressCheck->setEnabled(!active);
+    m_rawRotateMegabytesSpin->setEnabled(!active);
+    m_rawRotateMinutesSpin->setEnabled(!active);
+    m_rawStatusLabel->setText(message);
+}
+
 void RecordingWidget::onStartStopClicked()
 {
     if (m_isRecording) {
         stopRecording();
         m_startStopButton->setChecked(false);
+    } else if (m_armed) {
+        disarmTrigger();
+        m_startStopButton->setChecked(false);
+    } else if (m_preTriggerGroup->isChecked()
+               && currentTriggerConfig().type != TriggerType::Manual) {
+        m_startStopButton->setChecked(armTrigger());
     } else {
         if (startRecording()) {
             m_startStopButton->setChecked(true);
+            int flushed = flushPreTrigger();
+            if (flushed > 0) {
+                m_statusLabel->setText(tr("Recording... %1 pre-trigger records").arg(flushed));
+            }
         } else {
             m_startStopButton->setChecked(false);
         }
     }
 }
 
+void RecordingWidget::onTriggerNowClicked()
+{
+    if (m_armed) {
+        fireTrigger(tr("manual"));
+    }
+}
+
+void RecordingWidget::onTriggerTypeChanged(int index)
+{
+    Q_UNUSED(index);
+    
+    TriggerType type = currentTriggerConfig().type;
+    m_triggerChannelSpin->setEnabled(type == TriggerType::ChannelThreshold);
+    m_triggerEdgeCombo->setEnabled(type == TriggerType::ChannelThreshold);
+    m_triggerLevelSpin->setEnabled(type == TriggerType::ChannelThreshold);
+    m_triggerPatternEdit->setEnabled(type == TriggerType::LinePattern);
+    updateStartButtonText();
+}
+
+void RecordingWidget::onPreTriggerSettingsChanged()
+{
+    if (!m_preTriggerGroup->isChecked()) {
+        // Release the slots while history is disabled
+        m_preTrigger.setCapacity(1);
+        updateStartButtonText();
+        return;
+    }
+    
+    qint64 maxBytes = static_cast<qint64>(m_historyMegabytesSpin->value()) * 1024 * 1024;
+    m_preTrigger.setMaxAgeMs(static_cast<qint64>(m_historySecondsSpin->value()) * 1000);
+    m_preTrigger.setMaxBytes(maxBytes);
+    
+    // Size the ring for typical ~512-byte packets; only reallocates on settings change
+    int capacity = static_cast<int>(qBound<qint64>(1024, maxBytes / 512, 1 << 20));
+    if (capacity != m_preTrigger.capacity()) {
+        m_preTrigger.setCapacity(capacity);
+    }
+    updateStartButtonText();
+}
+
 void RecordingWidget::onBrowseClicked()
 {
+    QString filter = (currentFormat() == RecordingFileFormat::Native)
+        ? tr("ComStudio Recordings (*.csrec);;All Files (*)")
+        : tr("CSV Files (*.csv);;All Files (*)");
+    
     QString path = QFileDialog::getSaveFileName(this,
         tr("Save Recording"),
         m_filePathEdit->text(),
-        tr("CSV Files (*.csv);;All Files (*)"));
+        filter);
     
     if (!path.isEmpty()) {
         m_filePathEdit->setText(path);
     }
 }
 
+void RecordingWidget::onFormatChanged(int index)
+{
+    Q_UNUSED(index);
+    
+    // Keep the file extension in sync with the selected format
+    QString path = m_filePathEdit->text();
+    if (path.isEmpty()) {
+        return;
+    }
+    
+    QFileInfo info(path);
+    QString suffix = (currentFormat() == RecordingFileFormat::Native)
+        ? QString(RecordingFormat::FileSuffix) : QStringLiteral("csv");
+    QString directory = path.left(path.size() - info.fileName().size());
+    m_filePathEdit->setText(directory + info.completeBaseName() + "." + suffix);
+}
+
+void RecordingWidget::onExportCsvClicked()
+{
+    QString sourcePath = QFileDialog::getOpenFileName(this,
+        tr("Open Recording"),
+        QString(),
+        tr("ComStudio Recordings (*.csrec);;All Files (*)"));
+    if (sourcePath.isEmpty()) {
+        return;
+    }
+    
+    QFileInfo info(sourcePath);
+    QString csvPath = QFileDialog::getSaveFileName(this,
+        tr("Save CSV"),
+        info.path() + "/" + info.completeBaseName() + ".csv",
+        tr("CSV Files (*.csv);;All Files (*)"));
+    if (csvPath.isEmpty()) {
+        return;
+    }
+    
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    QString error;
+    bool ok = RecordingReader::convertToCsv(sourcePath, csvPath, &error);
+    QApplication::restoreOverrideCursor();
+    
+    if (ok) {
+        m_statusLabel->setText(tr("Converted to %1").arg(QFileInfo(csvPath).fileName()));
+    } else {
+        QMessageBox::warning(this, tr("Error"),
+            tr("Could not convert recording:\n%1").arg(error));
+    }
+}
+
+RecordingFileFormat RecordingWidget::currentFormat() const
+{
+    return static_cast<RecordingFileFormat>(m_formatCombo->currentData().toInt());
+}
+
+TriggerConfig RecordingWidget::currentTriggerConfig() const
+{
+    TriggerConfig config;
+    config.type = static_cast<TriggerType>(m_triggerTypeCombo->currentData().toInt());
+    config.channelIndex = m_triggerChannelSpin->value();
+    config.threshold = m_triggerLevelSpin->value();
+    config.edge = static_cast<TriggerEdge>(m_triggerEdgeCombo->currentData().toInt());
+    config.pattern = m_triggerPatternEdit->text();
+    return config;
+}
+
+void RecordingWidget::setSettingsEnabled(bool enabled)
+{
+    m_filePathEdit->setEnabled(enabled);
+    m_browseButton->setEnabled(enabled);
+    m_formatCombo->setEnabled(enabled);
+    m_timestampCheck->setEnabled(enabled);
+    m_idFilterCheck->setEnabled(enabled);
+    m_idFilterSpin->setEnabled(enabled && m_idFilterCheck->isChecked());
+    m_preTriggerGroup->setEnabled(enabled);
+}
+
+void RecordingWidget::updateStartButtonText()
+{
+    if (!m_startStopButton) {
+        return;
+    }
+    if (m_isRecording) {
+        m_startStopButton->setText(tr("Stop Recording"));
+    } else if (m_armed) {
+        m_startStopButton->setText(tr("Disarm"));
+    } else if (m_preTriggerGroup->isChecked()
+               && currentTriggerConfig().type != TriggerType::Manual) {
+        m_startStopButton->setText(tr("Arm Trigger"));
+    } else {
+        m_startStopButton->setText(tr("Start Recording"));
+    }
+}
+
 bool RecordingWidget::startRecording()
 {
     QString path = m_filePathEdit->text();
@@ -127,119 +493,228 @@ bool RecordingWidget::startRecording()
         return false;
     }
     
-    m_file.setFileName(path);
-    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, tr("Error"),
-            tr("Could not open file for writing:\n%1").arg(m_file.errorString()));
-        return false;
+    if (currentFormat() == RecordingFileFormat::Native) {
+        m_nativeWriter = std::make_unique<RecordingWriter>();
+        if (!m_nativeWriter->open(path)) {
+            QMessageBox::warning(this, tr("Error"),
+                tr("Could not open file for writing:\n%1").arg(m_nativeWriter->errorString()));
+            m_nativeWriter.reset();
+            return false;
+        }
+    } else {
+        m_csvWriter = std::make_unique<CsvRecordWriter>(m_timestampCheck->isChecked());
+        if (!m_csvWriter->open(path)) {
+            QMessageBox::warning(this, tr("Error"),
+                tr("Could not open file for writing:\n%1").arg(m_csvWriter->errorString()));
+            m_csvWriter.reset();
+            return false;
+        }
     }
     
-    m_stream.setDevice(&m_file);
+    // Packets that arrived before the start go to the history, not the file
+    drainSource();
     m_isRecording = true;
-    m_headerWritten = false;
     m_recordCount = 0;
-    m_maxChannelsSeen = 0;
+    m_lostCount = 0;
     
     m_startStopButton->setText(tr("Stop Recording"));
     m_statusLabel->setText(tr("Recording..."));
-    m_filePathEdit->setEnabled(false);
-    m_browseButton->setEnabled(false);
-    m_timestampCheck->setEnabled(false);
-    m_idFilterCheck->setEnabled(false);
-    m_idFilterSpin->setEnabled(false);
+    setSettingsEnabled(false);
     
     return true;
 }
 
 void RecordingWidget::stopRecording()
 {
+    // Write what arrived before the stop
+    drainSource();
     m_isRecording = false;
-    m_stream.flush();
-    m_file.close();
     
-    m_startStopButton->setText(tr("Start Recording"));
-    m_statusLabel->setText(tr("Saved %1 records").arg(m_recordCount));
-    m_filePathEdit->setEnabled(true);
-    m_browseButton->setEnabled(true);
-    m_timestampCheck->setEnabled(true);
-    m_idFilterCheck->setEnabled(true);
-    m_idFilterSpin->setEnabled(m_idFilterCheck->isChecked());
+    QString error;
+    if (m_nativeWriter) {
+        if (!m_nativeWriter->close()) {
+            error = m_nativeWriter->errorString();
+        }
+        m_nativeWriter.reset();
+    } else if (m_csvWriter) {
+        if (!m_csvWriter->close()) {
+            error = m_csvWriter->errorString();
+        }
+        m_csvWriter.reset();
+    }
+    
+    updateStartButtonText();
+    if (error.isEmpty() && m_lostCount > 0) {
+        m_statusLabel->setText(tr("Saved %1 records, %2 lost").arg(m_recordCount).arg(m_lostCount));
+    } else if (error.isEmpty()) {
+        m_statusLabel->setText(tr("Saved %1 records").arg(m_recordCount));
+    } else {
+        m_statusLabel->setText(tr("Write error: %1").arg(error));
+    }
+    setSettingsEnabled(true);
 }
 
-void RecordingWidget::recordPacket(const GenericDataPacket &packet)
+bool RecordingWidget::armTrigger()
 {
-    if (!m_isRecording || !packet.isValid) {
-        return;
+    if (m_filePathEdit->text().isEmpty()) {
+        QMessageBox::warning(this, tr("Error"), tr("Please specify a file path."));
+        return false;
     }
     
-    // Apply ID filter
-    if (m_idFilterCheck->isChecked()) {
-        QString filterId = QString::number(m_idFilterSpin->value());
-        // Compare as strings - handles alphanumeric IDs
-        if (!filterId.isEmpty() && filterId != "-1" && packet.sensorId != filterId) {
-            return;
-        }
+    if (!m_trigger.setConfig(currentTriggerConfig())) {
+        QMessageBox::warning(this, tr("Error"), tr("Invalid trigger pattern."));
+        return false;
     }
     
-    // Write header on first packet (to know channel count)
-    if (!m_headerWritten) {
-        m_maxChannelsSeen = packet.values.size();
-        writeHeader();
-        m_headerWritten = true;
-    }
+    m_armed = true;
+    m_startStopButton->setText(tr("Disarm"));
+    m_triggerNowButton->setEnabled(true);
+    m_statusLabel->setText(tr("Armed - waiting for trigger"));
+    setSettingsEnabled(false);
+    return true;
+}
+
+void RecordingWidget::disarmTrigger()
+{
+    m_armed = false;
+    m_triggerNowButton->setEnabled(false);
+    m_statusLabel->setText(tr("Ready"));
+    setSettingsEnabled(true);
+    updateStartButtonText();
+}
+
+void RecordingWidget::fireTrigger(const QString &reason)
+{
+    m_armed = false;
+    m_triggerNowButton->setEnabled(false);
     
-    // Expand header if more channels appear
-    if (packet.values.size() > m_maxChannelsSeen) {
-        m_maxChannelsSeen = packet.values.size();
-        // Note: CSV header already written; new columns won't have headers
-        // This is a trade-off for streaming writes
+    if (!startRecording()) {
+        m_startStopButton->setChecked(false);
+        setSettingsEnabled(true);
+        updateStartButtonText();
+        return;
     }
     
-    writePacket(packet);
-    m_recordCount++;
-    
-    // Update status periodically
-    if (m_recordCount % 100 == 0) {
-        m_statusLabel->setText(tr("Recording... %1 records").arg(m_recordCount));
+    m_startStopButton->setChecked(true);
+    int flushed = flushPreTrigger();
+    m_statusLabel->setText(tr("Triggered (%1), %2 pre-trigger records").arg(reason).arg(flushed));
+}
+
+int RecordingWidget::flushPreTrigger()
+{
+    if (!m_preTriggerGroup->isChecked()) {
+        return 0;
     }
+    return m_preTrigger.drain([this](const GenericDataPacket &packet) {
+        writeRecord(packet);
+    });
 }
 
-void RecordingWidget::writeHeader()
+void RecordingWidget::recordPacket(const GenericDataPacket &packet)
 {
-    QStringList headers;
-    
-    if (m_timestampCheck->isChecked()) {
-        headers.append("Timestamp");
+    if (!packet.isValid) {
+        return;
+    }
+    if (!m_isRecording && !m_preTriggerGroup->isChecked()) {
+        return;
+    }
+    if (!passesIdFilter(packet)) {
+        return;
     }
     
-    headers.append("PacketIndex");
-    headers.append("SensorID");
-    
-    for (int i = 0; i < m_maxChannelsSeen; ++i) {
-        headers.append(QString("Ch%1").arg(i));
+    if (m_isRecording) {
+        writeRecord(packet);
+        return;
     }
     
-    m_stream << headers.join(",") << "\n";
+    // Not recording: keep history and evaluate the armed trigger
+    m_preTrigger.push(packet);
+    if (m_armed && m_trigger.checkPacket(packet)) {
+        fireTrigger(tr("threshold"));
+    }
 }
 
-void RecordingWidget::writePacket(const GenericDataPacket &packet)
+void RecordingWidget::setSource(DataBuffer *buffer)
 {
-    QStringList values;
-    
-    if (m_timestampCheck->isChecked()) {
-        values.append(QString::number(packet.timestamp));
+    delete m_cursor;
+    m_cursor = nullptr;
+    if (buffer) {
+        m_cursor = buffer->openCursor(QStringLiteral("recorder"), this);
+        // Queued: the recorder drains after the producer returns to the event loop
+        connect(m_cursor, &PacketCursor::readyRead,
+                this, &RecordingWidget::drainSource, Qt::QueuedConnection);
+        connect(m_cursor, &PacketCursor::fellBehind,
+                this, &RecordingWidget::onFellBehind);
     }
+}
+
+void RecordingWidget::drainSource()
+{
+    if (!m_cursor) {
+        return;
+    }
+    if (!m_isRecording && !m_preTriggerGroup->isChecked()) {
+        m_cursor->seekToEnd();
+        return;
+    }
+    const QVector<PacketBatch> batches = m_cursor->read();
+    for (const auto &batch : batches) {
+        for (const auto &packet : batch) {
+            recordPacket(packet);
+        }
+    }
+}
+
+void RecordingWidget::onFellBehind(quint64 skipped)
+{
+    if (!m_isRecording) {
+        return;  // Only pre-trigger history was affected
+    }
+    m_lostCount += skipped;
+    qWarning() << "Recorder fell behind," << skipped << "packets skipped";
+    m_statusLabel->setText(tr("Recording... %1 packets lost").arg(m_lostCount));
+}
+
+void RecordingWidget::checkRawLine(const QString &line)
+{
+    if (m_armed && m_trigger.checkLine(line)) {
+        fireTrigger(tr("pattern"));
+    }
+}
+
+bool RecordingWidget::passesIdFilter(const GenericDataPacket &packet) const
+{
+    if (m_idFilterCheck->isChecked()) {
+        QString filterId = QString::number(m_idFilterSpin->value());
+        // Compare as strings - handles alphanumeric IDs
+        if (!filterId.isEmpty() && filterId != "-1" && packet.sensorId != filterId) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RecordingWidget::writeRecord(const GenericDataPacket &packet)
+{
+    TRACE_SCOPE("RecordingWidget::writeRecord");
     
-    values.append(QString::number(packet.packetIndex));
-    values.append(packet.sensorId.isEmpty() ? "" : packet.sensorId);
-    
-    for (int i = 0; i < m_maxChannelsSeen; ++i) {
-        if (i < packet.values.size()) {
-            values.append(QString::number(packet.values[i], 'f', 6));
-        } else {
-            values.append("");
+    // Native format carries its own per-chunk schema
+    if (m_nativeWriter) {
+        if (!m_nativeWriter->append(packet)) {
+            m_statusLabel->setText(tr("Write error: %1").arg(m_nativeWriter->errorString()));
         }
+        m_recordCount++;
+        if (m_recordCount % 100 == 0) {
+            m_statusLabel->setText(tr("Recording... %1 records").arg(m_recordCount));
+        }
+        return;
     }
     
-    m_stream << values.join(",") << "\n";
+    m_csvWriter->append(packet);
+    m_recordCount++;
+    
+    // Update status periodically
+    if (m_recordCount % 100 == 0) {
+        m_statusLabel->setText(tr("Recording... %1 records").arg(m_recordCount));
+    }
 }
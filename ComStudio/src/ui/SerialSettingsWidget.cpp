@@ -12,6 +12,11 @@
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QGroupBox>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QDoubleSpinBox>
+#include <QSpinBox>
+#include <QFileDialog>
 #include <QSerialPortInfo>
 
 SerialSettingsWidget::SerialSettingsWidget(QWidget *parent)
@@ -28,6 +33,18 @@ void SerialSettingsWidget::setupUi()
     mainLayout->setContentsMargins(8, 8, 8, 8);
     mainLayout->setSpacing(8);
     
+    // Source kind
+    auto *sourceLayout = new QHBoxLayout();
+    sourceLayout->addWidget(new QLabel(tr("Source:")));
+    m_sourceCombo = new QComboBox();
+    m_sourceCombo->addItem(tr("Serial port"), static_cast<int>(PortKind::Serial));
+    m_sourceCombo->addItem(tr("Replay file"), static_cast<int>(PortKind::Replay));
+    m_sourceCombo->addItem(tr("Data generator"), static_cast<int>(PortKind::Generator));
+    connect(m_sourceCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &SerialSettingsWidget::onSourceKindChanged);
+    sourceLayout->addWidget(m_sourceCombo, 1);
+    mainLayout->addLayout(sourceLayout);
+    
     // Port selection group
     auto *portGroup = new QGroupBox(tr("Port Settings"));
     auto *portLayout = new QGridLayout(portGroup);
@@ -71,6 +88,60 @@ void SerialSettingsWidget::setupUi()
     
     mainLayout->addWidget(portGroup);
     
+    // Replay group (raw capture or text log)
+    m_replayGroup = new QGroupBox(tr("Replay"));
+    auto *replayLayout = new QGridLayout(m_replayGroup);
+    replayLayout->setSpacing(8);
+    
+    replayLayout->addWidget(new QLabel(tr("File:")), 0, 0);
+    m_replayPathEdit = new QLineEdit();
+    m_replayPathEdit->setPlaceholderText(tr("capture.csraw or log.txt"));
+    replayLayout->addWidget(m_replayPathEdit, 0, 1);
+    
+    m_replayBrowseButton = new QPushButton(tr("..."));
+    m_replayBrowseButton->setFixedWidth(30);
+    connect(m_replayBrowseButton, &QPushButton::clicked,
+            this, &SerialSettingsWidget::onReplayBrowseClicked);
+    replayLayout->addWidget(m_replayBrowseButton, 0, 2);
+    
+    replayLayout->addWidget(new QLabel(tr("Speed:")), 1, 0);
+    m_replaySpeedSpin = new QDoubleSpinBox();
+    m_replaySpeedSpin->setRange(0.1, 1000.0);
+    m_replaySpeedSpin->setDecimals(1);
+    m_replaySpeedSpin->setValue(1.0);
+    m_replaySpeedSpin->setSuffix(tr("x"));
+    m_replaySpeedSpin->setToolTip(tr("Captures keep their recorded timing;\n"
+                                     "text logs are paced at the selected baud rate"));
+    replayLayout->addWidget(m_replaySpeedSpin, 1, 1, 1, 2);
+    
+    m_replayMaxSpeedCheck = new QCheckBox(tr("As fast as possible"));
+    m_replayMaxSpeedCheck->setToolTip(tr("Ignore timing and report lines/s and packets/s"));
+    connect(m_replayMaxSpeedCheck, &QCheckBox::toggled,
+            m_replaySpeedSpin, &QWidget::setDisabled);
+    replayLayout->addWidget(m_replayMaxSpeedCheck, 2, 1, 1, 2);
+    
+    m_replayGroup->setVisible(false);
+    mainLayout->addWidget(m_replayGroup);
+    
+    // Generator group (synthetic traffic)
+    m_generatorGroup = createGeneratorGroup();
+    m_generatorGroup->setVisible(false);
+    mainLayout->addWidget(m_generatorGroup);
+    
+    // What to do when the GUI thread falls behind the reader
+    auto *overloadLayout = new QHBoxLayout();
+    overloadLayout->addWidget(new QLabel(tr("On overload:")));
+    m_overloadCombo = new QComboBox();
+    m_overloadCombo->addItem(tr("Decimate display"), static_cast<int>(OverloadPolicy::DecimateDisplay));
+    m_overloadCombo->addItem(tr("Block reader"), static_cast<int>(OverloadPolicy::Block));
+    m_overloadCombo->addItem(tr("Drop oldest"), static_cast<int>(OverloadPolicy::DropOldest));
+    m_overloadCombo->addItem(tr("Drop newest"), static_cast<int>(OverloadPolicy::DropNewest));
+    m_overloadCombo->setToolTip(tr("Decimate display: show fewer points while every packet is still recorded\n"
+                                   "Block reader: stop reading; the port buffer and flow control hold the data\n"
+                                   "Drop oldest/newest: discard read chunks (counted in the metrics)"));
+    overloadLayout->addWidget(m_overloadCombo, 1);
+    mainLayout->addLayout(overloadLayout);
+    
     // Status label
     m_statusLabel = new QLabel(tr("Disconnected"));
     m_statusLabel->setObjectName("statusDisconnected");
@@ -98,6 +169,73 @@ void SerialSettingsWidget::setupUi()
     mainLayout->addStretch();
 }
 
+QGroupBox* SerialSettingsWidget::createGeneratorGroup()
+{
+    auto *group = new QGroupBox(tr("Data Generator"));
+    auto *layout = new QGridLayout(group);
+    layout->setSpacing(8);
+    
+    layout->addWidget(new QLabel(tr("Format:")), 0, 0);
+    m_generatorFormatCombo = new QComboBox();
+    m_generatorFormatCombo->addItem(tr("CSV (1.2,3.4)"), static_cast<int>(GeneratorFormat::Csv));
+    m_generatorFormatCombo->addItem(tr("Labeled (X:1.2)"), static_cast<int>(GeneratorFormat::Labeled));
+    m_generatorFormatCombo->addItem(tr("ID-prefixed (id,1.2)"), static_cast<int>(GeneratorFormat::IdPrefixed));
+    m_generatorFormatCombo->addItem(tr("Binary (JustFloat)"), static_cast<int>(GeneratorFormat::JustFloat));
+    layout->addWidget(m_generatorFormatCombo, 0, 1);
+    
+    layout->addWidget(new QLabel(tr("Channels:")), 1, 0);
+    m_generatorChannelsSpin = new QSpinBox();
+    m_generatorChannelsSpin->setRange(1, 64);
+    m_generatorChannelsSpin->setValue(4);
+    layout->addWidget(m_generatorChannelsSpin, 1, 1);
+    
+    layout->addWidget(new QLabel(tr("Rate:")), 2, 0);
+    m_generatorRateSpin = new QSpinBox();
+    m_generatorRateSpin->setRange(0, 1000000);
+    m_generatorRateSpin->setSingleStep(100);
+    m_generatorRateSpin->setValue(1000);
+    m_generatorRateSpin->setSuffix(tr(" lines/s"));
+    m_generatorRateSpin->setSpecialValueText(tr("Unlimited"));
+    layout->addWidget(m_generatorRateSpin, 2, 1);
+    
+    m_generatorBaudLimitCheck = new QCheckBox(tr("Limit to baud rate"));
+    m_generatorBaudLimitCheck->setToolTip(tr("Cap throughput at the selected baud rate (10 bits per byte)"));
+    layout->addWidget(m_generatorBaudLimitCheck, 3, 1);
+    
+    layout->addWidget(new QLabel(tr("Noise:")), 4, 0);
+    m_generatorNoiseSpin = new QDoubleSpinBox();
+    m_generatorNoiseSpin->setRange(0.0, 10.0);
+    m_generatorNoiseSpin->setDecimals(2);
+    m_generatorNoiseSpin->setSingleStep(0.05);
+    m_generatorNoiseSpin->setValue(0.05);
+    m_generatorNoiseSpin->setToolTip(tr("Standard deviation relative to a signal amplitude of 1"));
+    layout->addWidget(m_generatorNoiseSpin, 4, 1);
+    
+    layout->addWidget(new QLabel(tr("Spikes:")), 5, 0);
+    m_generatorSpikeSpin = new QDoubleSpinBox();
+    m_generatorSpikeSpin->setRange(0.0, 100.0);
+    m_generatorSpikeSpin->setDecimals(2);
+    m_generatorSpikeSpin->setSuffix(tr(" %"));
+    layout->addWidget(m_generatorSpikeSpin, 5, 1);
+    
+    layout->addWidget(new QLabel(tr("Malformed:")), 6, 0);
+    m_generatorMalformedSpin = new QDoubleSpinBox();
+    m_generatorMalformedSpin->setRange(0.0, 100.0);
+    m_generatorMalformedSpin->setDecimals(2);
+    m_generatorMalformedSpin->setSuffix(tr(" %"));
+    m_generatorMalformedSpin->setToolTip(tr("Truncated lines, garbage characters and extra tokens"));
+    layout->addWidget(m_generatorMalformedSpin, 6, 1);
+    
+    layout->addWidget(new QLabel(tr("Sensor IDs:")), 7, 0);
+    m_generatorSensorsSpin = new QSpinBox();
+    m_generatorSensorsSpin->setRange(1, 255);
+    m_generatorSensorsSpin->setValue(3);
+    m_generatorSensorsSpin->setToolTip(tr("Distinct IDs in ID-prefixed format"));
+    layout->addWidget(m_generatorSensorsSpin, 7, 1);
+    
+    return group;
+}
+
 void SerialSettingsWidget::populateOptions()
 {
     // Baud rates
@@ -161,12 +299,27 @@ void SerialSettingsWidget::refreshPorts()
 SerialSettings SerialSettingsWidget::currentSettings() const
 {
     SerialSettings settings;
+    settings.kind = static_cast<PortKind>(m_sourceCombo->currentData().toInt());
     settings.portName = m_portCombo->currentData().toString();
     settings.baudRate = m_baudRateCombo->currentData().toInt();
     settings.dataBits = static_cast<QSerialPort::DataBits>(m_dataBitsCombo->currentData().toInt());
     settings.parity = static_cast<QSerialPort::Parity>(m_parityCombo->currentData().toInt());
     settings.stopBits = static_cast<QSerialPort::StopBits>(m_stopBitsCombo->currentData().toInt());
     settings.flowControl = static_cast<QSerialPort::FlowControl>(m_flowControlCombo->currentData().toInt());
+    settings.replayPath = m_replayPathEdit->text();
+    settings.replaySpeed = m_replaySpeedSpin->value();
+    settings.replayMaxSpeed = m_replayMaxSpeedCheck->isChecked();
+    
+    settings.generator.format = static_cast<GeneratorFormat>(m_generatorFormatCombo->currentData().toInt());
+    settings.generator.channels = m_generatorChannelsSpin->value();
+    settings.generator.linesPerSecond = m_generatorRateSpin->value();
+    settings.generator.baudLimit = m_generatorBaudLimitCheck->isChecked() ? settings.baudRate : 0;
+    settings.generator.noise = m_generatorNoiseSpin->value();
+    settings.generator.spikeProbability = m_generatorSpikeSpin->value() / 100.0;
+    settings.generator.malformedProbability = m_generatorMalformedSpin->value() / 100.0;
+    settings.generator.sensorCount = m_generatorSensorsSpin->value();
+    
+    settings.ingest.policy = static_cast<OverloadPolicy>(m_overloadCombo->currentData().toInt());
     return settings;
 }
 
@@ -180,15 +333,21 @@ void SerialSettingsWidget::updateConnectionState(bool connected)
 {
     m_isConnected = connected;
     
+    const bool serial = static_cast<PortKind>(m_sourceCombo->currentData().toInt()) == PortKind::Serial;
+    
     m_connectButton->setEnabled(!connected);
     m_disconnectButton->setEnabled(connected);
-    m_portCombo->setEnabled(!connected);
+    m_sourceCombo->setEnabled(!connected);
+    m_portCombo->setEnabled(!connected && serial);
     m_baudRateCombo->setEnabled(!connected);
     m_dataBitsCombo->setEnabled(!connected);
     m_parityCombo->setEnabled(!connected);
     m_stopBitsCombo->setEnabled(!connected);
     m_flowControlCombo->setEnabled(!connected);
-    m_refreshButton->setEnabled(!connected);
+    m_overloadCombo->setEnabled(!connected);
+    m_refreshButton->setEnabled(!connected && serial);
+    m_replayGroup->setEnabled(!connected);
+    m_generatorGroup->setEnabled(!connected);
     
     m_statusLabel->setObjectName(connected ? "statusConnected" : "statusDisconnected");
     m_statusLabel->style()->unpolish(m_statusLabel);
@@ -209,3 +368,25 @@ void SerialSettingsWidget::onRefreshClicked()
 {
     refreshPorts();
 }
+
+void SerialSettingsWidget::onSourceKindChanged(int index)
+{
+    Q_UNUSED(index);
+    
+    const auto kind = static_cast<PortKind>(m_sourceCombo->currentData().toInt());
+    m_replayGroup->setVisible(kind == PortKind::Replay);
+    m_generatorGroup->setVisible(kind == PortKind::Generator);
+    updateConnectionState(m_isConnected);
+}
+
+void SerialSettingsWidget::onReplayBrowseClicked()
+{
+    QString path = QFileDialog::getOpenFileName(this,
+        tr("Open Replay File"),
+        m_replayPathEdit->text(),
+        tr("Raw Captures (*.csraw);;Text Logs (*.txt *.log *.csv);;All Files (*)"));
+    
+    if (!path.isEmpty()) {
+        m_replayPathEdit->setText(path);
+    }
+}
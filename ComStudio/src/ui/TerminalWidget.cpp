@@ -4,6 +4,10 @@
  */
 
 #include "ui/TerminalWidget.h"
+#include "models/DataBuffer.h"
+#include "models/PacketCursor.h"
+#include "core/PipelineMetrics.h"
+#include "core/TraceRecorder.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -23,7 +27,6 @@ TerminalWidget::TerminalWidget(QWidget *parent)
     
     // Pre-allocate buffers
     m_pendingRawText.reserve(MAX_PENDING_CHARS);
-    m_pendingPackets.reserve(MAX_PENDING_PACKETS);
 }
 
 void TerminalWidget::setupUi()
@@ -140,6 +143,7 @@ void TerminalWidget::appendRawData(const QByteArray &data)
         m_pendingRawText.append('\n');
     }
     m_pendingRawText.append(formatted);
+    m_pendingRawLines++;
     
     // Start timer if not running
     if (!m_flushTimer->isActive()) {
@@ -175,6 +179,7 @@ void TerminalWidget::appendRawLine(const QString &line)
         m_pendingRawText.append('\n');
     }
     m_pendingRawText.append(formatted);
+    m_pendingRawLines++;
     
     // Start timer if not running
     if (!m_flushTimer->isActive()) {
@@ -187,31 +192,37 @@ void TerminalWidget::appendRawLine(const QString &line)
     }
 }
 
-void TerminalWidget::appendPacket(const GenericDataPacket &packet)
+void TerminalWidget::setSource(DataBuffer *buffer)
+{
+    delete m_cursor;
+    m_cursor = nullptr;
+    if (buffer) {
+        m_cursor = buffer->openCursor(QStringLiteral("terminal"), this);
+        connect(m_cursor, &PacketCursor::readyRead, this, &TerminalWidget::onPacketsAvailable);
+    }
+}
+
+void TerminalWidget::onPacketsAvailable()
 {
     // Only process in Parsed mode
     if (m_displayMode != DisplayMode::Parsed) {
+        m_cursor->seekToEnd();
         return;
     }
     
-    // Batch the packet
-    m_pendingPackets.append(packet);
-    
-    // Start timer if not running
+    // Packets are pulled and formatted on flush
     if (!m_flushTimer->isActive()) {
         m_flushTimer->start();
     }
-    
-    // Force flush if too many packets
-    if (m_pendingPackets.size() >= MAX_PENDING_PACKETS) {
-        onFlushTimer();
-    }
 }
 
 void TerminalWidget::clear()
 {
     m_pendingRawText.clear();
-    m_pendingPackets.clear();
+    m_pendingRawLines = 0;
+    if (m_cursor) {
+        m_cursor->seekToEnd();
+    }
     m_terminal->clear();
 }
 
@@ -222,38 +233,62 @@ void TerminalWidget::flushPendingData()
 
 void TerminalWidget::onFlushTimer()
 {
+    TRACE_SCOPE("TerminalWidget::onFlushTimer");
     m_flushTimer->stop();
     
+    // Pull the newest parsed packets since the last flush
+    QVector<PacketBatch> batches;
+    int packets = 0;
+    if (m_cursor) {
+        if (m_displayMode != DisplayMode::Parsed) {
+            m_cursor->seekToEnd();
+        } else {
+            const qint64 excess = m_cursor->available() - MAX_PENDING_PACKETS;
+            if (excess > 0) {
+                m_cursor->skip(excess);
+            }
+            batches = m_cursor->read();
+            for (const auto &batch : std::as_const(batches)) {
+                packets += static_cast<int>(batch.size());
+            }
+        }
+    }
+    
+    const int lines = m_pendingRawLines + packets;
+    StageTimer timer(MetricStage::TerminalAppend, static_cast<quint64>(lines));
+    PipelineMetrics::instance().add(MetricCounter::TerminalLines, static_cast<quint64>(lines));
+    PipelineMetrics::instance().setGauge(MetricGauge::TerminalPendingLines, lines);
+    
     // Flush raw text buffer
     if (!m_pendingRawText.isEmpty()) {
         m_terminal->appendPlainText(m_pendingRawText);
         m_pendingRawText.clear();
+        m_pendingRawLines = 0;
         // Keep the reserve capacity
         m_pendingRawText.reserve(MAX_PENDING_CHARS);
     }
     
     // Flush parsed packets buffer
-    if (!m_pendingPackets.isEmpty()) {
-        QString batch;
-        batch.reserve(m_pendingPackets.size() * 80);  // Estimate ~80 chars per packet
+    if (packets > 0) {
+        QString text;
+        text.reserve(packets * 80);  // Estimate ~80 chars per packet
         
-        for (const auto &packet : m_pendingPackets) {
-            QString formatted = formatPacket(packet);
-            if (m_timestampCheck->isChecked()) {
-                QString timestamp = QDateTime::fromMSecsSinceEpoch(packet.timestamp)
-                    .toString("[hh:mm:ss.zzz] ");
-                formatted = timestamp + formatted;
-            }
-            if (!batch.isEmpty()) {
-                batch.append('\n');
+        for (const auto &batch : std::as_const(batches)) {
+            for (const auto &packet : batch) {
+                QString formatted = formatPacket(packet);
+                if (m_timestampCheck->isChecked()) {
+                    QString timestamp = QDateTime::fromMSecsSinceEpoch(packet.timestamp)
+                        .toString("[hh:mm:ss.zzz] ");
+                    formatted = timestamp + formatted;
+                }
+                if (!text.isEmpty()) {
+                    text.append('\n');
+                }
+                text.append(formatted);
             }
-            batch.append(formatted);
         }
         
-        m_terminal->appendPlainText(batch);
-        m_pendingPackets.clear();
-        // Keep the reserve capacity
-        m_pendingPackets.reserve(MAX_PENDING_PACKETS);
+        m_terminal->appendPlainText(text);
     }
     
     // Auto-scroll if enabled
@@ -265,6 +300,11 @@ void TerminalWidget::onFlushTimer()
 void TerminalWidget::onDisplayModeChanged(int index)
 {
     m_displayMode = static_cast<DisplayMode>(m_displayModeCombo->itemData(index).toInt());
+    
+    // Parsed mode starts with packets that arrive from now on
+    if (m_cursor) {
+        m_cursor->seekToEnd();
+    }
 }
 
 void TerminalWidget::onSendClicked()
@@ -325,7 +365,7 @@ QString TerminalWidget::formatData(const QByteArray &data) const
     }
 }
 
-QString TerminalWidget::formatPacket(const GenericDataPacket &packet) const
+QString TerminalWidget::formatPacket(const GenericDataPacket &packet)
 {
     if (!packet.isValid) {
         return QString("[ERROR] %1").arg(packet.errorMessage);
@@ -0,0 +1,172 @@
+/**
+ * @file ChecksumTest.cpp
+ * @brief Known-vector tests of the Checksum functions (ctest)
+ *
+ * The slice-by-8 CRCs are checked against the catalogue check values
+ * ("123456789") and against a bitwise reference for every length up
+ * to a few slices, so the byte tail after the last 8-byte step is
+ * covered. The hardware CRC-32C must agree with the table version.
+ */
+
+#include <QtTest>
+#include <QRandomGenerator>
+
+#include "core/Checksum.h"
+
+namespace {
+
+const QByteArray CheckInput("123456789");
+
+/**
+ * @brief Bitwise reflected CRC-32 (reference)
+ */
+quint32 reflectedCrc32(QByteArrayView data, quint32 poly)
+{
+    quint32 crc = 0xFFFFFFFFu;
+    for (char c : data) {
+        crc ^= static_cast<quint8>(c);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * @brief Bitwise CRC-16/MODBUS (reference)
+ */
+quint16 modbusReference(QByteArrayView data)
+{
+    quint16 crc = 0xFFFF;
+    for (char c : data) {
+        crc ^= static_cast<quint8>(c);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief Bitwise CRC-16/CCITT-FALSE (reference)
+ */
+quint16 ccittReference(QByteArrayView data)
+{
+    quint16 crc = 0xFFFF;
+    for (char c : data) {
+        crc ^= static_cast<quint16>(static_cast<quint8>(c) << 8);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? static_cast<quint16>((crc << 1) ^ 0x1021) : static_cast<quint16>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+QByteArray randomBytes(qsizetype size, quint32 seed)
+{
+    QRandomGenerator random(seed);
+    QByteArray data(size, Qt::Uninitialized);
+    for (char &c : data) {
+        c = static_cast<char>(random.bounded(256));
+    }
+    return data;
+}
+
+} // namespace
+
+/**
+ * @class ChecksumTest
+ * @brief Check values, odd lengths and the hardware CRC-32C path
+ */
+class ChecksumTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void checkValues();
+    void oddLengths();
+    void unalignedStart();
+    void hardwareCrc32c();
+    void nmea_data();
+    void nmea();
+};
+
+void ChecksumTest::checkValues()
+{
+    QCOMPARE(Checksum::sum8(CheckInput), quint8(0xDD));
+    QCOMPARE(Checksum::xor8(CheckInput), quint8(0x31));
+    QCOMPARE(Checksum::crc16Modbus(CheckInput), quint16(0x4B37));
+    QCOMPARE(Checksum::crc16Ccitt(CheckInput), quint16(0x29B1));
+    QCOMPARE(Checksum::crc32(CheckInput), quint32(0xCBF43926));
+    QCOMPARE(Checksum::crc32c(CheckInput), quint32(0xE3069283));
+    QCOMPARE(Checksum::crc32cSoftware(CheckInput), quint32(0xE3069283));
+
+    // Empty input is the initial value, finalized
+    QCOMPARE(Checksum::crc32(QByteArrayView()), quint32(0));
+    QCOMPARE(Checksum::crc16Modbus(QByteArrayView()), quint16(0xFFFF));
+}
+
+void ChecksumTest::oddLengths()
+{
+    const QByteArray data = randomBytes(67, 1);
+    for (qsizetype size = 0; size <= data.size(); ++size) {
+        const QByteArrayView view = QByteArrayView(data).first(size);
+        QCOMPARE(Checksum::crc16Modbus(view), modbusReference(view));
+        QCOMPARE(Checksum::crc16Ccitt(view), ccittReference(view));
+        QCOMPARE(Checksum::crc32(view), reflectedCrc32(view, 0xEDB88320u));
+        QCOMPARE(Checksum::crc32cSoftware(view), reflectedCrc32(view, 0x82F63B78u));
+    }
+}
+
+void ChecksumTest::unalignedStart()
+{
+    const QByteArray data = randomBytes(40, 2);
+    for (qsizetype offset = 1; offset < 8; ++offset) {
+        const QByteArrayView view = QByteArrayView(data).sliced(offset);
+        QCOMPARE(Checksum::crc32(view), reflectedCrc32(view, 0xEDB88320u));
+        QCOMPARE(Checksum::crc32c(view), reflectedCrc32(view, 0x82F63B78u));
+    }
+}
+
+void ChecksumTest::hardwareCrc32c()
+{
+    if (!Checksum::hasHardwareCrc32c()) {
+        QSKIP("No CRC-32C instruction on this CPU");
+    }
+    for (qsizetype size : {0, 1, 7, 8, 9, 15, 16, 63, 1000, 4099}) {
+        const QByteArray data = randomBytes(size, 3 + static_cast<quint32>(size));
+        QCOMPARE(Checksum::crc32c(data), Checksum::crc32cSoftware(data));
+    }
+}
+
+void ChecksumTest::nmea_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<int>("result");
+    QTest::addColumn<int>("bodySize");
+
+    const QByteArray gga("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,");
+    QTest::newRow("valid") << gga + "*47" << int(NmeaChecksum::Valid) << int(gga.size());
+    QTest::newRow("lowercase hex") << QByteArray("$AJ*0b") << int(NmeaChecksum::Valid) << 3;
+    QTest::newRow("trailing space") << gga + "*47 \r" << int(NmeaChecksum::Valid) << int(gga.size());
+    QTest::newRow("no dollar") << gga.mid(1) + "*47" << int(NmeaChecksum::Valid) << int(gga.size() - 1);
+    QTest::newRow("mismatch") << gga + "*48" << int(NmeaChecksum::Mismatch) << int(gga.size());
+    QTest::newRow("missing") << gga << int(NmeaChecksum::Missing) << -1;
+    QTest::newRow("bad hex") << gga + "*4G" << int(NmeaChecksum::Missing) << -1;
+    QTest::newRow("too short") << QByteArray("*4") << int(NmeaChecksum::Missing) << -1;
+}
+
+void ChecksumTest::nmea()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(int, result);
+    QFETCH(int, bodySize);
+
+    qsizetype body = -1;
+    QCOMPARE(int(Checksum::checkNmea(line, &body)), result);
+    QCOMPARE(int(body), bodySize);
+}
+
+QTEST_GUILESS_MAIN(ChecksumTest)
+
+#include "ChecksumTest.moc"
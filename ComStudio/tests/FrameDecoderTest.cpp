@@ -0,0 +1,181 @@
+/**
+ * @file FrameDecoderTest.cpp
+ * @brief Tests of the compiled binary frame decoder (ctest)
+ *
+ * Frames are built byte by byte next to the schema that describes
+ * them, so each case shows the wire layout it expects.
+ */
+
+#include <QtTest>
+#include <QJsonDocument>
+#include <QtEndian>
+
+#include "core/Checksum.h"
+#include "core/FrameSchema.h"
+
+namespace {
+
+QJsonObject json(const char *text)
+{
+    return QJsonDocument::fromJson(text).object();
+}
+
+template <typename T>
+void appendLe(QByteArray &out, T value)
+{
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+void appendBe(QByteArray &out, T value)
+{
+    char bytes[sizeof(T)];
+    qToBigEndian(value, bytes);
+    out.append(bytes, sizeof(T));
+}
+
+QVector<double> decodeAll(const FrameDecoder &decoder, const QByteArray &frame)
+{
+    QVector<double> values(decoder.channelNames().size());
+    decoder.decode(frame.constData(), values.data());
+    return values;
+}
+
+} // namespace
+
+/**
+ * @class FrameDecoderTest
+ * @brief Merged ops, byte order, bitfields, scaling, length and checksum
+ */
+class FrameDecoderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void mergedRuns();
+    void byteOrder();
+    void bitfields();
+    void scaleAndOffset();
+    void lengthAndChecksum();
+    void invalidSchema();
+};
+
+void FrameDecoderTest::mergedRuns()
+{
+    FrameDecoder decoder;
+    QVERIFY2(decoder.load(json(R"({ "sync": "AA 55", "fields": [
+        { "name": "a", "type": "i16" }, { "name": "b", "type": "i16" },
+        { "name": "c", "type": "i16" }, { "name": "d", "type": "i16" },
+        { "name": "t", "type": "f32" } ] })")), qPrintable(decoder.errorString()));
+
+    // Four adjacent i16 share one op, the f32 gets its own
+    QCOMPARE(decoder.programSize(), 2);
+    QCOMPARE(decoder.minFrameSize(), 14);
+    QCOMPARE(decoder.channelNames(), (QStringList{"a", "b", "c", "d", "t"}));
+
+    QByteArray frame("\xAA\x55", 2);
+    for (qint16 value : {1, -2, 3, -4}) {
+        appendLe<qint16>(frame, value);
+    }
+    appendLe<float>(frame, 1.5f);
+    QCOMPARE(decodeAll(decoder, frame), (QVector<double>{1, -2, 3, -4, 1.5}));
+}
+
+void FrameDecoderTest::byteOrder()
+{
+    FrameDecoder decoder;
+    QVERIFY2(decoder.load(json(R"({ "endian": "big", "fields": [
+        { "name": "be16", "type": "u16" },
+        { "name": "le16", "type": "u16", "endian": "little" },
+        { "name": "be32", "type": "i32" },
+        { "name": "bef", "type": "f32" },
+        { "name": "led", "type": "f64", "endian": "little" } ] })")), qPrintable(decoder.errorString()));
+
+    QByteArray frame;
+    appendBe<quint16>(frame, 0x1234);
+    appendLe<quint16>(frame, 0x1234);
+    appendBe<qint32>(frame, -2);
+    appendBe<float>(frame, 2.5f);
+    appendLe<double>(frame, 0.25);
+    QCOMPARE(frame.size(), decoder.minFrameSize());
+    QCOMPARE(decodeAll(decoder, frame), (QVector<double>{0x1234, 0x1234, -2, 2.5, 0.25}));
+}
+
+void FrameDecoderTest::bitfields()
+{
+    FrameDecoder decoder;
+    QVERIFY2(decoder.load(json(R"({ "fields": [
+        { "name": "lo", "type": "u8", "bits": [0, 3] },
+        { "name": "hi", "type": "u8", "bits": [3, 5] },
+        { "name": "mid", "type": "u16", "endian": "big", "bits": [4, 8], "scale": 2 } ] })")),
+             qPrintable(decoder.errorString()));
+
+    // lo and hi share byte 0; mid reads bits 4..11 of a big-endian u16
+    QCOMPARE(decoder.minFrameSize(), 3);
+    const QByteArray frame("\xB5\xAB\xCD", 3);
+    QCOMPARE(decodeAll(decoder, frame), (QVector<double>{0b101, 0b10110, 0xBC * 2}));
+}
+
+void FrameDecoderTest::scaleAndOffset()
+{
+    FrameDecoder decoder;
+    QVERIFY2(decoder.load(json(R"({ "fields": [
+        { "name": "temp", "type": "i16", "scale": 0.01, "offset": 5 },
+        { "name": "half", "type": "i16", "scale": 0.5 },
+        { "name": "raw", "type": "u8" } ] })")), qPrintable(decoder.errorString()));
+
+    // Different scaling keeps adjacent fields of one type apart
+    QCOMPARE(decoder.programSize(), 3);
+
+    QByteArray frame;
+    appendLe<qint16>(frame, -1000);
+    appendLe<qint16>(frame, 10);
+    frame.append('\xFF');
+    const QVector<double> values = decodeAll(decoder, frame);
+    QCOMPARE(values.size(), 3);
+    QVERIFY(qFuzzyCompare(values[0], -5.0));
+    QCOMPARE(values[1], 5.0);
+    QCOMPARE(values[2], 255.0);
+}
+
+void FrameDecoderTest::lengthAndChecksum()
+{
+    FrameDecoder decoder;
+    QVERIFY2(decoder.load(json(R"({ "sync": "AA", "length": { "at": 1, "type": "u8", "adjust": 4 },
+        "fields": [ { "name": "v", "type": "u16" } ],
+        "checksum": { "type": "crc16" } })")), qPrintable(decoder.errorString()));
+    QCOMPARE(decoder.minFrameSize(), 6);
+
+    QByteArray frame("\xAA\x02", 2);
+    appendLe<quint16>(frame, 0xBEEF);
+    appendLe<quint16>(frame, Checksum::crc16Modbus(QByteArrayView(frame).sliced(1)));
+
+    QCOMPARE(decoder.frameLength(frame), qsizetype(6));
+    QCOMPARE(decoder.frameLength(QByteArrayView(frame).first(1)), qsizetype(0));    // Length not here yet
+    QVERIFY(decoder.checksumOk(frame));
+    QCOMPARE(decodeAll(decoder, frame), QVector<double>{0xBEEF});
+
+    QByteArray corrupt = frame;
+    corrupt[2] = static_cast<char>(corrupt[2] ^ 0x01);
+    QVERIFY(!decoder.checksumOk(corrupt));
+
+    QByteArray tooShort = frame;
+    tooShort[1] = 0;    // 0 + 4 bytes is less than the minimum
+    QCOMPARE(decoder.frameLength(tooShort), qsizetype(-1));
+}
+
+void FrameDecoderTest::invalidSchema()
+{
+    FrameDecoder decoder;
+    QVERIFY(!decoder.load(json(R"({ "fields": [ { "name": "s", "type": "i16", "bits": [0, 4] } ] })")));
+    QVERIFY(!decoder.isValid());
+    QVERIFY(!decoder.load(json(R"({ "fields": [ { "name": "a", "type": "u8" }, { "name": "a", "type": "u8" } ] })")));
+    QVERIFY(!decoder.load(json(R"({ "fields": [] })")));
+    QVERIFY(!decoder.errorString().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(FrameDecoderTest)
+
+#include "FrameDecoderTest.moc"
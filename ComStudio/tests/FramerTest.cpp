@@ -0,0 +1,237 @@
+/**
+ * @file FramerTest.cpp
+ * @brief Tests of the COBS, SLIP, length-prefix and fixed-size framers (ctest)
+ *
+ * Each framer is fed encoded frames in one piece and byte by byte,
+ * with corrupt records in between to check that it resynchronizes.
+ */
+
+#include <QtTest>
+#include <QJsonObject>
+
+#include "core/Framer.h"
+
+namespace {
+
+/**
+ * @brief Reference COBS encoder, including the trailing 0x00 delimiter
+ */
+QByteArray cobsEncode(const QByteArray &payload)
+{
+    QByteArray out(1, '\0');
+    qsizetype codeAt = 0;
+    int code = 1;
+    for (char c : payload) {
+        if (c == '\0') {
+            out[codeAt] = static_cast<char>(code);
+            codeAt = out.size();
+            out.append('\0');
+            code = 1;
+            continue;
+        }
+        out.append(c);
+        if (++code == 0xFF) {
+            out[codeAt] = static_cast<char>(code);
+            codeAt = out.size();
+            out.append('\0');
+            code = 1;
+        }
+    }
+    out[codeAt] = static_cast<char>(code);
+    out.append('\0');
+    return out;
+}
+
+QByteArray nonZeroRun(int size)
+{
+    QByteArray run(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i) {
+        run[i] = static_cast<char>(1 + i % 255);
+    }
+    return run;
+}
+
+QList<QByteArray> drain(Framer &framer)
+{
+    QList<QByteArray> frames;
+    QByteArrayView frame;
+    while (framer.nextFrame(frame)) {
+        frames.append(frame.toByteArray());
+    }
+    return frames;
+}
+
+QList<QByteArray> feedBytewise(Framer &framer, const QByteArray &stream)
+{
+    QList<QByteArray> frames;
+    for (char c : stream) {
+        framer.push(QByteArrayView(&c, 1));
+        frames += drain(framer);
+    }
+    return frames;
+}
+
+} // namespace
+
+/**
+ * @class FramerTest
+ * @brief Escaping, zero runs and resynchronization of the framers
+ */
+class FramerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cobsVector();
+    void cobsZeroRuns_data();
+    void cobsZeroRuns();
+    void cobsResync();
+    void slipEscapes();
+    void slipResync();
+    void lengthPrefixResync();
+    void fixedSize();
+    void create();
+};
+
+void FramerTest::cobsVector()
+{
+    QCOMPARE(cobsEncode(QByteArray("\x11\x22\x00\x33", 4)), QByteArray("\x03\x11\x22\x02\x33\x00", 6));
+
+    CobsFramer framer;
+    framer.push(QByteArray("\x03\x11\x22\x02\x33\x00", 6));
+    QCOMPARE(drain(framer), QList<QByteArray>{QByteArray("\x11\x22\x00\x33", 4)});
+    QCOMPARE(framer.resyncs(), quint64(0));
+    QCOMPARE(framer.buffered(), qsizetype(0));
+}
+
+void FramerTest::cobsZeroRuns_data()
+{
+    QTest::addColumn<QByteArray>("payload");
+
+    QTest::newRow("single zero") << QByteArray(1, '\0');
+    QTest::newRow("zero run") << QByteArray(5, '\0');
+    QTest::newRow("zeros inside") << QByteArray("\x11\x00\x00\x22", 4);
+    QTest::newRow("trailing zero") << QByteArray("\x11\x22\x00", 3);
+    QTest::newRow("254 non-zero") << nonZeroRun(254);
+    QTest::newRow("255 non-zero") << nonZeroRun(255);
+    QTest::newRow("254 non-zero, zero") << nonZeroRun(254) + QByteArray(1, '\0');
+    QTest::newRow("600 non-zero") << nonZeroRun(600);
+}
+
+void FramerTest::cobsZeroRuns()
+{
+    QFETCH(QByteArray, payload);
+    const QByteArray stream = cobsEncode(payload) + cobsEncode("next");
+
+    CobsFramer whole;
+    whole.push(stream);
+    QCOMPARE(drain(whole), (QList<QByteArray>{payload, "next"}));
+
+    CobsFramer bytewise;
+    QCOMPARE(feedBytewise(bytewise, stream), (QList<QByteArray>{payload, "next"}));
+    QCOMPARE(bytewise.resyncs(), quint64(0));
+}
+
+void FramerTest::cobsResync()
+{
+    // Idle delimiters are skipped silently; a code byte pointing past
+    // the delimiter is corrupt and dropped up to that delimiter
+    const QByteArray stream = QByteArray(2, '\0') + QByteArray("\x05\x11\x00", 3) + cobsEncode("ok");
+
+    CobsFramer framer;
+    QCOMPARE(feedBytewise(framer, stream), QList<QByteArray>{"ok"});
+    QCOMPARE(framer.resyncs(), quint64(1));
+
+    // A frame longer than the maximum is corrupt too; with no delimiter
+    // in reach, the buffered bytes are dropped
+    CobsFramer small(4);
+    small.push(cobsEncode("toolong"));
+    QVERIFY(drain(small).isEmpty());
+    QCOMPARE(small.buffered(), qsizetype(0));
+    small.push(cobsEncode("ok"));
+    QCOMPARE(drain(small), QList<QByteArray>{"ok"});
+    QCOMPARE(small.resyncs(), quint64(1));
+}
+
+void FramerTest::slipEscapes()
+{
+    // END and ESC inside the payload are escaped as ESC ESC_END / ESC ESC_ESC
+    const QByteArray payload("\x01\xC0\xDB\x02", 4);
+    const QByteArray encoded("\xC0\x01\xDB\xDC\xDB\xDD\x02\xC0", 8);
+
+    SlipFramer framer;
+    framer.push(encoded);
+    QCOMPARE(drain(framer), QList<QByteArray>{payload});
+    QCOMPARE(framer.resyncs(), quint64(0));
+
+    SlipFramer bytewise;
+    QCOMPARE(feedBytewise(bytewise, encoded + encoded), (QList<QByteArray>{payload, payload}));
+
+    const FrameClaim claim = framer.claimFrame(encoded);
+    QCOMPARE(claim.result, FrameClaim::Match);
+    QCOMPARE(claim.length, encoded.size());
+    QCOMPARE(framer.claimFrame(encoded.first(4)).result, FrameClaim::NeedMore);
+    QCOMPARE(framer.claimFrame(QByteArray("text\n")).result, FrameClaim::NoMatch);
+}
+
+void FramerTest::slipResync()
+{
+    // ESC followed by anything but ESC_END / ESC_ESC is corrupt
+    const QByteArray stream = QByteArray("\xC0\x01\xDB\x05\xC0", 5) + QByteArray("\xC0ok\xC0", 4);
+
+    SlipFramer framer;
+    framer.push(stream);
+    QCOMPARE(drain(framer), QList<QByteArray>{"ok"});
+    QCOMPARE(framer.resyncs(), quint64(1));
+}
+
+void FramerTest::lengthPrefixResync()
+{
+    LengthPrefixFramer framer(2, true, 0, QByteArray("\xAA\x55", 2), 16);
+
+    // Noise, a record with an out-of-range length, then a good record
+    // split across pushes, ending in half a sync sequence. The bad
+    // record costs two resyncs: its sync byte, then the rest of its header
+    QByteArray stream("xy");
+    stream += QByteArray("\xAA\x55\x00\x40", 4);
+    stream += QByteArray("\xAA\x55\x00\x03" "abc", 7);
+    stream += QByteArray("\xAA", 1);
+
+    framer.push(stream.first(10));
+    QVERIFY(drain(framer).isEmpty());
+    framer.push(stream.sliced(10));
+    QCOMPARE(drain(framer), QList<QByteArray>{"abc"});
+    QCOMPARE(framer.resyncs(), quint64(3));
+    QCOMPARE(framer.buffered(), qsizetype(1));      // Kept: may start the next sync
+
+    framer.push(QByteArray("\x55\x00\x00", 3));
+    QCOMPARE(drain(framer), QList<QByteArray>{QByteArray()});
+}
+
+void FramerTest::fixedSize()
+{
+    FixedSizeFramer framer(3, QByteArray("\x7E", 1));
+    const QByteArray stream = QByteArray("\x7E" "abc" "zz" "\x7E" "def", 10);
+    QCOMPARE(feedBytewise(framer, stream), (QList<QByteArray>{"abc", "def"}));
+    QCOMPARE(framer.resyncs(), quint64(2));     // The two noise bytes, one at a time
+
+    FixedSizeFramer unsynced(2);
+    unsynced.push("abcde");
+    QCOMPARE(drain(unsynced), (QList<QByteArray>{"ab", "cd"}));
+    QCOMPARE(unsynced.buffered(), qsizetype(1));
+}
+
+void FramerTest::create()
+{
+    QString error;
+    QVERIFY(Framer::create(QJsonObject{{"type", "cobs"}}, error));
+    QVERIFY(Framer::create(QJsonObject{{"type", "length"}, {"bytes", 2}, {"sync", "AA 55"}}, error));
+    QVERIFY(!Framer::create(QJsonObject{{"type", "length"}, {"bytes", 3}}, error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!Framer::create(QJsonObject{{"type", "fixed"}}, error));
+    QVERIFY(!Framer::create(QJsonObject{{"type", "cobs"}, {"sync", "A"}}, error));
+}
+
+QTEST_GUILESS_MAIN(FramerTest)
+
+#include "FramerTest.moc"
@@ -0,0 +1,204 @@
+/**
+ * @file NmeaProtocolTest.cpp
+ * @brief Tests of the NMEA 0183 field conversions and sentence decoding (ctest)
+ *
+ * Coordinates and times are checked against hand-converted values;
+ * whole sentences go through parse() to check which ones are dropped.
+ */
+
+#include <QtTest>
+
+#include "core/NmeaProtocol.h"
+
+namespace {
+
+using FieldKind = NmeaProtocol::FieldKind;
+
+/**
+ * @brief Parse data and collect the packets and error messages
+ */
+struct ParseResult
+{
+    QVector<GenericDataPacket> packets;
+    QStringList errors;
+};
+
+ParseResult parseAll(NmeaProtocol &nmea, const QByteArray &data)
+{
+    ParseResult result;
+    QObject context;
+    QObject::connect(&nmea, &BaseProtocol::batchForLogging, &context, [&result](const PacketBatch &batch) {
+        for (const GenericDataPacket &packet : batch) {
+            result.packets.append(packet);
+        }
+    });
+    QObject::connect(&nmea, &BaseProtocol::parseError, &context, [&result](const QString &error, const QByteArray &) {
+        result.errors.append(error);
+    });
+    nmea.parse(data);
+    return result;
+}
+
+} // namespace
+
+/**
+ * @class NmeaProtocolTest
+ * @brief Coordinate and time conversion, and malformed sentences
+ */
+class NmeaProtocolTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void degrees_data();
+    void degrees();
+    void invalidDegrees_data();
+    void invalidDegrees();
+    void secondsOfDay_data();
+    void secondsOfDay();
+    void ggaSentence();
+    void malformedSentence();
+    void emptyFields();
+};
+
+void NmeaProtocolTest::degrees_data()
+{
+    QTest::addColumn<QByteArray>("value");
+    QTest::addColumn<char>("hemisphere");
+    QTest::addColumn<FieldKind>("kind");
+    QTest::addColumn<double>("expected");
+
+    QTest::newRow("north") << QByteArray("4807.038") << 'N' << FieldKind::Latitude << 48.0 + 7.038 / 60.0;
+    QTest::newRow("south") << QByteArray("3351.500") << 'S' << FieldKind::Latitude << -(33.0 + 51.5 / 60.0);
+    QTest::newRow("east") << QByteArray("01131.000") << 'E' << FieldKind::Longitude << 11.0 + 31.0 / 60.0;
+    QTest::newRow("west") << QByteArray("12225.800") << 'W' << FieldKind::Longitude << -(122.0 + 25.8 / 60.0);
+    QTest::newRow("pole") << QByteArray("9000.000") << 'N' << FieldKind::Latitude << 90.0;
+    QTest::newRow("antimeridian") << QByteArray("18000") << 'W' << FieldKind::Longitude << -180.0;
+    QTest::newRow("no fraction") << QByteArray("4807") << 'N' << FieldKind::Latitude << 48.0 + 7.0 / 60.0;
+}
+
+void NmeaProtocolTest::degrees()
+{
+    QFETCH(QByteArray, value);
+    QFETCH(char, hemisphere);
+    QFETCH(FieldKind, kind);
+    QFETCH(double, expected);
+
+    double degrees = 0.0;
+    QVERIFY(NmeaProtocol::toDegrees(value, hemisphere, kind, degrees));
+    QCOMPARE(degrees, expected);
+}
+
+void NmeaProtocolTest::invalidDegrees_data()
+{
+    QTest::addColumn<QByteArray>("value");
+    QTest::addColumn<char>("hemisphere");
+    QTest::addColumn<FieldKind>("kind");
+
+    QTest::newRow("latitude east") << QByteArray("4807.038") << 'E' << FieldKind::Latitude;
+    QTest::newRow("latitude west") << QByteArray("4807.038") << 'W' << FieldKind::Latitude;
+    QTest::newRow("longitude north") << QByteArray("01131.000") << 'N' << FieldKind::Longitude;
+    QTest::newRow("lowercase") << QByteArray("4807.038") << 'n' << FieldKind::Latitude;
+    QTest::newRow("no hemisphere") << QByteArray("4807.038") << '\0' << FieldKind::Latitude;
+    QTest::newRow("not a coordinate") << QByteArray("4807.038") << 'N' << FieldKind::Number;
+    QTest::newRow("latitude over 90") << QByteArray("9000.001") << 'N' << FieldKind::Latitude;
+    QTest::newRow("longitude over 180") << QByteArray("18000.600") << 'E' << FieldKind::Longitude;
+    QTest::newRow("minutes 60") << QByteArray("4860.000") << 'N' << FieldKind::Latitude;
+    QTest::newRow("negative") << QByteArray("-4807.038") << 'N' << FieldKind::Latitude;
+    QTest::newRow("empty") << QByteArray() << 'N' << FieldKind::Latitude;
+    QTest::newRow("trailing text") << QByteArray("4807.038x") << 'N' << FieldKind::Latitude;
+}
+
+void NmeaProtocolTest::invalidDegrees()
+{
+    QFETCH(QByteArray, value);
+    QFETCH(char, hemisphere);
+    QFETCH(FieldKind, kind);
+
+    double degrees = 123.0;
+    QVERIFY(!NmeaProtocol::toDegrees(value, hemisphere, kind, degrees));
+}
+
+void NmeaProtocolTest::secondsOfDay_data()
+{
+    QTest::addColumn<QByteArray>("value");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<double>("expected");
+
+    QTest::newRow("hhmmss") << QByteArray("123519") << true << 45319.0;
+    QTest::newRow("fraction") << QByteArray("123519.50") << true << 45319.5;
+    QTest::newRow("midnight") << QByteArray("000000.000") << true << 0.0;
+    QTest::newRow("last second") << QByteArray("235959.99") << true << 86399.99;
+    QTest::newRow("leap second") << QByteArray("235960") << true << 86400.0;
+    QTest::newRow("too short") << QByteArray("12351") << false << 0.0;
+    QTest::newRow("empty") << QByteArray() << false << 0.0;
+    QTest::newRow("hour 24") << QByteArray("240000") << false << 0.0;
+    QTest::newRow("minute 60") << QByteArray("126000") << false << 0.0;
+    QTest::newRow("second 61") << QByteArray("123561") << false << 0.0;
+    QTest::newRow("letters") << QByteArray("12a519") << false << 0.0;
+    QTest::newRow("trailing text") << QByteArray("123519Z") << false << 0.0;
+}
+
+void NmeaProtocolTest::secondsOfDay()
+{
+    QFETCH(QByteArray, value);
+    QFETCH(bool, valid);
+    QFETCH(double, expected);
+
+    double seconds = -1.0;
+    QCOMPARE(NmeaProtocol::toSecondsOfDay(value, seconds), valid);
+    if (valid) {
+        QCOMPARE(seconds, expected);
+    }
+}
+
+void NmeaProtocolTest::ggaSentence()
+{
+    NmeaProtocol nmea;
+    const ParseResult result =
+        parseAll(nmea, "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n");
+
+    QVERIFY(result.errors.isEmpty());
+    QCOMPARE(result.packets.size(), 1);
+    const GenericDataPacket &packet = result.packets.first();
+    QCOMPARE(packet.sensorId, QString("GGA"));
+    QCOMPARE(packet.channelNames, (QStringList{"time", "lat", "lon", "fix", "sats", "hdop", "alt"}));
+    QCOMPARE(packet.values.size(), packet.channelNames.size());
+    QCOMPARE(packet.channels.value("time"), 45319.0);
+    QCOMPARE(packet.channels.value("lat"), 48.0 + 7.038 / 60.0);
+    QCOMPARE(packet.channels.value("lon"), 11.0 + 31.0 / 60.0);
+    QCOMPARE(packet.channels.value("sats"), 8.0);
+    QCOMPARE(packet.channels.value("alt"), 545.4);
+}
+
+void NmeaProtocolTest::malformedSentence()
+{
+    // A latitude with an east/west hemisphere drops the whole sentence
+    // with one error; the next sentence still decodes
+    NmeaProtocol nmea;
+    const ParseResult result = parseAll(nmea,
+                                        "$GPGGA,123519,4807.038,E,01131.000,E,1,08,0.9,545.4,M,46.9,M,,\r\n"
+                                        "$GPGLL,4916.45,N,12311.12,W,225444,A\r\n");
+
+    QCOMPARE(result.errors.size(), 1);
+    QVERIFY(result.errors.first().contains("'lat'"));
+    QCOMPARE(result.packets.size(), 1);
+    QCOMPARE(result.packets.first().sensorId, QString("GLL"));
+    QCOMPARE(result.packets.first().channels.value("lon"), -(123.0 + 11.12 / 60.0));
+}
+
+void NmeaProtocolTest::emptyFields()
+{
+    // No fix yet: unreported fields are left out without an error
+    NmeaProtocol nmea;
+    const ParseResult result = parseAll(nmea, "$GPGGA,123519,,,,,0,00,,,M,,M,,\r\n");
+
+    QVERIFY(result.errors.isEmpty());
+    QCOMPARE(result.packets.size(), 1);
+    QCOMPARE(result.packets.first().channelNames, (QStringList{"time", "fix", "sats"}));
+    QCOMPARE(result.packets.first().values, (QVector<double>{45319.0, 0.0, 0.0}));
+}
+
+QTEST_GUILESS_MAIN(NmeaProtocolTest)
+
+#include "NmeaProtocolTest.moc"
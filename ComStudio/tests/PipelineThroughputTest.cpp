@@ -0,0 +1,422 @@
+/**
+ * @file PipelineThroughputTest.cpp
+ * @brief End-to-end throughput and loss regression tests (ctest)
+ *
+ * Fixed generator workloads are pushed through LineParser, DataBuffer
+ * and a recording writer, once in-process (parser-bound) and once
+ * through the SerialManager worker thread at a fixed line rate.
+ *
+ * Thresholds can be tuned per machine with environment variables:
+ * - COMSTUDIO_TEST_MIN_LINES_PER_SEC  in-process minimum (default 50000)
+ * - COMSTUDIO_TEST_MIN_RATE_FRACTION  generator port: fraction of the
+ *                                     configured rate to sustain (default 0.9)
+ * - COMSTUDIO_TEST_DURATION_MS        generator port run time (default 2000)
+ */
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QtEndian>
+
+#include "core/DataGenerator.h"
+#include "core/LineParser.h"
+#include "core/ParserConfig.h"
+#include "core/CsvRecordWriter.h"
+#include "core/RecordingFile.h"
+#include "core/SerialManager.h"
+#include "core/PipelineMetrics.h"
+#include "core/ProtocolHandler.h"
+#include "core/RawCapture.h"
+#include "core/ReplaySource.h"
+#include "core/VofaProtocols.h"
+#include "models/DataBuffer.h"
+
+namespace {
+
+constexpr int InProcessLines = 200000;
+constexpr int ChunkLines = 64;          ///< Lines per parse() call (typical read size)
+
+double envDouble(const char *name, double fallback)
+{
+    bool ok = false;
+    const double value = qEnvironmentVariable(name).toDouble(&ok);
+    return ok ? value : fallback;
+}
+
+ParserConfig configFor(GeneratorFormat format)
+{
+    ParserConfig config = ParserConfig::csvDefault();
+    if (format == GeneratorFormat::Labeled) {
+        config.stripLabels = true;
+    } else if (format == GeneratorFormat::IdPrefixed) {
+        config.idFieldIndex = 0;
+    }
+    return config;
+}
+
+/**
+ * @brief Parser -> DataBuffer + recording writer, as wired in the application
+ */
+class RecordingSink : public QObject
+{
+public:
+    RecordingSink(LineParser &parser, bool native, const QString &path)
+        : m_buffer(10000)
+    {
+        if (native) {
+            m_native = std::make_unique<RecordingWriter>();
+            m_opened = m_native->open(path);
+        } else {
+            m_csv = std::make_unique<CsvRecordWriter>(true);
+            m_opened = m_csv->open(path);
+        }
+        QObject::connect(&parser, &LineParser::batchForLogging,
+                         this, [this](const PacketBatch &batch) {
+                             m_buffer.addBatch(batch);
+                             for (const GenericDataPacket &packet : batch) {
+                                 if (m_native) {
+                                     m_writeOk = m_native->append(packet) && m_writeOk;
+                                 } else {
+                                     m_csv->append(packet);
+                                 }
+                             }
+                             m_recorded += static_cast<quint64>(batch.size());
+                         });
+    }
+
+    bool opened() const { return m_opened; }
+    quint64 recorded() const { return m_recorded; }
+
+    bool close()
+    {
+        return (m_native ? m_native->close() : m_csv->close()) && m_writeOk;
+    }
+
+private:
+    DataBuffer m_buffer;
+    std::unique_ptr<RecordingWriter> m_native;
+    std::unique_ptr<CsvRecordWriter> m_csv;
+    quint64 m_recorded = 0;
+    bool m_opened = false;
+    bool m_writeOk = true;
+};
+
+/**
+ * @brief Count rows of a finished recording
+ */
+quint64 recordedRows(const QString &path, bool native)
+{
+    if (native) {
+        RecordingReader reader;
+        return reader.open(path) ? reader.rowCount() : 0;
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const quint64 lines = static_cast<quint64>(file.readAll().count('\n'));
+    return lines > 0 ? lines - 1 : 0;   // minus header
+}
+
+} // namespace
+
+/**
+ * @class PipelineThroughputTest
+ * @brief Throughput and zero-loss checks for the core pipeline
+ */
+class PipelineThroughputTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void inProcess_data();
+    void inProcess();
+    void generatorPort_data();
+    void generatorPort();
+    void recordingRoundTrip();
+    void rotatedCaptureReplay();
+    void demuxTextBeforeJustFloat();
+};
+
+void PipelineThroughputTest::inProcess_data()
+{
+    QTest::addColumn<int>("format");
+    QTest::addColumn<int>("channels");
+    QTest::addColumn<bool>("native");
+
+    for (int channels : {1, 8, 32}) {
+        QTest::addRow("csv_%dch", channels)
+            << static_cast<int>(GeneratorFormat::Csv) << channels << false;
+        QTest::addRow("csv_%dch_native", channels)
+            << static_cast<int>(GeneratorFormat::Csv) << channels << true;
+    }
+    QTest::newRow("labeled_8ch") << static_cast<int>(GeneratorFormat::Labeled) << 8 << true;
+    QTest::newRow("id_8ch") << static_cast<int>(GeneratorFormat::IdPrefixed) << 8 << true;
+}
+
+void PipelineThroughputTest::inProcess()
+{
+    QFETCH(int, format);
+    QFETCH(int, channels);
+    QFETCH(bool, native);
+
+    GeneratorSettings settings;
+    settings.format = static_cast<GeneratorFormat>(format);
+    settings.channels = channels;
+    DataGenerator generator(settings);
+
+    // Generate up front so only the pipeline is timed
+    QVector<QByteArray> chunks;
+    for (int lines = 0; lines < InProcessLines; lines += ChunkLines) {
+        QByteArray chunk;
+        generator.generate(ChunkLines, chunk);
+        chunks.append(chunk);
+    }
+    const quint64 expected = generator.linesGenerated();
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(native ? "run.csrec" : "run.csv");
+
+    LineParser parser(configFor(settings.format));
+    RecordingSink sink(parser, native, path);
+    QVERIFY(sink.opened());
+
+    QElapsedTimer timer;
+    timer.start();
+    for (const QByteArray &chunk : std::as_const(chunks)) {
+        parser.parse(chunk);
+    }
+    QVERIFY(sink.close());
+    const double seconds = timer.nsecsElapsed() / 1e9;
+    const double linesPerSecond = expected / seconds;
+
+    qInfo().noquote() << QString("%1: %2 lines/s").arg(QTest::currentDataTag()).arg(linesPerSecond, 0, 'f', 0);
+
+    // Zero loss: every generated line is parsed, recorded and on disk
+    QCOMPARE(sink.recorded(), expected);
+    QCOMPARE(recordedRows(path, native), expected);
+
+    const double minimum = envDouble("COMSTUDIO_TEST_MIN_LINES_PER_SEC", 50000.0);
+    QVERIFY2(linesPerSecond >= minimum,
+             qPrintable(QString("%1 lines/s is below the %2 lines/s threshold")
+                            .arg(linesPerSecond, 0, 'f', 0).arg(minimum, 0, 'f', 0)));
+}
+
+void PipelineThroughputTest::generatorPort_data()
+{
+    QTest::addColumn<int>("format");
+    QTest::addColumn<int>("channels");
+    QTest::addColumn<double>("rate");
+
+    QTest::newRow("csv_4ch_5k")   << static_cast<int>(GeneratorFormat::Csv) << 4 << 5000.0;
+    QTest::newRow("csv_16ch_20k") << static_cast<int>(GeneratorFormat::Csv) << 16 << 20000.0;
+    QTest::newRow("id_8ch_20k")   << static_cast<int>(GeneratorFormat::IdPrefixed) << 8 << 20000.0;
+}
+
+void PipelineThroughputTest::generatorPort()
+{
+    QFETCH(int, format);
+    QFETCH(int, channels);
+    QFETCH(double, rate);
+
+    SerialSettings serialSettings;
+    serialSettings.kind = PortKind::Generator;
+    serialSettings.generator.format = static_cast<GeneratorFormat>(format);
+    serialSettings.generator.channels = channels;
+    serialSettings.generator.linesPerSecond = rate;
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("run.csrec");
+
+    LineParser parser(configFor(serialSettings.generator.format));
+    RecordingSink sink(parser, true, path);
+    QVERIFY(sink.opened());
+
+    // Count complete lines as delivered by the worker thread
+    SerialManager &serial = SerialManager::instance();
+    quint64 deliveredLines = 0;
+    QMetaObject::Connection bytesConnection = connect(&serial, &SerialManager::rawBytesReady,
+        this, [&](const QByteArray &data) {
+            deliveredLines += data.count('\n');
+            parser.parse(data);
+        });
+
+    QSignalSpy stateSpy(&serial, &SerialManager::connectionStateChanged);
+    PipelineMetrics::instance().reset();
+    serial.connectPort(serialSettings);
+    QVERIFY(stateSpy.wait(5000));
+    QVERIFY(stateSpy.last().at(0).toBool());
+
+    const int durationMs = static_cast<int>(envDouble("COMSTUDIO_TEST_DURATION_MS", 2000.0));
+    QElapsedTimer timer;
+    timer.start();
+    QTest::qWait(durationMs);
+
+    // Chunks emitted before the close are delivered before the state change
+    serial.disconnectPort();
+    QTRY_VERIFY_WITH_TIMEOUT(!stateSpy.last().at(0).toBool(), 5000);
+    const double seconds = timer.nsecsElapsed() / 1e9;
+    disconnect(bytesConnection);
+    QVERIFY(sink.close());
+
+    const MetricsSnapshot metrics = PipelineMetrics::instance().snapshot();
+    const double linesPerSecond = deliveredLines / seconds;
+    qInfo().noquote() << QString("%1: %2 lines/s sustained (target %3)")
+        .arg(QTest::currentDataTag()).arg(linesPerSecond, 0, 'f', 0).arg(rate, 0, 'f', 0);
+
+    // Zero loss between the worker thread and the recording
+    QCOMPARE(metrics.counter(MetricCounter::ParseErrors), quint64(0));
+    QCOMPARE(sink.recorded(), deliveredLines);
+    QCOMPARE(recordedRows(path, true), deliveredLines);
+
+    const double fraction = envDouble("COMSTUDIO_TEST_MIN_RATE_FRACTION", 0.9);
+    QVERIFY2(linesPerSecond >= rate * fraction,
+             qPrintable(QString("sustained %1 lines/s, expected at least %2")
+                            .arg(linesPerSecond, 0, 'f', 0).arg(rate * fraction, 0, 'f', 0)));
+}
+
+void PipelineThroughputTest::recordingRoundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("order.csrec");
+
+    // Ch10 and Ch11 sort before Ch2 by name; values must keep parse order.
+    // From row 8 on, Ch3 and Ch7 repeat a value and must not split chunks.
+    QVector<GenericDataPacket> written;
+    RecordingWriter writer;
+    QVERIFY(writer.open(path));
+    for (int row = 0; row < 16; ++row) {
+        GenericDataPacket packet;
+        packet.timestamp = 1000 + row;
+        packet.packetIndex = row;
+        packet.sensorId = "dev,\"a\"";
+        for (int c = 0; c < 12; ++c) {
+            const bool repeated = row >= 8 && (c == 3 || c == 7);
+            packet.addChannel(QString("Ch%1").arg(c), repeated ? -1.0 : row * 100.0 + c);
+        }
+        QVERIFY(writer.append(packet));
+        written.append(packet);
+    }
+    QVERIFY(writer.close());
+
+    RecordingReader reader;
+    QVERIFY(reader.open(path));
+    QCOMPARE(reader.chunkCount(), 1);
+    RecordingChunk chunk;
+    QVERIFY(reader.readChunk(0, chunk));
+    QCOMPARE(chunk.rowCount(), static_cast<int>(written.size()));
+    for (int row = 0; row < chunk.rowCount(); ++row) {
+        const GenericDataPacket packet = chunk.packetAt(row);
+        QCOMPARE(packet.values, written[row].values);
+        QCOMPARE(packet.channelNames, written[row].channelNames);
+        QCOMPARE(packet.channels, written[row].channels);
+        QCOMPARE(packet.sensorId, written[row].sensorId);
+    }
+
+    const QString csvPath = dir.filePath("order.csv");
+    QVERIFY(RecordingReader::convertToCsv(path, csvPath));
+    QFile csv(csvPath);
+    QVERIFY(csv.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QList<QByteArray> lines = csv.readAll().split('\n');
+    QVERIFY(lines.size() > 1);
+    QVERIFY(lines[0].endsWith(",Ch9,Ch10,Ch11"));
+    QCOMPARE(lines[1], QByteArray("1000,0,\"dev,\"\"a\"\"\",0.000000,1.000000,2.000000,"
+                                  "3.000000,4.000000,5.000000,6.000000,7.000000,8.000000,"
+                                  "9.000000,10.000000,11.000000"));
+}
+
+void PipelineThroughputTest::rotatedCaptureReplay()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("rotated.csraw");
+
+    RawCaptureSettings settings;
+    settings.path = path;
+    settings.blockSize = 4096;
+    settings.rotateBytes = 4096;
+    RawCaptureWriter writer;
+    QVERIFY(writer.open(settings));
+    QByteArray written;
+    for (int i = 0; i < 40; ++i) {
+        const QByteArray chunk = QByteArray::number(i).leftJustified(1000, static_cast<char>('a' + i % 26));
+        QVERIFY(writer.append(chunk));
+        written += chunk;
+    }
+    writer.close();
+    QVERIFY(writer.partCount() >= 3);
+    QVERIFY(!QFile::exists(path));
+
+    // The base path and the first part replay every part, in order
+    for (const QString &start : {path, RawCaptureWriter::partPath(path, 1)}) {
+        ReplaySource replay;
+        QVERIFY2(replay.open(start, 11520), qPrintable(replay.errorString()));
+        QVERIFY(replay.isCapture());
+        QByteArray replayed;
+        QByteArray data;
+        qint64 offsetNs = 0;
+        qint64 lastNs = 0;
+        while (replay.next(data, offsetNs)) {
+            QVERIFY(offsetNs >= lastNs);
+            lastNs = offsetNs;
+            replayed += data;
+        }
+        QVERIFY(replay.errorString().isEmpty());
+        QCOMPARE(replayed.size(), written.size());
+        QVERIFY(replayed == written);
+        QCOMPARE(replay.progress(), 1.0);
+    }
+
+    // A later part continues to the end
+    ReplaySource replay;
+    QVERIFY(replay.open(RawCaptureWriter::partPath(path, 2), 11520));
+    QByteArray replayed;
+    QByteArray data;
+    qint64 offsetNs = 0;
+    while (replay.next(data, offsetNs)) {
+        replayed += data;
+    }
+    QVERIFY(!replayed.isEmpty());
+    QVERIFY(written.endsWith(replayed));
+}
+
+void PipelineThroughputTest::demuxTextBeforeJustFloat()
+{
+    auto justFloat = std::make_shared<JustFloatProtocol>();
+    auto line = std::make_shared<LineParser>(ParserConfig::csvDefault());
+    ProtocolHandler handler;
+    handler.registerProtocol("justfloat", justFloat);
+    handler.registerProtocol("line", line);
+    QVERIFY(handler.setDemuxProtocols({"justfloat", "line"}));
+
+    QStringList lines;
+    connect(line.get(), &LineParser::rawLineReady, this, [&lines](const QString &text) {
+        lines.append(text);
+    });
+    QVector<double> frameValues;
+    connect(justFloat.get(), &BaseProtocol::batchForLogging, this, [&frameValues](const PacketBatch &batch) {
+        for (const auto &packet : batch) {
+            frameValues += packet.values;
+        }
+    });
+
+    // A short text line whose length keeps the tail 4-byte aligned
+    QByteArray data("ok1\n");
+    for (float value : {1.0f, 2.0f}) {
+        char bytes[4];
+        qToLittleEndian(value, bytes);
+        data.append(bytes, 4);
+    }
+    data.append("\x00\x00\x80\x7F", 4);
+    handler.processRawData(data);
+
+    QCOMPARE(lines, QStringList{"ok1"});
+    QCOMPARE(frameValues, (QVector<double>{1.0, 2.0}));
+}
+
+QTEST_GUILESS_MAIN(PipelineThroughputTest)
+
+#include "PipelineThroughputTest.moc"